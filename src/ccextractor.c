@@ -8,8 +8,12 @@ CI verification run: 2025-12-19T08:30 - Testing merged fixes from PRs #1847 and
 #include "ccextractor.h"
 #include <stdio.h>
 #include <locale.h>
-
-volatile int terminate_asap = 0;
+#ifndef _WIN32
+#include <sys/wait.h>
+#endif
+#ifdef ENABLE_OCR
+#include "lib_ccx/ocr.h"
+#endif
 
 struct ccx_s_options ccx_options;
 struct lib_ccx_ctx *signal_ctx;
@@ -23,7 +27,8 @@ void sigusr1_handler(int sig)
 void sigterm_handler(int sig)
 {
 	printf("Received SIGTERM, terminating as soon as possible.\n");
-	terminate_asap = 1;
+	if (signal_ctx)
+		signal_ctx->terminate_asap = 1;
 }
 
 void sigint_handler(int sig)
@@ -138,7 +143,6 @@ int start_ccx()
 	m_signal(SIGTERM, sigterm_handler);
 	m_signal(SIGUSR1, sigusr1_handler);
 #endif
-	terminate_asap = 0;
 
 	ret = 0;
 	while (switch_to_next_file(ctx, 0))
@@ -222,12 +226,25 @@ int start_ccx()
 					ret = tmp;
 				break;
 			case CCX_SM_MP4:
-				mprint("\rAnalyzing data with GPAC (MP4 library)\n");
-				close_input_file(ctx);	     // No need to have it open. GPAC will do it for us
-				if (ctx->current_file == -1) // We don't have a file to open, must be stdin, and GPAC is incompatible with stdin
+				// GPAC is incompatible with stdin and with fragmented files still being written, read those
+				// as a stream. Other files, even with --live-stream, go to GPAC.
+				if (ctx->current_file == -1 ||
+				    (ccx_options.live_stream && !ccx_options.extract_chapters && is_fragmented_mp4(ctx->inputfile[ctx->current_file])))
 				{
-					fatal(EXIT_INCOMPATIBLE_PARAMETERS, "MP4 requires an actual file, it's not possible to read from a stream, including stdin.\n");
+					if (ccx_options.extract_chapters)
+					{
+						fatal(EXIT_INCOMPATIBLE_PARAMETERS, "Extracting MP4 chapters requires an actual file, it's not possible to read them from a stream, including stdin.\n");
+					}
+					mprint("\rAnalyzing data as a fragmented MP4 stream\n");
+					tmp = processmp4_stream(ctx, &ctx->mp4_cfg);
+					if (ccx_options.print_file_reports)
+						print_file_report(ctx);
+					if (!ret)
+						ret = tmp;
+					break;
 				}
+				mprint("\rAnalyzing data with GPAC (MP4 library)\n");
+				close_input_file(ctx); // No need to have it open. GPAC will do it for us
 				if (ccx_options.extract_chapters)
 				{
 					tmp = dumpchapters(ctx, &ctx->mp4_cfg, ctx->inputfile[ctx->current_file]);
@@ -261,11 +278,11 @@ int start_ccx()
 		{
 			mprint("\n");
 			dbg_print(CCX_DMT_DECODER_608, "\nTime stamps after last caption block was written:\n");
-			dbg_print(CCX_DMT_DECODER_608, "GOP: %s	  \n", print_mstime_static(gop_time.ms));
+			dbg_print(CCX_DMT_DECODER_608, "GOP: %s	  \n", print_mstime_static(dec_ctx->timing->gop_time.ms));
 
 			dbg_print(CCX_DMT_DECODER_608, "GOP: %s (%+3dms incl.)\n",
-				  print_mstime_static((LLONG)(gop_time.ms - first_gop_time.ms + get_fts_max(dec_ctx->timing) - fts_at_gop_start)),
-				  (int)(get_fts_max(dec_ctx->timing) - fts_at_gop_start));
+				  print_mstime_static((LLONG)(dec_ctx->timing->gop_time.ms - dec_ctx->timing->first_gop_time.ms + get_fts_max(dec_ctx->timing) - dec_ctx->timing->fts_at_gop_start)),
+				  (int)(get_fts_max(dec_ctx->timing) - dec_ctx->timing->fts_at_gop_start));
 			// When padding is active the CC block time should be within
 			// 1000/29.97 us of the differences.
 			dbg_print(CCX_DMT_DECODER_608, "Max. FTS:	   %s  (without caption blocks since then)\n",
@@ -274,8 +291,8 @@ int start_ccx()
 			if (dec_ctx->codec == CCX_CODEC_ATSC_CC)
 			{
 				mprint("\nTotal frames time:	  %s  (%u frames at %.2ffps)\n",
-				       print_mstime_static((LLONG)(total_frames_count * 1000 / current_fps)),
-				       total_frames_count, current_fps);
+				       print_mstime_static((LLONG)(dec_ctx->timing->total_frames_count * 1000 / dec_ctx->timing->current_fps)),
+				       dec_ctx->timing->total_frames_count, dec_ctx->timing->current_fps);
 			}
 
 			if (dec_ctx->stat_hdtv)
@@ -287,35 +304,35 @@ int start_ccx()
 			}
 			// Add one frame as fts_max marks the beginning of the last frame,
 			// but we need the end.
-			dec_ctx->timing->fts_global += dec_ctx->timing->fts_max + (LLONG)(1000.0 / current_fps);
+			dec_ctx->timing->fts_global += dec_ctx->timing->fts_max + (LLONG)(1000.0 / dec_ctx->timing->current_fps);
 			// CFS: At least in Hauppage mode, cb_field can be responsible for ALL the
 			// timing (cb_fields having a huge number and fts_now and fts_global being 0 all
 			// the time), so we need to take that into account in fts_global before resetting
 			// counters.
-			if (cb_field1 != 0)
-				dec_ctx->timing->fts_global += cb_field1 * 1001 / 3;
-			else if (cb_field2 != 0)
-				dec_ctx->timing->fts_global += cb_field2 * 1001 / 3;
+			if (dec_ctx->timing->cb_field1 != 0)
+				dec_ctx->timing->fts_global += dec_ctx->timing->cb_field1 * 1001 / 3;
+			else if (dec_ctx->timing->cb_field2 != 0)
+				dec_ctx->timing->fts_global += dec_ctx->timing->cb_field2 * 1001 / 3;
 			else
-				dec_ctx->timing->fts_global += cb_708 * 1001 / 3;
+				dec_ctx->timing->fts_global += dec_ctx->timing->cb_708 * 1001 / 3;
 			// Reset counters - This is needed if some captions are still buffered
 			// and need to be written after the last file is processed.
-			cb_field1 = 0;
-			cb_field2 = 0;
-			cb_708 = 0;
+			dec_ctx->timing->cb_field1 = 0;
+			dec_ctx->timing->cb_field2 = 0;
+			dec_ctx->timing->cb_708 = 0;
 			dec_ctx->timing->fts_now = 0;
 			dec_ctx->timing->fts_max = 0;
 
 			if (dec_ctx->total_pulldownframes)
 				mprint("incl. pulldown frames:  %s  (%u frames at %.2ffps)\n",
-				       print_mstime_static((LLONG)(dec_ctx->total_pulldownframes * 1000 / current_fps)),
-				       dec_ctx->total_pulldownframes, current_fps);
+				       print_mstime_static((LLONG)(dec_ctx->total_pulldownframes * 1000 / dec_ctx->timing->current_fps)),
+				       dec_ctx->total_pulldownframes, dec_ctx->timing->current_fps);
 			if (dec_ctx->timing->pts_set >= 1 && dec_ctx->timing->min_pts != 0x01FFFFFFFFLL)
 			{
-				LLONG postsyncms = (LLONG)(dec_ctx->frames_since_last_gop * 1000 / current_fps);
+				LLONG postsyncms = (LLONG)(dec_ctx->frames_since_last_gop * 1000 / dec_ctx->timing->current_fps);
 				mprint("\nMin PTS:				%s\n",
 				       print_mstime_static(dec_ctx->timing->min_pts / (MPEG_CLOCK_FREQ / 1000) - dec_ctx->timing->fts_offset));
-				if (pts_big_change)
+				if (dec_ctx->timing->pts_big_change)
 					mprint("(Reference clock was reset at some point, Min PTS is approximated)\n");
 				mprint("Max PTS:				%s\n",
 				       print_mstime_static(dec_ctx->timing->sync_pts / (MPEG_CLOCK_FREQ / 1000) + postsyncms));
@@ -325,18 +342,18 @@ int start_ccx()
 			}
 
 			// dvr-ms files have invalid GOPs
-			if (gop_time.inited && first_gop_time.inited && stream_mode != CCX_SM_ASF)
+			if (dec_ctx->timing->gop_time.inited && dec_ctx->timing->first_gop_time.inited && stream_mode != CCX_SM_ASF)
 			{
 				mprint("\nInitial GOP time:	   %s\n",
-				       print_mstime_static(first_gop_time.ms));
+				       print_mstime_static(dec_ctx->timing->first_gop_time.ms));
 				mprint("Final GOP time:		 %s%+3dF\n",
-				       print_mstime_static(gop_time.ms),
+				       print_mstime_static(dec_ctx->timing->gop_time.ms),
 				       dec_ctx->frames_since_last_gop);
 				mprint("Diff. GOP length:	   %s%+3dF",
-				       print_mstime_static(gop_time.ms - first_gop_time.ms),
+				       print_mstime_static(dec_ctx->timing->gop_time.ms - dec_ctx->timing->first_gop_time.ms),
 				       dec_ctx->frames_since_last_gop);
 				mprint("	(%s)\n\n",
-				       print_mstime_static(gop_time.ms - first_gop_time.ms + (LLONG)((dec_ctx->frames_since_last_gop) * 1000 / 29.97)));
+				       print_mstime_static(dec_ctx->timing->gop_time.ms - dec_ctx->timing->first_gop_time.ms + (LLONG)((dec_ctx->frames_since_last_gop) * 1000 / 29.97)));
 			}
 
 			if (dec_ctx->false_pict_header)
@@ -418,6 +435,289 @@ int start_ccx()
 	return ret ? EXIT_OK : EXIT_NO_CAPTIONS;
 }
 
+#ifndef _WIN32
+/* --batch: each input file is processed by a worker process of its own, forked
+   once the options have been parsed. A process per file keeps the jobs apart:
+   fatal() ends the whole process, so a broken file only ends its own worker.
+
+   What main() does before start_batch() is shared by the workers: the
+   configuration file, the parameters and their checks, locale and logger.
+   start_batch() also loads Tesseract when --ocrlang names its language, and
+   the FreeType fonts and ASCII glyphs when the output is SPUPNG. Each worker
+   takes these over on first use, sharing their pages with the others until
+   it writes to them.
+   Everything start_ccx() does is repeated by every worker, including the
+   library contexts and output files, and so is Tesseract without --ocrlang,
+   whose language comes from the stream. */
+
+struct batch_job
+{
+	const char *input;
+	pid_t pid;		 // 0 until the job is started
+	int started, done;	 // Jobs never started were skipped
+	int status;		 // As returned by waitpid()
+	FILE *log;		 // What the job wrote to stderr
+	char message[256];	 // Its last line, for the report
+	struct timespec start;
+	LLONG elapsed_ms;
+};
+
+static volatile int batch_terminate = 0;
+
+static void batch_signal_handler(int sig)
+{
+	batch_terminate = 1;
+}
+
+static LLONG batch_elapsed_ms(const struct timespec *start)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (LLONG)(now.tv_sec - start->tv_sec) * 1000 + (now.tv_nsec - start->tv_nsec) / 1000000;
+}
+
+// In the worker process: extract the captions of one file as if it was the only input
+static void run_batch_job(int index)
+{
+	int devnull = open("/dev/null", O_WRONLY);
+	if (devnull >= 0)
+	{
+		dup2(devnull, STDOUT_FILENO);
+		close(devnull);
+	}
+
+	ccx_options.inputfile += index;
+	ccx_options.num_input_files = 1;
+	ccx_options.enc_cfg.first_input_file = ccx_options.inputfile[0];
+	ccx_options.batch_mode = 0;
+	exit(start_ccx());
+}
+
+static void start_batch_job(struct batch_job *job, int index)
+{
+	clock_gettime(CLOCK_MONOTONIC, &job->start);
+	job->started = 1;
+	job->log = tmpfile();
+
+	fflush(stdout);
+	fflush(stderr);
+	job->pid = fork();
+	if (job->pid == 0)
+	{
+		if (job->log)
+			dup2(fileno(job->log), STDERR_FILENO);
+		run_batch_job(index);
+	}
+	if (job->pid < 0)
+	{
+		job->done = 1;
+		job->status = -1;
+		snprintf(job->message, sizeof(job->message), "Could not start a worker process: %s", strerror(errno));
+		if (job->log)
+			fclose(job->log);
+		job->log = NULL;
+	}
+}
+
+// Keeps the last line the job wrote to stderr, usually why it failed
+static void read_batch_job_message(struct batch_job *job)
+{
+	char tail[1024];
+	if (!job->log)
+		return;
+
+	fseek(job->log, 0, SEEK_END);
+	long size = ftell(job->log);
+	long from = size > (long)sizeof(tail) - 1 ? size - (long)sizeof(tail) + 1 : 0;
+	fseek(job->log, from, SEEK_SET);
+	size_t length = fread(tail, 1, sizeof(tail) - 1, job->log);
+	fclose(job->log);
+	job->log = NULL;
+
+	while (length && (tail[length - 1] == '\n' || tail[length - 1] == '\r' || tail[length - 1] == ' '))
+		length--;
+	tail[length] = '\0';
+	char *line = tail + length;
+	while (line > tail && line[-1] != '\n' && line[-1] != '\r')
+		line--;
+	if (!strncmp(line, "Error: ", 7))
+		line += 7;
+	snprintf(job->message, sizeof(job->message), "%s", line);
+}
+
+static const char *batch_job_status(const struct batch_job *job)
+{
+	if (!job->started)
+		return "skipped";
+	if (job->status == -1 || WIFSIGNALED(job->status))
+		return job->status == -1 ? "failed" : "crashed";
+	switch (WEXITSTATUS(job->status))
+	{
+		case EXIT_OK:
+			return "ok";
+		case EXIT_NO_CAPTIONS:
+			return "no_captions";
+		default:
+			return "failed";
+	}
+}
+
+static void write_json_string(FILE *f, const char *s)
+{
+	fputc('"', f);
+	for (; *s; s++)
+	{
+		unsigned char c = (unsigned char)*s;
+		if (c == '"' || c == '\\')
+			fprintf(f, "\\%c", c);
+		else if (c < 0x20)
+			fprintf(f, "\\u%04x", c);
+		else
+			fputc(c, f);
+	}
+	fputc('"', f);
+}
+
+static void write_batch_report(const char *filename, struct batch_job *jobs, int count, int workers, LLONG elapsed_ms)
+{
+	const char *statuses[] = {"ok", "no_captions", "failed", "crashed", "skipped"};
+	int totals[5] = {0};
+	FILE *f = fopen(filename, "w");
+	if (!f)
+	{
+		mprint("Could not write the batch report to %s: %s\n", filename, strerror(errno));
+		return;
+	}
+
+	for (int i = 0; i < count; i++)
+		for (int s = 0; s < 5; s++)
+			if (!strcmp(batch_job_status(&jobs[i]), statuses[s]))
+				totals[s]++;
+
+	fprintf(f, "{\n  \"files\": %d,\n  \"jobs\": %d,\n  \"elapsed_ms\": %lld,\n", count, workers, (long long)elapsed_ms);
+	for (int s = 0; s < 5; s++)
+		fprintf(f, "  \"%s\": %d,\n", statuses[s], totals[s]);
+	fprintf(f, "  \"results\": [");
+	for (int i = 0; i < count; i++)
+	{
+		struct batch_job *job = &jobs[i];
+		fprintf(f, "%s\n    {\"input\": ", i ? "," : "");
+		write_json_string(f, job->input);
+		fprintf(f, ", \"status\": \"%s\"", batch_job_status(job));
+		if (job->started && job->status != -1)
+		{
+			if (WIFSIGNALED(job->status))
+				fprintf(f, ", \"signal\": %d", WTERMSIG(job->status));
+			else
+				fprintf(f, ", \"exit_code\": %d", WEXITSTATUS(job->status));
+		}
+		if (job->started)
+			fprintf(f, ", \"elapsed_ms\": %lld", (long long)job->elapsed_ms);
+		if (job->message[0])
+		{
+			fprintf(f, ", \"message\": ");
+			write_json_string(f, job->message);
+		}
+		fputc('}', f);
+	}
+	fprintf(f, "\n  ]\n}\n");
+	fclose(f);
+}
+
+int start_batch()
+{
+	int count = ccx_options.num_input_files;
+	int workers = ccx_options.batch_jobs;
+	if (workers <= 0)
+	{
+		long processors = sysconf(_SC_NPROCESSORS_ONLN);
+		workers = processors > 0 ? (int)processors : 1;
+	}
+	if (workers > count)
+		workers = count;
+
+	struct batch_job *jobs = calloc(count, sizeof(struct batch_job));
+	if (!jobs)
+		fatal(EXIT_NOT_ENOUGH_MEMORY, "In start_batch: Out of memory allocating jobs.");
+	for (int i = 0; i < count; i++)
+		jobs[i].input = ccx_options.inputfile[i];
+
+	mprint("Processing %d files, %d at a time\n", count, workers);
+#ifdef ENABLE_OCR
+	preload_ocr();
+#endif
+	spupng_preload_renderer();
+	m_signal(SIGINT, batch_signal_handler);
+	m_signal(SIGTERM, batch_signal_handler);
+	batch_terminate = 0;
+
+	struct timespec start;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	int next = 0, running = 0, finished = 0;
+	for (;;)
+	{
+		while (running < workers && next < count && !batch_terminate)
+		{
+			start_batch_job(&jobs[next], next);
+			if (jobs[next].done)
+				mprint("[%d/%d] %s: %s\n", ++finished, count, jobs[next].input, jobs[next].message);
+			else
+				running++;
+			next++;
+		}
+		if (!running)
+			break;
+
+		int status;
+		pid_t pid = waitpid(-1, &status, 0);
+		if (pid < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			break;
+		}
+		for (int i = 0; i < next; i++)
+		{
+			struct batch_job *job = &jobs[i];
+			if (job->pid != pid || job->done)
+				continue;
+			job->done = 1;
+			job->status = status;
+			job->elapsed_ms = batch_elapsed_ms(&job->start);
+			read_batch_job_message(job);
+			running--;
+			mprint("[%d/%d] %s: %s\n", ++finished, count, job->input, batch_job_status(job));
+			break;
+		}
+	}
+	LLONG elapsed_ms = batch_elapsed_ms(&start);
+
+	int ret = EXIT_NO_CAPTIONS, failures = 0;
+	for (int i = 0; i < count; i++)
+	{
+		const char *job_status = batch_job_status(&jobs[i]);
+		if (!strcmp(job_status, "ok") && ret == EXIT_NO_CAPTIONS)
+			ret = EXIT_OK;
+		else if (!strcmp(job_status, "failed") || !strcmp(job_status, "crashed"))
+			failures++;
+	}
+	if (batch_terminate)
+		mprint("Terminated, %d files were not processed\n", count - next);
+	mprint("Done, %d of %d files failed, processing time = %lld seconds\n", failures, count, (long long)(elapsed_ms / 1000));
+	if (ccx_options.batch_report)
+		write_batch_report(ccx_options.batch_report, jobs, count, workers, elapsed_ms);
+
+	free(jobs);
+	return failures || batch_terminate ? EXIT_NOT_CLASSIFIED : ret;
+}
+#else
+int start_batch()
+{
+	fatal(EXIT_INCOMPATIBLE_PARAMETERS, "--batch is not supported on Windows yet.\n");
+	return EXIT_INCOMPATIBLE_PARAMETERS;
+}
+#endif
+
 int main(int argc, char *argv[])
 {
 	setlocale(LC_ALL, ""); // Supports non-English CCs
@@ -449,6 +749,6 @@ int main(int argc, char *argv[])
 		exit(compile_ret);
 	}
 
-	int start_ret = start_ccx();
+	int start_ret = ccx_options.batch_mode ? start_batch() : start_ccx();
 	return start_ret;
 }
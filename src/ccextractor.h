@@ -29,7 +29,6 @@ CURLcode res;
 
 extern struct ccx_s_options ccx_options;
 extern struct lib_ccx_ctx *signal_ctx;
-// volatile int terminate_asap = 0;
 
 struct ccx_s_options *api_init_options();
 
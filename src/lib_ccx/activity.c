@@ -4,8 +4,6 @@ relevant events. */
 #include "lib_ccx.h"
 #include "ccx_common_option.h"
 
-unsigned long net_activity_gui = 0;
-
 /* Print current progress. For percentage, -1 -> streaming mode */
 void activity_progress(int percentage, int cur_min, int cur_sec)
 {
@@ -117,7 +115,7 @@ void activity_report_version(void)
 	}
 }
 
-void activity_report_data_read(void)
+void activity_report_data_read(unsigned long net_activity_gui)
 {
 	if (ccx_options.gui_mode_reports)
 	{
@@ -169,7 +169,7 @@ int asf_get_more_data(struct lib_ccx_ctx *ctx, struct demuxer_data **ppdata)
 		if (result != 30)
 		{
 			mprint("Premature end of file!\n");
-			end_of_file = 1;
+			ctx->end_of_file = 1;
 			return payload_read;
 		}
 
@@ -207,7 +207,7 @@ int asf_get_more_data(struct lib_ccx_ctx *ctx, struct demuxer_data **ppdata)
 		if (result != get_bytes)
 		{
 			mprint("Premature end of file!\n");
-			end_of_file = 1;
+			ctx->end_of_file = 1;
 			return payload_read;
 		}
 
@@ -549,7 +549,7 @@ int asf_get_more_data(struct lib_ccx_ctx *ctx, struct demuxer_data **ppdata)
 		if (result != 50)
 		{
 			mprint("Premature end of file!\n");
-			end_of_file = 1;
+			ctx->end_of_file = 1;
 			return payload_read;
 		}
 
@@ -591,7 +591,7 @@ int asf_get_more_data(struct lib_ccx_ctx *ctx, struct demuxer_data **ppdata)
 			if (result != 1)
 			{
 				mprint("Premature end of file!\n");
-				end_of_file = 1;
+				ctx->end_of_file = 1;
 				return payload_read;
 			}
 			data_packet_length += 1;
@@ -608,7 +608,7 @@ int asf_get_more_data(struct lib_ccx_ctx *ctx, struct demuxer_data **ppdata)
 				if (result != ecdatalength)
 				{
 					mprint("Premature end of file!\n");
-					end_of_file = 1;
+					ctx->end_of_file = 1;
 					return payload_read;
 				}
 				data_packet_length += ecdatalength;
@@ -629,7 +629,7 @@ int asf_get_more_data(struct lib_ccx_ctx *ctx, struct demuxer_data **ppdata)
 			if (result != 2)
 			{
 				mprint("Premature end of file!\n");
-				end_of_file = 1;
+				ctx->end_of_file = 1;
 				return payload_read;
 			}
 			data_packet_length += 2;
@@ -665,7 +665,7 @@ int asf_get_more_data(struct lib_ccx_ctx *ctx, struct demuxer_data **ppdata)
 			if (result != payload_parser_size)
 			{
 				mprint("Premature end of file!\n");
-				end_of_file = 1;
+				ctx->end_of_file = 1;
 				return payload_read;
 			}
 			data_packet_length += payload_parser_size;
@@ -703,7 +703,7 @@ int asf_get_more_data(struct lib_ccx_ctx *ctx, struct demuxer_data **ppdata)
 				if (result != 1)
 				{
 					mprint("Premature end of file!\n");
-					end_of_file = 1;
+					ctx->end_of_file = 1;
 					return payload_read;
 				}
 				data_packet_length += 1;
@@ -742,7 +742,7 @@ int asf_get_more_data(struct lib_ccx_ctx *ctx, struct demuxer_data **ppdata)
 				if (result != payload_header_size)
 				{
 					mprint("Premature end of file!\n");
-					end_of_file = 1;
+					ctx->end_of_file = 1;
 					return payload_read;
 				}
 				data_packet_length += payload_header_size;
@@ -774,7 +774,7 @@ int asf_get_more_data(struct lib_ccx_ctx *ctx, struct demuxer_data **ppdata)
 				if (result != replicated_length)
 				{
 					mprint("Premature end of file!\n");
-					end_of_file = 1;
+					ctx->end_of_file = 1;
 					return payload_read;
 				}
 				// Parse Replicated data
@@ -850,7 +850,7 @@ int asf_get_more_data(struct lib_ccx_ctx *ctx, struct demuxer_data **ppdata)
 					if (result != asf_data_container.PayloadLType)
 					{
 						mprint("Premature end of file!\n");
-						end_of_file = 1;
+						ctx->end_of_file = 1;
 						return payload_read;
 					}
 					asf_data_container.PayloadLength = asf_readval(plheader, asf_data_container.PayloadLType);
@@ -990,7 +990,7 @@ int asf_get_more_data(struct lib_ccx_ctx *ctx, struct demuxer_data **ppdata)
 				if (result != asf_data_container.PayloadLength)
 				{
 					mprint("Premature end of file!\n");
-					end_of_file = 1;
+					ctx->end_of_file = 1;
 					return payload_read;
 				}
 				asf_data_container.dobjectread += asf_data_container.PayloadLength;
@@ -1004,7 +1004,7 @@ int asf_get_more_data(struct lib_ccx_ctx *ctx, struct demuxer_data **ppdata)
 				if (result != asf_data_container.PayloadLength)
 				{
 					mprint("Premature end of file!\n");
-					end_of_file = 1;
+					ctx->end_of_file = 1;
 					return payload_read;
 				}
 				asf_data_container.dobjectread += result;
@@ -1022,7 +1022,7 @@ int asf_get_more_data(struct lib_ccx_ctx *ctx, struct demuxer_data **ppdata)
 		if (result != asf_data_container.PaddingLength)
 		{
 			mprint("Premature end of file!\n");
-			end_of_file = 1;
+			ctx->end_of_file = 1;
 			return payload_read;
 		}
 		asf_data_container.dobjectread += result;
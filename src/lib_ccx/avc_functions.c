@@ -12,7 +12,7 @@ static unsigned char *remove_03emu(unsigned char *from, unsigned char *to);
 static void sei_rbsp(struct avc_ctx *ctx, unsigned char *seibuf, unsigned char *seiend);
 static unsigned char *sei_message(struct avc_ctx *ctx, unsigned char *seibuf, unsigned char *seiend);
 static void user_data_registered_itu_t_t35(struct avc_ctx *ctx, unsigned char *userbuf, unsigned char *userend);
-static void seq_parameter_set_rbsp(struct avc_ctx *ctx, unsigned char *seqbuf, unsigned char *seqend);
+static void seq_parameter_set_rbsp(struct avc_ctx *ctx, struct ccx_common_timing_ctx *timing, unsigned char *seqbuf, unsigned char *seqend);
 static void slice_header(struct encoder_ctx *enc_ctx, struct lib_cc_decode *ctx, unsigned char *heabuf, unsigned char *heaend, int nal_unit_type, struct cc_subtitle *sub);
 
 double roundportable(double x) { return floor(x + 0.5); }
@@ -88,13 +88,6 @@ struct avc_ctx *init_avc(void)
 	return ctx;
 }
 
-// HEVC NAL unit types for SEI messages
-#define HEVC_NAL_PREFIX_SEI 39
-#define HEVC_NAL_SUFFIX_SEI 40
-#define HEVC_NAL_VPS 32
-#define HEVC_NAL_SPS 33
-#define HEVC_NAL_PPS 34
-
 void do_NAL(struct encoder_ctx *enc_ctx, struct lib_cc_decode *dec_ctx, unsigned char *NAL_start, LLONG NAL_length, struct cc_subtitle *sub)
 {
 	unsigned char *NAL_stop;
@@ -160,7 +153,7 @@ void do_NAL(struct encoder_ctx *enc_ctx, struct lib_cc_decode *dec_ctx, unsigned
 			// Found sequence parameter set
 			// We need this to parse NAL type 1 (CCX_NAL_TYPE_CODED_SLICE_NON_IDR_PICTURE_1)
 			dec_ctx->avc_ctx->num_nal_unit_type_7++;
-			seq_parameter_set_rbsp(dec_ctx->avc_ctx, payload_start, NAL_stop);
+			seq_parameter_set_rbsp(dec_ctx->avc_ctx, dec_ctx->timing, payload_start, NAL_stop);
 			dec_ctx->avc_ctx->got_seq_para = 1;
 		}
 		else if (dec_ctx->avc_ctx->got_seq_para && (nal_unit_type == CCX_NAL_TYPE_CODED_SLICE_NON_IDR_PICTURE_1 ||
@@ -653,7 +646,7 @@ void user_data_registered_itu_t_t35(struct avc_ctx *ctx, unsigned char *userbuf,
 }
 
 // Process sequence parameters in AVC data.
-void seq_parameter_set_rbsp(struct avc_ctx *ctx, unsigned char *seqbuf, unsigned char *seqend)
+void seq_parameter_set_rbsp(struct avc_ctx *ctx, struct ccx_common_timing_ctx *timing, unsigned char *seqbuf, unsigned char *seqend)
 {
 	LLONG tmp, tmp1;
 	struct bitstream q1;
@@ -882,10 +875,10 @@ void seq_parameter_set_rbsp(struct avc_ctx *ctx, unsigned char *seqbuf, unsigned
 			{
 				double clock_tick = (double)num_units_in_tick / time_scale;
 				dvprint("clock_tick= %f\n", clock_tick);
-				if (current_fps != (double)time_scale / (2 * num_units_in_tick))
+				if (timing->current_fps != (double)time_scale / (2 * num_units_in_tick))
 				{
-					current_fps = (double)time_scale / (2 * num_units_in_tick); // Based on formula D-2, p. 359 of the ISO/IEC 14496-10:2012(E) spec.
-					mprint("Changed fps using NAL to: %f\n", current_fps);
+					timing->current_fps = (double)time_scale / (2 * num_units_in_tick); // Based on formula D-2, p. 359 of the ISO/IEC 14496-10:2012(E) spec.
+					mprint("Changed fps using NAL to: %f\n", timing->current_fps);
 				}
 			}
 		}
@@ -984,7 +977,7 @@ void slice_header(struct encoder_ctx *enc_ctx, struct lib_cc_decode *dec_ctx, un
 
 			// When bottom_field_flag is set the video is interlaced,
 			// override current_fps.
-			current_fps = framerates_values[dec_ctx->current_frame_rate];
+			dec_ctx->timing->current_fps = framerates_values[dec_ctx->current_frame_rate];
 		}
 	}
 
@@ -1197,7 +1190,7 @@ void slice_header(struct encoder_ctx *enc_ctx, struct lib_cc_decode *dec_ctx, un
 		// frame rate
 		// The 2* accounts for a discrepancy between current and actual FPS
 		// seen in some files (CCSample2.mpg)
-		current_index = (int)roundportable(2 * (dec_ctx->timing->current_pts - dec_ctx->avc_ctx->currefpts) / (MPEG_CLOCK_FREQ / current_fps));
+		current_index = (int)roundportable(2 * (dec_ctx->timing->current_pts - dec_ctx->avc_ctx->currefpts) / (MPEG_CLOCK_FREQ / dec_ctx->timing->current_fps));
 
 		if (abs(current_index) >= MAXBFRAMES)
 		{
@@ -1276,7 +1269,7 @@ void slice_header(struct encoder_ctx *enc_ctx, struct lib_cc_decode *dec_ctx, un
 		}
 	}
 
-	total_frames_count++;
+	dec_ctx->timing->total_frames_count++;
 	dec_ctx->frames_since_last_gop++;
 
 	store_hdcc(enc_ctx, dec_ctx, dec_ctx->avc_ctx->cc_data, dec_ctx->avc_ctx->cc_count, current_index, dec_ctx->timing->fts_now, sub);
@@ -1,6 +1,13 @@
 #ifndef AVC_FUNCTION_H
 #define AVC_FUNCTION_H
 
+// HEVC NAL unit types for SEI messages
+#define HEVC_NAL_PREFIX_SEI 39
+#define HEVC_NAL_SUFFIX_SEI 40
+#define HEVC_NAL_VPS 32
+#define HEVC_NAL_SPS 33
+#define HEVC_NAL_PPS 34
+
 struct avc_ctx
 {
 	unsigned char cc_count;
@@ -48,6 +48,7 @@ extern void ccxr_millis_to_time(LLONG milli, unsigned *hours, unsigned *minutes,
 
 void freep(void *arg);
 void dbg_print(LLONG mask, const char *fmt, ...);
+int dbg_enabled(LLONG mask);
 unsigned char *debug_608_to_ASC(unsigned char *ccdata, int channel);
 int add_cc_sub_text(struct cc_subtitle *sub, char *str, LLONG start_time,
 		    LLONG end_time, char *info, char *mode, enum ccx_encoding_type);
@@ -77,6 +77,10 @@ void init_options(struct ccx_s_options *options)
 	options->ocr_line_split = 0;	  // By default, don't split images into lines (pending testing)
 	options->ocr_blacklist = 1;	  // By default, use character blacklist to prevent common OCR errors (| vs I, etc.)
 	options->mkvlang = NULL;	  // By default, all the languages are extracted
+	options->mkv_threads = 1;	  // By default, MKV subtitle tracks are written one after another
+	options->png_threads = 1;	  // By default, SPUPNG images are written as they are produced
+	options->png_compression_level = -1;
+	options->png_filters = 0;
 	options->ignore_pts_jumps = 1;
 	options->analyze_video_stream = 0;
 
@@ -88,6 +92,7 @@ void init_options(struct ccx_s_options *options)
 	options->hardsubx_conf_thresh = 0.0;
 	options->hardsubx_hue = 0.0;
 	options->hardsubx_lum_thresh = 95.0;
+	options->hardsubx_band_height = 25.0;
 	options->hardsubx_and_common = 0;
 
 	options->transcript_settings = ccx_encoders_default_transcript_settings;
@@ -111,6 +116,9 @@ void init_options(struct ccx_s_options *options)
 	options->noautotimeref = 0;	     // Do NOT set time automatically?
 	options->input_source = CCX_DS_FILE; // Files, stdin or network
 	options->multiprogram = 0;
+	options->batch_mode = 0;
+	options->batch_jobs = 0;
+	options->batch_report = NULL;
 	options->out_interval = -1;
 	options->segment_on_key_frames_only = 0;
 
@@ -144,6 +152,8 @@ void init_options(struct ccx_s_options *options)
 	options->enc_cfg.force_dropframe = 0; // Assume No Drop Frame for MCC Encode.
 	options->enc_cfg.scc_framerate = 0;   // Default: 29.97fps for SCC output
 	options->enc_cfg.extract_only_708 = 0;
+	options->enc_cfg.nb_extra_write_formats = 0; // Only the --out format
+	options->enc_cfg.threaded_outputs = 0;
 
 	options->settings_dtvcc.enabled = 0;
 	options->settings_dtvcc.active_services_count = 0;
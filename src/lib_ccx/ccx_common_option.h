@@ -26,6 +26,8 @@ struct demuxer_cfg
 	unsigned ts_forced_streamtype; // User selected (forced) stream type
 };
 
+#define CCX_MAX_EXTRA_OUTPUTS 8 // Formats that --also-out can add to --out
+
 struct encoder_cfg
 {
 	int extract;	      // Extract 1st, 2nd or both fields
@@ -87,6 +89,16 @@ struct encoder_cfg
 	char **services_charsets;
 	char *all_services_charset;
 	int extract_only_708; // 1 if only 708 subs extraction is enabled
+
+	// Additional outputs fed by the same decoding pass
+	enum ccx_output_format extra_write_formats[CCX_MAX_EXTRA_OUTPUTS];
+	int nb_extra_write_formats;
+	int threaded_outputs; // 1 to give each additional output its own thread
+
+	// Library use (ccx_session.h): encoded output and subtitles go to callbacks instead of files
+	ccx_output_callback output_callback;
+	ccx_subtitle_callback subtitle_callback;
+	void *callback_opaque;
 };
 
 struct ccx_s_options // Options from user parameters
@@ -155,6 +167,10 @@ struct ccx_s_options // Options from user parameters
 	int ocr_line_split;	  // If 1, split images into lines before OCR (uses PSM 7 for better accuracy)
 	int ocr_blacklist;	  // If 1, use character blacklist to prevent common OCR errors (default: enabled)
 	char *mkvlang;		  // The name of the language stream for MKV
+	int mkv_threads;	  // How many MKV subtitle tracks are written at the same time
+	int png_threads;	  // How many threads compress and write SPUPNG images
+	int png_compression_level; // zlib level of SPUPNG images, -1 for libpng's default
+	int png_filters;	  // libpng PNG_FILTER_* mask for SPUPNG images, 0 for libpng's default
 	int analyze_video_stream; // If 1, the video stream will be processed even if we're using a different one for subtitles.
 
 	/*HardsubX related stuff*/
@@ -165,6 +181,7 @@ struct ccx_s_options // Options from user parameters
 	float hardsubx_conf_thresh;
 	float hardsubx_hue;
 	float hardsubx_lum_thresh;
+	float hardsubx_band_height; // Height of the subtitle band at the bottom of the frame, in percent
 
 	ccx_encoders_transcript_format transcript_settings; // Keeps the settings for generating transcript output files.
 	enum ccx_output_date_format date_format;
@@ -198,6 +215,9 @@ struct ccx_s_options // Options from user parameters
 	int pes_header_to_stdout; // If this is set to 1, the PES Header will be printed to console (debugging purposes)
 	int ignore_pts_jumps;	  // If 1, the program will ignore PTS jumps. Sometimes this parameter is required for DVB subs with > 30s pause time
 	int multiprogram;
+	int batch_mode;	    // Process every input file as an independent job (--batch)
+	int batch_jobs;	    // Jobs to run at the same time in batch mode, 0 for one per processor
+	char *batch_report; // File to write the JSON report of a batch to
 	int out_interval;
 	int segment_on_key_frames_only;
 	int scc_framerate; // SCC input framerate: 0=29.97 (default), 1=24, 2=25, 3=30
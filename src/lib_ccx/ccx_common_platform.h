@@ -119,4 +119,18 @@ typedef int64_t LLONG;
 typedef uint64_t ULLONG;
 typedef uint8_t UBYTE;
 
+// A lock that can be defined statically, for the state that threads share
+#ifdef _WIN32
+typedef SRWLOCK ccx_static_lock;
+#define CCX_STATIC_LOCK_INIT SRWLOCK_INIT
+#define ccx_static_lock_acquire(lock) AcquireSRWLockExclusive(lock)
+#define ccx_static_lock_release(lock) ReleaseSRWLockExclusive(lock)
+#else
+#include <pthread.h>
+typedef pthread_mutex_t ccx_static_lock;
+#define CCX_STATIC_LOCK_INIT PTHREAD_MUTEX_INITIALIZER
+#define ccx_static_lock_acquire(lock) pthread_mutex_lock(lock)
+#define ccx_static_lock_release(lock) pthread_mutex_unlock(lock)
+#endif
+
 #endif // CCX_PLATFORM_H
@@ -9,24 +9,9 @@
  * Requires: frames_since_ref_time, current_tref
  */
 
-// Count 608 (per field) and 708 blocks since last set_fts() call
-int cb_field1, cb_field2, cb_708;
-
 int MPEG_CLOCK_FREQ = 90000; // This "constant" is part of the standard
 
 int max_dif = 5;
-unsigned pts_big_change;
-
-// PTS timing related stuff
-
-double current_fps = (double)30000.0 / 1001; /* 29.97 */ // TODO: Get from framerates_values[] instead
-
-int frames_since_ref_time = 0;
-unsigned total_frames_count;
-
-struct gop_time_code gop_time, first_gop_time, printed_gop;
-LLONG fts_at_gop_start = 0;
-int gop_rollover = 0;
 
 struct ccx_common_timing_settings_t ccx_common_timing_settings;
 
@@ -39,8 +24,8 @@ LLONG ccxr_get_visible_start(struct ccx_common_timing_ctx *ctx, int current_fiel
 LLONG ccxr_get_visible_end(struct ccx_common_timing_ctx *ctx, int current_field);
 char *ccxr_print_mstime_static(LLONG mstime, char *buf);
 void ccxr_print_debug_timing(struct ccx_common_timing_ctx *ctx);
-void ccxr_calculate_ms_gop_time(struct gop_time_code *g);
-int ccxr_gop_accepted(struct gop_time_code *g);
+void ccxr_calculate_ms_gop_time(struct ccx_common_timing_ctx *ctx, struct gop_time_code *g);
+int ccxr_gop_accepted(struct ccx_common_timing_ctx *ctx, struct gop_time_code *g);
 
 void ccx_common_timing_init(LLONG *file_position, int no_sync)
 {
@@ -83,6 +68,20 @@ struct ccx_common_timing_ctx *init_timing_ctx(struct ccx_common_timing_settings_
 	ctx->fts_global = 0;	// Duration of previous files (-ve mode), see c1global
 	ctx->pts_reset = 0;	// 0 = No, 1 = Yes. PTS resets when current_pts is lower than prev
 
+	ctx->cb_field1 = 0;
+	ctx->cb_field2 = 0;
+	ctx->cb_708 = 0;
+	ctx->pts_big_change = 0;
+
+	ctx->current_fps = (double)30000.0 / 1001; /* 29.97 */ // TODO: Get from framerates_values[] instead
+	ctx->frames_since_ref_time = 0;
+	ctx->total_frames_count = 0;
+
+	memset(&ctx->gop_time, 0, sizeof(struct gop_time_code));
+	memset(&ctx->first_gop_time, 0, sizeof(struct gop_time_code));
+	ctx->fts_at_gop_start = 0;
+	ctx->gop_rollover = 0;
+
 	return ctx;
 }
 
@@ -181,12 +180,12 @@ void print_debug_timing(struct ccx_common_timing_ctx *ctx)
 	return ccxr_print_debug_timing(ctx);
 }
 
-void calculate_ms_gop_time(struct gop_time_code *g)
+void calculate_ms_gop_time(struct ccx_common_timing_ctx *ctx, struct gop_time_code *g)
 {
-	return ccxr_calculate_ms_gop_time(g);
+	return ccxr_calculate_ms_gop_time(ctx, g);
 }
 
-int gop_accepted(struct gop_time_code *g)
+int gop_accepted(struct ccx_common_timing_ctx *ctx, struct gop_time_code *g)
 {
-	return ccxr_gop_accepted(g);
+	return ccxr_gop_accepted(ctx, g);
 }
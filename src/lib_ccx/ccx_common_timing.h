@@ -54,23 +54,23 @@ struct ccx_common_timing_ctx
 	LLONG sync_pts2fts_fts;
 	LLONG sync_pts2fts_pts;
 	int pts_reset; // 0 = No, 1 = Yes. PTS resets when current_pts is lower than prev
+
+	// Count 608 (per field) and 708 blocks since last set_fts() call
+	int cb_field1, cb_field2, cb_708;
+	unsigned pts_big_change;
+
+	double current_fps;
+	int frames_since_ref_time;
+	unsigned total_frames_count;
+
+	struct gop_time_code gop_time, first_gop_time;
+	LLONG fts_at_gop_start;
+	int gop_rollover;
 };
-// Count 608 (per field) and 708 blocks since last set_fts() call
-extern int cb_field1, cb_field2, cb_708;
 
 extern int MPEG_CLOCK_FREQ; // This is part of the standard
 
 extern int max_dif;
-extern unsigned pts_big_change;
-
-extern enum ccx_frame_type current_picture_coding_type;
-extern double current_fps;
-extern int frames_since_ref_time;
-extern unsigned total_frames_count;
-
-extern struct gop_time_code gop_time, first_gop_time, printed_gop;
-extern LLONG fts_at_gop_start;
-extern int gop_rollover;
 
 void ccx_common_timing_init(LLONG *file_position, int no_sync);
 
@@ -87,7 +87,7 @@ LLONG get_fts_max(struct ccx_common_timing_ctx *ctx);
 char *print_mstime_static(LLONG mstime);
 size_t print_mstime_buff(LLONG mstime, char *fmt, char *buf);
 void print_debug_timing(struct ccx_common_timing_ctx *ctx);
-int gop_accepted(struct gop_time_code *g);
-void calculate_ms_gop_time(struct gop_time_code *g);
+int gop_accepted(struct ccx_common_timing_ctx *ctx, struct gop_time_code *g);
+void calculate_ms_gop_time(struct ccx_common_timing_ctx *ctx, struct gop_time_code *g);
 
 #endif
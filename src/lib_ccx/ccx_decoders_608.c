@@ -8,7 +8,6 @@
 
 static const int rowdata[] = {11, -1, 1, 2, 3, 4, 12, 13, 14, 15, 5, 6, 7, 8, 9, 10};
 // Relationship between the first PAC byte and the row number
-int in_xds_mode = 0;
 
 // unsigned char str[2048]; // Another generic general purpose buffer
 
@@ -1187,17 +1186,18 @@ int process608(const unsigned char *data, int length, void *private_data, struct
 		{
 			if (context)
 				context->channel = 3;
-			if (!in_xds_mode)
+			if (!dec_ctx->in_xds_mode)
 			{
-				ts_start_of_xds = get_fts(dec_ctx->timing, dec_ctx->current_field);
-				in_xds_mode = 1;
+				if (dec_ctx->xds_ctx)
+					dec_ctx->xds_ctx->ts_start_of_xds = get_fts(dec_ctx->timing, dec_ctx->current_field);
+				dec_ctx->in_xds_mode = 1;
 			}
 			if (report)
 				report->xds = 1;
 		}
-		if (hi == 0x0F && in_xds_mode && (context == NULL || context->my_field == 2)) // End of XDS block
+		if (hi == 0x0F && dec_ctx->in_xds_mode && (context == NULL || context->my_field == 2)) // End of XDS block
 		{
-			in_xds_mode = 0;
+			dec_ctx->in_xds_mode = 0;
 			do_end_of_xds(sub, dec_ctx->xds_ctx, lo);
 			if (context)
 				context->channel = context->new_channel; // Switch from channel 3
@@ -1208,7 +1208,7 @@ int process608(const unsigned char *data, int length, void *private_data, struct
 					      // http://www.theneitherworld.com/mcpoodle/SCC_TOOLS/DOCS/CC_CHARS.HTML
 		{
 			if (!context || context->my_field == 2)
-				in_xds_mode = 0; // Back to normal (CEA 608-8.6.2)
+				dec_ctx->in_xds_mode = 0; // Back to normal (CEA 608-8.6.2)
 			if (!context)		 // Not XDS and we don't have a writebuffer, nothing else would have an effect
 				continue;
 
@@ -1241,7 +1241,7 @@ int process608(const unsigned char *data, int length, void *private_data, struct
 		}
 		else
 		{
-			if (in_xds_mode && (context == NULL || context->my_field == 2))
+			if (dec_ctx->in_xds_mode && (context == NULL || context->my_field == 2))
 			{
 				process_xds_bytes(dec_ctx->xds_ctx, hi, lo);
 				continue;
@@ -1273,7 +1273,9 @@ int process608(const unsigned char *data, int length, void *private_data, struct
 
 			if (!context->textprinted && context->channel == context->my_channel)
 			{ // Current FTS information after the characters are shown
-				ccx_common_logging.debug_ftn(CCX_DMT_DECODER_608, "Current FTS: %s\n", print_mstime_static(get_fts(dec_ctx->timing, context->my_field)));
+				char fts_buf[32];
+				print_mstime_buff(get_fts(dec_ctx->timing, context->my_field), "%02u:%02u:%02u:%03u", fts_buf);
+				ccx_common_logging.debug_ftn(CCX_DMT_DECODER_608, "Current FTS: %s\n", fts_buf);
 				// printf("  N:%u", unsigned(fts_now) );
 				// printf("  G:%u", unsigned(fts_global) );
 				// printf("  F:%d %d %d %d\n",
@@ -4,8 +4,6 @@
 #include "ccx_common_structs.h"
 #include "ccx_decoders_structs.h"
 
-extern LLONG ts_start_of_xds;
-
 /*
    This variable (ccx_decoder_608_report) holds data on the cc channels & xds packets that are encountered during file parse.
    This can be interesting if you just want to know what kind of data a file holds that has 608 packets. CCExtractor uses it
@@ -200,7 +200,13 @@ void dtvcc_clear_packet(dtvcc_ctx *ctx)
 void dtvcc_tv_clear(dtvcc_service_decoder *decoder)
 {
 	for (int i = 0; i < CCX_DTVCC_SCREENGRID_ROWS; i++)
-		memset(decoder->tv->chars[i], 0, CCX_DTVCC_SCREENGRID_COLUMNS * sizeof(dtvcc_symbol));
+		if (CCX_DTVCC_ROW_MAY_HAVE_TEXT(decoder->tv, i))
+			memset(decoder->tv->chars[i], 0, CCX_DTVCC_SCREENGRID_COLUMNS * sizeof(dtvcc_symbol));
+	memset(decoder->tv->dirty_rows, 0, sizeof(decoder->tv->dirty_rows));
+	decoder->tv->dirty_tracking = 1;
+	decoder->tv->pens[CCX_DTVCC_DEFAULT_PEN_INDEX].color = dtvcc_default_pen_color;
+	decoder->tv->pens[CCX_DTVCC_DEFAULT_PEN_INDEX].attribs = dtvcc_default_pen_attribs;
+	decoder->tv->pen_count = 1;
 	decoder->tv->time_ms_show = -1;
 	decoder->tv->time_ms_hide = -1;
 };
@@ -591,11 +597,19 @@ void dtvcc_window_copy_to_screen(dtvcc_service_decoder *decoder, dtvcc_window *w
 	for (int j = 0; j < copyrows; j++)
 	{
 		memcpy(decoder->tv->chars[top + j], window->rows[j], copycols * sizeof(dtvcc_symbol));
-		for (int col = 0; col < CCX_DTVCC_SCREENGRID_COLUMNS; col++)
+		for (int col = 0; col < CCX_DTVCC_MAX_COLUMNS; col++)
 		{
-			decoder->tv->pen_attribs[top + j][col] = window->pen_attribs[j][col];
-			decoder->tv->pen_colors[top + j][col] = window->pen_colors[j][col];
+			// Runs of cells painted with the same pen reuse the previous lookup
+			if (col > 0 &&
+			    !memcmp(&window->pen_colors[j][col], &window->pen_colors[j][col - 1], sizeof(dtvcc_pen_color)) &&
+			    !memcmp(&window->pen_attribs[j][col], &window->pen_attribs[j][col - 1], sizeof(dtvcc_pen_attribs)))
+				decoder->tv->pen_index[top + j][col] = decoder->tv->pen_index[top + j][col - 1];
+			else
+				decoder->tv->pen_index[top + j][col] = dtvcc_screen_intern_pen(decoder->tv, window->pen_colors[j][col], window->pen_attribs[j][col]);
 		}
+		memset(decoder->tv->pen_index[top + j] + CCX_DTVCC_MAX_COLUMNS, CCX_DTVCC_DEFAULT_PEN_INDEX,
+		       CCX_DTVCC_SCREENGRID_COLUMNS - CCX_DTVCC_MAX_COLUMNS);
+		decoder->tv->dirty_rows[top + j] = 1;
 	}
 
 	dtvcc_screen_update_time_show(decoder->tv, window->time_ms_show);
@@ -606,6 +620,28 @@ void dtvcc_window_copy_to_screen(dtvcc_service_decoder *decoder, dtvcc_window *w
 #endif
 }
 
+/**
+ * Returns the index of the pen in the screen's pen table, adding it if needed.
+ * Screens only ever use a handful of pens, so a linear search is enough.
+ */
+unsigned char dtvcc_screen_intern_pen(dtvcc_tv_screen *tv, dtvcc_pen_color color, dtvcc_pen_attribs attribs)
+{
+	for (int i = 0; i < tv->pen_count; i++)
+	{
+		if (!memcmp(&tv->pens[i].color, &color, sizeof(color)) &&
+		    !memcmp(&tv->pens[i].attribs, &attribs, sizeof(attribs)))
+			return i;
+	}
+	if (tv->pen_count == CCX_DTVCC_MAX_SCREEN_PENS)
+	{
+		ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] dtvcc_screen_intern_pen: pen table full, using default pen\n");
+		return CCX_DTVCC_DEFAULT_PEN_INDEX;
+	}
+	tv->pens[tv->pen_count].color = color;
+	tv->pens[tv->pen_count].attribs = attribs;
+	return tv->pen_count++;
+}
+
 void dtvcc_screen_print(dtvcc_ctx *dtvcc, dtvcc_service_decoder *decoder)
 {
 	// TODO use priorities to solve windows overlap (with a video sample, please)
@@ -795,6 +831,12 @@ void dtvcc_process_character(dtvcc_service_decoder *decoder, dtvcc_symbol symbol
 	if (cw == -1 || !window->is_defined) // Writing to a non existing window, skipping
 		return;
 
+	if (window->pen_row >= CCX_DTVCC_MAX_ROWS || window->pen_column >= CCX_DTVCC_MAX_COLUMNS)
+	{
+		ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] dtvcc_process_character: pen is outside of the window, skipping\n");
+		return;
+	}
+
 	window->is_empty = 0;
 	window->rows[window->pen_row][window->pen_column] = symbol;
 	window->pen_attribs[window->pen_row][window->pen_column] = window->pen_attribs_pattern; // "Painting" char by pen - attribs
@@ -291,8 +291,8 @@ typedef struct dtvcc_window
 	int pen_row;
 	int pen_column;
 	dtvcc_symbol *rows[CCX_DTVCC_MAX_ROWS];
-	dtvcc_pen_color pen_colors[CCX_DTVCC_MAX_ROWS][CCX_DTVCC_SCREENGRID_COLUMNS];
-	dtvcc_pen_attribs pen_attribs[CCX_DTVCC_MAX_ROWS][CCX_DTVCC_SCREENGRID_COLUMNS];
+	dtvcc_pen_color pen_colors[CCX_DTVCC_MAX_ROWS][CCX_DTVCC_MAX_COLUMNS];
+	dtvcc_pen_attribs pen_attribs[CCX_DTVCC_MAX_ROWS][CCX_DTVCC_MAX_COLUMNS];
 	dtvcc_pen_color pen_color_pattern;
 	dtvcc_pen_attribs pen_attribs_pattern;
 	int memory_reserved;
@@ -301,18 +301,41 @@ typedef struct dtvcc_window
 	LLONG time_ms_hide;
 } dtvcc_window;
 
+/**
+ * Pen color and attributes a screen cell was painted with.
+ * TV screens keep a small table of the distinct pens in use and store one
+ * table index per cell instead of the full pen, see dtvcc_tv_screen.
+ */
+typedef struct dtvcc_pen
+{
+	dtvcc_pen_color color;
+	dtvcc_pen_attribs attribs;
+} dtvcc_pen;
+
+// Index 0 of the pen table is always the default pen
+#define CCX_DTVCC_MAX_SCREEN_PENS 256
+#define CCX_DTVCC_DEFAULT_PEN_INDEX 0
+
 typedef struct dtvcc_tv_screen
 {
 	dtvcc_symbol chars[CCX_DTVCC_SCREENGRID_ROWS][CCX_DTVCC_SCREENGRID_COLUMNS];
-	dtvcc_pen_color pen_colors[CCX_DTVCC_SCREENGRID_ROWS][CCX_DTVCC_SCREENGRID_COLUMNS];
-	dtvcc_pen_attribs pen_attribs[CCX_DTVCC_SCREENGRID_ROWS][CCX_DTVCC_SCREENGRID_COLUMNS];
+	unsigned char pen_index[CCX_DTVCC_SCREENGRID_ROWS][CCX_DTVCC_SCREENGRID_COLUMNS];
+	dtvcc_pen pens[CCX_DTVCC_MAX_SCREEN_PENS];
+	int pen_count;
 	LLONG time_ms_show;
 	LLONG time_ms_hide;
 	unsigned int cc_count;
 	int service_number;
 	int old_cc_time_end;
+	/* Rows touched by dtvcc_window_copy_to_screen since the last clear.
+	 * Only trusted while dirty_tracking is set, i.e. once the screen has
+	 * been cleared at least once; otherwise every row must be scanned. */
+	unsigned char dirty_rows[CCX_DTVCC_SCREENGRID_ROWS];
+	int dirty_tracking;
 } dtvcc_tv_screen;
 
+#define CCX_DTVCC_ROW_MAY_HAVE_TEXT(tv, row) (!(tv)->dirty_tracking || (tv)->dirty_rows[row])
+
 /**
  * Holds data on the CEA 708 services that are encountered during file parse
  * This can be interesting, so CCExtractor uses it for the report functionality.
@@ -402,6 +425,7 @@ void dtvcc_screen_update_time_hide(dtvcc_tv_screen *tv, LLONG time);
 void dtvcc_get_window_dimensions(dtvcc_window *window, int *x1, int *x2, int *y1, int *y2);
 int dtvcc_is_window_overlapping(dtvcc_service_decoder *decoder, dtvcc_window *window);
 void dtvcc_window_copy_to_screen(dtvcc_service_decoder *decoder, dtvcc_window *window);
+unsigned char dtvcc_screen_intern_pen(dtvcc_tv_screen *tv, dtvcc_pen_color color, dtvcc_pen_attribs attribs);
 void dtvcc_screen_print(dtvcc_ctx *dtvcc, dtvcc_service_decoder *decoder);
 void dtvcc_process_hcr(dtvcc_service_decoder *decoder);
 void dtvcc_process_ff(dtvcc_service_decoder *decoder);
@@ -10,6 +10,8 @@ extern void ccxr_close_handle(void *handle);
 
 int dtvcc_is_row_empty(dtvcc_tv_screen *tv, int row_index)
 {
+	if (!CCX_DTVCC_ROW_MAY_HAVE_TEXT(tv, row_index))
+		return 1;
 	for (int j = 0; j < CCX_DTVCC_SCREENGRID_COLUMNS; j++)
 	{
 		if (CCX_DTVCC_SYM_IS_SET(tv->chars[row_index][j]))
@@ -63,7 +65,7 @@ void dtvcc_change_pen_colors(dtvcc_tv_screen *tv, dtvcc_pen_color pen_color, int
 	if (column_index >= CCX_DTVCC_SCREENGRID_COLUMNS)
 		new_pen_color = dtvcc_default_pen_color;
 	else
-		new_pen_color = tv->pen_colors[row_index][column_index];
+		new_pen_color = tv->pens[tv->pen_index[row_index][column_index]].color;
 	if (pen_color.fg_color != new_pen_color.fg_color)
 	{
 		if (pen_color.fg_color != 0x3f && !open)
@@ -101,7 +103,7 @@ void dtvcc_change_pen_attribs(dtvcc_tv_screen *tv, dtvcc_pen_attribs pen_attribs
 	if (column_index >= CCX_DTVCC_SCREENGRID_COLUMNS)
 		new_pen_attribs = dtvcc_default_pen_attribs;
 	else
-		new_pen_attribs = tv->pen_attribs[row_index][column_index];
+		new_pen_attribs = tv->pens[tv->pen_index[row_index][column_index]].attribs;
 	if (pen_attribs.italic != new_pen_attribs.italic)
 	{
 		remaining = INITIAL_ENC_BUFFER_CAPACITY - *buf_len;
@@ -171,8 +173,8 @@ void dtvcc_write_row(dtvcc_writer_ctx *writer, dtvcc_service_decoder *decoder, i
 		if (use_colors)
 			dtvcc_change_pen_colors(tv, pen_color, row_index, i, encoder, &buf_len, 1);
 
-		pen_color = tv->pen_colors[row_index][i];
-		pen_attribs = tv->pen_attribs[row_index][i];
+		pen_color = tv->pens[tv->pen_index[row_index][i]].color;
+		pen_attribs = tv->pens[tv->pen_index[row_index][i]].attribs;
 		if (i < first)
 		{
 			size_t size = write_utf16_char(' ', buf + buf_len);
@@ -669,6 +671,9 @@ void dtvcc_writer_init(dtvcc_writer_ctx *writer,
 	ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] dtvcc_writer_init\n");
 	writer->fd = -1;
 	writer->cd = (iconv_t)-1;
+	writer->transcoder = NULL;
+	writer->transcoder_resolved = 0;
+	writer->use_utf16 = 0;
 	if ((write_format == CCX_OF_NULL) || (write_format == CCX_OF_MCC))
 	{
 		writer->filename = NULL;
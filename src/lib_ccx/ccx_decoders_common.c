@@ -15,12 +15,13 @@ made to reuse, not duplicate, as many functions as possible */
 #include "ccx_encoders_mcc.h"
 #include "ccx_dtvcc.h"
 
-extern int ccxr_process_cc_data(struct lib_cc_decode *dec_ctx, unsigned char *cc_data, int cc_count);
+extern void ccxr_process_dtvcc_triplets(void *dtvcc_rust, const unsigned char *cc_data, int cc_count);
 extern void ccxr_flush_decoder(struct dtvcc_ctx *dtvcc, struct dtvcc_service_decoder *decoder);
 
-uint64_t utc_refvalue = UINT64_MAX; /* _UI64_MAX/UINT64_MAX means don't use UNIX, 0 = use current system time as reference, +1 use a specific reference */
-extern int in_xds_mode;
+// Number of DTVCC triplets handed to the 708 decoder at once
+#define DTVCC_BATCH_SIZE 64
 
+uint64_t utc_refvalue = UINT64_MAX; /* _UI64_MAX/UINT64_MAX means don't use UNIX, 0 = use current system time as reference, +1 use a specific reference */
 LLONG ccxr_get_visible_start(struct ccx_common_timing_ctx *ctx, int current_field);
 LLONG ccxr_get_visible_end(struct ccx_common_timing_ctx *ctx, int current_field);
 
@@ -28,41 +29,170 @@ LLONG ccxr_get_visible_end(struct ccx_common_timing_ctx *ctx, int current_field)
    obviously but it guarantees there's no timing overlap */
 LLONG get_visible_start(struct ccx_common_timing_ctx *ctx, int current_field)
 {
+	char buf[32];
 	LLONG fts = ccxr_get_visible_start(ctx, current_field);
-	ccx_common_logging.debug_ftn(CCX_DMT_DECODER_608, "Visible Start time=%s\n", print_mstime_static(fts));
+	print_mstime_buff(fts, "%02u:%02u:%02u:%03u", buf);
+	ccx_common_logging.debug_ftn(CCX_DMT_DECODER_608, "Visible Start time=%s\n", buf);
 	return fts;
 }
 
 /* This function returns the current FTS and saves it so it can be used by get_visible_start */
 LLONG get_visible_end(struct ccx_common_timing_ctx *ctx, int current_field)
 {
+	char buf[32];
 	LLONG fts = ccxr_get_visible_end(ctx, current_field);
-	ccx_common_logging.debug_ftn(CCX_DMT_DECODER_608, "Visible End time=%s\n", print_mstime_static(fts));
+	print_mstime_buff(fts, "%02u:%02u:%02u:%03u", buf);
+	ccx_common_logging.debug_ftn(CCX_DMT_DECODER_608, "Visible End time=%s\n", buf);
 	return fts;
 }
 
-int process_cc_data(struct encoder_ctx *enc_ctx, struct lib_cc_decode *dec_ctx, unsigned char *cc_data, int cc_count, struct cc_subtitle *sub)
+/* Whether caption data of a field (3 for DTVCC) at the current time is inside the
+   extraction window. Past its end, the decoder is flagged as done. */
+static int is_in_extraction_window(struct lib_cc_decode *ctx, int field)
 {
+	LLONG fts;
+
+	if (!ctx->extraction_start.set && !ctx->extraction_end.set)
+		return 1;
+
+	fts = get_fts(ctx->timing, field);
+	if (ctx->extraction_end.set && fts > ctx->extraction_end.time_in_ms)
+	{
+		ctx->processed_enough = 1;
+		return 0;
+	}
+	return !ctx->extraction_start.set || fts >= ctx->extraction_start.time_in_ms;
+}
+
+static void process_dtvcc_triplets(struct lib_cc_decode *ctx, unsigned char *data, int count)
+{
+#ifndef DISABLE_RUST
+	ccxr_process_dtvcc_triplets(ctx->dtvcc_rust, data, count);
+#else
+	unsigned char temp[4];
+	for (int i = 0; i < count * 3; i += 3)
+	{
+		temp[0] = (data[i] & 4) >> 2;
+		temp[1] = data[i] & 3;
+		temp[2] = data[i + 1];
+		temp[3] = data[i + 2];
+		dtvcc_process_data(ctx->dtvcc, temp);
+	}
+#endif
+}
+
+/* Processes the cc_data of a whole frame (or PES), presented at fts.
+   Does the work of do_cb() for every triplet, but demultiplexes field 1, field 2 and
+   DTVCC in a single pass: the timing is set once, the extraction window and debug
+   checks are made once per frame unless the field counters move, and the DTVCC
+   triplets reach the 708 decoder in one call instead of one per triplet. */
+int process_cc_data(struct encoder_ctx *enc_ctx, struct lib_cc_decode *dec_ctx, unsigned char *cc_data, int cc_count, LLONG fts, struct cc_subtitle *sub)
+{
+	unsigned char dtvcc_data[DTVCC_BATCH_SIZE * 3];
+	int dtvcc_count = 0;
+	int dtvcc_blocks = 0;
 	int ret = -1;
 
+	dec_ctx->timing->fts_now = fts;
+
 	if (dec_ctx->write_format == CCX_OF_MCC)
 	{
 		mcc_encode_cc_data(enc_ctx, dec_ctx, cc_data, cc_count);
 		return 0;
 	}
 
-	ret = ccxr_process_cc_data(dec_ctx, cc_data, cc_count);
-
-	for (int j = 0; j < cc_count * 3; j = j + 3)
+	// In raw and elementary streams every block moves the time of its field by one,
+	// container formats time the whole frame with its PTS
+	int count_blocks = dec_ctx->in_bufferdatatype != CCX_H264 && dec_ctx->in_bufferdatatype != CCX_PES;
+	int log_raw = dbg_enabled(CCX_DMT_CBRAW);
+	const char *log_time = log_raw ? print_mstime_static(dec_ctx->timing->fts_now + dec_ctx->timing->fts_global) : NULL;
+	int skip_padding = dec_ctx->write_format != CCX_OF_RAW && dec_ctx->write_format != CCX_OF_DVDRAW;
+	// The whole frame goes to the 708 decoder at the time it started at
+	int dtvcc_timeok = is_in_extraction_window(dec_ctx, 3);
+	int field_timeok[2];
+	field_timeok[0] = is_in_extraction_window(dec_ctx, 1);
+	field_timeok[1] = is_in_extraction_window(dec_ctx, 2);
+
+	for (int j = 0; j < cc_count * 3; j += 3)
 	{
-		if (validate_cc_data_pair(cc_data + j))
+		unsigned char *cc_block = cc_data + j;
+		unsigned char cc_type = *cc_block & 3;
+
+		if (validate_cc_data_pair(cc_block))
 			continue;
-		ret = do_cb(dec_ctx, cc_data + j, sub);
-		if (ret == 1) // 1 means success here
-			ret = 0;
+		ret = 0;
+
+		if (skip_padding && (cc_block[0] == 0xFA || cc_block[0] == 0xFC || cc_block[0] == 0xFD) &&
+		    (cc_block[1] & 0x7F) == 0 && (cc_block[2] & 0x7F) == 0)
+			continue;
+
+		if (log_raw)
+			dbg_print(CCX_DMT_CBRAW, "%s   %d   %02X:%c%c:%02X", log_time, dec_ctx->in_xds_mode,
+				  cc_block[0], cc_block[1] & 0x7f, cc_block[2] & 0x7f, cc_block[2]);
+
+		dec_ctx->cc_stats[cc_type]++;
+
+		if (cc_type <= 1)
+		{
+			int field = cc_type + 1;
+			if (log_raw)
+				dbg_print(CCX_DMT_CBRAW, cc_type == 0 ? "    %s   ..   ..\n" : "    ..   %s   ..\n", debug_608_to_ASC(cc_block, cc_type));
+
+			dec_ctx->current_field = field;
+			dec_ctx->saw_caption_block = 1;
+
+			if (field_timeok[cc_type])
+			{
+				if (dec_ctx->write_format != CCX_OF_RCWT)
+				{
+					if (cc_type == 0)
+						printdata(dec_ctx, cc_block + 1, 2, 0, 0, sub);
+					else
+						printdata(dec_ctx, 0, 0, cc_block + 1, 2, sub);
+				}
+				else
+					writercwtdata(dec_ctx, cc_block, sub);
+			}
+			if (count_blocks)
+			{
+				if (cc_type == 0)
+					dec_ctx->timing->cb_field1++;
+				else
+					dec_ctx->timing->cb_field2++;
+				field_timeok[cc_type] = is_in_extraction_window(dec_ctx, field);
+			}
+		}
+		else
+		{
+			if (log_raw)
+				dbg_print(CCX_DMT_CBRAW, "    ..   ..   DD\n");
+
+			dec_ctx->current_field = 3;
+
+			if (dtvcc_timeok && dec_ctx->write_format != CCX_OF_RAW)
+			{
+				memcpy(dtvcc_data + dtvcc_count * 3, cc_block, 3);
+				if (++dtvcc_count == DTVCC_BATCH_SIZE)
+				{
+					process_dtvcc_triplets(dec_ctx, dtvcc_data, dtvcc_count);
+					dtvcc_count = 0;
+				}
+			}
+			if (dtvcc_timeok && dec_ctx->write_format == CCX_OF_RCWT)
+				writercwtdata(dec_ctx, cc_block, sub);
+			dtvcc_blocks++;
+		}
 	}
+
+	if (dtvcc_count)
+		process_dtvcc_triplets(dec_ctx, dtvcc_data, dtvcc_count);
+	// Only now, so that the 708 decoder saw the time the frame started at
+	if (count_blocks)
+		dec_ctx->timing->cb_708 += dtvcc_blocks;
+
 	return ret;
 }
+
 int validate_cc_data_pair(unsigned char *cc_data_pair)
 {
 	unsigned char cc_valid = (*cc_data_pair & 4) >> 2;
@@ -93,8 +223,6 @@ int do_cb(struct lib_cc_decode *ctx, unsigned char *cc_block, struct cc_subtitle
 	unsigned char cc_valid = (*cc_block & 4) >> 2;
 	unsigned char cc_type = *cc_block & 3;
 
-	int timeok = 1;
-
 	if (ctx->fix_padding && cc_valid == 0 && cc_type <= 1 // Only fix NTSC packets
 	    && cc_block[1] == 0 && cc_block[2] == 0)
 	{
@@ -110,8 +238,9 @@ int do_cb(struct lib_cc_decode *ctx, unsigned char *cc_block, struct cc_subtitle
 		return 1;
 
 	// Print raw data with FTS.
-	dbg_print(CCX_DMT_CBRAW, "%s   %d   %02X:%c%c:%02X", print_mstime_static(ctx->timing->fts_now + ctx->timing->fts_global), in_xds_mode,
-		  cc_block[0], cc_block[1] & 0x7f, cc_block[2] & 0x7f, cc_block[2]);
+	if (dbg_enabled(CCX_DMT_CBRAW))
+		dbg_print(CCX_DMT_CBRAW, "%s   %d   %02X:%c%c:%02X", print_mstime_static(ctx->timing->fts_now + ctx->timing->fts_global), ctx->in_xds_mode,
+			  cc_block[0], cc_block[1] & 0x7f, cc_block[2] & 0x7f, cc_block[2]);
 
 	/* In theory the writercwtdata() function could return early and not
 	 * go through the 608/708 cases below.  We do that to get accurate
@@ -131,16 +260,7 @@ int do_cb(struct lib_cc_decode *ctx, unsigned char *cc_block, struct cc_subtitle
 				ctx->current_field = 1;
 				ctx->saw_caption_block = 1;
 
-				if (ctx->extraction_start.set &&
-				    get_fts(ctx->timing, ctx->current_field) < ctx->extraction_start.time_in_ms)
-					timeok = 0;
-				if (ctx->extraction_end.set &&
-				    get_fts(ctx->timing, ctx->current_field) > ctx->extraction_end.time_in_ms)
-				{
-					timeok = 0;
-					ctx->processed_enough = 1;
-				}
-				if (timeok)
+				if (is_in_extraction_window(ctx, ctx->current_field))
 				{
 					if (ctx->write_format != CCX_OF_RCWT)
 						printdata(ctx, cc_block + 1, 2, 0, 0, sub);
@@ -151,7 +271,7 @@ int do_cb(struct lib_cc_decode *ctx, unsigned char *cc_block, struct cc_subtitle
 				// because the frame PTS already represents the correct timestamp.
 				// The cb_field offset is only meaningful for raw/elementary streams.
 				if (ctx->in_bufferdatatype != CCX_H264 && ctx->in_bufferdatatype != CCX_PES)
-					cb_field1++;
+					ctx->timing->cb_field1++;
 				break;
 			case 1:
 				dbg_print(CCX_DMT_CBRAW, "    ..   %s   ..\n", debug_608_to_ASC(cc_block, 1));
@@ -159,16 +279,7 @@ int do_cb(struct lib_cc_decode *ctx, unsigned char *cc_block, struct cc_subtitle
 				ctx->current_field = 2;
 				ctx->saw_caption_block = 1;
 
-				if (ctx->extraction_start.set &&
-				    get_fts(ctx->timing, ctx->current_field) < ctx->extraction_start.time_in_ms)
-					timeok = 0;
-				if (ctx->extraction_end.set &&
-				    get_fts(ctx->timing, ctx->current_field) > ctx->extraction_end.time_in_ms)
-				{
-					timeok = 0;
-					ctx->processed_enough = 1;
-				}
-				if (timeok)
+				if (is_in_extraction_window(ctx, ctx->current_field))
 				{
 					if (ctx->write_format != CCX_OF_RCWT)
 						printdata(ctx, 0, 0, cc_block + 1, 2, sub);
@@ -177,7 +288,7 @@ int do_cb(struct lib_cc_decode *ctx, unsigned char *cc_block, struct cc_subtitle
 				}
 				// For container formats, don't increment cb_field (see comment above)
 				if (ctx->in_bufferdatatype != CCX_H264 && ctx->in_bufferdatatype != CCX_PES)
-					cb_field2++;
+					ctx->timing->cb_field2++;
 				break;
 			case 2: // EIA-708
 				//  DTVCC packet data
@@ -188,23 +299,14 @@ int do_cb(struct lib_cc_decode *ctx, unsigned char *cc_block, struct cc_subtitle
 				// DTVCC packet start
 				ctx->current_field = 3;
 
-				if (ctx->extraction_start.set &&
-				    get_fts(ctx->timing, ctx->current_field) < ctx->extraction_start.time_in_ms)
-					timeok = 0;
-				if (ctx->extraction_end.set &&
-				    get_fts(ctx->timing, ctx->current_field) > ctx->extraction_end.time_in_ms)
-				{
-					timeok = 0;
-					ctx->processed_enough = 1;
-				}
-				if (timeok)
+				if (is_in_extraction_window(ctx, ctx->current_field))
 				{
 					if (ctx->write_format == CCX_OF_RCWT)
 						writercwtdata(ctx, cc_block, sub);
 				}
 				// For container formats, don't increment cb_708 (see comment above)
 				if (ctx->in_bufferdatatype != CCX_H264 && ctx->in_bufferdatatype != CCX_PES)
-					cb_708++;
+					ctx->timing->cb_708++;
 				// Check for bytes read
 				// printf ("Warning: Losing EIA-708 data!\n");
 				break;
@@ -279,6 +381,7 @@ struct lib_cc_decode *init_cc_decode(struct ccx_decoders_common_settings_t *sett
 	ctx->context_cc608_field_1 = NULL;
 	ctx->context_cc608_field_2 = NULL;
 	ctx->xds_ctx = NULL;
+	ctx->in_xds_mode = 0;
 	ctx->vbi_decoder = NULL;
 	ctx->prev = NULL;
 	memset(&ctx->dec_sub, 0, sizeof(ctx->dec_sub));
@@ -351,6 +454,7 @@ struct lib_cc_decode *init_cc_decode(struct ccx_decoders_common_settings_t *sett
 	ctx->frames_since_last_gop = 0;
 	ctx->total_pulldownfields = 0;
 	ctx->total_pulldownframes = 0;
+	ctx->last_data_pts = 0x01FFFFFFFFLL;
 	ctx->stat_numuserheaders = 0;
 	ctx->stat_dvdccheaders = 0;
 	ctx->stat_scte20ccheaders = 0;
@@ -530,6 +634,10 @@ struct encoder_ctx *copy_encoder_context(struct encoder_ctx *ctx)
 	ctx_copy->end_credits_text = NULL;
 	ctx_copy->prev = NULL;
 	ctx_copy->last_string = NULL;
+	// DVB subtitles are only encoded through this copy, so it feeds the --also-out outputs
+	// too. They stay the original's: free_encoder_context() leaves them alone
+	ctx_copy->sinks = ctx->sinks;
+	ctx_copy->nb_sinks = ctx->nb_sinks;
 
 	if (ctx->buffer)
 	{
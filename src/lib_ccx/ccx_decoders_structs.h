@@ -161,6 +161,7 @@ struct lib_cc_decode
 	int last_gop_length; // Length of the previous group of pictures
 	unsigned total_pulldownfields;
 	unsigned total_pulldownframes;
+	LLONG last_data_pts; // PTS process_data() last set the FTS from
 	int program_number;
 	struct list_head list;
 	struct ccx_common_timing_ctx *timing;
@@ -222,6 +223,7 @@ struct lib_cc_decode
 	// The sequence number of the current anchor frame.  All currently read
 	// B-Frames belong to this I- or P-frame.
 	int anchor_seq_number;
+	int in_xds_mode; // 1 while field 2 carries XDS instead of captions
 	struct ccx_decoders_xds_context *xds_ctx;
 	struct ccx_decoder_vbi_ctx *vbi_decoder;
 
@@ -4,8 +4,6 @@
 #include "ccx_common_common.h"
 #include "utility.h"
 
-LLONG ts_start_of_xds = -1; // Time at which we switched to XDS mode, =-1 hasn't happened yet
-
 static const char *XDSclasses[] =
     {
 	"Current",
@@ -116,6 +114,7 @@ struct ccx_decoders_xds_context *ccx_decoders_xds_init_library(struct ccx_common
 	ctx->cur_xds_payload = NULL;
 	ctx->cur_xds_payload_length = 0;
 	ctx->cur_xds_packet_type = 0;
+	ctx->ts_start_of_xds = -1;
 	ctx->timing = timing;
 
 	ctx->xds_write_to_file = xds_write_to_file;
@@ -140,7 +139,7 @@ int write_xds_string(struct cc_subtitle *sub, struct ccx_decoders_xds_context *c
 		sub->datatype = CC_DATATYPE_GENERIC;
 		data = (struct eia608_screen *)sub->data + sub->nb_data;
 		data->format = SFORMAT_XDS;
-		data->start_time = ts_start_of_xds;
+		data->start_time = ctx->ts_start_of_xds;
 		data->end_time = get_fts(ctx->timing, 2);
 		data->xds_str = p;
 		data->xds_len = len;
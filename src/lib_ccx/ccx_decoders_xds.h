@@ -46,6 +46,7 @@ typedef struct ccx_decoders_xds_context
 	unsigned char *cur_xds_payload;
 	int cur_xds_payload_length;
 	int cur_xds_packet_type;
+	LLONG ts_start_of_xds; // Time at which we switched to XDS mode, =-1 hasn't happened yet
 	struct ccx_common_timing_ctx *timing;
 
 	unsigned current_ar_start;
@@ -320,6 +320,7 @@ void ccx_demuxer_delete(struct ccx_demuxer **ctx)
 	}
 
 	freep(&lctx->filebuffer);
+	freep(&lctx->haup_capbuf);
 	freep(ctx);
 }
 
@@ -400,7 +401,6 @@ struct ccx_demuxer *init_demuxer(void *parent, struct demuxer_cfg *cfg)
 	for (i = 0; i < MAX_PSI_PID; i++)
 		ctx->PID_buffers[i] = NULL;
 
-	init_ts(ctx);
 	ctx->filebuffer = NULL;
 
 	return ctx;
@@ -130,8 +130,14 @@ struct ccx_demuxer
 	struct PMT_entry *PIDs_programs[MAX_PID];
 	struct ccx_demux_report freport;
 
+	unsigned char tspacket[188];  // Current TS packet
+	uint64_t last_pes_header_pts; // PTS of last PES header dumped (debug purposes)
+
 	/* Hauppauge support */
 	unsigned hauppauge_warning_shown; // Did we detect a possible Hauppauge capture and told the user already?
+	unsigned char *haup_capbuf;
+	long haup_capbufsize;
+	long haup_capbuflen; // Bytes read in haup_capbuf
 
 	int multi_stream_per_prog;
 
@@ -142,12 +148,18 @@ struct ccx_demuxer
 	LLONG filebuffer_start;	     // Position of buffer start relative to file
 	unsigned int filebuffer_pos; // Position of pointer relative to buffer start
 	unsigned int bytesinbuffer;  // Number of bytes we actually have on buffer
+	int push_input;		     // 1 if a library user appends the input to filebuffer (ccx_session.h)
 
 	int warning_program_not_found_shown;
+	int warning_no_pat_shown;
+	int warning_incomplete_pmt_shown;
 
 	// Remember if the last header was valid. Used to suppress too much output
 	// and the expected unrecognized first header for TiVo files.
 	int strangeheader;
+
+	int gui_mode_reports;		// Report network reads to the GUI
+	unsigned long net_activity_gui; // Network reads so far, for the GUI reports
 #ifdef ENABLE_FFMPEG
 	void *ffmpeg_ctx;
 #endif
@@ -105,7 +105,8 @@ dtvcc_ctx *dtvcc_init(struct ccx_decoder_dtvcc_settings *opts)
 	ctx->report_enabled = opts->print_file_reports;
 	ctx->timing = opts->timing;
 
-	ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] initializing services\n");
+	ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] initializing services (%zu bytes of decoder state per service)\n",
+				     sizeof(dtvcc_service_decoder) + sizeof(dtvcc_tv_screen));
 
 	for (int i = 0; i < CCX_DTVCC_MAX_SERVICES; i++)
 	{
@@ -119,6 +120,7 @@ dtvcc_ctx *dtvcc_init(struct ccx_decoder_dtvcc_settings *opts)
 			ccx_common_logging.fatal_ftn(EXIT_NOT_ENOUGH_MEMORY, "dtvcc_init");
 		decoder->tv->service_number = i + 1;
 		decoder->tv->cc_count = 0;
+		decoder->tv->dirty_tracking = 0;
 
 		for (int j = 0; j < CCX_DTVCC_MAX_WINDOWS; j++)
 			decoder->windows[j].memory_reserved = 0;
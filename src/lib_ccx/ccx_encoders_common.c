@@ -8,6 +8,9 @@
 #include "ccx_encoders_xds.h"
 #include "ccx_encoders_helpers.h"
 #include "ccextractor.h"
+#ifndef _WIN32
+#include <pthread.h>
+#endif
 
 #ifdef WIN32
 int fsync(int fd)
@@ -122,6 +125,55 @@ int get_str_basic(unsigned char *out_buffer, unsigned char *in_buffer, int trim_
 	return ccxr_get_str_basic(out_buffer, in_buffer, trim_subs, in_enc, out_enc, max_len);
 }
 
+ssize_t write_output(struct ccx_s_write *out, const void *buf, size_t count)
+{
+	if (out->callback)
+	{
+		out->callback(out->callback_opaque, buf, count);
+		return count;
+	}
+	return write(out->fh, buf, count);
+}
+
+void write_output_wrapped(struct ccx_s_write *out, const void *buf, size_t count)
+{
+	if (out->callback)
+	{
+		out->callback(out->callback_opaque, buf, count);
+		return;
+	}
+	write_wrapped(out->fh, buf, count);
+}
+
+int output_printf(struct ccx_s_write *out, const char *fmt, ...)
+{
+	char line[1024];
+	char *text = line;
+	va_list args;
+
+	va_start(args, fmt);
+	int length = vsnprintf(line, sizeof(line), fmt, args);
+	va_end(args);
+	if (length < 0)
+		return -1;
+
+	// Rare long lines are formatted again into a buffer of their own
+	if (length >= sizeof(line))
+	{
+		text = malloc(length + 1);
+		if (!text)
+			return -1;
+		va_start(args, fmt);
+		vsnprintf(text, length + 1, fmt, args);
+		va_end(args);
+	}
+
+	int ret = write_output(out, text, length);
+	if (text != line)
+		free(text);
+	return ret;
+}
+
 int write_subtitle_file_footer(struct encoder_ctx *ctx, struct ccx_s_write *out)
 {
 	int used;
@@ -137,7 +189,7 @@ int write_subtitle_file_footer(struct encoder_ctx *ctx, struct ccx_s_write *out)
 				dbg_print(CCX_DMT_DECODER_608, "\r%s\n", str);
 			}
 			used = encode_line(ctx, ctx->buffer, (unsigned char *)str);
-			ret = write(out->fh, ctx->buffer, used);
+			ret = write_output(out, ctx->buffer, used);
 			if (ret != used)
 			{
 				mprint("WARNING: loss of data\n");
@@ -150,7 +202,7 @@ int write_subtitle_file_footer(struct encoder_ctx *ctx, struct ccx_s_write *out)
 				dbg_print(CCX_DMT_DECODER_608, "\r%s\n", str);
 			}
 			used = encode_line(ctx, ctx->buffer, (unsigned char *)str);
-			ret = write(out->fh, ctx->buffer, used);
+			ret = write_output(out, ctx->buffer, used);
 			if (ret != used)
 			{
 				mprint("WARNING: loss of data\n");
@@ -166,7 +218,7 @@ int write_subtitle_file_footer(struct encoder_ctx *ctx, struct ccx_s_write *out)
 				dbg_print(CCX_DMT_DECODER_608, "\r%s\n", str);
 			}
 			used = encode_line(ctx, ctx->buffer, (unsigned char *)str);
-			ret = write(out->fh, ctx->buffer, used);
+			ret = write_output(out, ctx->buffer, used);
 			if (ret != used)
 			{
 				mprint("WARNING: loss of data\n");
@@ -174,7 +226,7 @@ int write_subtitle_file_footer(struct encoder_ctx *ctx, struct ccx_s_write *out)
 			break;
 		case CCX_OF_SCC:
 		case CCX_OF_CCD:
-			ret = write(out->fh, ctx->encoded_crlf, ctx->encoded_crlf_length);
+			ret = write_output(out, ctx->encoded_crlf, ctx->encoded_crlf_length);
 			break;
 		default: // Nothing to do, no footer on this format
 			break;
@@ -190,7 +242,7 @@ static int write_bom(struct encoder_ctx *ctx, struct ccx_s_write *out)
 	{
 		if (ctx->encoding == CCX_ENC_UTF_8)
 		{ // Write BOM
-			ret = write(out->fh, UTF8_BOM, sizeof(UTF8_BOM));
+			ret = write_output(out, UTF8_BOM, sizeof(UTF8_BOM));
 			if (ret < sizeof(UTF8_BOM))
 			{
 				mprint("WARNING: Unable to write UTF BOM\n");
@@ -199,7 +251,7 @@ static int write_bom(struct encoder_ctx *ctx, struct ccx_s_write *out)
 		}
 		if (ctx->encoding == CCX_ENC_UNICODE)
 		{ // Write BOM
-			ret = write(out->fh, LITTLE_ENDIAN_BOM, sizeof(LITTLE_ENDIAN_BOM));
+			ret = write_output(out, LITTLE_ENDIAN_BOM, sizeof(LITTLE_ENDIAN_BOM));
 			if (ret < sizeof(LITTLE_ENDIAN_BOM))
 			{
 				mprint("WARNING: Unable to write LITTLE_ENDIAN_BOM \n");
@@ -218,14 +270,14 @@ static int write_subtitle_file_header(struct encoder_ctx *ctx, struct ccx_s_writ
 	switch (ctx->write_format)
 	{
 		case CCX_OF_CCD:
-			if (write(out->fh, CCD_HEADER, sizeof(CCD_HEADER) - 1) == -1 || write(out->fh, ctx->encoded_crlf, ctx->encoded_crlf_length) == -1)
+			if (write_output(out, CCD_HEADER, sizeof(CCD_HEADER) - 1) == -1 || write_output(out, ctx->encoded_crlf, ctx->encoded_crlf_length) == -1)
 			{
 				mprint("Unable to write CCD header to file\n");
 				return -1;
 			}
 			break;
 		case CCX_OF_SCC:
-			if (write(out->fh, SCC_HEADER, sizeof(SCC_HEADER) - 1) == -1)
+			if (write_output(out, SCC_HEADER, sizeof(SCC_HEADER) - 1) == -1)
 			{
 				mprint("Unable to write SCC header to file\n");
 				return -1;
@@ -241,7 +293,7 @@ static int write_subtitle_file_header(struct encoder_ctx *ctx, struct ccx_s_writ
 				return -1;
 			REQUEST_BUFFER_CAPACITY(ctx, strlen(ssa_header) * 3);
 			used = encode_line(ctx, ctx->buffer, (unsigned char *)ssa_header);
-			if (write(out->fh, ctx->buffer, used) < used)
+			if (write_output(out, ctx->buffer, used) < used)
 			{
 				mprint("WARNING: Unable to write complete Buffer \n");
 				return -1;
@@ -265,7 +317,7 @@ static int write_subtitle_file_header(struct encoder_ctx *ctx, struct ccx_s_writ
 				{
 					used = encode_line(ctx, ctx->buffer, (unsigned char *)webvtt_header[i]);
 				}
-				if (write(out->fh, ctx->buffer, used) < used)
+				if (write_output(out, ctx->buffer, used) < used)
 				{
 					mprint("WARNING: Unable to write complete Buffer \n");
 					return -1;
@@ -278,7 +330,7 @@ static int write_subtitle_file_header(struct encoder_ctx *ctx, struct ccx_s_writ
 				return -1;
 			REQUEST_BUFFER_CAPACITY(ctx, strlen(sami_header) * 3);
 			used = encode_line(ctx, ctx->buffer, (unsigned char *)sami_header);
-			if (write(out->fh, ctx->buffer, used) < used)
+			if (write_output(out, ctx->buffer, used) < used)
 			{
 				mprint("WARNING: Unable to write complete Buffer \n");
 				return -1;
@@ -290,7 +342,7 @@ static int write_subtitle_file_header(struct encoder_ctx *ctx, struct ccx_s_writ
 				return -1;
 			REQUEST_BUFFER_CAPACITY(ctx, strlen(smptett_header) * 3);
 			used = encode_line(ctx, ctx->buffer, (unsigned char *)smptett_header);
-			if (write(out->fh, ctx->buffer, used) < used)
+			if (write_output(out, ctx->buffer, used) < used)
 			{
 				mprint("WARNING: Unable to write complete Buffer \n");
 				return -1;
@@ -303,7 +355,7 @@ static int write_subtitle_file_header(struct encoder_ctx *ctx, struct ccx_s_writ
 				net_send_header(rcwt_header, sizeof(rcwt_header));
 			else
 			{
-				if (write(out->fh, rcwt_header, sizeof(rcwt_header)) < 0)
+				if (write_output(out, rcwt_header, sizeof(rcwt_header)) < 0)
 				{
 					mprint("Unable to write rcwt header\n");
 					return -1;
@@ -312,7 +364,7 @@ static int write_subtitle_file_header(struct encoder_ctx *ctx, struct ccx_s_writ
 
 			break;
 		case CCX_OF_RAW:
-			if (write(out->fh, BROADCAST_HEADER, sizeof(BROADCAST_HEADER)) < sizeof(BROADCAST_HEADER))
+			if (write_output(out, BROADCAST_HEADER, sizeof(BROADCAST_HEADER)) < sizeof(BROADCAST_HEADER))
 			{
 				mprint("Unable to write Raw header\n");
 				return -1;
@@ -332,7 +384,7 @@ static int write_subtitle_file_header(struct encoder_ctx *ctx, struct ccx_s_writ
 				return -1;
 			REQUEST_BUFFER_CAPACITY(ctx, strlen(simple_xml_header) * 3);
 			used = encode_line(ctx, ctx->buffer, (unsigned char *)simple_xml_header);
-			if (write(out->fh, ctx->buffer, used) < used)
+			if (write_output(out, ctx->buffer, used) < used)
 			{
 				mprint("WARNING: Unable to write complete Buffer \n");
 				return -1;
@@ -369,7 +421,7 @@ int write_cc_subtitle_as_simplexml(struct cc_subtitle *sub, struct encoder_ctx *
 			{
 				continue;
 			}
-			ret = write(context->out->fh, context->encoded_crlf, context->encoded_crlf_length);
+			ret = write_output(context->out, context->encoded_crlf, context->encoded_crlf_length);
 			if (ret < context->encoded_crlf_length)
 			{
 				mprint("Warning:Loss of data\n");
@@ -401,14 +453,14 @@ void write_cc_line_as_simplexml(struct eia608_screen *data, struct encoder_ctx *
 	length = get_str_basic(context->subline, data->characters[line_number],
 			       context->trim_subs, CCX_ENC_ASCII, context->encoding, CCX_DECODER_608_SCREEN_WIDTH);
 
-	ret = write(context->out->fh, cap, strlen(cap));
-	ret = write(context->out->fh, context->subline, length);
+	ret = write_output(context->out, cap, strlen(cap));
+	ret = write_output(context->out, context->subline, length);
 	if (ret < length)
 	{
 		mprint("Warning:Loss of data\n");
 	}
-	ret = write(context->out->fh, cap1, strlen(cap1));
-	ret = write(context->out->fh, context->encoded_crlf, context->encoded_crlf_length);
+	ret = write_output(context->out, cap1, strlen(cap1));
+	ret = write_output(context->out, context->encoded_crlf, context->encoded_crlf_length);
 }
 
 int write_cc_buffer_as_simplexml(struct eia608_screen *data, struct encoder_ctx *context)
@@ -446,7 +498,7 @@ int write_cc_bitmap_as_simplexml(struct cc_subtitle *sub, struct encoder_ctx *co
 static void try_to_add_end_credits(struct encoder_ctx *context, struct ccx_s_write *out, LLONG current_fts)
 {
 	LLONG window, length, st, end;
-	if (out->fh == -1)
+	if (out->fh == -1 && !out->callback)
 		return;
 	window = current_fts - context->last_displayed_subs_ms - 1;
 	if (window < context->endcreditsforatleast.time_in_ms) // Won't happen, window is too short
@@ -570,7 +622,7 @@ static int init_output_ctx(struct encoder_ctx *ctx, struct encoder_cfg *cfg)
 		return ret;                                                                                                               \
 	}
 
-	if (cfg->cc_to_stdout == CCX_FALSE && cfg->send_to_srv == CCX_FALSE && cfg->extract == 12 && cfg->write_format != CCX_OF_MCC)
+	if (cfg->cc_to_stdout == CCX_FALSE && cfg->send_to_srv == CCX_FALSE && !cfg->output_callback && cfg->extract == 12 && cfg->write_format != CCX_OF_MCC)
 		nb_lang = 2;
 	else
 		nb_lang = 1;
@@ -585,7 +637,14 @@ static int init_output_ctx(struct encoder_ctx *ctx, struct encoder_cfg *cfg)
 	ctx->ucla = cfg->ucla;
 	ctx->force_dropframe = cfg->force_dropframe;
 
-	if (ctx->generates_file && cfg->cc_to_stdout == CCX_FALSE && cfg->send_to_srv == CCX_FALSE && cfg->extract_only_708 == CCX_FALSE)
+	if (cfg->output_callback)
+	{
+		// A library user takes the output, no file is opened
+		ctx->out[0].fh = -1;
+		ctx->out[0].callback = cfg->output_callback;
+		ctx->out[0].callback_opaque = cfg->callback_opaque;
+	}
+	else if (ctx->generates_file && cfg->cc_to_stdout == CCX_FALSE && cfg->send_to_srv == CCX_FALSE && cfg->extract_only_708 == CCX_FALSE)
 	{
 		if (cfg->output_filename != NULL)
 		{
@@ -703,6 +762,312 @@ static int init_output_ctx(struct encoder_ctx *ctx, struct encoder_cfg *cfg)
 	return EXIT_OK;
 }
 
+// Subtitles a threaded output can fall behind by before the decoder waits for it
+#define SINK_QUEUE_LIMIT 64
+
+struct encoder_sink_job
+{
+	struct cc_subtitle *sub;
+	struct ccx_common_timing_ctx timing; // As it was when the subtitle was encoded
+	int has_timing;
+	struct encoder_sink_job *next;
+};
+
+// An additional output (--also-out): an encoder of its own, fed a copy of every
+// subtitle its parent encoder gets
+struct encoder_sink
+{
+	struct encoder_ctx *ctx;
+	struct encoder_cfg cfg; // init_encoder() keeps pointers into it
+#ifndef _WIN32
+	int threaded;
+	pthread_t thread;
+	pthread_mutex_t lock;
+	pthread_cond_t job_ready;
+	pthread_cond_t queue_room;
+	struct encoder_sink_job *head, *tail;
+	int queued;
+	int closing;
+#endif
+};
+
+static void *copy_or_die(const void *data, size_t length)
+{
+	void *copy = malloc(length);
+	if (!copy)
+		fatal(EXIT_NOT_ENOUGH_MEMORY, "In copy_sink_subtitle: Out of memory copying subtitle data.");
+	memcpy(copy, data, length);
+	return copy;
+}
+
+// Deep copy of a subtitle, which the sink's encoder consumes like its parent does the original
+static struct cc_subtitle *copy_sink_subtitle(const struct cc_subtitle *sub)
+{
+	struct cc_subtitle *copy = copy_or_die(sub, sizeof(struct cc_subtitle));
+	copy->prev = NULL;
+	copy->next = NULL;
+	if (!sub->data)
+		return copy;
+
+	switch (sub->type)
+	{
+		case CC_608:
+		{
+			struct eia608_screen *data = copy_or_die(sub->data, sub->nb_data * sizeof(struct eia608_screen));
+			for (unsigned i = 0; i < sub->nb_data; i++)
+			{
+				if (data[i].format == SFORMAT_XDS && data[i].xds_str)
+				{
+					data[i].xds_str = copy_or_die(data[i].xds_str, data[i].xds_len + 1);
+					data[i].xds_str[data[i].xds_len] = '\0';
+				}
+			}
+			copy->data = data;
+			break;
+		}
+		case CC_BITMAP:
+		{
+			struct cc_bitmap *rect = copy_or_die(sub->data, sub->nb_data * sizeof(struct cc_bitmap));
+			for (unsigned i = 0; i < sub->nb_data; i++)
+			{
+				if (rect[i].data0)
+					rect[i].data0 = copy_or_die(rect[i].data0, rect[i].linesize0 * rect[i].h);
+				if (rect[i].data1)
+					rect[i].data1 = copy_or_die(rect[i].data1, 1024); // Palette of 256 colors
+#ifdef ENABLE_OCR
+				if (rect[i].ocr_text)
+					rect[i].ocr_text = strdup(rect[i].ocr_text);
+#endif
+			}
+			copy->data = rect;
+			break;
+		}
+		case CC_TEXT:
+		{
+			// The text writers free the rest of the chain, the head stays with the caller
+			struct cc_subtitle *last = copy;
+			copy->data = strdup(sub->data);
+			for (const struct cc_subtitle *node = sub->next; node; node = node->next)
+			{
+				struct cc_subtitle *node_copy = copy_or_die(node, sizeof(struct cc_subtitle));
+				node_copy->data = node->data ? strdup(node->data) : NULL;
+				node_copy->prev = last;
+				node_copy->next = NULL;
+				last->next = node_copy;
+				last = node_copy;
+			}
+			break;
+		}
+		default:
+			copy->data = copy_or_die(sub->data, sub->nb_data);
+			break;
+	}
+	return copy;
+}
+
+// Frees what encode_sub() left of a copy made by copy_sink_subtitle()
+static void free_sink_subtitle(struct cc_subtitle *sub)
+{
+	if (sub->data)
+	{
+		if (sub->type == CC_608)
+		{
+			struct eia608_screen *data = sub->data;
+			for (unsigned i = 0; i < sub->nb_data; i++)
+				if (data[i].format == SFORMAT_XDS)
+					freep(&data[i].xds_str);
+		}
+		else if (sub->type == CC_BITMAP)
+		{
+			struct cc_bitmap *rect = sub->data;
+			for (unsigned i = 0; i < sub->nb_data; i++)
+			{
+				freep(&rect[i].data0);
+				freep(&rect[i].data1);
+#ifdef ENABLE_OCR
+				freep(&rect[i].ocr_text);
+#endif
+			}
+		}
+		freep(&sub->data);
+	}
+	free(sub);
+}
+
+// Whether an output of this format can take the subtitle. Raw data only makes sense
+// for the main output, and some formats can't represent bitmaps or text.
+static int sink_accepts(enum ccx_output_format format, const struct cc_subtitle *sub)
+{
+	switch (sub->type)
+	{
+		case CC_608:
+			return 1;
+		case CC_BITMAP:
+			return format != CCX_OF_CCD && format != CCX_OF_SCC && format != CCX_OF_G608;
+		case CC_TEXT:
+			return format != CCX_OF_CCD && format != CCX_OF_SCC && format != CCX_OF_G608;
+		default:
+			return 0;
+	}
+}
+
+#ifndef _WIN32
+static void *encoder_sink_worker(void *arg)
+{
+	struct encoder_sink *sink = (struct encoder_sink *)arg;
+	for (;;)
+	{
+		pthread_mutex_lock(&sink->lock);
+		while (!sink->head && !sink->closing)
+			pthread_cond_wait(&sink->job_ready, &sink->lock);
+		struct encoder_sink_job *job = sink->head;
+		if (job)
+		{
+			sink->head = job->next;
+			if (!sink->head)
+				sink->tail = NULL;
+			sink->queued--;
+			pthread_cond_signal(&sink->queue_room);
+		}
+		pthread_mutex_unlock(&sink->lock);
+
+		if (!job) // Closing and nothing left
+			return NULL;
+		sink->ctx->timing = job->has_timing ? &job->timing : NULL;
+		encode_sub(sink->ctx, job->sub);
+		sink->ctx->timing = NULL;
+		free_sink_subtitle(job->sub);
+		free(job);
+	}
+}
+#endif
+
+static void send_to_sinks(struct encoder_ctx *ctx, struct cc_subtitle *sub)
+{
+	for (int i = 0; i < ctx->nb_sinks; i++)
+	{
+		struct encoder_sink *sink = &ctx->sinks[i];
+		if (!sink_accepts(sink->ctx->write_format, sub))
+			continue;
+
+		struct cc_subtitle *copy = copy_sink_subtitle(sub);
+#ifndef _WIN32
+		if (sink->threaded)
+		{
+			struct encoder_sink_job *job = malloc(sizeof(struct encoder_sink_job));
+			if (!job)
+				fatal(EXIT_NOT_ENOUGH_MEMORY, "In send_to_sinks: Out of memory allocating job.");
+			job->sub = copy;
+			job->has_timing = ctx->timing != NULL;
+			if (job->has_timing)
+				job->timing = *ctx->timing;
+			job->next = NULL;
+
+			pthread_mutex_lock(&sink->lock);
+			while (sink->queued >= SINK_QUEUE_LIMIT)
+				pthread_cond_wait(&sink->queue_room, &sink->lock);
+			if (sink->tail)
+				sink->tail->next = job;
+			else
+				sink->head = job;
+			sink->tail = job;
+			sink->queued++;
+			pthread_cond_signal(&sink->job_ready);
+			pthread_mutex_unlock(&sink->lock);
+			continue;
+		}
+#endif
+		sink->ctx->timing = ctx->timing;
+		encode_sub(sink->ctx, copy);
+		free_sink_subtitle(copy);
+	}
+}
+
+// Creates an encoder for each of the --also-out formats, writing next to the main output
+static void init_encoder_sinks(struct encoder_ctx *ctx, struct encoder_cfg *opt)
+{
+	ctx->sinks = NULL;
+	ctx->nb_sinks = 0;
+	if (!opt->nb_extra_write_formats || opt->extract_only_708)
+		return;
+	if (opt->cc_to_stdout || opt->send_to_srv || opt->output_callback)
+	{
+		mprint("Only the --out format can be written to stdout, a server or a callback, ignoring --also-out.\n");
+		return;
+	}
+
+	ctx->sinks = calloc(opt->nb_extra_write_formats, sizeof(struct encoder_sink));
+	if (!ctx->sinks)
+		fatal(EXIT_NOT_ENOUGH_MEMORY, "In init_encoder_sinks: Out of memory allocating sinks.");
+
+	for (int i = 0; i < opt->nb_extra_write_formats; i++)
+	{
+		struct encoder_sink *sink = &ctx->sinks[ctx->nb_sinks];
+		sink->cfg = *opt;
+		sink->cfg.write_format = opt->extra_write_formats[i];
+		sink->cfg.nb_extra_write_formats = 0;
+		sink->cfg.dtvcc_extract = 0; // 708 services go to their own files from the main output
+		sink->cfg.subtitle_callback = NULL; // The main output already reported the subtitle
+		if (opt->output_filename)
+		{
+			char *basefilename = get_basename(opt->output_filename);
+			sink->cfg.output_filename = create_outfilename(basefilename, NULL, get_file_extension(sink->cfg.write_format));
+			free(basefilename);
+		}
+
+		sink->ctx = init_encoder(&sink->cfg);
+		freep(&sink->cfg.output_filename);
+		if (!sink->ctx)
+		{
+			mprint("Could not create the additional %s output, skipping it.\n", get_file_extension(sink->cfg.write_format));
+			continue;
+		}
+
+#ifndef _WIN32
+		if (opt->threaded_outputs)
+		{
+			pthread_mutex_init(&sink->lock, NULL);
+			pthread_cond_init(&sink->job_ready, NULL);
+			pthread_cond_init(&sink->queue_room, NULL);
+			sink->threaded = pthread_create(&sink->thread, NULL, encoder_sink_worker, sink) == 0;
+			if (!sink->threaded) // Encode in the decoding thread instead
+			{
+				pthread_mutex_destroy(&sink->lock);
+				pthread_cond_destroy(&sink->job_ready);
+				pthread_cond_destroy(&sink->queue_room);
+			}
+		}
+#endif
+		ctx->nb_sinks++;
+	}
+}
+
+// Waits for threaded outputs to catch up, then closes every additional output
+static void dinit_encoder_sinks(struct encoder_ctx *ctx, LLONG current_fts)
+{
+	for (int i = 0; i < ctx->nb_sinks; i++)
+	{
+		struct encoder_sink *sink = &ctx->sinks[i];
+#ifndef _WIN32
+		if (sink->threaded)
+		{
+			pthread_mutex_lock(&sink->lock);
+			sink->closing = 1;
+			pthread_cond_broadcast(&sink->job_ready);
+			pthread_mutex_unlock(&sink->lock);
+			pthread_join(sink->thread, NULL);
+			pthread_mutex_destroy(&sink->lock);
+			pthread_cond_destroy(&sink->job_ready);
+			pthread_cond_destroy(&sink->queue_room);
+		}
+#endif
+		sink->ctx->timing = ctx->timing;
+		dinit_encoder(&sink->ctx, current_fts);
+	}
+	freep(&ctx->sinks);
+	ctx->nb_sinks = 0;
+}
+
 /**
  * @param current_fts used while calculating window for end credits
  */
@@ -712,6 +1077,7 @@ void dinit_encoder(struct encoder_ctx **arg, LLONG current_fts)
 	int i;
 	if (!ctx)
 		return;
+	dinit_encoder_sinks(ctx, current_fts);
 	for (i = 0; i < ctx->nb_out; i++)
 	{
 		if (ctx->end_credits_text != NULL)
@@ -752,6 +1118,7 @@ struct encoder_ctx *init_encoder(struct encoder_cfg *opt)
 	}
 
 	ctx->capacity = INITIAL_ENC_BUFFER_CAPACITY;
+	ctx->timing = NULL;
 	ctx->srt_counter = 0;
 	ctx->cea_708_counter = 0;
 	ctx->wrote_webvtt_header = 0;
@@ -851,7 +1218,11 @@ struct encoder_ctx *init_encoder(struct encoder_cfg *opt)
 		ctx->tlt_srt_counter[i] = 0;
 	}
 
+	ctx->subtitle_callback = opt->subtitle_callback;
+	ctx->callback_opaque = opt->callback_opaque;
+
 	ctx->prev = NULL;
+	init_encoder_sinks(ctx, opt);
 	return ctx;
 }
 
@@ -865,7 +1236,7 @@ void set_encoder_rcwt_fileformat(struct encoder_ctx *ctx, short int format)
 
 static int write_newline(struct encoder_ctx *ctx, int lang)
 {
-	return write(ctx->out[lang].fh, ctx->encoded_crlf, ctx->encoded_crlf_length);
+	return write_output(&ctx->out[lang], ctx->encoded_crlf, ctx->encoded_crlf_length);
 }
 
 struct ccx_s_write *get_output_ctx(struct encoder_ctx *ctx, int lan)
@@ -910,6 +1281,12 @@ int encode_sub(struct encoder_ctx *context, struct cc_subtitle *sub)
 		return CCX_OK;
 	}
 
+	// Before this encoder changes the subtitle (delay, censoring, freeing it)
+	if (context->subtitle_callback)
+		context->subtitle_callback(context->callback_opaque, sub);
+	if (context->nb_sinks)
+		send_to_sinks(context, sub);
+
 	context = change_filename(context);
 
 	if (context->sbs_enabled)
@@ -955,7 +1332,7 @@ int encode_sub(struct encoder_ctx *context, struct cc_subtitle *sub)
 					xds_write_transcript_line_prefix(context, out, data->start_time, data->end_time, data->cur_xds_packet_class);
 					if (data->xds_len > 0)
 					{
-						ret = write(out->fh, data->xds_str, data->xds_len);
+						ret = write_output(out, data->xds_str, data->xds_len);
 						if (ret < data->xds_len)
 						{
 							mprint("WARNING:Loss of data\n");
@@ -1033,6 +1410,8 @@ int encode_sub(struct encoder_ctx *context, struct cc_subtitle *sub)
 							temporarily_close_output(context->out);
 						}
 						break;
+					case CCX_OF_NULL: // Only reported to the subtitle callback
+						break;
 					default:
 						mprint("Output format not supported\n");
 						break;
@@ -1144,7 +1523,7 @@ int encode_sub(struct encoder_ctx *context, struct cc_subtitle *sub)
 				net_send_header(sub->data, sub->nb_data);
 			else
 			{
-				ret = write(context->out->fh, sub->data, sub->nb_data);
+				ret = write_output(context->out, sub->data, sub->nb_data);
 				if (ret < sub->nb_data)
 				{
 					mprint("WARNING: Loss of data\n");
@@ -1198,7 +1577,7 @@ int encode_sub(struct encoder_ctx *context, struct cc_subtitle *sub)
 
 	if (!sub->nb_data)
 		freep(&sub->data);
-	if (wrote_something && context->force_flush)
+	if (wrote_something && context->force_flush && !context->out->callback)
 		fsync(context->out->fh); // Don't buffer
 	return wrote_something;
 }
@@ -1345,8 +1724,8 @@ struct ccx_s_write *get_teletext_output(struct encoder_ctx *ctx, uint16_t telete
 	if (teletext_page == 0 || ctx->out == NULL)
 		return ctx->out;
 
-	// Check if we're sending to stdout - can't do multi-page in that case
-	if (ctx->out[0].fh == STDOUT_FILENO)
+	// Check if we're sending to stdout or a callback - can't do multi-page in that case
+	if (ctx->out[0].fh == STDOUT_FILENO || ctx->out[0].callback)
 		return ctx->out;
 
 	// Check if we already have an output file for this page
@@ -45,6 +45,10 @@ typedef struct dtvcc_writer_ctx
 	char *charset;
 	char *filename;
 	iconv_t cd;
+	// Output transcoder resolved once from charset by the Rust 708 writer
+	const void *transcoder;
+	int transcoder_resolved;
+	int use_utf16;
 } dtvcc_writer_ctx;
 
 typedef struct ccx_sbs_utf8_character
@@ -183,6 +187,14 @@ struct encoder_ctx
 	uint16_t tlt_out_pages[MAX_TLT_PAGES_EXTRACT];       // Page numbers for each output slot
 	unsigned int tlt_srt_counter[MAX_TLT_PAGES_EXTRACT]; // SRT counter per page
 	int tlt_out_count;                                    // Number of teletext output files
+
+	// Additional outputs (--also-out), encoders of their own fed the same subtitles
+	struct encoder_sink *sinks;
+	int nb_sinks;
+
+	// Library use: sees every subtitle before it is encoded
+	ccx_subtitle_callback subtitle_callback;
+	void *callback_opaque;
 };
 
 #define INITIAL_ENC_BUFFER_CAPACITY 2048
@@ -217,6 +229,18 @@ void dinit_encoder(struct encoder_ctx **arg, LLONG current_fts);
  */
 int encode_sub(struct encoder_ctx *ctx, struct cc_subtitle *sub);
 
+/**
+ * Write to an output, which is either a file descriptor or the output
+ * callback of a library user
+ *
+ * write_output() behaves like write(), write_output_wrapped() writes
+ * everything or exits like write_wrapped() and output_printf() behaves
+ * like fdprintf()
+ */
+ssize_t write_output(struct ccx_s_write *out, const void *buf, size_t count);
+void write_output_wrapped(struct ccx_s_write *out, const void *buf, size_t count);
+int output_printf(struct ccx_s_write *out, const char *fmt, ...);
+
 int write_cc_buffer_as_ccd(const struct eia608_screen *data, struct encoder_ctx *context);
 int write_cc_buffer_as_scc(const struct eia608_screen *data, struct encoder_ctx *context);
 int write_cc_buffer_as_srt(struct eia608_screen *data, struct encoder_ctx *context);
@@ -252,6 +276,7 @@ int write_cc_bitmap_as_webvtt(struct cc_subtitle *sub, struct encoder_ctx *conte
 int write_cc_bitmap_as_sami(struct cc_subtitle *sub, struct encoder_ctx *context);
 int write_cc_bitmap_as_smptett(struct cc_subtitle *sub, struct encoder_ctx *context);
 int write_cc_bitmap_as_spupng(struct cc_subtitle *sub, struct encoder_ctx *context);
+void spupng_preload_renderer(void);
 int write_cc_bitmap_as_transcript(struct cc_subtitle *sub, struct encoder_ctx *context);
 int write_cc_bitmap_as_libcurl(struct cc_subtitle *sub, struct encoder_ctx *context);
 
@@ -16,25 +16,25 @@ int write_cc_buffer_as_g608(struct eia608_screen *data, struct encoder_ctx *cont
 	context->srt_counter++;
 	snprintf(timeline, sizeof(timeline), "%u%s", context->srt_counter, context->encoded_crlf);
 	used = encode_line(context, context->buffer, (unsigned char *)timeline);
-	write_wrapped(context->out->fh, context->buffer, used);
+	write_output_wrapped(context->out, context->buffer, used);
 	snprintf(timeline, sizeof(timeline), "%02u:%02u:%02u,%03u --> %02u:%02u:%02u,%03u%s",
 		 h1, m1, s1, ms1, h2, m2, s2, ms2, context->encoded_crlf);
 	used = encode_line(context, context->buffer, (unsigned char *)timeline);
 
-	write_wrapped(context->out->fh, context->buffer, used);
+	write_output_wrapped(context->out, context->buffer, used);
 	for (int i = 0; i < 15; i++)
 	{
 		int length = get_line_encoded(context, context->subline, i, data);
-		write_wrapped(context->out->fh, context->subline, length);
+		write_output_wrapped(context->out, context->subline, length);
 
 		length = get_color_encoded(context, context->subline, i, data);
-		write_wrapped(context->out->fh, context->subline, length);
+		write_output_wrapped(context->out, context->subline, length);
 
 		length = get_font_encoded(context, context->subline, i, data);
-		write_wrapped(context->out->fh, context->subline, length);
-		write_wrapped(context->out->fh, context->encoded_crlf, context->encoded_crlf_length);
+		write_output_wrapped(context->out, context->subline, length);
+		write_output_wrapped(context->out, context->encoded_crlf, context->encoded_crlf_length);
 		wrote_something = 1;
 	}
-	write_wrapped(context->out->fh, context->encoded_crlf, context->encoded_crlf_length);
+	write_output_wrapped(context->out, context->encoded_crlf, context->encoded_crlf_length);
 	return wrote_something;
 }
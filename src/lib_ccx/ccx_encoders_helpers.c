@@ -86,66 +86,160 @@ void censor_word(size_t index, unsigned char *word)
 	memset(word, 0x98, strlen(profane.words[index])); // 0x98 is the asterisk in EIA-608
 }
 
-void call_function_if_match(unsigned char *line, struct word_list *list, void (*modification)(size_t, unsigned char *))
+/*
+ * Case-insensitive word sets for the capitalization and profanity lists.
+ * Lines are split at the same delimiters as strtok() would use, and each word
+ * is hashed while it is scanned and looked up in an open addressing table, so
+ * a line is processed in one pass whatever the size of the lists.
+ */
+struct word_slot
 {
-	unsigned char delim[64] = {
-	    ' ', '\n', '\r', 0x89, 0x99,
-	    '!', '"', '#', '%', '&',
-	    '\'', '(', ')', ';', '<',
-	    '=', '>', '?', '[', '\\',
-	    ']', '*', '+', ',', '-',
-	    '.', '/', ':', '^', '_',
-	    '{', '|', '}', '~', '\0'};
-
-	unsigned char *line_token = strdup(line);
-	unsigned char *c = strtok(line_token, delim);
-
-	if (c != NULL)
-	{
-		do
-		{
-			unsigned char **index = bsearch(&c, list->words, list->len, sizeof(*list->words), string_cmp);
+	uint32_t hash;
+	uint32_t index; // Index in the word list plus one, 0 if the slot is free
+};
 
-			if (index)
-			{
-				modification(index - (unsigned char **)list->words, line + (c - line_token));
-			}
-		} while ((c = strtok(NULL, delim)) != NULL);
+struct word_matcher
+{
+	struct word_slot *slots;
+	size_t mask;
+	size_t max_length;
+};
+
+static struct word_matcher capitalization_matcher;
+static struct word_matcher profane_matcher;
+
+static const unsigned char word_delimiters[] = {
+    ' ', '\n', '\r', 0x89, 0x99,
+    '!', '"', '#', '%', '&',
+    '\'', '(', ')', ';', '<',
+    '=', '>', '?', '[', '\\',
+    ']', '*', '+', ',', '-',
+    '.', '/', ':', '^', '_',
+    '{', '|', '}', '~', '\0'};
+
+static unsigned char is_word_delimiter[256];
+
+// Words are compared and hashed ignoring ASCII case, like strcasecmp() in the C locale
+static inline unsigned char fold_case(unsigned char c)
+{
+	return (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c;
+}
+
+static inline uint32_t hash_step(uint32_t hash, unsigned char c)
+{
+	return (hash ^ fold_case(c)) * 16777619u; // FNV-1a
+}
+
+#define WORD_HASH_INIT 2166136261u
+
+static int words_equal(const char *word, const unsigned char *token, size_t length)
+{
+	for (size_t i = 0; i < length; i++)
+	{
+		if (fold_case(word[i]) != fold_case(token[i]))
+			return 0;
 	}
-	free(line_token);
+	return word[length] == '\0';
 }
 
-void telx_correct_case(char *sub_line)
+// Returns the index of the word of list equal to token, or -1
+static long find_word(const struct word_matcher *matcher, const struct word_list *list, const unsigned char *token, size_t length, uint32_t hash)
 {
-	char delim[64] = {
-	    ' ', '\n', '\r', 0x89, 0x99,
-	    '!', '"', '#', '%', '&',
-	    '\'', '(', ')', ';', '<',
-	    '=', '>', '?', '[', '\\',
-	    ']', '*', '+', ',', '-',
-	    '.', '/', ':', '^', '_',
-	    '{', '|', '}', '~', '\0'};
-
-	char *line = strdup(((char *)sub_line));
-	char *oline = (char *)sub_line;
-	char *c = strtok(line, delim);
-	if (c == NULL)
+	if (!matcher->slots || length > matcher->max_length)
+		return -1;
+
+	for (size_t i = hash & matcher->mask; matcher->slots[i].index; i = (i + 1) & matcher->mask)
 	{
-		free(line);
-		return;
+		const struct word_slot *slot = &matcher->slots[i];
+		if (slot->hash == hash && words_equal(list->words[slot->index - 1], token, length))
+			return slot->index - 1;
 	}
-	do
+	return -1;
+}
+
+static void build_word_matcher(struct word_matcher *matcher, const struct word_list *list)
+{
+	size_t capacity = 16;
+
+	free(matcher->slots);
+	memset(matcher, 0, sizeof(*matcher));
+	if (!list->len)
+		return;
+
+	while (capacity < list->len * 2)
+		capacity *= 2;
+	matcher->slots = calloc(capacity, sizeof(struct word_slot));
+	if (!matcher->slots)
+		ccx_common_logging.fatal_ftn(EXIT_NOT_ENOUGH_MEMORY, "In build_word_matcher: Out of memory allocating the word table.");
+	matcher->mask = capacity - 1;
+
+	for (size_t i = 0; i < list->len; i++)
 	{
-		char **index = bsearch(&c, capitalization_list.words, capitalization_list.len, sizeof(*capitalization_list.words), string_cmp);
+		const unsigned char *word = (const unsigned char *)list->words[i];
+		size_t length = strlen(list->words[i]);
+		uint32_t hash = WORD_HASH_INIT;
+
+		for (size_t j = 0; j < length; j++)
+			hash = hash_step(hash, word[j]);
+		if (length > matcher->max_length)
+			matcher->max_length = length;
+
+		// With duplicates differing only in case, the first one wins
+		if (find_word(matcher, list, word, length, hash) >= 0)
+			continue;
+		size_t slot = hash & matcher->mask;
+		while (matcher->slots[slot].index)
+			slot = (slot + 1) & matcher->mask;
+		matcher->slots[slot].hash = hash;
+		matcher->slots[slot].index = i + 1;
+	}
+}
+
+void ccx_encoders_helpers_build_word_matchers(void)
+{
+	memset(is_word_delimiter, 0, sizeof(is_word_delimiter));
+	for (size_t i = 0; i < sizeof(word_delimiters); i++)
+		is_word_delimiter[word_delimiters[i]] = 1;
+
+	build_word_matcher(&capitalization_matcher, &capitalization_list);
+	build_word_matcher(&profane_matcher, &profane);
+}
+
+static void call_function_if_match(unsigned char *line, size_t length, const struct word_matcher *matcher, const struct word_list *list,
+			    void (*modification)(size_t, unsigned char *))
+{
+	size_t start = 0;
+	uint32_t hash = WORD_HASH_INIT;
+
+	if (!matcher->slots)
+		return;
 
-		if (index)
+	for (size_t i = 0; i <= length; i++)
+	{
+		// The end of the line ends the last word, as the NUL delimiter does
+		if (i == length || is_word_delimiter[line[i]])
 		{
-			char *correct_c = capitalization_list.words[index - capitalization_list.words];
-			size_t len = strlen(correct_c);
-			memcpy(oline + (c - line), correct_c, len);
+			if (i > start)
+			{
+				long index = find_word(matcher, list, line + start, i - start, hash);
+				if (index >= 0)
+					modification(index, line + start);
+			}
+			if (i == length || !line[i])
+				break;
+			start = i + 1;
+			hash = WORD_HASH_INIT;
 		}
-	} while ((c = strtok(NULL, delim)) != NULL);
-	free(line);
+		else
+		{
+			hash = hash_step(hash, line[i]);
+		}
+	}
+}
+
+void telx_correct_case(char *sub_line)
+{
+	call_function_if_match((unsigned char *)sub_line, strlen(sub_line), &capitalization_matcher, &capitalization_list, capitalize_word);
 }
 
 int is_all_caps(struct encoder_ctx *context, int line_num, struct eia608_screen *data)
@@ -445,12 +539,12 @@ void correct_spelling_and_censor_words(struct encoder_ctx *context, unsigned cha
 	if (context->sentence_cap)
 	{
 		if (clever_capitalize(context, line, length))
-			call_function_if_match(line, &capitalization_list, capitalize_word);
+			call_function_if_match(line, length, &capitalization_matcher, &capitalization_list, capitalize_word);
 	}
 
 	if (context->filter_profanity)
 	{
-		call_function_if_match(line, &profane, censor_word);
+		call_function_if_match(line, length, &profane_matcher, &profane, censor_word);
 	}
 }
 
@@ -489,9 +583,3 @@ void shell_sort(void *base, int nb, size_t size, int (*compar)(const void *p1, c
 	}
 	free(tmp);
 }
-
-void ccx_encoders_helpers_perform_shellsort_words(void)
-{
-	shell_sort(capitalization_list.words, capitalization_list.len, sizeof(*capitalization_list.words), string_cmp_function, NULL);
-	shell_sort(profane.words, profane.len, sizeof(*profane.words), string_cmp_function, NULL);
-}
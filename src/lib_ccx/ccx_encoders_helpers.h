@@ -47,6 +47,7 @@ unsigned encode_line(struct encoder_ctx *ctx, unsigned char *buffer, unsigned ch
 
 void shell_sort(void *base, int nb, size_t size, int (*compar)(const void *p1, const void *p2, void *arg), void *arg);
 
-void ccx_encoders_helpers_perform_shellsort_words(void);
+// Builds the lookup tables of the capitalization and profanity lists, once they are filled
+void ccx_encoders_helpers_build_word_matchers(void);
 void ccx_encoders_helpers_setup(enum ccx_encoding_type encoding, int no_font_color, int no_type_setting, int trim_subs);
 #endif
@@ -20,12 +20,11 @@ static const uint32 framerate_translation[16] = {0, 2397, 2400, 2500, 2997, 3000
 
 static void debug_log(char *file, int line, ...);
 static struct ccx_mcc_caption_time convert_to_caption_time(LLONG mstime);
-static void generate_mcc_header(int fh, int fr_code, int dropframe_flag);
+static void generate_mcc_header(struct ccx_s_write *out, int fr_code, int dropframe_flag);
 static uint8 *add_boilerplate(struct encoder_ctx *ctx, unsigned char *cc_data, int cc_count, int fr_code);
 static uint16 count_compressed_chars(uint8 *data_ptr, uint16 num_elements);
 static void compress_data(uint8 *data_ptr, uint16 num_elements, uint8 *out_data_ptr);
 static void byte_to_ascii(uint8 hex_byte, uint8 *msn, uint8 *lsn);
-static void write_string(int fh, char *string);
 
 static void random_chars(char buffer[], int len);
 static void uuid4(char *buffer);
@@ -107,7 +106,7 @@ boolean mcc_encode_cc_data(struct encoder_ctx *enc_ctx, struct lib_cc_decode *de
 		dec_ctx->saw_caption_block = CCX_TRUE;
 		enc_ctx->header_printed_flag = CCX_TRUE;
 		enc_ctx->cdp_hdr_seq = 0;
-		generate_mcc_header(enc_ctx->out->fh, dec_ctx->current_frame_rate, enc_ctx->force_dropframe);
+		generate_mcc_header(enc_ctx->out, dec_ctx->current_frame_rate, enc_ctx->force_dropframe);
 
 		enc_ctx->next_caption_time.hour = caption_time.hour;
 		enc_ctx->next_caption_time.minute = caption_time.minute;
@@ -169,7 +168,7 @@ boolean mcc_encode_cc_data(struct encoder_ctx *enc_ctx, struct lib_cc_decode *de
 		compressed_data_buffer[current_len + 1] = '\0';
 	}
 
-	write_wrapped(enc_ctx->out->fh, compressed_data_buffer, strlen(compressed_data_buffer));
+	write_output_wrapped(enc_ctx->out, compressed_data_buffer, strlen(compressed_data_buffer));
 
 	free(compressed_data_buffer);
 
@@ -177,7 +176,44 @@ boolean mcc_encode_cc_data(struct encoder_ctx *enc_ctx, struct lib_cc_decode *de
 		     // With void function type - throws an error
 } // mcc_encode_cc_data()
 
-static void generate_mcc_header(int fh, int fr_code, int dropframe_flag)
+// Fixed part of the header, written with the lines that follow in a single write
+static const char mcc_header_text[] =
+	"File Format=MacCaption_MCC V1.0\n\n"
+	"///////////////////////////////////////////////////////////////////////////////////\n"
+	"// Telestream, LLC\n"
+	"// Ancillary Data Packet Transfer File\n"
+	"//\n// Permission to generate this format is granted provided that\n"
+	"//   1. This ANC Transfer file format is used on an as-is basis and no warranty is given, and\n"
+	"//   2. This entire descriptive information text is included in a generated .mcc file.\n"
+	"//\n// General file format:\n"
+	"//   HH:MM:SS:FF(tab)[Hexadecimal ANC data in groups of 2 characters]\n"
+	"//     Hexadecimal data starts with the Ancillary Data Packet DID (Data ID defined in S291M)\n"
+	"//       and concludes with the Check Sum following the User Data Words.\n"
+	"//     Each time code line must contain at most one complete ancillary data packet.\n"
+	"//     To transfer additional ANC Data successive lines may contain identical time code.\n"
+	"//     Time Code Rate=[24, 25, 30, 30DF, 50, 60, 60DF]\n//\n"
+	"//   ANC data bytes may be represented by one ASCII character according to the following schema:\n"
+	"//     G  FAh 00h 00h\n"
+	"//     H  2 x (FAh 00h 00h)\n"
+	"//     I  3 x (FAh 00h 00h)\n"
+	"//     J  4 x (FAh 00h 00h)\n"
+	"//     K  5 x (FAh 00h 00h)\n"
+	"//     L  6 x (FAh 00h 00h)\n"
+	"//     M  7 x (FAh 00h 00h)\n"
+	"//     N  8 x (FAh 00h 00h)\n"
+	"//     O  9 x (FAh 00h 00h)\n"
+	"//     P  FBh 80h 80h\n"
+	"//     Q  FCh 80h 80h\n"
+	"//     R  FDh 80h 80h\n"
+	"//     S  96h 69h\n"
+	"//     T  61h 01h\n"
+	"//     U  E1h 00h 00h 00h\n"
+	"//     Q  FCh 80h 80h\n"
+	"//     Q  FCh 80h 80h\n"
+	"//     Z  00h\n//\n"
+	"///////////////////////////////////////////////////////////////////////////////////\n\n";
+
+static void generate_mcc_header(struct ccx_s_write *out, int fr_code, int dropframe_flag)
 {
 	char uuid_str[50];
 	char date_str[64];
@@ -236,45 +272,10 @@ static void generate_mcc_header(int fh, int fr_code, int dropframe_flag)
 			break;
 	}
 
-	write_string(fh, "File Format=MacCaption_MCC V1.0\n\n");
-	write_string(fh, "///////////////////////////////////////////////////////////////////////////////////\n");
-	write_string(fh, "// Telestream, LLC\n");
-	write_string(fh, "// Ancillary Data Packet Transfer File\n");
-	write_string(fh, "//\n// Permission to generate this format is granted provided that\n");
-	write_string(fh, "//   1. This ANC Transfer file format is used on an as-is basis and no warranty is given, and\n");
-	write_string(fh, "//   2. This entire descriptive information text is included in a generated .mcc file.\n");
-	write_string(fh, "//\n// General file format:\n");
-	write_string(fh, "//   HH:MM:SS:FF(tab)[Hexadecimal ANC data in groups of 2 characters]\n");
-	write_string(fh, "//     Hexadecimal data starts with the Ancillary Data Packet DID (Data ID defined in S291M)\n");
-	write_string(fh, "//       and concludes with the Check Sum following the User Data Words.\n");
-	write_string(fh, "//     Each time code line must contain at most one complete ancillary data packet.\n");
-	write_string(fh, "//     To transfer additional ANC Data successive lines may contain identical time code.\n");
-	write_string(fh, "//     Time Code Rate=[24, 25, 30, 30DF, 50, 60, 60DF]\n//\n");
-	write_string(fh, "//   ANC data bytes may be represented by one ASCII character according to the following schema:\n");
-	write_string(fh, "//     G  FAh 00h 00h\n");
-	write_string(fh, "//     H  2 x (FAh 00h 00h)\n");
-	write_string(fh, "//     I  3 x (FAh 00h 00h)\n");
-	write_string(fh, "//     J  4 x (FAh 00h 00h)\n");
-	write_string(fh, "//     K  5 x (FAh 00h 00h)\n");
-	write_string(fh, "//     L  6 x (FAh 00h 00h)\n");
-	write_string(fh, "//     M  7 x (FAh 00h 00h)\n");
-	write_string(fh, "//     N  8 x (FAh 00h 00h)\n");
-	write_string(fh, "//     O  9 x (FAh 00h 00h)\n");
-	write_string(fh, "//     P  FBh 80h 80h\n");
-	write_string(fh, "//     Q  FCh 80h 80h\n");
-	write_string(fh, "//     R  FDh 80h 80h\n");
-	write_string(fh, "//     S  96h 69h\n");
-	write_string(fh, "//     T  61h 01h\n");
-	write_string(fh, "//     U  E1h 00h 00h 00h\n");
-	write_string(fh, "//     Q  FCh 80h 80h\n");
-	write_string(fh, "//     Q  FCh 80h 80h\n");
-	write_string(fh, "//     Z  00h\n//\n");
-	write_string(fh, "///////////////////////////////////////////////////////////////////////////////////\n\n");
-	write_string(fh, uuid_str);
-	write_string(fh, "Creation Program=CCExtractor\n");
-	write_string(fh, date_str);
-	write_string(fh, time_str);
-	write_string(fh, tcr_str);
+	char header[sizeof(mcc_header_text) + sizeof(uuid_str) + sizeof(date_str) + sizeof(time_str) + sizeof(tcr_str) + 32];
+	int length = snprintf(header, sizeof(header), "%s%sCreation Program=CCExtractor\n%s%s%s",
+			      mcc_header_text, uuid_str, date_str, time_str, tcr_str);
+	write_output_wrapped(out, header, length);
 } // generate_mcc_header()
 
 static uint8 *add_boilerplate(struct encoder_ctx *ctx, unsigned char *cc_data, int cc_count, int fr_code)
@@ -722,24 +723,11 @@ static struct ccx_mcc_caption_time convert_to_caption_time(LLONG mstime)
 
 static void byte_to_ascii(uint8 hex_byte, uint8 *msn, uint8 *lsn)
 {
+	static const char hex_digits[] = "0123456789ABCDEF";
+
 	ASSERT(msn);
 	ASSERT(lsn);
 
-	*msn = (hex_byte & 0xF0);
-	*msn = *msn >> 4;
-	if (*msn < 0x0A)
-		*msn = *msn + '0';
-	else
-		*msn = (*msn - 0x0A) + 'A';
-
-	*lsn = (hex_byte & 0x0F);
-	if (*lsn < 0x0A)
-		*lsn = *lsn + '0';
-	else
-		*lsn = (*lsn - 0x0A) + 'A';
+	*msn = hex_digits[hex_byte >> 4];
+	*lsn = hex_digits[hex_byte & 0x0F];
 } // byteToAscii()
-
-static void write_string(int fh, char *string)
-{
-	write_wrapped(fh, string, strlen(string));
-}
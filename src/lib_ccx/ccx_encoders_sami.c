@@ -22,7 +22,7 @@ int write_stringz_as_sami(char *string, struct encoder_ctx *context, LLONG ms_st
 	}
 
 	used = encode_line(context, context->buffer, (unsigned char *)str);
-	ret = write(context->out->fh, context->buffer, used);
+	ret = write_output(context->out, context->buffer, used);
 	if (ret != used)
 		return ret;
 
@@ -70,15 +70,15 @@ int write_stringz_as_sami(char *string, struct encoder_ctx *context, LLONG ms_st
 			dbg_print(CCX_DMT_DECODER_608, "\r");
 			dbg_print(CCX_DMT_DECODER_608, "%s\n", context->subline);
 		}
-		ret = write(context->out->fh, el, u);
+		ret = write_output(context->out, el, u);
 		if (ret != u)
 			goto end;
 
-		ret = write(context->out->fh, context->encoded_br, context->encoded_br_length);
+		ret = write_output(context->out, context->encoded_br, context->encoded_br_length);
 		if (ret != context->encoded_br_length)
 			goto end;
 
-		ret = write(context->out->fh, context->encoded_crlf, context->encoded_crlf_length);
+		ret = write_output(context->out, context->encoded_crlf, context->encoded_crlf_length);
 		if (ret != context->encoded_crlf_length)
 			goto end;
 
@@ -91,7 +91,7 @@ int write_stringz_as_sami(char *string, struct encoder_ctx *context, LLONG ms_st
 		dbg_print(CCX_DMT_DECODER_608, "\r%s\n", str);
 	}
 	used = encode_line(context, context->buffer, (unsigned char *)str);
-	ret = write(context->out->fh, context->buffer, used);
+	ret = write_output(context->out, context->buffer, used);
 	if (ret != used)
 		goto end;
 	snprintf(str, sizeof(str),
@@ -101,7 +101,7 @@ int write_stringz_as_sami(char *string, struct encoder_ctx *context, LLONG ms_st
 	{
 		dbg_print(CCX_DMT_DECODER_608, "\r%s\n", str);
 	}
-	ret = write(context->out->fh, context->buffer, used);
+	ret = write_output(context->out, context->buffer, used);
 	if (ret != used)
 		goto end;
 
@@ -129,7 +129,7 @@ int write_cc_bitmap_as_sami(struct cc_subtitle *sub, struct encoder_ctx *context
 	{
 		snprintf(buf, context->capacity,
 			 "<SYNC start=%llu><P class=\"UNKNOWNCC\">\r\n", (unsigned long long)sub->start_time);
-		write_wrapped(context->out->fh, buf, strlen(buf));
+		write_output_wrapped(context->out, buf, strlen(buf));
 		for (int i = sub->nb_data - 1; i >= 0; i--)
 		{
 			if (rect[i].ocr_text && *(rect[i].ocr_text))
@@ -139,21 +139,21 @@ int write_cc_bitmap_as_sami(struct cc_subtitle *sub, struct encoder_ctx *context
 					token = strtok(rect[i].ocr_text, "\r\n");
 					snprintf(buf, context->capacity, "%s", token);
 					token = strtok(NULL, "\r\n");
-					write_wrapped(context->out->fh, buf, strlen(buf));
+					write_output_wrapped(context->out, buf, strlen(buf));
 					if (i != 0)
-						write_wrapped(context->out->fh, context->encoded_br, context->encoded_br_length);
-					write_wrapped(context->out->fh, context->encoded_crlf, context->encoded_crlf_length);
+						write_output_wrapped(context->out, context->encoded_br, context->encoded_br_length);
+					write_output_wrapped(context->out, context->encoded_crlf, context->encoded_crlf_length);
 				}
 			}
 		}
 		snprintf(buf, context->capacity, "</P></SYNC>\r\n");
-		write_wrapped(context->out->fh, buf, strlen(buf));
+		write_output_wrapped(context->out, buf, strlen(buf));
 	}
 	else // we write an empty subtitle to clear the old one
 	{
 		snprintf(buf, context->capacity,
 			 "<SYNC start=%llu><P class=\"UNKNOWNCC\">&nbsp;</P></SYNC>\r\n\r\n", (unsigned long long)sub->start_time);
-		write_wrapped(context->out->fh, buf, strlen(buf));
+		write_output_wrapped(context->out, buf, strlen(buf));
 	}
 #endif
 
@@ -201,7 +201,7 @@ int write_cc_buffer_as_sami(struct eia608_screen *data, struct encoder_ctx *cont
 		dbg_print(CCX_DMT_DECODER_608, "\r%s\n", str);
 	}
 	used = encode_line(context, context->buffer, (unsigned char *)str);
-	write_wrapped(context->out->fh, context->buffer, used);
+	write_output_wrapped(context->out, context->buffer, used);
 	for (int i = 0; i < 15; i++)
 	{
 		if (data->row_used[i])
@@ -212,11 +212,11 @@ int write_cc_buffer_as_sami(struct eia608_screen *data, struct encoder_ctx *cont
 				dbg_print(CCX_DMT_DECODER_608, "\r");
 				dbg_print(CCX_DMT_DECODER_608, "%s\n", context->subline);
 			}
-			write_wrapped(context->out->fh, context->subline, length);
+			write_output_wrapped(context->out, context->subline, length);
 			wrote_something = 1;
 			if (i != 14)
-				write_wrapped(context->out->fh, context->encoded_br, context->encoded_br_length);
-			write_wrapped(context->out->fh, context->encoded_crlf, context->encoded_crlf_length);
+				write_output_wrapped(context->out, context->encoded_br, context->encoded_br_length);
+			write_output_wrapped(context->out, context->encoded_crlf, context->encoded_crlf_length);
 		}
 	}
 	snprintf(str, sizeof(str), "</P></SYNC>\r\n");
@@ -225,7 +225,7 @@ int write_cc_buffer_as_sami(struct eia608_screen *data, struct encoder_ctx *cont
 		dbg_print(CCX_DMT_DECODER_608, "\r%s\n", str);
 	}
 	used = encode_line(context, context->buffer, (unsigned char *)str);
-	write_wrapped(context->out->fh, context->buffer, used);
+	write_output_wrapped(context->out, context->buffer, used);
 	snprintf(str, sizeof(str),
 		 "<SYNC start=%llu><P class=\"UNKNOWNCC\">&nbsp;</P></SYNC>\r\n\r\n",
 		 (unsigned long long)data->end_time - 1); // - 1 to prevent overlap
@@ -234,6 +234,6 @@ int write_cc_buffer_as_sami(struct eia608_screen *data, struct encoder_ctx *cont
 		dbg_print(CCX_DMT_DECODER_608, "\r%s\n", str);
 	}
 	used = encode_line(context, context->buffer, (unsigned char *)str);
-	write_wrapped(context->out->fh, context->buffer, used);
+	write_output_wrapped(context->out, context->buffer, used);
 	return wrote_something;
 }
@@ -414,41 +414,94 @@ unsigned get_second_byte(const enum control_code code)
 	return control_codes[code].byte2;
 }
 
-void add_padding(int fd, const char disassemble)
+/*
+ * A caption is assembled in memory and written to the output with a single
+ * write instead of one per code word. The buffer is flushed early only if a
+ * caption doesn't fit.
+ */
+#define SCC_BUFFER_SIZE 4096
+
+struct scc_writer
+{
+	struct ccx_s_write *out;
+	unsigned int length;
+	char buffer[SCC_BUFFER_SIZE];
+};
+
+static const char hex_digits[] = "0123456789abcdef";
+
+static void scc_flush(struct scc_writer *writer)
+{
+	if (writer->length)
+		write_output_wrapped(writer->out, writer->buffer, writer->length);
+	writer->length = 0;
+}
+
+// Returns room for length more bytes at the end of the buffer
+static char *scc_reserve(struct scc_writer *writer, unsigned int length)
+{
+	char *out;
+
+	if (writer->length + length > SCC_BUFFER_SIZE)
+		scc_flush(writer);
+	out = writer->buffer + writer->length;
+	writer->length += length;
+	return out;
+}
+
+static void scc_append(struct scc_writer *writer, const char *data, unsigned int length)
+{
+	memcpy(scc_reserve(writer, length), data, length);
+}
+
+// Appends a code word as hex, preceded by a space if it starts a new pair of bytes
+static void scc_append_hex(struct scc_writer *writer, const unsigned char *bytes, int count, const unsigned int bytes_written)
+{
+	int space = bytes_written % 2 == 0;
+	char *out = scc_reserve(writer, space + count * 2);
+
+	if (space)
+		*out++ = ' ';
+	for (int i = 0; i < count; i++)
+	{
+		*out++ = hex_digits[bytes[i] >> 4];
+		*out++ = hex_digits[bytes[i] & 0x0f];
+	}
+}
+
+void add_padding(struct scc_writer *writer, const char disassemble)
 {
 
 	if (disassemble)
 	{
-		write_wrapped(fd, "_", 1);
+		scc_append(writer, "_", 1);
 	}
 	else
 	{
 		// 0x80 == odd_parity(0x00)
-		write_wrapped(fd, "80", 2);
+		scc_append(writer, "80", 2);
 	}
 }
 
-void check_padding(const int fd, bool disassemble, unsigned int *bytes_written)
+void check_padding(struct scc_writer *writer, bool disassemble, unsigned int *bytes_written)
 {
 	if (*bytes_written % 2 == 1)
 	{
-		add_padding(fd, disassemble);
+		add_padding(writer, disassemble);
 		++*bytes_written;
 	}
 }
 
-void write_character(const int fd, const unsigned char character, const bool disassemble, unsigned int *bytes_written)
+void write_character(struct scc_writer *writer, const unsigned char character, const bool disassemble, unsigned int *bytes_written)
 {
 	if (disassemble)
 	{
-		write_wrapped(fd, &character, 1);
+		scc_append(writer, (const char *)&character, 1);
 	}
 	else
 	{
-		if (*bytes_written % 2 == 0)
-			write_wrapped(fd, " ", 1);
-
-		fdprintf(fd, "%02x", odd_parity(character));
+		unsigned char byte = odd_parity(character);
+		scc_append_hex(writer, &byte, 1, *bytes_written);
 	}
 	++*bytes_written; // increment int pointed to by (unsigned int *) bytes_written
 }
@@ -460,21 +513,19 @@ void write_character(const int fd, const unsigned char character, const bool dis
  *                      (disassembly) format. It's purpose is to know if
  *                      padding should be added
  */
-void write_control_code(const int fd, const unsigned char channel, const enum control_code code, const bool disassemble, unsigned int *bytes_written)
+void write_control_code(struct scc_writer *writer, const unsigned char channel, const enum control_code code, const bool disassemble, unsigned int *bytes_written)
 {
-	check_padding(fd, disassemble, bytes_written);
+	check_padding(writer, disassemble, bytes_written);
 	if (disassemble)
 	{
 		unsigned int length;
 		const char *assembly_code = disassemble_code(code, &length);
-		write_wrapped(fd, assembly_code, length);
+		scc_append(writer, assembly_code, length);
 	}
 	else
 	{
-		if (*bytes_written % 2 == 0)
-			write_wrapped(fd, " ", 1);
-
-		fdprintf(fd, "%02x%02x", odd_parity(get_first_byte(channel, code)), odd_parity(get_second_byte(code)));
+		unsigned char bytes[2] = {odd_parity(get_first_byte(channel, code)), odd_parity(get_second_byte(code))};
+		scc_append_hex(writer, bytes, 2, *bytes_written);
 	}
 	*bytes_written += 2;
 }
@@ -573,7 +624,7 @@ static bool row_uses_high_range(unsigned char row)
  * Write a styled PAC code (color/font at column 0) directly
  * This is more efficient than using indent PAC + mid-row code when at column 0
  *
- * @param fd File descriptor
+ * @param writer Output buffer
  * @param channel Caption channel (1-4)
  * @param row Row number (0-14)
  * @param color Color to set
@@ -581,19 +632,20 @@ static bool row_uses_high_range(unsigned char row)
  * @param disassemble If true, output assembly format
  * @param bytes_written Pointer to byte counter
  */
-static void write_styled_preamble(const int fd, const unsigned char channel, const unsigned char row,
+static void write_styled_preamble(struct scc_writer *writer, const unsigned char channel, const unsigned char row,
 				  enum ccx_decoder_608_color_code color, enum font_bits font,
 				  const bool disassemble, unsigned int *bytes_written)
 {
 	// Get the preamble code for column 0 to obtain byte1
 	enum control_code base_preamble = get_preamble_code(row, 0);
-	unsigned char byte1 = odd_parity(get_first_byte(channel, base_preamble));
+	unsigned char bytes[2];
+	bytes[0] = odd_parity(get_first_byte(channel, base_preamble));
 
 	// Get styled byte2
 	bool use_high_range = row_uses_high_range(row);
-	unsigned char byte2 = odd_parity(get_styled_pac_byte2(color, font, use_high_range));
+	bytes[1] = odd_parity(get_styled_pac_byte2(color, font, use_high_range));
 
-	check_padding(fd, disassemble, bytes_written);
+	check_padding(writer, disassemble, bytes_written);
 
 	if (disassemble)
 	{
@@ -607,13 +659,13 @@ static void write_styled_preamble(const int fd, const unsigned char channel, con
 		else if (font == FONT_UNDERLINED_ITALICS)
 			font_suffix = "IU";
 
-		fdprintf(fd, "{%02d00%s%s}", row + 1, color_names[color], font_suffix);
+		char assembly[16];
+		int length = snprintf(assembly, sizeof(assembly), "{%02d00%s%s}", row + 1, color_names[color], font_suffix);
+		scc_append(writer, assembly, length);
 	}
 	else
 	{
-		if (*bytes_written % 2 == 0)
-			write_wrapped(fd, " ", 1);
-		fdprintf(fd, "%02x%02x", byte1, byte2);
+		scc_append_hex(writer, bytes, 2, *bytes_written);
 	}
 	*bytes_written += 2;
 }
@@ -678,11 +730,11 @@ static float get_scc_fps(int scc_framerate)
 	}
 }
 
-void add_timestamp(const struct encoder_ctx *context, LLONG time, const bool disassemble)
+void add_timestamp(const struct encoder_ctx *context, struct scc_writer *writer, LLONG time, const bool disassemble)
 {
-	write_wrapped(context->out->fh, context->encoded_crlf, context->encoded_crlf_length);
+	scc_append(writer, (const char *)context->encoded_crlf, context->encoded_crlf_length);
 	if (!disassemble)
-		write_wrapped(context->out->fh, context->encoded_crlf, context->encoded_crlf_length);
+		scc_append(writer, (const char *)context->encoded_crlf, context->encoded_crlf_length);
 
 	unsigned hour, minute, second, milli;
 	millis_to_time(time, &hour, &minute, &second, &milli);
@@ -690,17 +742,19 @@ void add_timestamp(const struct encoder_ctx *context, LLONG time, const bool dis
 	// SMPTE format - use configurable frame rate (issue #1191)
 	float fps = get_scc_fps(context->scc_framerate);
 	float frame = milli * fps / 1000;
-	fdprintf(context->out->fh, "%02u:%02u:%02u:%02.f\t", hour, minute, second, frame);
+	char timestamp[32];
+	int length = snprintf(timestamp, sizeof(timestamp), "%02u:%02u:%02u:%02.f\t", hour, minute, second, frame);
+	scc_append(writer, timestamp, length);
 }
 
-void clear_screen(const struct encoder_ctx *context, LLONG end_time, const unsigned char channel, const bool disassemble)
+void clear_screen(const struct encoder_ctx *context, struct scc_writer *writer, LLONG end_time, const unsigned char channel, const bool disassemble)
 {
-	add_timestamp(context, end_time, disassemble);
+	add_timestamp(context, writer, end_time, disassemble);
 	unsigned int bytes_written = 0;
-	write_control_code(context->out->fh, channel, EDM, disassemble, &bytes_written);
+	write_control_code(writer, channel, EDM, disassemble, &bytes_written);
 }
 
-int write_cc_buffer_as_scenarist(const struct eia608_screen *data, struct encoder_ctx *context, const char disassemble)
+static void write_scenarist_caption(const struct eia608_screen *data, struct encoder_ctx *context, struct scc_writer *writer, const char disassemble)
 {
 	unsigned int bytes_written = 0;
 	enum font_bits current_font = FONT_REGULAR;
@@ -711,8 +765,8 @@ int write_cc_buffer_as_scenarist(const struct eia608_screen *data, struct encode
 	unsigned char current_column = UINT8_MAX;
 
 	// 1. Load the caption
-	add_timestamp(context, data->start_time, disassemble);
-	write_control_code(context->out->fh, data->channel, RCL, disassemble, &bytes_written);
+	add_timestamp(context, writer, data->start_time, disassemble);
+	write_control_code(writer, data->channel, RCL, disassemble, &bytes_written);
 	for (uint8_t row = 0; row < 15; ++row)
 	{
 		// If there is nothing to display on this row, skip it.
@@ -742,7 +796,7 @@ int write_cc_buffer_as_scenarist(const struct eia608_screen *data, struct encode
 					// This avoids needing a separate mid-row code
 					if (column == 0 && can_use_styled_pac(data->colors[row][column], data->fonts[row][column], 0))
 					{
-						write_styled_preamble(context->out->fh, data->channel, row,
+						write_styled_preamble(writer, data->channel, row,
 								      data->colors[row][column], data->fonts[row][column],
 								      disassemble, &bytes_written);
 						current_row = row;
@@ -750,7 +804,7 @@ int write_cc_buffer_as_scenarist(const struct eia608_screen *data, struct encode
 						current_font = data->fonts[row][column];
 						current_color = data->colors[row][column];
 						// Write the character and continue
-						write_character(context->out->fh, data->characters[row][column], disassemble, &bytes_written);
+						write_character(writer, data->characters[row][column], disassemble, &bytes_written);
 						++current_column;
 						continue;
 					}
@@ -777,40 +831,52 @@ int write_cc_buffer_as_scenarist(const struct eia608_screen *data, struct encode
 					tab_offset_code = get_tab_offset_code(column);
 				}
 
-				write_control_code(context->out->fh, data->channel, position_code, disassemble, &bytes_written);
+				write_control_code(writer, data->channel, position_code, disassemble, &bytes_written);
 				if (tab_offset_code)
-					write_control_code(context->out->fh, data->channel, tab_offset_code, disassemble, &bytes_written);
+					write_control_code(writer, data->channel, tab_offset_code, disassemble, &bytes_written);
 				if (switch_font || switch_color)
-					write_control_code(context->out->fh, data->channel, font_code, disassemble, &bytes_written);
+					write_control_code(writer, data->channel, font_code, disassemble, &bytes_written);
 
 				current_row = row;
 				current_column = column;
 				current_font = data->fonts[row][column];
 				current_color = data->colors[row][column];
 			}
-			write_character(context->out->fh, data->characters[row][column], disassemble, &bytes_written);
+			write_character(writer, data->characters[row][column], disassemble, &bytes_written);
 			++current_column;
 		}
-		check_padding(context->out->fh, disassemble, &bytes_written);
+		check_padding(writer, disassemble, &bytes_written);
 	}
 
 	// 2. Show the caption
-	write_control_code(context->out->fh, data->channel, EOC, disassemble, &bytes_written);
-	write_control_code(context->out->fh, data->channel, ENM, disassemble, &bytes_written);
+	write_control_code(writer, data->channel, EOC, disassemble, &bytes_written);
+	write_control_code(writer, data->channel, ENM, disassemble, &bytes_written);
 
 	// 3. Clear the caption
-	clear_screen(context, data->end_time, data->channel, disassemble);
-
-	return 1;
+	clear_screen(context, writer, data->end_time, data->channel, disassemble);
 }
 
-int write_cc_buffer_as_ccd(const struct eia608_screen *data, struct encoder_ctx *context)
+int write_cc_buffer_as_scenarist(const struct eia608_screen *data, struct encoder_ctx *context, const char disassemble)
 {
-	if (!context->wrote_ccd_channel_header)
+	struct scc_writer writer;
+
+	writer.out = context->out;
+	writer.length = 0;
+	if (disassemble && !context->wrote_ccd_channel_header)
 	{
-		fdprintf(context->out->fh, "CHANNEL %d%s", data->channel, context->encoded_crlf);
+		char header[48];
+		int length = snprintf(header, sizeof(header), "CHANNEL %d%s", data->channel, context->encoded_crlf);
+		scc_append(&writer, header, length);
 		context->wrote_ccd_channel_header = true;
 	}
+	write_scenarist_caption(data, context, &writer, disassemble);
+	scc_flush(&writer);
+
+	return 1;
+}
+
+int write_cc_buffer_as_ccd(const struct eia608_screen *data, struct encoder_ctx *context)
+{
 	return write_cc_buffer_as_scenarist(data, context, true);
 }
 
@@ -57,7 +57,7 @@ void write_stringz_as_smptett(char *string, struct encoder_ctx *context, LLONG m
 		dbg_print(CCX_DMT_DECODER_608, "\r%s\n", str);
 	}
 	used = encode_line(context, context->buffer, (unsigned char *)str);
-	write_wrapped(context->out->fh, context->buffer, used);
+	write_output_wrapped(context->out, context->buffer, used);
 	// Scan for \n in the string and replace it with a 0
 	while (pos_r < len)
 	{
@@ -84,10 +84,10 @@ void write_stringz_as_smptett(char *string, struct encoder_ctx *context, LLONG m
 			dbg_print(CCX_DMT_DECODER_608, "\r");
 			dbg_print(CCX_DMT_DECODER_608, "%s\n", context->subline);
 		}
-		write_wrapped(context->out->fh, el, u);
+		write_output_wrapped(context->out, el, u);
 		// write (wb->fh, encoded_br, encoded_br_length);
 
-		write_wrapped(context->out->fh, context->encoded_crlf, context->encoded_crlf_length);
+		write_output_wrapped(context->out, context->encoded_crlf, context->encoded_crlf_length);
 		begin += strlen((const char *)begin) + 1;
 	}
 
@@ -97,7 +97,7 @@ void write_stringz_as_smptett(char *string, struct encoder_ctx *context, LLONG m
 		dbg_print(CCX_DMT_DECODER_608, "\r%s\n", str);
 	}
 	used = encode_line(context, context->buffer, (unsigned char *)str);
-	write_wrapped(context->out->fh, context->buffer, used);
+	write_output_wrapped(context->out, context->buffer, used);
 
 	free(el);
 	free(unescaped);
@@ -132,13 +132,13 @@ int write_cc_bitmap_as_smptett(struct cc_subtitle *sub, struct encoder_ctx *cont
 				millis_to_time(sub->end_time - 1, &h2, &m2, &s2, &ms2); // -1 To prevent overlapping with next line.
 				int written = snprintf(buf, INITIAL_ENC_BUFFER_CAPACITY, "<p begin=\"%02u:%02u:%02u.%03u\" end=\"%02u:%02u:%02u.%03u\">\n", h1, m1, s1, ms1, h2, m2, s2, ms2);
 				if (written > 0 && (size_t)written < INITIAL_ENC_BUFFER_CAPACITY)
-					write_wrapped(context->out->fh, buf, written);
+					write_output_wrapped(context->out, buf, written);
 				len = strlen(rect[i].ocr_text);
-				write_wrapped(context->out->fh, rect[i].ocr_text, len);
-				write_wrapped(context->out->fh, context->encoded_crlf, context->encoded_crlf_length);
+				write_output_wrapped(context->out, rect[i].ocr_text, len);
+				write_output_wrapped(context->out, context->encoded_crlf, context->encoded_crlf_length);
 				written = snprintf(buf, INITIAL_ENC_BUFFER_CAPACITY, "</p>\n");
 				if (written > 0 && (size_t)written < INITIAL_ENC_BUFFER_CAPACITY)
-					write_wrapped(context->out->fh, buf, written);
+					write_output_wrapped(context->out, buf, written);
 			}
 		}
 	}
@@ -230,7 +230,7 @@ int write_cc_buffer_as_smptett(struct eia608_screen *data, struct encoder_ctx *c
 					dbg_print(CCX_DMT_DECODER_608, "\r%s\n", str);
 				}
 				used = encode_line(context, context->buffer, (unsigned char *)str);
-				write_wrapped(context->out->fh, context->buffer, used);
+				write_output_wrapped(context->out, context->buffer, used);
 				// Trimming subs because the position is defined by "tts:origin"
 				int old_trim_subs = context->trim_subs;
 				context->trim_subs = 1;
@@ -445,9 +445,9 @@ int write_cc_buffer_as_smptett(struct eia608_screen *data, struct encoder_ctx *c
 					}
 				}
 
-				write_wrapped(context->out->fh, final, strlen(final));
+				write_output_wrapped(context->out, final, strlen(final));
 
-				write_wrapped(context->out->fh, context->encoded_crlf, context->encoded_crlf_length);
+				write_output_wrapped(context->out, context->encoded_crlf, context->encoded_crlf_length);
 				context->trim_subs = old_trim_subs;
 
 				snprintf(str, sizeof(str), "        <style tts:backgroundColor=\"#000000FF\" tts:fontSize=\"18px\"/></span>\n      </p>\n");
@@ -456,7 +456,7 @@ int write_cc_buffer_as_smptett(struct eia608_screen *data, struct encoder_ctx *c
 					dbg_print(CCX_DMT_DECODER_608, "\r%s\n", str);
 				}
 				used = encode_line(context, context->buffer, (unsigned char *)str);
-				write_wrapped(context->out->fh, context->buffer, used);
+				write_output_wrapped(context->out, context->buffer, used);
 
 				if (context->encoding != CCX_ENC_UNICODE)
 				{
@@ -8,6 +8,9 @@
 #include "lib_ccx.h"
 #include "ccx_encoders_helpers.h"
 #include <assert.h>
+#ifndef _WIN32
+#include <pthread.h>
+#endif
 #ifdef ENABLE_OCR
 #include "ocr.h"
 #undef OCR_DEBUG
@@ -21,13 +24,79 @@
 #define FONT_SIZE 20
 #define CANVAS_WIDTH 600
 
+#define GLYPH_CACHE_SIZE 1024 // Power of two
+#define PNG_JOBS_PER_THREAD 4  // Images waiting to be written, per thread
+#define KEPT_IMAGES_BYTES (64 << 20) // Copies of written images kept to compare with
+
 FT_Library ft_library = NULL;
 
-// The FT_Face object handles typographical information
-// The different face variables are for the regular and italics
-FT_Face face_regular = NULL;
-FT_Face face_italics = NULL;
-FT_Face face = NULL;
+// A glyph rendered by FreeType, with its own copy of the bitmap
+struct spupng_glyph
+{
+	FT_Face face; // Key: face, character code and pixel size
+	uint32_t code;
+	int size;
+	int rendered; // 0 if the font can't render this character
+	FT_Bitmap bitmap;
+	int bitmap_top;
+	int advance_x, advance_y; // In pixels
+};
+
+// Text rendering state kept for the life of an encoder, so the font files are parsed and
+// each glyph rasterized only once instead of for every subtitle.
+struct spupng_text_renderer
+{
+	// The FT_Face object handles typographical information
+	// The different face variables are for the regular and italics
+	FT_Face face_regular;
+	FT_Face face_italics;
+	struct spupng_glyph glyphs[GLYPH_CACHE_SIZE]; // Open addressing, keyed by face and code
+	int nb_glyphs;
+	struct pixel_t *canvas; // Reused for every string, grown as needed
+	int canvas_rows;
+};
+
+// An image to be compressed and written, with its own copy of the pixels
+struct spupng_png_job
+{
+	char *filename;
+	uint8_t *pixels; // Palette indexes if nb_colors isn't 0, RGBA pixels otherwise
+	int w, h;
+	int nb_colors;
+	png_color palette[256];
+	png_byte alpha[256];
+	struct spupng_png_job *next;
+};
+
+// An image already written, which identical ones refer to instead of being written again
+struct spupng_written_image
+{
+	uint64_t hash; // Of the size, palette and pixels, 0 for an unused slot
+	char *relative_path;
+	struct spupng_png_job *image; // Copy of what was written, compared on a hash match
+};
+
+// Writes the images of an encoder, on a pool of threads with --png-threads
+struct spupng_png_writer
+{
+	struct spupng_written_image *images; // Open addressing, keyed by hash
+	unsigned images_size;		     // Power of two
+	unsigned nb_images;
+	size_t kept_bytes; // Pixels of the copies in images
+#ifndef _WIN32
+	pthread_t *workers;
+	int nb_workers;
+	pthread_mutex_t lock;
+	pthread_cond_t job_ready;
+	pthread_cond_t queue_room;
+	struct spupng_png_job *head, *tail;
+	int queued;
+	int closing;
+#endif
+};
+
+static void spupng_save_image(struct spupng_t *sp, struct spupng_png_job *job);
+static void spupng_free_png_writer(struct spupng_png_writer *w);
 
 #define CCPL (ccfont2_width / CCW * ccfont2_height / CCH)
 
@@ -121,12 +190,40 @@ struct spupng_t *spunpg_init(struct ccx_s_write *out)
 	// Would need to do something different for PAL format and teletext.
 	sp->xOffset = 88;
 	sp->yOffset = 46;
+	sp->renderer = NULL;
+	sp->png_writer = NULL;
 
 	return sp;
 }
 
+static void spupng_clear_glyphs(struct spupng_text_renderer *r)
+{
+	for (int i = 0; i < GLYPH_CACHE_SIZE; i++)
+	{
+		if (r->glyphs[i].face)
+			free(r->glyphs[i].bitmap.buffer);
+	}
+	memset(r->glyphs, 0, sizeof(r->glyphs));
+	r->nb_glyphs = 0;
+}
+
+static void spupng_free_renderer(struct spupng_text_renderer *r)
+{
+	if (!r)
+		return;
+	spupng_clear_glyphs(r);
+	if (r->face_regular)
+		FT_Done_Face(r->face_regular);
+	if (r->face_italics)
+		FT_Done_Face(r->face_italics);
+	free(r->canvas);
+	free(r);
+}
+
 void spunpg_free(struct spupng_t *sp)
 {
+	spupng_free_png_writer(sp->png_writer);
+	spupng_free_renderer(sp->renderer);
 	free(sp->dirname);
 	free(sp->pngfile);
 	free(sp->relative_path_png);
@@ -251,6 +348,15 @@ void set_spupng_offset(void *ctx, int x, int y)
 	sp->xOffset = x;
 	sp->yOffset = y;
 }
+// Applies the --png-compression and --png-filter settings
+static void spupng_set_png_options(png_structp png_ptr)
+{
+	if (ccx_options.png_compression_level >= 0)
+		png_set_compression_level(png_ptr, ccx_options.png_compression_level);
+	if (ccx_options.png_filters)
+		png_set_filter(png_ptr, PNG_FILTER_TYPE_BASE, ccx_options.png_filters);
+}
+
 int save_spupng(const char *filename, uint8_t *bitmap, int w, int h,
 		png_color *palette, png_byte *alpha, int nb_color)
 {
@@ -295,6 +401,7 @@ int save_spupng(const char *filename, uint8_t *bitmap, int w, int h,
 	}
 	memset(row_pointer, 0, sizeof(png_bytep) * h);
 	png_init_io(png_ptr, f);
+	spupng_set_png_options(png_ptr);
 
 	png_set_IHDR(png_ptr, info_ptr, w, h,
 		     /* bit_depth */ 8,
@@ -380,11 +487,8 @@ int write_cc_bitmap_as_spupng(struct cc_subtitle *sub, struct encoder_ctx *conte
 	int x_pos, y_pos, width, height, i;
 	int x, y, y_off, x_off, ret = 0;
 	uint8_t *pbuf;
-	char *filename;
 	struct cc_bitmap *rect;
-	png_color *palette = NULL;
-	png_byte *alpha = NULL;
-	int wrote_opentag = 1;
+	struct spupng_png_job *job;
 
 	x_pos = -1;
 	y_pos = -1;
@@ -394,14 +498,12 @@ int write_cc_bitmap_as_spupng(struct cc_subtitle *sub, struct encoder_ctx *conte
 	if (sub->data == NULL)
 		return 0;
 
-	inc_spupng_fileindex(sp);
-	write_sputag_open(sp, sub->start_time, sub->end_time - 1);
-
 	if (sub->nb_data == 0 && (sub->flags & SUB_EOD_MARKER))
 	{
+		inc_spupng_fileindex(sp);
+		write_sputag_open(sp, sub->start_time, sub->end_time - 1);
 		context->prev_start = -1;
-		if (wrote_opentag)
-			write_sputag_close(sp);
+		write_sputag_close(sp);
 		return 0;
 	}
 	rect = sub->data;
@@ -439,16 +541,15 @@ int write_cc_bitmap_as_spupng(struct cc_subtitle *sub, struct encoder_ctx *conte
 			}
 		}
 	}
-	filename = get_spupng_filename(sp);
 	set_spupng_offset(sp, x_pos, y_pos);
 	if (sub->flags & SUB_EOD_MARKER)
 		context->prev_start = sub->start_time;
-	pbuf = (uint8_t *)malloc(width * height);
-	if (!pbuf)
+	job = (struct spupng_png_job *)calloc(1, sizeof(struct spupng_png_job));
+	pbuf = (uint8_t *)calloc(width * height + 1, 1);
+	if (!job || !pbuf)
 	{
 		fatal(EXIT_NOT_ENOUGH_MEMORY, "In write_cc_bitmap_as_spupng: Out of memory allocating pbuf.");
 	}
-	memset(pbuf, 0x0, width * height);
 
 	for (i = 0; i < sub->nb_data; i++)
 	{
@@ -460,21 +561,15 @@ int write_cc_bitmap_as_spupng(struct cc_subtitle *sub, struct encoder_ctx *conte
 				pbuf[((y + y_off) * width) + x_off + x] = rect[i].data0[y * rect[i].w + x];
 		}
 	}
-	palette = (png_color *)malloc(rect[0].nb_colors * sizeof(png_color));
-	if (!palette)
-	{
-		ret = -1;
-		goto end;
-	}
-	alpha = (png_byte *)malloc(rect[0].nb_colors * sizeof(png_byte));
-	if (!alpha)
-	{
-		ret = -1;
-		goto end;
-	}
-
 	/* TODO do rectangle wise, one color table should not be used for all rectangles */
-	mapclut_paletee(palette, alpha, (uint32_t *)rect[0].data1, rect[0].nb_colors);
+	job->nb_colors = rect[0].nb_colors > 256 ? 256 : rect[0].nb_colors;
+	mapclut_paletee(job->palette, job->alpha, (uint32_t *)rect[0].data1, job->nb_colors);
+	job->pixels = pbuf;
+	job->w = width;
+	job->h = height;
+	spupng_save_image(sp, job);
+
+	write_sputag_open(sp, sub->start_time, sub->end_time - 1);
 #ifdef ENABLE_OCR
 	if (!context->nospupngocr)
 	{
@@ -487,12 +582,7 @@ int write_cc_bitmap_as_spupng(struct cc_subtitle *sub, struct encoder_ctx *conte
 		}
 	}
 #endif
-	save_spupng(filename, pbuf, width, height, palette, alpha, rect[0].nb_colors);
-	freep(&pbuf);
-
-end:
-	if (wrote_opentag)
-		write_sputag_close(sp);
+	write_sputag_close(sp);
 
 	for (i = 0, rect = sub->data; i < sub->nb_data; i++, rect++)
 	{
@@ -501,9 +591,6 @@ end:
 	}
 	sub->nb_data = 0;
 	freep(&sub->data);
-	freep(&palette);
-	freep(&alpha);
-	freep(&pbuf);
 	return ret;
 }
 
@@ -535,6 +622,7 @@ int write_image(struct pixel_t *buffer, FILE *fp, int width, int height)
 	}
 
 	png_init_io(png_ptr, fp);
+	spupng_set_png_options(png_ptr);
 
 	// Write header
 	png_set_IHDR(png_ptr, info_ptr, width, height,
@@ -578,6 +666,285 @@ finalise:
 	return ret_code;
 }
 
+static size_t spupng_image_bytes(const struct spupng_png_job *job)
+{
+	return (size_t)job->w * job->h * (job->nb_colors ? 1 : sizeof(struct pixel_t));
+}
+
+// Hash of an image, to find identical ones: 64 bit FNV-1a over the size, the palette and
+// the pixels, taken 8 bytes at a time
+static uint64_t spupng_image_hash(struct spupng_png_job *job)
+{
+	uint64_t hash = 0xcbf29ce484222325ULL;
+	size_t size = spupng_image_bytes(job);
+	uint64_t word;
+	size_t i;
+
+	hash = (hash ^ (uint64_t)job->w) * 0x100000001b3ULL;
+	hash = (hash ^ (uint64_t)job->h) * 0x100000001b3ULL;
+	hash = (hash ^ (uint64_t)job->nb_colors) * 0x100000001b3ULL;
+	for (i = 0; i < (size_t)job->nb_colors; i++)
+	{
+		word = (uint64_t)job->palette[i].red << 24 | job->palette[i].green << 16 | job->palette[i].blue << 8 | job->alpha[i];
+		hash = (hash ^ word) * 0x100000001b3ULL;
+	}
+	for (i = 0; i + 8 <= size; i += 8)
+	{
+		memcpy(&word, job->pixels + i, 8);
+		hash = (hash ^ word) * 0x100000001b3ULL;
+	}
+	for (; i < size; i++)
+		hash = (hash ^ job->pixels[i]) * 0x100000001b3ULL;
+	return hash ? hash : 1;
+}
+
+static int spupng_same_image(const struct spupng_png_job *a, const struct spupng_png_job *b)
+{
+	return a->w == b->w && a->h == b->h && a->nb_colors == b->nb_colors &&
+	       memcmp(a->palette, b->palette, a->nb_colors * sizeof(png_color)) == 0 &&
+	       memcmp(a->alpha, b->alpha, a->nb_colors) == 0 &&
+	       memcmp(a->pixels, b->pixels, spupng_image_bytes(a)) == 0;
+}
+
+// Compresses and writes an image, and frees the job
+static void spupng_write_job(struct spupng_png_job *job)
+{
+	if (job->nb_colors)
+	{
+		save_spupng(job->filename, job->pixels, job->w, job->h, job->palette, job->alpha, job->nb_colors);
+	}
+	else
+	{
+		FILE *f = fopen(job->filename, "wb");
+		if (f == NULL)
+		{
+			fatal(CCX_COMMON_EXIT_FILE_CREATION_FAILED, "Cannot open %s: %s\n",
+			      job->filename, strerror(errno));
+		}
+		if (!write_image((struct pixel_t *)job->pixels, f, job->w, job->h))
+		{
+			fatal(CCX_COMMON_EXIT_FILE_CREATION_FAILED, "Cannot write %s: %s\n",
+			      job->filename, strerror(errno));
+		}
+		fclose(f);
+	}
+	free(job->filename);
+	free(job->pixels);
+	free(job);
+}
+
+#ifndef _WIN32
+static void *spupng_png_worker(void *arg)
+{
+	struct spupng_png_writer *w = (struct spupng_png_writer *)arg;
+	for (;;)
+	{
+		pthread_mutex_lock(&w->lock);
+		while (!w->head && !w->closing)
+			pthread_cond_wait(&w->job_ready, &w->lock);
+		struct spupng_png_job *job = w->head;
+		if (job)
+		{
+			w->head = job->next;
+			if (!w->head)
+				w->tail = NULL;
+			w->queued--;
+			pthread_cond_signal(&w->queue_room);
+		}
+		pthread_mutex_unlock(&w->lock);
+
+		if (!job) // Closing and nothing left
+			return NULL;
+		spupng_write_job(job);
+	}
+}
+#endif
+
+static struct spupng_png_writer *spupng_get_png_writer(struct spupng_t *sp)
+{
+	if (sp->png_writer)
+		return sp->png_writer;
+
+	struct spupng_png_writer *w = calloc(1, sizeof(struct spupng_png_writer));
+	if (!w)
+	{
+		fatal(EXIT_NOT_ENOUGH_MEMORY, "In spupng_get_png_writer: Out of memory allocating writer.");
+	}
+	w->images_size = 1024;
+	w->images = calloc(w->images_size, sizeof(struct spupng_written_image));
+	if (!w->images)
+	{
+		fatal(EXIT_NOT_ENOUGH_MEMORY, "In spupng_get_png_writer: Out of memory allocating image table.");
+	}
+
+#ifndef _WIN32
+	if (ccx_options.png_threads > 1)
+	{
+		w->workers = malloc(sizeof(pthread_t) * ccx_options.png_threads);
+		if (!w->workers)
+		{
+			fatal(EXIT_NOT_ENOUGH_MEMORY, "In spupng_get_png_writer: Out of memory allocating threads.");
+		}
+		pthread_mutex_init(&w->lock, NULL);
+		pthread_cond_init(&w->job_ready, NULL);
+		pthread_cond_init(&w->queue_room, NULL);
+		while (w->nb_workers < ccx_options.png_threads &&
+		       pthread_create(&w->workers[w->nb_workers], NULL, spupng_png_worker, w) == 0)
+			w->nb_workers++;
+		if (w->nb_workers == 0) // Write the images as they come instead
+		{
+			pthread_mutex_destroy(&w->lock);
+			pthread_cond_destroy(&w->job_ready);
+			pthread_cond_destroy(&w->queue_room);
+		}
+	}
+#endif
+
+	sp->png_writer = w;
+	return w;
+}
+
+// Forgets the images written so far; identical ones coming later get files of their own
+static void spupng_clear_images(struct spupng_png_writer *w)
+{
+	for (unsigned i = 0; i < w->images_size; i++)
+	{
+		if (!w->images[i].hash)
+			continue;
+		free(w->images[i].relative_path);
+		free(w->images[i].image->pixels);
+		free(w->images[i].image);
+	}
+	memset(w->images, 0, w->images_size * sizeof(struct spupng_written_image));
+	w->nb_images = 0;
+	w->kept_bytes = 0;
+}
+
+// Waits for the queued images to be written and frees the writer.
+static void spupng_free_png_writer(struct spupng_png_writer *w)
+{
+	if (!w)
+		return;
+#ifndef _WIN32
+	if (w->nb_workers)
+	{
+		pthread_mutex_lock(&w->lock);
+		w->closing = 1;
+		pthread_cond_broadcast(&w->job_ready);
+		pthread_mutex_unlock(&w->lock);
+		for (int i = 0; i < w->nb_workers; i++)
+			pthread_join(w->workers[i], NULL);
+		pthread_mutex_destroy(&w->lock);
+		pthread_cond_destroy(&w->job_ready);
+		pthread_cond_destroy(&w->queue_room);
+	}
+	free(w->workers);
+#endif
+	spupng_clear_images(w);
+	free(w->images);
+	free(w);
+}
+
+// Slot of the image table holding an image identical to `job`, or the free slot where it
+// goes. Images whose hashes collide are told apart by their contents.
+static unsigned spupng_image_slot(struct spupng_png_writer *w, uint64_t hash, const struct spupng_png_job *job)
+{
+	unsigned slot = (unsigned)(hash >> 32) & (w->images_size - 1);
+	while (w->images[slot].hash && (w->images[slot].hash != hash || !spupng_same_image(w->images[slot].image, job)))
+		slot = (slot + 1) & (w->images_size - 1);
+	return slot;
+}
+
+// Saves the image of the next subpicture, taking ownership of the job.
+// Afterwards sp->relative_path_png is the image to reference: an identical image written
+// before, or a new file that may still be in the queue.
+static void spupng_save_image(struct spupng_t *sp, struct spupng_png_job *job)
+{
+	struct spupng_png_writer *w = spupng_get_png_writer(sp);
+	uint64_t hash = spupng_image_hash(job);
+	unsigned slot = spupng_image_slot(w, hash, job);
+	size_t bytes = spupng_image_bytes(job);
+	struct spupng_png_job *image;
+
+	if (w->images[slot].hash)
+	{
+		strcpy(sp->relative_path_png, w->images[slot].relative_path);
+		free(job->pixels);
+		free(job);
+		return;
+	}
+
+	if (w->kept_bytes + bytes > KEPT_IMAGES_BYTES)
+	{
+		spupng_clear_images(w);
+		slot = spupng_image_slot(w, hash, job);
+	}
+
+	// The job is freed once written, possibly by a worker, so the table keeps a copy
+	image = malloc(sizeof(struct spupng_png_job));
+	if (!image || !(image->pixels = malloc(bytes ? bytes : 1)))
+	{
+		fatal(EXIT_NOT_ENOUGH_MEMORY, "In spupng_save_image: Out of memory copying image.");
+	}
+	image->w = job->w;
+	image->h = job->h;
+	image->nb_colors = job->nb_colors;
+	memcpy(image->palette, job->palette, sizeof(job->palette));
+	memcpy(image->alpha, job->alpha, sizeof(job->alpha));
+	memcpy(image->pixels, job->pixels, bytes);
+	image->filename = NULL;
+	image->next = NULL;
+
+	inc_spupng_fileindex(sp);
+	w->images[slot].hash = hash;
+	w->images[slot].image = image;
+	w->images[slot].relative_path = strdup(sp->relative_path_png);
+	w->kept_bytes += bytes;
+	job->filename = strdup(sp->pngfile);
+	if (!w->images[slot].relative_path || !job->filename)
+	{
+		fatal(EXIT_NOT_ENOUGH_MEMORY, "In spupng_save_image: Out of memory allocating filename.");
+	}
+
+	if (++w->nb_images > w->images_size / 4 * 3)
+	{
+		struct spupng_written_image *old = w->images;
+		unsigned old_size = w->images_size;
+		w->images_size *= 2;
+		w->images = calloc(w->images_size, sizeof(struct spupng_written_image));
+		if (!w->images)
+		{
+			fatal(EXIT_NOT_ENOUGH_MEMORY, "In spupng_save_image: Out of memory growing image table.");
+		}
+		for (unsigned i = 0; i < old_size; i++)
+		{
+			if (old[i].hash)
+				w->images[spupng_image_slot(w, old[i].hash, old[i].image)] = old[i];
+		}
+		free(old);
+	}
+
+#ifndef _WIN32
+	if (w->nb_workers)
+	{
+		pthread_mutex_lock(&w->lock);
+		while (w->queued >= w->nb_workers * PNG_JOBS_PER_THREAD)
+			pthread_cond_wait(&w->queue_room, &w->lock);
+		job->next = NULL;
+		if (w->tail)
+			w->tail->next = job;
+		else
+			w->head = job;
+		w->tail = job;
+		w->queued++;
+		pthread_cond_signal(&w->job_ready);
+		pthread_mutex_unlock(&w->lock);
+		return;
+	}
+#endif
+	spupng_write_job(job);
+}
+
 // Draw a FT_Bitmap to the target surface
 // Dest: target - an array which stores image data (ARGB), row by row.
 // Src: bitmap.buffer - 8bit grayscale image, row by row, with the size of bitmap.rows*bitmap.width
@@ -709,12 +1076,143 @@ int init_face(FT_Face *face, char *font)
 	if ((error = FT_Set_Pixel_Sizes(*face, 0, FONT_SIZE)))
 	{
 		mprint("\nFailed to init freetype when trying to set size, error code: %d\n", error);
+		FT_Done_Face(*face);
+		*face = NULL;
 		return 1;
 	}
 
 	return 0;
 }
 
+// Opens the fonts of a new text renderer.
+// Returns NULL if a font can't be loaded.
+static struct spupng_text_renderer *spupng_open_renderer(void)
+{
+	int error;
+
+	// Init FreeType if it hasn't been inited yet.
+	if (ft_library == NULL)
+	{
+		if ((error = FT_Init_FreeType(&ft_library)))
+		{
+			mprint("\nFailed to init freetype, error code: %d\n", error);
+			return NULL;
+		}
+	}
+
+	struct spupng_text_renderer *r = calloc(1, sizeof(struct spupng_text_renderer));
+	if (!r)
+	{
+		fatal(EXIT_NOT_ENOUGH_MEMORY, "In spupng_open_renderer: Out of memory allocating renderer.");
+	}
+
+	// Init FreeType typographical face objects
+	if (init_face(&r->face_regular, ccx_options.enc_cfg.render_font) ||
+	    init_face(&r->face_italics, ccx_options.enc_cfg.render_font_italics))
+	{
+		spupng_free_renderer(r);
+		return NULL;
+	}
+	return r;
+}
+
+// A renderer set up before --batch forks its workers. The first encoder of each worker
+// takes it over, so the workers share its fonts and glyphs instead of each loading them again.
+static struct spupng_text_renderer *preloaded_renderer = NULL;
+#ifndef _WIN32
+static pthread_mutex_t preloaded_renderer_lock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+// Returns the text renderer of the encoder, opening the fonts on first use.
+// Returns NULL if a font can't be loaded.
+static struct spupng_text_renderer *spupng_get_renderer(struct spupng_t *sp)
+{
+	if (sp->renderer)
+		return sp->renderer;
+
+#ifndef _WIN32
+	pthread_mutex_lock(&preloaded_renderer_lock);
+#endif
+	sp->renderer = preloaded_renderer;
+	preloaded_renderer = NULL;
+#ifndef _WIN32
+	pthread_mutex_unlock(&preloaded_renderer_lock);
+#endif
+	if (!sp->renderer)
+		sp->renderer = spupng_open_renderer();
+	return sp->renderer;
+}
+
+// Returns the glyph of `code` in `face`, rendering it on first use.
+// Returns NULL if the font can't render it.
+static struct spupng_glyph *spupng_get_glyph(struct spupng_text_renderer *r, FT_Face face, uint32_t code)
+{
+	uint32_t slot = (uint32_t)(((uintptr_t)face >> 4) ^ (code * 2654435761u)) & (GLYPH_CACHE_SIZE - 1);
+	struct spupng_glyph *g;
+	for (g = &r->glyphs[slot]; g->face; g = &r->glyphs[slot])
+	{
+		if (g->face == face && g->code == code && g->size == FONT_SIZE)
+			return g->rendered ? g : NULL;
+		slot = (slot + 1) & (GLYPH_CACHE_SIZE - 1);
+	}
+
+	// Keep the table sparse; captions use few distinct characters, so starting over is rare
+	if (r->nb_glyphs >= GLYPH_CACHE_SIZE * 3 / 4)
+	{
+		spupng_clear_glyphs(r);
+		return spupng_get_glyph(r, face, code);
+	}
+
+	r->nb_glyphs++;
+	g->face = face;
+	g->code = code;
+	g->size = FONT_SIZE;
+	if (FT_Load_Char(face, code, FT_LOAD_RENDER))
+		return NULL;
+
+	FT_GlyphSlot ft_slot = face->glyph;
+	g->rendered = 1;
+	g->bitmap = ft_slot->bitmap;
+	g->bitmap.buffer = NULL;
+	g->bitmap.pitch = ft_slot->bitmap.width;
+	g->bitmap_top = ft_slot->bitmap_top;
+	g->advance_x = ft_slot->advance.x >> 6;
+	g->advance_y = ft_slot->advance.y >> 6;
+	// Characters such as ' ' don't have bitmap.
+	if (ft_slot->bitmap.buffer != NULL)
+	{
+		g->bitmap.buffer = malloc(ft_slot->bitmap.rows * ft_slot->bitmap.width + 1);
+		if (!g->bitmap.buffer)
+		{
+			fatal(EXIT_NOT_ENOUGH_MEMORY, "In spupng_get_glyph: Out of memory allocating bitmap.");
+		}
+		for (unsigned int y = 0; y < ft_slot->bitmap.rows; y++)
+			memcpy(g->bitmap.buffer + y * ft_slot->bitmap.width,
+			       ft_slot->bitmap.buffer + y * ft_slot->bitmap.pitch, ft_slot->bitmap.width);
+	}
+	return g;
+}
+
+// Sets up the renderer the --batch workers take over, when they will write SPUPNG.
+// The printable ASCII glyphs are rendered as well, as nearly every subtitle needs them.
+void spupng_preload_renderer(void)
+{
+	int uses_spupng = ccx_options.write_format == CCX_OF_SPUPNG;
+	for (int i = 0; i < ccx_options.enc_cfg.nb_extra_write_formats; i++)
+		uses_spupng |= ccx_options.enc_cfg.extra_write_formats[i] == CCX_OF_SPUPNG;
+	if (!uses_spupng || preloaded_renderer)
+		return;
+
+	preloaded_renderer = spupng_open_renderer();
+	if (!preloaded_renderer)
+		return;
+	for (uint32_t code = 0x20; code < 0x7f; code++)
+	{
+		spupng_get_glyph(preloaded_renderer, preloaded_renderer->face_regular, code);
+		spupng_get_glyph(preloaded_renderer, preloaded_renderer->face_italics, code);
+	}
+}
+
 // The function will NOT free src.
 // You need to free the src and return value yourself!
 uint32_t *utf8_to_utf32(char *src)
@@ -748,26 +1246,12 @@ uint32_t *utf8_to_utf32(char *src)
 #define BigtoLittle32(A) ((((uint32_t)(A) & 0xff000000) >> 24) | (((uint32_t)(A) & 0x00ff0000) >> 8) | (((uint32_t)(A) & 0x0000ff00) << 8) | (((uint32_t)(A) & 0x000000ff) << 24))
 
 // Generate PNG file from an UTF-8 string (str)
-// PNG file will be stored at output
+// The image is saved as the next subpicture of sp, see spupng_save_image()
 // Return 1 on success.
-int spupng_export_string2png(struct spupng_t *sp, char *str, FILE *output)
+int spupng_export_string2png(struct spupng_t *sp, char *str)
 {
-	int error;
-	// Init FreeType if it hasn't been inited yet.
-	if (ft_library == NULL)
-	{
-
-		if ((error = FT_Init_FreeType(&ft_library)))
-		{
-			mprint("\nFailed to init freetype, error code: %d\n", error);
-			return 0;
-		}
-	}
-
-	// Init FreeType typographical face objects
-	if ((error = init_face(&face_regular, ccx_options.enc_cfg.render_font)))
-		return 0;
-	if ((error = init_face(&face_italics, ccx_options.enc_cfg.render_font_italics)))
+	struct spupng_text_renderer *r = spupng_get_renderer(sp);
+	if (!r)
 		return 0;
 
 	int canvas_width = CANVAS_WIDTH;
@@ -779,24 +1263,27 @@ int spupng_export_string2png(struct spupng_t *sp, char *str, FILE *output)
 	int cursor_x = 0;
 	int cursor_y = line_height * 2;
 
-	// Allocate buffer
+	// Reuse the buffer of the previous strings
 	// Note: (0, 0) of buffer is at the top left corner.
-	struct pixel_t *buffer = malloc(canvas_width * canvas_height * sizeof(struct pixel_t));
-	if (buffer == NULL)
+	if (r->canvas_rows < canvas_height)
 	{
-		fatal(EXIT_NOT_ENOUGH_MEMORY, "In spupng_export_string2png: Out of memory allocating buffer. Need %lu bytes.",
-		      (unsigned long)(canvas_width * canvas_height * sizeof(struct pixel_t)));
+		struct pixel_t *new_buffer = realloc(r->canvas, canvas_width * canvas_height * sizeof(struct pixel_t));
+		if (new_buffer == NULL)
+		{
+			fatal(EXIT_NOT_ENOUGH_MEMORY, "In spupng_export_string2png: Out of memory allocating buffer. Need %lu bytes.",
+			      (unsigned long)(canvas_width * canvas_height * sizeof(struct pixel_t)));
+		}
+		r->canvas = new_buffer;
+		r->canvas_rows = canvas_height;
 	}
+	struct pixel_t *buffer = r->canvas;
 	memset(buffer, 0, canvas_width * canvas_height * sizeof(struct pixel_t));
 
 	// str = "<font color=\"#66CDAA\"> __ This should be aquamarine </font> Regular <i> Italics font</i> <font color=\"#00ff00\">This should be green.</font> <u> Underlining __ testing </u> Regular text. Even more text. Random text. More text."; // Test string
 	char *tmp = strdup(str);
 
 	if (!tmp)
-	{
-		free(buffer);
 		return -1;
-	}
 
 	char *token = strtok(tmp, "<>");
 
@@ -804,19 +1291,19 @@ int spupng_export_string2png(struct spupng_t *sp, char *str, FILE *output)
 	int prev_color = 0xffffff;
 	int underline = 0;
 	int font = 0;
-	face = face_regular;
+	FT_Face face = r->face_regular;
 
 	while (token != NULL)
 	{
 		if (strlen(token) == 1 && strncmp("i", token, 1) == 0)
 		{
 			token = strtok(NULL, "<>");
-			face = face_italics;
+			face = r->face_italics;
 			continue;
 		}
 		else if (strlen(token) == 2 && strncmp("/i", token, 2) == 0)
 		{
-			face = face_regular;
+			face = r->face_regular;
 			token = strtok(NULL, "<>");
 			continue;
 		}
@@ -871,9 +1358,6 @@ int spupng_export_string2png(struct spupng_t *sp, char *str, FILE *output)
 		}
 		// mprint("%s\n", token);
 
-		FT_GlyphSlot slot = face->glyph;
-		;
-
 		uint32_t *string_utf32 = utf8_to_utf32(token);
 
 		// Render characters to image
@@ -881,10 +1365,11 @@ int spupng_export_string2png(struct spupng_t *sp, char *str, FILE *output)
 		{
 			uint32_t current_char_code = BigtoLittle32(*iter); // Convert big-endian and little-endian
 
-			if (FT_Load_Char(face, current_char_code, FT_LOAD_RENDER))
+			struct spupng_glyph *glyph = spupng_get_glyph(r, face, current_char_code);
+			if (!glyph)
 				continue; // ignore errors
 
-			unsigned char *bitmap = slot->bitmap.buffer;
+			unsigned char *bitmap = glyph->bitmap.buffer;
 
 			// Handle '\n'
 			if (current_char_code == '\n')
@@ -898,28 +1383,31 @@ int spupng_export_string2png(struct spupng_t *sp, char *str, FILE *output)
 			}
 
 			// Expand canvas if needed
-			while (cursor_y - slot->bitmap_top + line_height + line_spacing + extender * 2 >= canvas_height)
+			while (cursor_y - glyph->bitmap_top + line_height + line_spacing + extender * 2 >= canvas_height)
 			{
 				int old_height = canvas_height;
 				canvas_height += line_height + line_spacing + extender * 2;
-				struct pixel_t *new_buffer = realloc(buffer, canvas_width * canvas_height * sizeof(struct pixel_t));
-				if (new_buffer == NULL)
+				if (r->canvas_rows < canvas_height)
 				{
-					free(buffer);
-					free(tmp);
-					free(string_utf32);
-					fatal(EXIT_NOT_ENOUGH_MEMORY, "In spupng_export_string2png: Out of memory expanding buffer. Need %lu bytes.",
-					      (unsigned long)(canvas_width * canvas_height * sizeof(struct pixel_t)));
+					struct pixel_t *new_buffer = realloc(buffer, canvas_width * canvas_height * sizeof(struct pixel_t));
+					if (new_buffer == NULL)
+					{
+						free(tmp);
+						free(string_utf32);
+						fatal(EXIT_NOT_ENOUGH_MEMORY, "In spupng_export_string2png: Out of memory expanding buffer. Need %lu bytes.",
+						      (unsigned long)(canvas_width * canvas_height * sizeof(struct pixel_t)));
+					}
+					buffer = r->canvas = new_buffer;
+					r->canvas_rows = canvas_height;
 				}
-				memset(new_buffer + old_height * canvas_width, 0, (canvas_height - old_height) * canvas_width * sizeof(struct pixel_t));
-				buffer = new_buffer;
+				memset(buffer + old_height * canvas_width, 0, (canvas_height - old_height) * canvas_width * sizeof(struct pixel_t));
 			}
 
 			// Characters such as ' ' don't have bitmap.
 			if (bitmap != NULL)
 			{
 				// TODO: this kind of line break may break characters in the middle!
-				if ((cursor_x + (slot->advance.x >> 6)) > canvas_width)
+				if ((cursor_x + glyph->advance_x) > canvas_width)
 				{ // Time for a line-break!
 					// But before that, let's center justify the subtitle.
 					// Valid subtitle area: (0, cursor_y) to (cursor_x, cursor_y + line_height)
@@ -931,7 +1419,7 @@ int spupng_export_string2png(struct spupng_t *sp, char *str, FILE *output)
 					cursor_y += line_height + line_spacing;
 				}
 
-				draw_to_buffer(buffer, canvas_width, slot->bitmap, cursor_x, cursor_y - slot->bitmap_top, color);
+				draw_to_buffer(buffer, canvas_width, glyph->bitmap, cursor_x, cursor_y - glyph->bitmap_top, color);
 
 				if (underline)
 				{
@@ -939,7 +1427,7 @@ int spupng_export_string2png(struct spupng_t *sp, char *str, FILE *output)
 					int pixel_offset = fu_to_ypixels(face, face->underline_position);
 
 					// Calculates how wide a character is
-					int glyph_width = slot->advance.x >> 6;
+					int glyph_width = glyph->advance_x;
 					// mprint("Glyph Width: %d\n", glyph_width);
 
 					int underline_thickness = fu_to_ypixels(face, face->underline_thickness);
@@ -955,7 +1443,7 @@ int spupng_export_string2png(struct spupng_t *sp, char *str, FILE *output)
 					// Converts underline offset from font units to pixels
 					int pixel_offset = fu_to_ypixels(face, face->underline_position);
 					// Calculates how wide a character is
-					int glyph_width = (slot->advance.x >> 6);
+					int glyph_width = glyph->advance_x;
 
 					// mprint("Glyph Width: %d\n", glyph_width);
 					int underline_thickness = fu_to_ypixels(face, face->underline_thickness);
@@ -965,12 +1453,12 @@ int spupng_export_string2png(struct spupng_t *sp, char *str, FILE *output)
 
 			/*
 			mprint("\nDrawing [%c] (%d), advance %d,%d, at %d,%d. bitmap_top=%d",
-				current_char_code, current_char_code, slot->advance.x >> 6, slot->advance.y >> 6, cursor_x, cursor_y, slot->bitmap_top);
+				current_char_code, current_char_code, glyph->advance_x, glyph->advance_y, cursor_x, cursor_y, glyph->bitmap_top);
 			*/
 
 			// Increase pen position
-			cursor_x += slot->advance.x >> 6;
-			cursor_y += slot->advance.y >> 6;
+			cursor_x += glyph->advance_x;
+			cursor_y += glyph->advance_y;
 		}
 		token = strtok(NULL, "<>");
 		free(string_utf32);
@@ -991,11 +1479,18 @@ int spupng_export_string2png(struct spupng_t *sp, char *str, FILE *output)
 	*/
 
 	// Save image
-	write_image(buffer, output, canvas_width, canvas_height);
+	struct spupng_png_job *job = calloc(1, sizeof(struct spupng_png_job));
+	size_t size = canvas_width * canvas_height * sizeof(struct pixel_t);
+	if (!job || !(job->pixels = malloc(size)))
+	{
+		fatal(EXIT_NOT_ENOUGH_MEMORY, "In spupng_export_string2png: Out of memory allocating image. Need %lu bytes.",
+		      (unsigned long)size);
+	}
+	memcpy(job->pixels, buffer, size);
+	job->w = canvas_width;
+	job->h = canvas_height;
+	spupng_save_image(sp, job);
 	free(tmp);
-	free(buffer);
-	FT_Done_Face(face_regular);
-	FT_Done_Face(face_italics);
 	return 1;
 }
 
@@ -1084,21 +1579,10 @@ int eia608_to_str(struct encoder_ctx *context, struct eia608_screen *data, char
 int spupng_write_string(struct spupng_t *sp, char *string, LLONG start_time, LLONG end_time,
 			struct encoder_ctx *context)
 {
-	inc_spupng_fileindex(sp);
-	if ((sp->fppng = fopen(sp->pngfile, "wb")) == NULL)
-	{
-		fatal(CCX_COMMON_EXIT_FILE_CREATION_FAILED, "Cannot open %s: %s\n",
-		      sp->pngfile, strerror(errno));
-	}
-
-	if (!spupng_export_string2png(sp, string, sp->fppng))
+	if (!spupng_export_string2png(sp, string))
 	{
-		// free(string_utf32);
-		fatal(CCX_COMMON_EXIT_FILE_CREATION_FAILED, "Cannot write %s: %s\n",
-		      sp->pngfile, strerror(errno));
+		fatal(CCX_COMMON_EXIT_FILE_CREATION_FAILED, "Cannot render %s\n", string);
 	}
-	// free(string_utf32);
-	fclose(sp->fppng);
 	write_sputag_open(sp, start_time, end_time);
 	write_spucomment(sp, string);
 	write_sputag_close(sp);
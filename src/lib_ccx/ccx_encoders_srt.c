@@ -7,9 +7,9 @@
 #include "ccextractor.h"
 
 /* Helper function to write SRT to a specific output file (issue #665 - teletext multi-page)
-   Takes output file descriptor and counter pointer as parameters */
+   Takes the output and counter pointer as parameters */
 static int write_stringz_as_srt_to_output(char *string, struct encoder_ctx *context, LLONG ms_start, LLONG ms_end,
-					  int out_fh, unsigned int *srt_counter)
+					  struct ccx_s_write *out, unsigned int *srt_counter)
 {
 	int used;
 	unsigned h1, m1, s1, ms1;
@@ -24,14 +24,14 @@ static int write_stringz_as_srt_to_output(char *string, struct encoder_ctx *cont
 	(*srt_counter)++;
 	snprintf(timeline, sizeof(timeline), "%u%s", *srt_counter, context->encoded_crlf);
 	used = encode_line(context, context->buffer, (unsigned char *)timeline);
-	write_wrapped(out_fh, context->buffer, used);
+	write_output_wrapped(out, context->buffer, used);
 	snprintf(timeline, sizeof(timeline), "%02u:%02u:%02u,%03u --> %02u:%02u:%02u,%03u%s",
 		 h1, m1, s1, ms1, h2, m2, s2, ms2, context->encoded_crlf);
 	used = encode_line(context, context->buffer, (unsigned char *)timeline);
 	dbg_print(CCX_DMT_DECODER_608, "\n- - - SRT caption - - -\n");
 	dbg_print(CCX_DMT_DECODER_608, "%s", timeline);
 
-	write_wrapped(out_fh, context->buffer, used);
+	write_output_wrapped(out, context->buffer, used);
 	int len = strlen(string);
 	unsigned char *unescaped = (unsigned char *)malloc(len + 1);
 	if (!unescaped)
@@ -70,14 +70,14 @@ static int write_stringz_as_srt_to_output(char *string, struct encoder_ctx *cont
 			dbg_print(CCX_DMT_DECODER_608, "\r");
 			dbg_print(CCX_DMT_DECODER_608, "%s\n", context->subline);
 		}
-		write_wrapped(out_fh, el, u);
-		write_wrapped(out_fh, context->encoded_crlf, context->encoded_crlf_length);
+		write_output_wrapped(out, el, u);
+		write_output_wrapped(out, context->encoded_crlf, context->encoded_crlf_length);
 		begin += strlen((const char *)begin) + 1;
 	}
 
 	dbg_print(CCX_DMT_DECODER_608, "- - - - - - - - - - - -\r\n");
 
-	write_wrapped(out_fh, context->encoded_crlf, context->encoded_crlf_length);
+	write_output_wrapped(out, context->encoded_crlf, context->encoded_crlf_length);
 	free(el);
 	free(unescaped);
 
@@ -89,7 +89,7 @@ static int write_stringz_as_srt_to_output(char *string, struct encoder_ctx *cont
 int write_stringz_as_srt(char *string, struct encoder_ctx *context, LLONG ms_start, LLONG ms_end)
 {
 	return write_stringz_as_srt_to_output(string, context, ms_start, ms_end,
-					      context->out->fh, &context->srt_counter);
+					      context->out, &context->srt_counter);
 }
 
 int write_cc_bitmap_as_srt(struct cc_subtitle *sub, struct encoder_ctx *context)
@@ -128,14 +128,14 @@ int write_cc_bitmap_as_srt(struct cc_subtitle *sub, struct encoder_ctx *context)
 				context->srt_counter++;
 				snprintf(timeline, sizeof(timeline), "%u%s", context->srt_counter, context->encoded_crlf);
 				used = encode_line(context, context->buffer, (unsigned char *)timeline);
-				write_wrapped(context->out->fh, context->buffer, used);
+				write_output_wrapped(context->out, context->buffer, used);
 				snprintf(timeline, sizeof(timeline), "%02u:%02u:%02u,%03u --> %02u:%02u:%02u,%03u%s",
 					 h1, m1, s1, ms1, h2, m2, s2, ms2, context->encoded_crlf);
 				used = encode_line(context, context->buffer, (unsigned char *)timeline);
-				write_wrapped(context->out->fh, context->buffer, used);
+				write_output_wrapped(context->out, context->buffer, used);
 				len = strlen(str);
-				write_wrapped(context->out->fh, str, len);
-				write_wrapped(context->out->fh, context->encoded_crlf, context->encoded_crlf_length);
+				write_output_wrapped(context->out, str, len);
+				write_output_wrapped(context->out, context->encoded_crlf, context->encoded_crlf_length);
 			}
 			freep(&str);
 		}
@@ -170,7 +170,7 @@ int write_cc_subtitle_as_srt(struct cc_subtitle *sub, struct encoder_ctx *contex
 			if (out && counter)
 			{
 				ret = write_stringz_as_srt_to_output(sub->data, context, sub->start_time, sub->end_time,
-								     out->fh, counter);
+								     out, counter);
 			}
 			else
 			{
@@ -223,12 +223,12 @@ int write_cc_buffer_as_srt(struct eia608_screen *data, struct encoder_ctx *conte
 	++context->srt_counter;
 	snprintf(timeline, sizeof(timeline), "%u%s", context->srt_counter, context->encoded_crlf);
 	used = encode_line(context, context->buffer, (unsigned char *)timeline);
-	write_wrapped(context->out->fh, context->buffer, used);
+	write_output_wrapped(context->out, context->buffer, used);
 
 	snprintf(timeline, sizeof(timeline), "%02u:%02u:%02u,%03u --> %02u:%02u:%02u,%03u%s",
 		 h1, m1, s1, ms1, h2, m2, s2, ms2, context->encoded_crlf);
 	used = encode_line(context, context->buffer, (unsigned char *)timeline);
-	write_wrapped(context->out->fh, context->buffer, used);
+	write_output_wrapped(context->out, context->buffer, used);
 
 	dbg_print(CCX_DMT_DECODER_608, "\n- - - SRT caption ( %d) - - -\n", context->srt_counter);
 	dbg_print(CCX_DMT_DECODER_608, "%s", timeline);
@@ -287,7 +287,7 @@ int write_cc_buffer_as_srt(struct eia608_screen *data, struct encoder_ctx *conte
 					do_dash = 0;
 
 				if (do_dash)
-					write_wrapped(context->out->fh, "- ", 2);
+					write_output_wrapped(context->out, "- ", 2);
 				prev_line_start = first;
 				prev_line_end = last;
 				prev_line_center1 = center1;
@@ -299,8 +299,8 @@ int write_cc_buffer_as_srt(struct eia608_screen *data, struct encoder_ctx *conte
 				dbg_print(CCX_DMT_DECODER_608, "\r");
 				dbg_print(CCX_DMT_DECODER_608, "%s\n", context->subline);
 			}
-			write_wrapped(context->out->fh, context->subline, length);
-			write_wrapped(context->out->fh, context->encoded_crlf, context->encoded_crlf_length);
+			write_output_wrapped(context->out, context->subline, length);
+			write_output_wrapped(context->out, context->encoded_crlf, context->encoded_crlf_length);
 			wrote_something = 1;
 			// fprintf (wb->fh,context->encoded_crlf);
 		}
@@ -308,7 +308,7 @@ int write_cc_buffer_as_srt(struct eia608_screen *data, struct encoder_ctx *conte
 	dbg_print(CCX_DMT_DECODER_608, "- - - - - - - - - - - -\r\n");
 
 	// fprintf (wb->fh, context->encoded_crlf);
-	write_wrapped(context->out->fh, context->encoded_crlf, context->encoded_crlf_length);
+	write_output_wrapped(context->out, context->encoded_crlf, context->encoded_crlf_length);
 	// printf("$ = %s\n",context->encoded_crlf);
 	return wrote_something;
 }
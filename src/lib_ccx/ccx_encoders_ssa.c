@@ -24,7 +24,7 @@ int write_stringz_as_ssa(char *string, struct encoder_ctx *context, LLONG ms_sta
 	dbg_print(CCX_DMT_DECODER_608, "\n- - - ASS/SSA caption - - -\n");
 	dbg_print(CCX_DMT_DECODER_608, "%s", timeline);
 
-	write_wrapped(context->out->fh, context->buffer, used);
+	write_output_wrapped(context->out, context->buffer, used);
 	int len = strlen(string);
 	unsigned char *unescaped = (unsigned char *)malloc(len + 1);
 	if (!unescaped)
@@ -63,14 +63,14 @@ int write_stringz_as_ssa(char *string, struct encoder_ctx *context, LLONG ms_sta
 			dbg_print(CCX_DMT_DECODER_608, "\r");
 			dbg_print(CCX_DMT_DECODER_608, "%s\n", context->subline);
 		}
-		write_wrapped(context->out->fh, el, u);
-		write_wrapped(context->out->fh, "\\N", 2);
+		write_output_wrapped(context->out, el, u);
+		write_output_wrapped(context->out, "\\N", 2);
 		begin += strlen((const char *)begin) + 1;
 	}
 
 	dbg_print(CCX_DMT_DECODER_608, "- - - - - - - - - - - -\r\n");
 
-	write_wrapped(context->out->fh, context->encoded_crlf, context->encoded_crlf_length);
+	write_output_wrapped(context->out, context->encoded_crlf, context->encoded_crlf_length);
 	free(el);
 	free(unescaped);
 
@@ -118,9 +118,9 @@ int write_cc_bitmap_as_ssa(struct cc_subtitle *sub, struct encoder_ctx *context)
 			snprintf(timeline, sizeof(timeline), "Dialogue: 0,%02u:%02u:%02u.%01u,%02u:%02u:%02u.%02u,Default,,0000,0000,0000,,",
 				 h1, m1, s1, ms1 / 10, h2, m2, s2, ms2 / 10);
 			used = encode_line(context, context->buffer, (unsigned char *)timeline);
-			write_wrapped(context->out->fh, context->buffer, used);
-			write_wrapped(context->out->fh, str, len);
-			write_wrapped(context->out->fh, context->encoded_crlf, context->encoded_crlf_length);
+			write_output_wrapped(context->out, context->buffer, used);
+			write_output_wrapped(context->out, str, len);
+			write_output_wrapped(context->out, context->encoded_crlf, context->encoded_crlf_length);
 		}
 		freep(&str);
 	}
@@ -193,7 +193,7 @@ int write_cc_buffer_as_ssa(struct eia608_screen *data, struct encoder_ctx *conte
 	dbg_print(CCX_DMT_DECODER_608, "\n- - - ASS/SSA caption - - -\n");
 	dbg_print(CCX_DMT_DECODER_608, "%s", timeline);
 
-	write_wrapped(context->out->fh, context->buffer, used);
+	write_output_wrapped(context->out, context->buffer, used);
 	int line_count = 0;
 	for (int i = 0; i < 15; i++)
 	{
@@ -249,7 +249,7 @@ int write_cc_buffer_as_ssa(struct eia608_screen *data, struct encoder_ctx *conte
 					do_dash = 0;
 
 				if (do_dash)
-					write_wrapped(context->out->fh, "- ", 2);
+					write_output_wrapped(context->out, "- ", 2);
 				prev_line_start = first;
 				prev_line_end = last;
 				prev_line_center1 = center1;
@@ -263,9 +263,9 @@ int write_cc_buffer_as_ssa(struct eia608_screen *data, struct encoder_ctx *conte
 			}
 			if (line_count)
 			{
-				write_wrapped(context->out->fh, "\\N", 2);
+				write_output_wrapped(context->out, "\\N", 2);
 			}
-			write_wrapped(context->out->fh, context->subline, length);
+			write_output_wrapped(context->out, context->subline, length);
 			line_count++;
 			wrote_something = 1;
 		}
@@ -273,6 +273,6 @@ int write_cc_buffer_as_ssa(struct eia608_screen *data, struct encoder_ctx *conte
 
 	dbg_print(CCX_DMT_DECODER_608, "- - - - - - - - - - - -\r\n");
 
-	write_wrapped(context->out->fh, context->encoded_crlf, context->encoded_crlf_length);
+	write_output_wrapped(context->out, context->encoded_crlf, context->encoded_crlf_length);
 	return wrote_something;
 }
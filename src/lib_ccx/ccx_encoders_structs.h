@@ -1,6 +1,15 @@
 #ifndef CCX_ENCODERS_STRUCTS_H
 #define CCX_ENCODERS_STRUCTS_H
 
+#include <stddef.h>
+
+struct cc_subtitle;
+
+// Receives encoded output instead of a file when a library user sets it
+typedef void (*ccx_output_callback)(void *opaque, const unsigned char *data, size_t length);
+// Receives every subtitle an encoder gets, before it is encoded
+typedef void (*ccx_subtitle_callback)(void *opaque, struct cc_subtitle *sub);
+
 typedef struct ccx_encoders_transcript_format
 {
 	// TODO: add more options, and (perhaps) reduce other ccextractor options?
@@ -27,6 +36,8 @@ struct ccx_s_write
 	char *playlist_filename;
 	int renaming_extension; // Used for file rotations
 	int append_mode;	/* Append the file. Prevent overwriting of files */
+	ccx_output_callback callback; // If set, output goes here and fh is -1
+	void *callback_opaque;
 };
 
 struct spupng_t
@@ -39,6 +50,8 @@ struct spupng_t
 	int fileIndex;
 	int xOffset;
 	int yOffset;
+	struct spupng_text_renderer *renderer; // Fonts and glyph cache for text, set up on first use
+	struct spupng_png_writer *png_writer;	// Writes the images, set up on first use
 };
 
 #endif
@@ -34,7 +34,7 @@ int write_cc_bitmap_as_transcript(struct cc_subtitle *sub, struct encoder_ctx *c
 				if (context->transcript_settings->relativeTimestamp)
 				{
 					millis_to_date(sub->start_time, buf1, context->date_format, context->millis_separator);
-					fdprintf(context->out->fh, "%s|", buf1);
+					output_printf(context->out, "%s|", buf1);
 				}
 				else
 				{
@@ -42,7 +42,7 @@ int write_cc_bitmap_as_transcript(struct cc_subtitle *sub, struct encoder_ctx *c
 					int start_time_dec = sub->start_time % 1000;
 					struct tm *start_time_struct = gmtime(&start_time_int);
 					strftime(buf1, sizeof(buf1), "%Y%m%d%H%M%S", start_time_struct);
-					fdprintf(context->out->fh, "%s%c%03d|", buf1, context->millis_separator, start_time_dec);
+					output_printf(context->out, "%s%c%03d|", buf1, context->millis_separator, start_time_dec);
 				}
 			}
 
@@ -52,7 +52,7 @@ int write_cc_bitmap_as_transcript(struct cc_subtitle *sub, struct encoder_ctx *c
 				if (context->transcript_settings->relativeTimestamp)
 				{
 					millis_to_date(sub->end_time, buf2, context->date_format, context->millis_separator);
-					fdprintf(context->out->fh, "%s|", buf2);
+					output_printf(context->out, "%s|", buf2);
 				}
 				else
 				{
@@ -60,16 +60,16 @@ int write_cc_bitmap_as_transcript(struct cc_subtitle *sub, struct encoder_ctx *c
 					int end_time_dec = sub->end_time % 1000;
 					struct tm *end_time_struct = gmtime(&end_time_int);
 					strftime(buf2, sizeof(buf2), "%Y%m%d%H%M%S", end_time_struct);
-					fdprintf(context->out->fh, "%s%c%03d|", buf2, context->millis_separator, end_time_dec);
+					output_printf(context->out, "%s%c%03d|", buf2, context->millis_separator, end_time_dec);
 				}
 			}
 			if (context->transcript_settings->showCC)
 			{
-				fdprintf(context->out->fh, "%s|", language[sub->lang_index]);
+				output_printf(context->out, "%s|", language[sub->lang_index]);
 			}
 			if (context->transcript_settings->showMode)
 			{
-				fdprintf(context->out->fh, "DVB|");
+				output_printf(context->out, "DVB|");
 			}
 
 			while (token)
@@ -77,22 +77,22 @@ int write_cc_bitmap_as_transcript(struct cc_subtitle *sub, struct encoder_ctx *c
 				char *newline_pos = strstr(token, context->encoded_crlf);
 				if (!newline_pos)
 				{
-					fdprintf(context->out->fh, "%s", token);
+					output_printf(context->out, "%s", token);
 					break;
 				}
 				else
 				{
 					while (token != newline_pos)
 					{
-						fdprintf(context->out->fh, "%c", *token);
+						output_printf(context->out, "%c", *token);
 						token++;
 					}
 					token += context->encoded_crlf_length;
-					fdprintf(context->out->fh, "%c", ' ');
+					output_printf(context->out, "%c", ' ');
 				}
 			}
 
-			write_wrapped(context->out->fh, context->encoded_crlf, context->encoded_crlf_length);
+			write_output_wrapped(context->out, context->encoded_crlf, context->encoded_crlf_length);
 		}
 	}
 #endif
@@ -152,7 +152,7 @@ int write_cc_subtitle_as_transcript(struct cc_subtitle *sub, struct encoder_ctx
 				if (context->transcript_settings->relativeTimestamp)
 				{
 					millis_to_date(start_time, buf, context->date_format, context->millis_separator);
-					fdprintf(context->out->fh, "%s|", buf);
+					output_printf(context->out, "%s|", buf);
 				}
 				else
 				{
@@ -160,7 +160,7 @@ int write_cc_subtitle_as_transcript(struct cc_subtitle *sub, struct encoder_ctx
 					int start_time_dec = start_time % 1000;
 					struct tm *start_time_struct = gmtime(&start_time_int);
 					strftime(buf, sizeof(buf), "%Y%m%d%H%M%S", start_time_struct);
-					fdprintf(context->out->fh, "%s%c%03d|", buf, context->millis_separator, start_time_dec);
+					output_printf(context->out, "%s%c%03d|", buf, context->millis_separator, start_time_dec);
 				}
 			}
 
@@ -170,7 +170,7 @@ int write_cc_subtitle_as_transcript(struct cc_subtitle *sub, struct encoder_ctx
 				if (context->transcript_settings->relativeTimestamp)
 				{
 					millis_to_date(end_time, buf, context->date_format, context->millis_separator);
-					fdprintf(context->out->fh, "%s|", buf);
+					output_printf(context->out, "%s|", buf);
 				}
 				else
 				{
@@ -178,32 +178,32 @@ int write_cc_subtitle_as_transcript(struct cc_subtitle *sub, struct encoder_ctx
 					int end_time_dec = end_time % 1000;
 					struct tm *end_time_struct = gmtime(&end_time_int);
 					strftime(buf, sizeof(buf), "%Y%m%d%H%M%S", end_time_struct);
-					fdprintf(context->out->fh, "%s%c%03d|", buf, context->millis_separator, end_time_dec);
+					output_printf(context->out, "%s%c%03d|", buf, context->millis_separator, end_time_dec);
 				}
 			}
 
 			if (context->transcript_settings->showCC)
 			{
 				if (!context->ucla || !strcmp(sub->mode, "TLT"))
-					fdprintf(context->out->fh, sub->info);
+					output_printf(context->out, sub->info);
 				else if (context->in_fileformat == 1)
 					// TODO, data->my_field == 1 ? data->channel : data->channel + 2); // Data from field 2 is CC3 or 4
-					fdprintf(context->out->fh, "CC?|");
+					output_printf(context->out, "CC?|");
 			}
 			if (context->transcript_settings->showMode)
 			{
 				if (context->ucla && strcmp(sub->mode, "TLT") == 0)
-					fdprintf(context->out->fh, "|");
+					output_printf(context->out, "|");
 				else
-					fdprintf(context->out->fh, "%s|", sub->mode);
+					output_printf(context->out, "%s|", sub->mode);
 			}
-			ret = write(context->out->fh, context->subline, length);
+			ret = write_output(context->out, context->subline, length);
 			if (ret < length)
 			{
 				mprint("Warning:Loss of data\n");
 			}
 
-			ret = write(context->out->fh, context->encoded_crlf, context->encoded_crlf_length);
+			ret = write_output(context->out, context->encoded_crlf, context->encoded_crlf_length);
 			if (ret < context->encoded_crlf_length)
 			{
 				mprint("Warning:Loss of data\n");
@@ -255,7 +255,7 @@ void write_cc_line_as_transcript2(struct eia608_screen *data, struct encoder_ctx
 			if (context->transcript_settings->relativeTimestamp)
 			{
 				millis_to_date(data->start_time, buf1, context->date_format, context->millis_separator);
-				fdprintf(context->out->fh, "%s|", buf1);
+				output_printf(context->out, "%s|", buf1);
 			}
 			else
 			{
@@ -263,7 +263,7 @@ void write_cc_line_as_transcript2(struct eia608_screen *data, struct encoder_ctx
 				int start_time_dec = data->start_time % 1000;
 				struct tm *start_time_struct = gmtime(&start_time_int);
 				strftime(buf1, sizeof(buf1), "%Y%m%d%H%M%S", start_time_struct);
-				fdprintf(context->out->fh, "%s%c%03d|", buf1, context->millis_separator, start_time_dec);
+				output_printf(context->out, "%s%c%03d|", buf1, context->millis_separator, start_time_dec);
 			}
 		}
 
@@ -273,7 +273,7 @@ void write_cc_line_as_transcript2(struct eia608_screen *data, struct encoder_ctx
 			if (context->transcript_settings->relativeTimestamp)
 			{
 				millis_to_date(data->end_time, buf2, context->date_format, context->millis_separator);
-				fdprintf(context->out->fh, "%s|", buf2);
+				output_printf(context->out, "%s|", buf2);
 			}
 			else
 			{
@@ -281,13 +281,13 @@ void write_cc_line_as_transcript2(struct eia608_screen *data, struct encoder_ctx
 				int end_time_dec = data->end_time % 1000;
 				struct tm *end_time_struct = gmtime(&end_time_int);
 				strftime(buf2, sizeof(buf2), "%Y%m%d%H%M%S", end_time_struct);
-				fdprintf(context->out->fh, "%s%c%03d|", buf2, context->millis_separator, end_time_dec);
+				output_printf(context->out, "%s%c%03d|", buf2, context->millis_separator, end_time_dec);
 			}
 		}
 
 		if (context->transcript_settings->showCC)
 		{
-			fdprintf(context->out->fh, "CC%d|", data->my_field == 1 ? data->channel : data->channel + 2); // Data from field 2 is CC3 or 4
+			output_printf(context->out, "CC%d|", data->my_field == 1 ? data->channel : data->channel + 2); // Data from field 2 is CC3 or 4
 		}
 		if (context->transcript_settings->showMode)
 		{
@@ -316,16 +316,16 @@ void write_cc_line_as_transcript2(struct eia608_screen *data, struct encoder_ctx
 					mode = "PAI";
 					break;
 			}
-			fdprintf(context->out->fh, "%s|", mode);
+			output_printf(context->out, "%s|", mode);
 		}
 
-		ret = write(context->out->fh, context->subline, length);
+		ret = write_output(context->out, context->subline, length);
 		if (ret < length)
 		{
 			mprint("Warning:Loss of data\n");
 		}
 
-		ret = write(context->out->fh, context->encoded_crlf, context->encoded_crlf_length);
+		ret = write_output(context->out, context->encoded_crlf, context->encoded_crlf_length);
 		if (ret < context->encoded_crlf_length)
 		{
 			mprint("Warning:Loss of data\n");
@@ -137,7 +137,7 @@ int write_stringz_as_webvtt(char *string, struct encoder_ctx *context, LLONG ms_
 	dbg_print(CCX_DMT_DECODER_608, "\n- - - WEBVTT caption - - -\n");
 	dbg_print(CCX_DMT_DECODER_608, "%s", timeline);
 
-	written = write(context->out->fh, context->buffer, used);
+	written = write_output(context->out, context->buffer, used);
 	if (written != used)
 		return -1;
 	int len = strlen(string);
@@ -178,14 +178,14 @@ int write_stringz_as_webvtt(char *string, struct encoder_ctx *context, LLONG ms_
 			dbg_print(CCX_DMT_DECODER_608, "\r");
 			dbg_print(CCX_DMT_DECODER_608, "%s\n", context->subline);
 		}
-		written = write(context->out->fh, el, u);
+		written = write_output(context->out, el, u);
 		if (written != u)
 		{
 			free(el);
 			free(unescaped);
 			return -1;
 		}
-		written = write(context->out->fh, context->encoded_crlf, context->encoded_crlf_length);
+		written = write_output(context->out, context->encoded_crlf, context->encoded_crlf_length);
 		if (written != context->encoded_crlf_length)
 		{
 			free(el);
@@ -196,7 +196,7 @@ int write_stringz_as_webvtt(char *string, struct encoder_ctx *context, LLONG ms_
 
 	dbg_print(CCX_DMT_DECODER_608, "- - - - - - - - - - - -\r\n");
 
-	written = write(context->out->fh, context->encoded_crlf, context->encoded_crlf_length);
+	written = write_output(context->out, context->encoded_crlf, context->encoded_crlf_length);
 	free(el);
 	free(unescaped);
 	if (written != context->encoded_crlf_length)
@@ -225,18 +225,18 @@ void write_webvtt_header(struct encoder_ctx *context)
 			 ccx_options.enc_cfg.line_terminator_lf ? "\n\n" : "\r\n\r\n");
 
 		used = encode_line(context, context->buffer, (unsigned char *)header_string);
-		write_wrapped(context->out->fh, context->buffer, used);
+		write_output_wrapped(context->out, context->buffer, used);
 	}
 	else
 	{
 		// Must have another newline if X-TIMESTAMP-MAP is not used
 		if (ccx_options.enc_cfg.line_terminator_lf == 1) // If -lf parameter is set.
 		{
-			write_wrapped(context->out->fh, "\n", 1);
+			write_output_wrapped(context->out, "\n", 1);
 		}
 		else
 		{
-			write_wrapped(context->out->fh, "\r\n", 2);
+			write_output_wrapped(context->out, "\r\n", 2);
 		}
 	}
 
@@ -269,23 +269,23 @@ void write_webvtt_header(struct encoder_ctx *context)
 			fatal(EXIT_NOT_ENOUGH_MEMORY, "In write_webvtt_header: Out of memory allocating outline_css_file.");
 		}
 		snprintf(outline_css_file, outline_css_file_size, webvtt_outline_css, css_file_name);
-		write_wrapped(context->out->fh, outline_css_file, strlen(outline_css_file));
+		write_output_wrapped(context->out, outline_css_file, strlen(outline_css_file));
 		free(css_file_name);
 		free(outline_css_file);
 	}
 	else if (ccx_options.use_webvtt_styling)
 	{
-		write_wrapped(context->out->fh, webvtt_inline_css, strlen(webvtt_inline_css));
+		write_output_wrapped(context->out, webvtt_inline_css, strlen(webvtt_inline_css));
 		if (ccx_options.enc_cfg.line_terminator_lf == 1) // If -lf parameter is set.
 		{
-			write_wrapped(context->out->fh, "\n", 1);
+			write_output_wrapped(context->out, "\n", 1);
 		}
 		else
 		{
-			write_wrapped(context->out->fh, "\r\n", 2);
+			write_output_wrapped(context->out, "\r\n", 2);
 		}
-		write_wrapped(context->out->fh, "##\n", 3);
-		write_wrapped(context->out->fh, context->encoded_crlf, context->encoded_crlf_length);
+		write_output_wrapped(context->out, "##\n", 3);
+		write_output_wrapped(context->out, context->encoded_crlf, context->encoded_crlf_length);
 	}
 
 	context->wrote_webvtt_header = 1; // Do it even if couldn't write the header, because it won't be possible anyway
@@ -323,10 +323,10 @@ int write_cc_bitmap_as_webvtt(struct cc_subtitle *sub, struct encoder_ctx *conte
 			snprintf(timeline, sizeof(timeline), "%02u:%02u:%02u.%03u --> %02u:%02u:%02u.%03u%s",
 				 h1, m1, s1, ms1, h2, m2, s2, ms2, context->encoded_crlf);
 			used = encode_line(context, context->buffer, (unsigned char *)timeline);
-			write_wrapped(context->out->fh, context->buffer, used);
+			write_output_wrapped(context->out, context->buffer, used);
 			len = strlen(str);
-			write_wrapped(context->out->fh, str, len);
-			write_wrapped(context->out->fh, context->encoded_crlf, context->encoded_crlf_length);
+			write_output_wrapped(context->out, str, len);
+			write_output_wrapped(context->out, context->encoded_crlf, context->encoded_crlf_length);
 		}
 		freep(&str);
 	}
@@ -461,7 +461,7 @@ int write_cc_buffer_as_webvtt(struct eia608_screen *data, struct encoder_ctx *co
 
 			dbg_print(CCX_DMT_DECODER_608, "\n- - - WEBVTT caption - - -\n");
 			dbg_print(CCX_DMT_DECODER_608, "%s", timeline);
-			written = write(context->out->fh, context->buffer, used);
+			written = write_output(context->out, context->buffer, used);
 			if (written != used)
 				return -1;
 
@@ -501,18 +501,18 @@ int write_cc_buffer_as_webvtt(struct eia608_screen *data, struct encoder_ctx *co
 					if (open_font != FONT_REGULAR)
 					{
 						if (open_font & FONT_ITALICS)
-							write_wrapped(context->out->fh, strdup("<i>"), 3);
+							write_output_wrapped(context->out, strdup("<i>"), 3);
 						if (open_font & FONT_UNDERLINED)
-							write_wrapped(context->out->fh, strdup("<u>"), 3);
+							write_output_wrapped(context->out, strdup("<u>"), 3);
 					}
 
 					// opening events for colors
 					int open_color = color_events[j] & 0xFF; // Last 16 bytes
 					if (open_color != COL_WHITE)
 					{
-						write_wrapped(context->out->fh, strdup("<c."), 3);
-						write_wrapped(context->out->fh, color_text[open_color][0], strlen(color_text[open_color][0]));
-						write_wrapped(context->out->fh, ">", 1);
+						write_output_wrapped(context->out, strdup("<c."), 3);
+						write_output_wrapped(context->out, color_text[open_color][0], strlen(color_text[open_color][0]));
+						write_output_wrapped(context->out, ">", 1);
 					}
 				}
 
@@ -522,7 +522,7 @@ int write_cc_buffer_as_webvtt(struct eia608_screen *data, struct encoder_ctx *co
 					unsigned char buf[5] = {0};
 					// Note: reference should be safe even when j == COLUMNS; characters is nul-terminated
 					int bytes = get_char_in_utf_8(buf, data->characters[i][j]);
-					write_wrapped(context->out->fh, buf, bytes);
+					write_output_wrapped(context->out, buf, bytes);
 				}
 
 				if (ccx_options.use_webvtt_styling)
@@ -531,7 +531,7 @@ int write_cc_buffer_as_webvtt(struct eia608_screen *data, struct encoder_ctx *co
 					int close_color = color_events[j] >> 16; // First 16 bytes
 					if (close_color != COL_WHITE)
 					{
-						write_wrapped(context->out->fh, strdup("</c>"), 4);
+						write_output_wrapped(context->out, strdup("</c>"), 4);
 					}
 
 					// closing events for fonts
@@ -539,9 +539,9 @@ int write_cc_buffer_as_webvtt(struct eia608_screen *data, struct encoder_ctx *co
 					if (close_font != FONT_REGULAR)
 					{
 						if (close_font & FONT_UNDERLINED)
-							write_wrapped(context->out->fh, strdup("</u>"), 4);
+							write_output_wrapped(context->out, strdup("</u>"), 4);
 						if (close_font & FONT_ITALICS)
-							write_wrapped(context->out->fh, strdup("</i>"), 4);
+							write_output_wrapped(context->out, strdup("</i>"), 4);
 					}
 				}
 			}
@@ -552,12 +552,12 @@ int write_cc_buffer_as_webvtt(struct eia608_screen *data, struct encoder_ctx *co
 				free(font_events);
 			}
 
-			written = write(context->out->fh,
-					context->encoded_crlf, context->encoded_crlf_length);
+			written = write_output(context->out,
+					       context->encoded_crlf, context->encoded_crlf_length);
 			if (written != context->encoded_crlf_length)
 				return -1;
 
-			written = write(context->out->fh, context->encoded_crlf, context->encoded_crlf_length);
+			written = write_output(context->out, context->encoded_crlf, context->encoded_crlf_length);
 			if (written != context->encoded_crlf_length)
 				return -1;
 
@@ -2,5 +2,28 @@
 #define CXX_MP4_H
 
 int processmp4(struct lib_ccx_ctx *ctx, struct ccx_s_mp4Cfg *cfg, char *file);
+// Reads fragmented MP4 from the demuxer input, for stdin and other streams GPAC can't open
+int processmp4_stream(struct lib_ccx_ctx *ctx, struct ccx_s_mp4Cfg *cfg);
+// Whether file has to be read with processmp4_stream(): its moov announces movie fragments
+// (mvex), or no moov comes before the media data. 0 if it can't be read.
+int is_fragmented_mp4(const char *file);
 int dumpchapters(struct lib_ccx_ctx *ctx, struct ccx_s_mp4Cfg *cfg, char *file);
+
+// Walks the length prefixed NAL units of an AVC or HEVC sample: length bytes in data, or,
+// if data is NULL, at offset of fd, where only the parts do_NAL() looks at are read into buf.
+struct mp4_nal_reader
+{
+	int fd;
+	const unsigned char *data;
+	uint64_t offset;
+	uint32_t length;
+	uint32_t pos; // Position of the next NAL unit in the sample
+	unsigned char *buf;
+	uint32_t buf_size;
+};
+// Moves to the next NAL unit. On success *nal holds its first *used bytes, the ones do_NAL()
+// needs (0 if it should be skipped), and its header byte if *nal_length isn't 0.
+// Returns 1 for a NAL unit, 0 at the end of the sample and -1 if the sample is corrupt.
+int mp4_nal_reader_next(struct mp4_nal_reader *r, const char *caller, uint32_t nal_unit_size, int is_hevc,
+			unsigned char **nal, uint32_t *nal_length, uint32_t *used);
 #endif
@@ -0,0 +1,334 @@
+#include "lib_ccx.h"
+#include "ccx_common_option.h"
+#include "ccx_session.h"
+#include "ccx_demuxer.h"
+#include "utility.h"
+
+struct ccx_session
+{
+	struct lib_ccx_ctx *ctx;
+	enum ccx_session_input input;
+	int ended;
+
+	// What general_loop keeps between two pieces of data
+	struct demuxer_data *datalist;
+	struct demuxer_data *data_node;
+	struct lib_cc_decode *dec_ctx;
+	struct encoder_ctx *enc_ctx;
+	uint64_t min_pts;
+	int caps;
+
+	int got_first_pts;	       // cc_data input: the first frame is time zero
+	unsigned char cc_data[31 * 3]; // cc_data input: the caller's triplets, which the decoder may fix up
+};
+
+// Sessions that exist, which all read ccx_options and tlt_config as the first one set them up
+static int live_sessions = 0;
+static const struct ccx_s_options *sessions_opt = NULL;
+static ccx_static_lock sessions_lock = CCX_STATIC_LOCK_INIT;
+
+static void release_session(void)
+{
+	ccx_static_lock_acquire(&sessions_lock);
+	live_sessions--;
+	ccx_static_lock_release(&sessions_lock);
+}
+
+static void discard_output(void *opaque, const unsigned char *data, size_t length)
+{
+}
+
+// Turns the caller's options into ones that need no files
+static void session_options(void)
+{
+	ccx_options.inputfile = NULL;
+	ccx_options.num_input_files = 0;
+	if (!ccx_options.output_filename)
+		ccx_options.input_source = CCX_DS_NETWORK; // Only names the output base "network"
+	ccx_options.live_stream = 0;
+	ccx_options.multiprogram = 0;
+	ccx_options.out_interval = -1;
+	ccx_options.cc_to_stdout = 0;
+	ccx_options.send_to_srv = 0;
+	ccx_options.keep_output_closed = 0;
+	ccx_options.xmltv = 0;
+	ccx_options.settings_dtvcc.enabled = 0;
+
+	// The parameter parser copies these into the encoder configuration
+	struct encoder_cfg *cfg = &ccx_options.enc_cfg;
+	cfg->extract = ccx_options.extract;
+	cfg->write_format = ccx_options.write_format;
+	cfg->date_format = ccx_options.date_format;
+	cfg->transcript_settings = ccx_options.transcript_settings;
+	cfg->subs_delay = ccx_options.subs_delay;
+
+	cfg->output_filename = NULL;
+	cfg->first_input_file = NULL;
+	cfg->multiple_files = 0;
+	cfg->cc_to_stdout = 0;
+	cfg->send_to_srv = 0;
+	cfg->keep_output_closed = 0;
+	cfg->dtvcc_extract = 0;
+	cfg->extract_only_708 = 0;
+	cfg->nb_extra_write_formats = 0;
+
+	// And these into the teletext configuration
+	tlt_config.dolevdist = ccx_options.dolevdist;
+	tlt_config.levdistmincnt = ccx_options.levdistmincnt;
+	tlt_config.levdistmaxpct = ccx_options.levdistmaxpct;
+	tlt_config.extraction_start = ccx_options.extraction_start;
+	tlt_config.extraction_end = ccx_options.extraction_end;
+	tlt_config.write_format = ccx_options.write_format;
+	tlt_config.date_format = ccx_options.date_format;
+	tlt_config.noautotimeref = ccx_options.noautotimeref;
+	tlt_config.nofontcolor = ccx_options.nofontcolor;
+	tlt_config.nohtmlescape = ccx_options.nohtmlescape;
+}
+
+struct ccx_session *ccx_session_create(struct ccx_s_options *opt, enum ccx_session_input input,
+				       const struct ccx_session_callbacks *callbacks)
+{
+	struct ccx_session *session;
+	struct ccx_demuxer *demux;
+
+	if (opt->write_format == CCX_OF_SPUPNG || opt->write_format == CCX_OF_CURL)
+	{
+		mprint("ccx_session_create: This output format can't be sent to a callback.\n");
+		return NULL;
+	}
+
+	session = calloc(1, sizeof(struct ccx_session));
+	if (!session)
+		return NULL;
+	session->input = input;
+	session->min_pts = UINT64_MAX;
+
+	// Other sessions may be reading the options right now, so only the first one sets them
+	ccx_static_lock_acquire(&sessions_lock);
+	if (!live_sessions)
+	{
+		if (opt != &ccx_options)
+			ccx_options = *opt;
+		session_options();
+		sessions_opt = opt;
+	}
+	else if (opt != sessions_opt && opt != &ccx_options)
+	{
+		ccx_static_lock_release(&sessions_lock);
+		mprint("ccx_session_create: Sessions that exist at the same time must share their options.\n");
+		free(session);
+		return NULL;
+	}
+	live_sessions++;
+	ccx_static_lock_release(&sessions_lock);
+
+	session->ctx = init_libraries(&ccx_options);
+	if (!session->ctx)
+	{
+		release_session();
+		free(session);
+		return NULL;
+	}
+
+	// Set even without an output callback, so that no file gets opened
+	struct encoder_cfg *cfg = &session->ctx->enc_cfg;
+	cfg->output_callback = callbacks->output ? callbacks->output : discard_output;
+	cfg->subtitle_callback = callbacks->subtitle;
+	cfg->callback_opaque = callbacks->opaque;
+
+	demux = session->ctx->demux_ctx;
+	if (init_file_buffer(demux) < 0)
+	{
+		dinit_libraries(&session->ctx);
+		release_session();
+		free(session);
+		return NULL;
+	}
+	demux->push_input = 1;
+	demux->stream_mode = input == CCX_SESSION_INPUT_TS ? CCX_SM_TRANSPORT : CCX_SM_ELEMENTARY_OR_NOT_FOUND;
+
+	return session;
+}
+
+// Runs what the demuxer collected through the decoders, like an iteration of general_loop
+static void session_process(struct ccx_session *session, int ret)
+{
+	if (!session->datalist || is_decoder_processed_enough(session->ctx) == CCX_TRUE)
+		return;
+
+	process_non_multiprogram_general_loop(session->ctx, &session->datalist, &session->data_node,
+					      &session->dec_ctx, &session->enc_ctx, &session->min_pts, ret, &session->caps);
+}
+
+static int session_feed_ts(struct ccx_session *session, const unsigned char *data, size_t length)
+{
+	struct ccx_demuxer *demux = session->ctx->demux_ctx;
+	unsigned int packet_size = demux->m2ts ? 192 : 188;
+
+	while (length)
+	{
+		// Move the partial packet left by the last chunk to the start of the buffer
+		unsigned int left = demux->bytesinbuffer - demux->filebuffer_pos;
+		memmove(demux->filebuffer, demux->filebuffer + demux->filebuffer_pos, left);
+		demux->filebuffer_start += demux->filebuffer_pos;
+		demux->filebuffer_pos = 0;
+		demux->bytesinbuffer = left;
+
+		size_t taken = FILEBUFFERSIZE - left;
+		if (taken > length)
+			taken = length;
+		memcpy(demux->filebuffer + left, data, taken);
+		demux->bytesinbuffer += taken;
+		data += taken;
+		length -= taken;
+
+		// ts_readpacket() returns CCX_EAGAIN instead of reading past the pushed data
+		while (demux->bytesinbuffer - demux->filebuffer_pos >= packet_size)
+		{
+			int ret = ts_readstream(demux, &session->datalist);
+			session_process(session, ret);
+		}
+	}
+	return CCX_OK;
+}
+
+static int session_feed_pes(struct ccx_session *session, const unsigned char *data, size_t length)
+{
+	unsigned char header[6 + 3 + 255]; // Longest possible PES header
+	size_t header_bytes = length < sizeof(header) ? length : sizeof(header);
+	int headerlength;
+
+	if (length < 9 || data[0] != 0x00 || data[1] != 0x00 || data[2] != 0x01 || (data[3] & 0xf0) != 0xe0)
+	{
+		mprint("ccx_session_feed: Not a video PES packet.\n");
+		return CCX_EINVAL;
+	}
+
+	if (!session->datalist)
+	{
+		session->datalist = alloc_demuxer_data();
+		if (!session->datalist)
+			fatal(EXIT_NOT_ENOUGH_MEMORY, "In ccx_session_feed: Out of memory allocating the PES data.");
+		session->datalist->bufferdatatype = session->input == CCX_SESSION_INPUT_PES_H264 ? CCX_H264 : CCX_PES;
+	}
+
+	struct demuxer_data *node = session->datalist;
+	memcpy(header, data, header_bytes);
+	if (read_video_pes_header(session->ctx->demux_ctx, node, header, &headerlength, (int)header_bytes) < 0)
+	{
+		mprint("ccx_session_feed: Incomplete PES header.\n");
+		return CCX_EINVAL;
+	}
+
+	// Video the decoder couldn't finish yet stays in front of the new payload
+	size_t payload = length - headerlength;
+	if (node->len + payload >= BUFSIZE)
+	{
+		mprint("ccx_session_feed: PES packet too large (%zu bytes).\n", payload);
+		return CCX_EINVAL;
+	}
+	memcpy(node->buffer + node->len, data + headerlength, payload);
+	node->len += payload;
+
+	session_process(session, CCX_OK);
+	return CCX_OK;
+}
+
+int ccx_session_feed(struct ccx_session *session, const unsigned char *data, size_t length)
+{
+	if (session->ended)
+		return CCX_EINVAL;
+
+	switch (session->input)
+	{
+		case CCX_SESSION_INPUT_TS:
+			return session_feed_ts(session, data, length);
+		case CCX_SESSION_INPUT_PES_MPEG2:
+		case CCX_SESSION_INPUT_PES_H264:
+			return session_feed_pes(session, data, length);
+		default:
+			return CCX_EINVAL;
+	}
+}
+
+int ccx_session_feed_cc_data(struct ccx_session *session, const unsigned char *data, int cc_count, LLONG pts)
+{
+	struct lib_cc_decode *dec_ctx;
+	struct encoder_ctx *enc_ctx;
+
+	if (session->ended || session->input != CCX_SESSION_INPUT_CC_DATA || cc_count < 0 || cc_count > 31)
+		return CCX_EINVAL;
+	if (is_decoder_processed_enough(session->ctx) == CCX_TRUE)
+		return CCX_OK;
+
+	dec_ctx = update_decoder_list(session->ctx);
+	enc_ctx = update_encoder_list(session->ctx);
+#ifndef DISABLE_RUST
+	ccxr_dtvcc_set_encoder(dec_ctx->dtvcc_rust, enc_ctx);
+#else
+	dec_ctx->dtvcc->encoder = (void *)enc_ctx;
+#endif
+	if (enc_ctx)
+		enc_ctx->timing = dec_ctx->timing;
+
+	if (!session->got_first_pts)
+	{
+		// Like rcwt_loop, the times are known so min_pts is set right away
+		dec_ctx->timing->min_pts = pts;
+		dec_ctx->timing->current_pts = pts;
+		dec_ctx->timing->pts_set = 2; // MinPtsSet
+		session->got_first_pts = 1;
+	}
+
+	// A whole frame at its PTS, as the cc_data the video decoders take out of PES
+	dec_ctx->in_bufferdatatype = CCX_PES;
+	set_current_pts(dec_ctx->timing, pts);
+	set_fts(dec_ctx->timing);
+	memcpy(session->cc_data, data, cc_count * 3);
+	process_cc_data(enc_ctx, dec_ctx, session->cc_data, cc_count, dec_ctx->timing->fts_now, &dec_ctx->dec_sub);
+	if (dec_ctx->dec_sub.got_output)
+	{
+		encode_sub(enc_ctx, &dec_ctx->dec_sub);
+		dec_ctx->dec_sub.got_output = 0;
+	}
+	return CCX_OK;
+}
+
+void ccx_session_end(struct ccx_session *session)
+{
+	struct lib_cc_decode *dec_ctx;
+
+	if (session->ended)
+		return;
+	session->ended = 1;
+
+	// Makes process_non_multiprogram_general_loop() flush the last DVB subtitle
+	session->ctx->end_of_file = 1;
+	if (session->input == CCX_SESSION_INPUT_TS)
+	{
+		// PES packets still being collected, as at the end of a file
+		cinfo_cremation(session->ctx->demux_ctx, &session->datalist);
+		session_process(session, CCX_EOF);
+	}
+	delete_datalist(session->datalist);
+	session->datalist = NULL;
+
+	// The rest of the flushing and the footers are done by dinit_libraries()
+	list_for_each_entry(dec_ctx, &session->ctx->dec_ctx_head, list, struct lib_cc_decode)
+	{
+		if (dec_ctx->has_ccdata_buffered)
+			process_hdcc(get_encoder_by_pn(session->ctx, dec_ctx->program_number), dec_ctx, &dec_ctx->dec_sub);
+		freep(&dec_ctx->xds_ctx);
+	}
+	dinit_libraries(&session->ctx);
+	release_session();
+}
+
+void ccx_session_delete(struct ccx_session **session)
+{
+	if (!session || !*session)
+		return;
+
+	ccx_session_end(*session);
+	freep(session);
+}
@@ -0,0 +1,103 @@
+#ifndef CCX_SESSION_H
+#define CCX_SESSION_H
+
+#include "ccx_common_option.h"
+#include "ccx_decoders_structs.h"
+
+/*
+ * Library use without files: a session takes input that the caller already
+ * has in memory and hands the results to callbacks, instead of reading an
+ * input file and writing output files like start_ccx() does.
+ *
+ *	struct ccx_s_options opt;
+ *	init_options(&opt);
+ *	opt.write_format = CCX_OF_SRT;
+ *	struct ccx_session_callbacks cb = {.output = write_srt, .opaque = channel};
+ *	struct ccx_session *session = ccx_session_create(&opt, CCX_SESSION_INPUT_TS, &cb);
+ *	while (more input)
+ *		ccx_session_feed(session, chunk, length);
+ *	ccx_session_end(session);
+ *	ccx_session_delete(&session);
+ *
+ * Several sessions can exist at a time, each used by one thread at a time:
+ * every session has its own demuxer, decoders, timing and encoder. They
+ * share ccx_options and the teletext configuration, which the first session
+ * sets up from its options, so sessions that exist together must be created
+ * with the same opt. A server with several channels runs a session per
+ * channel in one process.
+ *
+ * CEA-708 services are written to files of their own and are not available
+ * through a session; SPUPNG and curl output are not either.
+ */
+
+enum ccx_session_input
+{
+	CCX_SESSION_INPUT_TS,	      // Transport stream (M2TS if opt->demux_cfg.m2ts), in chunks of any size
+	CCX_SESSION_INPUT_PES_MPEG2,  // MPEG-2 video PES packets, one whole packet per call
+	CCX_SESSION_INPUT_PES_H264,   // H.264 video PES packets, one whole packet per call
+	CCX_SESSION_INPUT_CC_DATA,    // cc_data triplets of a frame with its PTS, see ccx_session_feed_cc_data()
+};
+
+struct ccx_session_callbacks
+{
+	// Encoded output in opt->write_format, the file header arrives during
+	// ccx_session_create() and the footer during ccx_session_end(). May be NULL.
+	ccx_output_callback output;
+	// Every subtitle before it is encoded; sub and its data are only valid
+	// during the call. May be NULL.
+	ccx_subtitle_callback subtitle;
+	void *opaque; // Passed to both callbacks
+};
+
+struct ccx_session;
+
+/**
+ * Create a session
+ *
+ * @param opt options as init_options() or the parameter parser leave them,
+ *            copied into ccx_options when no other session exists. Input
+ *            files, output files, stdout and server output are ignored.
+ * @param input kind of data that will be fed
+ * @param callbacks where the results go
+ *
+ * @return the session, NULL if other sessions exist with different
+ *         options or the options can't be used without files
+ */
+struct ccx_session *ccx_session_create(struct ccx_s_options *opt, enum ccx_session_input input,
+				       const struct ccx_session_callbacks *callbacks);
+
+/**
+ * Feed transport stream bytes or one PES packet
+ *
+ * Callbacks are called from inside this function. A partial TS packet at
+ * the end of data is kept until the next call.
+ *
+ * @return CCX_OK, or CCX_EINVAL if data doesn't fit the session input
+ */
+int ccx_session_feed(struct ccx_session *session, const unsigned char *data, size_t length);
+
+/**
+ * Feed the cc_data of one frame, as in the user data of MPEG-2 and H.264 video
+ *
+ * @param data cc_count triplets of cc_valid/cc_type, cc_data_1, cc_data_2
+ * @param cc_count number of triplets, at most 31 as in the 5-bit cc_count field
+ * @param pts presentation time of the frame, 90 kHz
+ *
+ * @return CCX_OK, or CCX_EINVAL if the session doesn't take cc_data or
+ *         cc_count is out of range
+ */
+int ccx_session_feed_cc_data(struct ccx_session *session, const unsigned char *data, int cc_count, LLONG pts);
+
+/**
+ * End of input: flush the subtitles still on screen and write the footer
+ *
+ * Nothing can be fed afterwards.
+ */
+void ccx_session_end(struct ccx_session *session);
+
+/**
+ * Free a session, ending it first if ccx_session_end() wasn't called
+ */
+void ccx_session_delete(struct ccx_session **session);
+
+#endif
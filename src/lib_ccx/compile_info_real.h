@@ -0,0 +1,12 @@
+/*
+ * the configured options and settings for CCExtractor
+ */
+
+#ifndef CCX_CCEXTRACTOR_COMPILE_REAL_H
+#define CCX_CCEXTRACTOR_COMPILE_REAL_H
+#define GIT_COMMIT "778eb14b1601d221fcae84390698d98e5c249a6c"
+#define COMPILE_DATE "2026-10-18"
+#endif
+
+#define CCExtractor_VERSION_MAJOR "0"
+#define CCExtractor_VERSION_MINOR "89"
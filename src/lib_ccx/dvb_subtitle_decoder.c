@@ -156,12 +156,39 @@ typedef struct DVBSubRegion
 	uint8_t *pbuf;
 	int buf_size;
 	int dirty;
+	int changed; // Pixels modified since the region was last composed
 
 	DVBSubObjectDisplay *display_list;
 
 	struct DVBSubRegion *next;
 } DVBSubRegion;
 
+#define DVBSUB_MAX_COMPOSED_REGIONS 256
+
+/* The last page image composed by write_dvb_sub(). While the same regions are
+ * shown at the same places, only the regions whose pixels changed are copied
+ * into it again. */
+typedef struct DVBSubComposition
+{
+	uint8_t *buf;
+	int buf_size;
+
+	int x;
+	int y;
+	int width;
+	int height;
+
+	int nb_regions; // -1 if the buffer can't be updated in place
+	struct
+	{
+		int id;
+		int x_pos;
+		int y_pos;
+		int width;
+		int height;
+	} regions[DVBSUB_MAX_COMPOSED_REGIONS];
+} DVBSubComposition;
+
 typedef struct DVBSubDisplayDefinition
 {
 	int version;
@@ -190,6 +217,11 @@ typedef struct DVBSubContext
 
 	DVBSubRegionDisplay *display_list;
 	DVBSubDisplayDefinition *display_definition;
+	// Merged page image, updated in place from one display set to the next. Like the lists
+	// above, the memcpy() in dvbsub_handle_display_segment() shares it with the copy kept
+	// for the previous subtitle; only the live context owns it and frees it, in
+	// dvbsub_close_decoder(), as free_decoder_context() frees the copy shallowly.
+	DVBSubComposition *composition;
 } DVBSubContext;
 
 static __inline unsigned int bytestream_get_byte(const uint8_t **b)
@@ -203,83 +235,101 @@ static __inline unsigned int bytestream_get_be16(const uint8_t **b)
 	(*b) += 2;
 	return RB16(*b - 2);
 }
-typedef struct GetBitContext
+/* Run-length codes of the 2 and 4-bit/pixel code strings (ETSI EN 300 743
+ * 7.2.5.2). A code starting with a non-zero pixel code is a single pixel, the
+ * others are decoded by looking up the bits after their zero prefix: 14 bits
+ * for 2-bit strings, 12 for 4-bit ones, in the same 16 bits of lookahead.
+ * Each entry holds the length of the code after the prefix, the number of
+ * pixels (0 for the end of the string) and the pixel code. The longest 4-bit
+ * code doesn't fit, its pixel code is read separately. */
+#define RLE_BITS(e) ((e) & 0x1f)
+#define RLE_RUN(e) (((e) >> 5) & 0x1ff)
+#define RLE_CODE(e) (((e) >> 14) & 0xf)
+#define RLE_CODE_FOLLOWS (1 << 18)
+#define RLE_ENTRY(bits, run, code) ((bits) | ((run) << 5) | ((code) << 14))
+
+static uint32_t rle2_table[1 << 14];
+static uint32_t rle4_table[1 << 12];
+
+static void init_rle_tables(void)
 {
-	const uint8_t *buffer, *buffer_end;
-	int index;
-	int size_in_bits;
-	int size_in_bits_plus8;
-} GetBitContext;
+	static int initialized = 0;
+	uint32_t w;
 
-/**
- * Initialize GetBitContext.
- * @param buffer bitstream buffer, must be FF_INPUT_BUFFER_PADDING_SIZE bytes
- *        larger than the actual read bits because some optimized bitstream
- *        readers read 32 or 64 bit at once and could read over the end
- * @param bit_size the size of the buffer in bits
- * @return 0 on success, AVERROR_INVALIDDATA if the buffer_size would overflow.
- */
-static __inline int init_get_bits(GetBitContext *s, const uint8_t *buffer,
-				  int bit_size)
-{
-	int buffer_size;
-	int ret = 0;
+	if (initialized)
+		return;
+	initialized = 1;
 
-	if (bit_size >= INT_MAX - 7 || bit_size < 0 || !buffer)
+	// 2-bit/pixel code string, after 00
+	for (w = 0; w < (1 << 14); w++)
 	{
-		buffer_size = bit_size = 0;
-		buffer = NULL;
-		ret = -1;
-		errno = EINVAL;
+		if ((w >> 13) & 1) // 1 LLL CC
+			rle2_table[w] = RLE_ENTRY(6, ((w >> 10) & 7) + 3, (w >> 8) & 3);
+		else if ((w >> 12) & 1) // 01
+			rle2_table[w] = RLE_ENTRY(2, 1, 0);
+		else
+		{
+			switch ((w >> 10) & 3)
+			{
+				case 0: // 00 00, end of string
+					rle2_table[w] = RLE_ENTRY(4, 0, 0);
+					break;
+				case 1: // 00 01
+					rle2_table[w] = RLE_ENTRY(4, 2, 0);
+					break;
+				case 2: // 00 10 LLLL CC
+					rle2_table[w] = RLE_ENTRY(10, ((w >> 6) & 15) + 12, (w >> 4) & 3);
+					break;
+				case 3: // 00 11 LLLLLLLL CC
+					rle2_table[w] = RLE_ENTRY(14, ((w >> 2) & 255) + 29, w & 3);
+					break;
+			}
+		}
 	}
 
-	buffer_size = (bit_size + 7) >> 3;
-
-	s->buffer = buffer;
-	s->size_in_bits = bit_size;
-	s->size_in_bits_plus8 = bit_size + 8;
-	s->buffer_end = buffer + buffer_size;
-	s->index = 0;
-
-	return ret;
-}
-
-static __inline int get_bits_count(const GetBitContext *s)
-{
-	return s->index;
+	// 4-bit/pixel code string, after 0000
+	for (w = 0; w < (1 << 12); w++)
+	{
+		if (!((w >> 11) & 1)) // 0 LLL, end of string if LLL is 0
+			rle4_table[w] = RLE_ENTRY(4, ((w >> 8) & 7) ? ((w >> 8) & 7) + 2 : 0, 0);
+		else if (!((w >> 10) & 1)) // 10 LL CCCC
+			rle4_table[w] = RLE_ENTRY(8, ((w >> 8) & 3) + 4, (w >> 4) & 15);
+		else
+		{
+			switch ((w >> 8) & 3)
+			{
+				case 0: // 11 00
+					rle4_table[w] = RLE_ENTRY(4, 1, 0);
+					break;
+				case 1: // 11 01
+					rle4_table[w] = RLE_ENTRY(4, 2, 0);
+					break;
+				case 2: // 11 10 LLLL CCCC
+					rle4_table[w] = RLE_ENTRY(12, ((w >> 4) & 15) + 9, w & 15);
+					break;
+				case 3: // 11 11 LLLLLLLL CCCC
+					rle4_table[w] = RLE_ENTRY(12, (w & 255) + 25, 0) | RLE_CODE_FOLLOWS;
+					break;
+			}
+		}
+	}
 }
 
-static __inline unsigned int get_bits(GetBitContext *s, int n)
-{
-	register int tmp;
-	unsigned int re_index = s->index;
-	unsigned int re_cache = 0;
-	unsigned int re_size_plus8 = s->size_in_bits_plus8;
-
-	if (n <= 0 || n > 25)
-		return -1;
-	re_cache = RB32(s->buffer + (re_index >> 3)) << (re_index & 7);
-
-	tmp = ((uint32_t)re_cache) >> (32 - n);
-
-	re_index = ((re_size_plus8 < re_index + (n)) ? (re_size_plus8) : (re_index + (n)));
-
-	s->index = re_index;
-	return tmp;
-}
-static __inline unsigned int get_bits1(GetBitContext *s)
+// Returns the 16 bits at bit position pos of buf, reading zeros past its end
+static __inline unsigned int peek_bits16(const uint8_t *buf, int buf_size, int pos)
 {
-	unsigned int index = s->index;
-	uint8_t result = s->buffer[index >> 3];
-
-	result <<= index & 7;
-	result >>= 8 - 1;
-
-	if (s->index < s->size_in_bits_plus8)
-		index++;
-	s->index = index;
+	int byte = pos >> 3;
+	uint32_t v = 0;
 
-	return result;
+	if (byte + 3 <= buf_size)
+		v = (buf[byte] << 16) | (buf[byte + 1] << 8) | buf[byte + 2];
+	else
+	{
+		for (int i = 0; i < 3; i++)
+			if (byte + i < buf_size)
+				v |= buf[byte + i] << (16 - 8 * i);
+	}
+	return (v >> (8 - (pos & 7))) & 0xffff;
 }
 
 static DVBSubObject *get_object(DVBSubContext *ctx, int object_id)
@@ -451,6 +501,16 @@ void *dvbsub_init_decoder(struct dvb_config *cfg)
 #endif
 	ctx->version = -1;
 
+	ctx->composition = (DVBSubComposition *)malloc(sizeof(DVBSubComposition));
+	if (!ctx->composition)
+	{
+		fatal(EXIT_NOT_ENOUGH_MEMORY, "In dvbsub_init_decoder: Out of memory.");
+	}
+	memset(ctx->composition, 0, sizeof(DVBSubComposition));
+	ctx->composition->nb_regions = -1;
+
+	init_rle_tables();
+
 	default_clut.id = -1;
 	default_clut.next = NULL;
 
@@ -547,6 +607,9 @@ int dvbsub_close_decoder(void **dvb_ctx)
 	delete_cluts(ctx);
 
 	freep(&ctx->display_definition);
+	if (ctx->composition)
+		freep(&ctx->composition->buf);
+	freep(&ctx->composition);
 
 	while (ctx->display_list)
 	{
@@ -563,292 +626,89 @@ int dvbsub_close_decoder(void **dvb_ctx)
 	return 0;
 }
 
-static int dvbsub_read_2bit_string(uint8_t *destbuf, int dbuf_len,
-				   const uint8_t **srcbuf, int buf_size, int non_mod, uint8_t *map_table,
-				   int x_pos)
+/* Decodes a 2 or 4-bit/pixel code string, depth being 2 or 4, with the
+ * run-length code table of that depth. Pixels coded with 1 in non-modifying
+ * colour mode are left untouched. end_bits is the size of the end of string code. */
+static int dvbsub_read_rle_string(int depth, const uint32_t *table, int end_bits, const char *name,
+				  uint8_t *destbuf, int dbuf_len, const uint8_t **srcbuf, int buf_size,
+				  int non_mod, uint8_t *map_table, int x_pos)
 {
-	GetBitContext gb;
-
-	int bits;
-	int run_length;
+	int size_in_bits = buf_size << 3;
+	int pos = 0;
 	int pixels_read = x_pos;
+	unsigned int prefix_mask = (1 << (16 - depth)) - 1;
 
-	init_get_bits(&gb, *srcbuf, buf_size << 3);
-
-	destbuf += x_pos;
-
-	while (get_bits_count(&gb) < buf_size << 3 && pixels_read < dbuf_len)
+	while (pos < size_in_bits && pixels_read < dbuf_len)
 	{
-		bits = get_bits(&gb, 2);
+		unsigned int w = peek_bits16(*srcbuf, buf_size, pos);
+		int bits = w >> (16 - depth);
 
 		if (bits)
 		{
+			pos += depth;
 			if (non_mod != 1 || bits != 1)
-			{
-				if (map_table)
-					*destbuf++ = map_table[bits];
-				else
-					*destbuf++ = bits;
-			}
+				destbuf[pixels_read] = map_table ? map_table[bits] : bits;
 			pixels_read++;
+			continue;
 		}
-		else
+
+		uint32_t entry = table[w & prefix_mask];
+		int run_length = RLE_RUN(entry);
+
+		bits = RLE_CODE(entry);
+		pos += depth + RLE_BITS(entry);
+		if (entry & RLE_CODE_FOLLOWS)
 		{
-			bits = get_bits1(&gb);
-			if (bits == 1)
-			{
-				run_length = get_bits(&gb, 3) + 3;
-				bits = get_bits(&gb, 2);
+			bits = peek_bits16(*srcbuf, buf_size, pos) >> 12;
+			pos += 4;
+		}
 
-				if (non_mod == 1 && bits == 1)
-					pixels_read += run_length;
-				else
-				{
-					if (map_table)
-						bits = map_table[bits];
-					while (run_length-- > 0 && pixels_read < dbuf_len)
-					{
-						*destbuf++ = bits;
-						pixels_read++;
-					}
-				}
-			}
-			else
-			{
-				bits = get_bits1(&gb);
-				if (bits == 0)
-				{
-					bits = get_bits(&gb, 2);
-					if (bits == 2)
-					{
-						run_length = get_bits(&gb, 4) + 12;
-						bits = get_bits(&gb, 2);
-
-						if (non_mod == 1 && bits == 1)
-							pixels_read += run_length;
-						else
-						{
-							if (map_table)
-								bits = map_table[bits];
-							while (run_length-- > 0 && pixels_read < dbuf_len)
-							{
-								*destbuf++ = bits;
-								pixels_read++;
-							}
-						}
-					}
-					else if (bits == 3)
-					{
-						run_length = get_bits(&gb, 8) + 29;
-						bits = get_bits(&gb, 2);
-
-						if (non_mod == 1 && bits == 1)
-							pixels_read += run_length;
-						else
-						{
-							if (map_table)
-								bits = map_table[bits];
-							while (run_length-- > 0 && pixels_read < dbuf_len)
-							{
-								*destbuf++ = bits;
-								pixels_read++;
-							}
-						}
-					}
-					else if (bits == 1)
-					{
-						if (map_table)
-							bits = map_table[0];
-						else
-							bits = 0;
-						run_length = 2;
-						while (run_length-- > 0 && pixels_read < dbuf_len)
-						{
-							*destbuf++ = bits;
-							pixels_read++;
-						}
-					}
-					else
-					{
-						(*srcbuf) += (get_bits_count(&gb) + 7) >> 3;
-						return pixels_read;
-					}
-				}
-				else
-				{
-					if (map_table)
-						bits = map_table[0];
-					else
-						bits = 0;
-					*destbuf++ = bits;
-					pixels_read++;
-				}
-			}
+		if (run_length == 0)
+		{
+			(*srcbuf) += (MIN(pos, size_in_bits + 8) + 7) >> 3;
+			return pixels_read;
 		}
+
+		if (non_mod == 1 && bits == 1)
+		{
+			pixels_read += run_length;
+			continue;
+		}
+
+		if (map_table)
+			bits = map_table[bits];
+		if (run_length > dbuf_len - pixels_read)
+			run_length = dbuf_len - pixels_read;
+		memset(destbuf + pixels_read, bits, run_length);
+		pixels_read += run_length;
 	}
 
-	if (get_bits(&gb, 6))
+	if (peek_bits16(*srcbuf, buf_size, pos) >> (16 - end_bits))
 	{
-		mprint("DVBSub error: line overflow at dvbsub_read_2bit_string()\n");
+		mprint("DVBSub error: line overflow at %s()\n", name);
 		return -1;
 	}
+	pos += end_bits;
 
-	(*srcbuf) += (get_bits_count(&gb) + 7) >> 3;
+	(*srcbuf) += (MIN(pos, size_in_bits + 8) + 7) >> 3;
 
 	return pixels_read;
 }
 
-static int dvbsub_read_4bit_string(uint8_t *destbuf, int dbuf_len,
+static int dvbsub_read_2bit_string(uint8_t *destbuf, int dbuf_len,
 				   const uint8_t **srcbuf, int buf_size, int non_mod, uint8_t *map_table,
 				   int x_pos)
 {
-	GetBitContext gb;
-
-	int bits;
-	int run_length;
-	int pixels_read = x_pos;
-
-	init_get_bits(&gb, *srcbuf, buf_size << 3);
-
-	destbuf += x_pos;
-
-	while (get_bits_count(&gb) < buf_size << 3 && pixels_read < dbuf_len)
-	{
-		bits = get_bits(&gb, 4);
-
-		if (bits)
-		{
-			if (non_mod != 1 || bits != 1)
-			{
-				if (map_table)
-					*destbuf++ = map_table[bits];
-				else
-					*destbuf++ = bits;
-			}
-			pixels_read++;
-		}
-		else
-		{
-			bits = get_bits1(&gb);
-			if (bits == 0)
-			{
-				run_length = get_bits(&gb, 3);
-
-				if (run_length == 0)
-				{
-					(*srcbuf) += (get_bits_count(&gb) + 7) >> 3;
-					return pixels_read;
-				}
-
-				run_length += 2;
-
-				if (map_table)
-					bits = map_table[0];
-				else
-					bits = 0;
-
-				while (run_length-- > 0 && pixels_read < dbuf_len)
-				{
-					*destbuf++ = bits;
-					pixels_read++;
-				}
-			}
-			else
-			{
-				bits = get_bits1(&gb);
-				if (bits == 0)
-				{
-					run_length = get_bits(&gb, 2) + 4;
-					bits = get_bits(&gb, 4);
-
-					if (non_mod == 1 && bits == 1)
-						pixels_read += run_length;
-					else
-					{
-						if (map_table)
-							bits = map_table[bits];
-						while (run_length-- > 0 && pixels_read < dbuf_len)
-						{
-							*destbuf++ = bits;
-							pixels_read++;
-						}
-					}
-				}
-				else
-				{
-					bits = get_bits(&gb, 2);
-					if (bits == 2)
-					{
-						run_length = get_bits(&gb, 4) + 9;
-						bits = get_bits(&gb, 4);
-
-						if (non_mod == 1 && bits == 1)
-							pixels_read += run_length;
-						else
-						{
-							if (map_table)
-								bits = map_table[bits];
-							while (run_length-- > 0 && pixels_read < dbuf_len)
-							{
-								*destbuf++ = bits;
-								pixels_read++;
-							}
-						}
-					}
-					else if (bits == 3)
-					{
-						run_length = get_bits(&gb, 8) + 25;
-						bits = get_bits(&gb, 4);
-
-						if (non_mod == 1 && bits == 1)
-							pixels_read += run_length;
-						else
-						{
-							if (map_table)
-								bits = map_table[bits];
-							while (run_length-- > 0 && pixels_read < dbuf_len)
-							{
-								*destbuf++ = bits;
-								pixels_read++;
-							}
-						}
-					}
-					else if (bits == 1)
-					{
-						if (map_table)
-							bits = map_table[0];
-						else
-							bits = 0;
-						run_length = 2;
-						while (run_length-- > 0 && pixels_read < dbuf_len)
-						{
-							*destbuf++ = bits;
-							pixels_read++;
-						}
-					}
-					else
-					{
-						if (map_table)
-							bits = map_table[0];
-						else
-							bits = 0;
-						*destbuf++ = bits;
-						pixels_read++;
-					}
-				}
-			}
-		}
-	}
-
-	if (get_bits(&gb, 8))
-	{
-		mprint("DVBSub error: line overflow at dvbsub_read_4bit_string()\n");
-		return -1;
-	}
-
-	(*srcbuf) += (get_bits_count(&gb) + 7) >> 3;
+	return dvbsub_read_rle_string(2, rle2_table, 6, "dvbsub_read_2bit_string", destbuf, dbuf_len,
+				      srcbuf, buf_size, non_mod, map_table, x_pos);
+}
 
-	return pixels_read;
+static int dvbsub_read_4bit_string(uint8_t *destbuf, int dbuf_len,
+				   const uint8_t **srcbuf, int buf_size, int non_mod, uint8_t *map_table,
+				   int x_pos)
+{
+	return dvbsub_read_rle_string(4, rle4_table, 8, "dvbsub_read_4bit_string", destbuf, dbuf_len,
+				      srcbuf, buf_size, non_mod, map_table, x_pos);
 }
 
 static int dvbsub_read_8bit_string(uint8_t *destbuf, int dbuf_len,
@@ -949,6 +809,7 @@ static int dvbsub_parse_pixel_data_block(void *dvb_ctx,
 
 	pbuf = region->pbuf;
 	region->dirty = 1;
+	region->changed = 1;
 
 	x_pos = display->x_pos;
 	y_pos = display->y_pos;
@@ -1324,7 +1185,10 @@ static void dvbsub_parse_region_segment(void *dvb_ctx, const uint8_t *buf,
 	}
 
 	if (fill)
+	{
 		memset(region->pbuf, region->bgcolor, region->buf_size);
+		region->changed = 1;
+	}
 
 	delete_region_display_list(ctx, region);
 
@@ -1518,6 +1382,105 @@ static void dvbsub_parse_display_definition_segment(void *dvb_ctx,
 	}
 }
 
+/* Copies the pixels of a region into the composition, clipped to it */
+static void dvbsub_copy_region(DVBSubComposition *comp, DVBSubRegion *region,
+			       DVBSubRegionDisplay *display)
+{
+	int x_off = display->x_pos - comp->x;
+	int y_off = display->y_pos - comp->y;
+	int x_start = x_off < 0 ? -x_off : 0;
+	int x_end = MIN(region->width, comp->width - x_off);
+	int y_start = y_off < 0 ? -y_off : 0;
+	int y_end = MIN(region->height, comp->height - y_off);
+
+	if (x_end <= x_start || y_end <= y_start)
+	{
+		dbg_print(CCX_DMT_DVB, "\nRegion %d is outside of the subtitle, ignored.\n", region->id);
+		return;
+	}
+	for (int y = y_start; y < y_end; y++)
+		memcpy(comp->buf + (y + y_off) * comp->width + x_off + x_start,
+		       region->pbuf + y * region->width + x_start, x_end - x_start);
+}
+
+/* Brings the composition of the page in the given rectangle up to date */
+static void dvbsub_compose(DVBSubContext *ctx, int x_pos, int y_pos, int width, int height)
+{
+	DVBSubComposition *comp = ctx->composition;
+	DVBSubRegionDisplay *display;
+	DVBSubRegion *region;
+	int n = 0;
+	int in_place = comp->nb_regions >= 0 && comp->x == x_pos && comp->y == y_pos &&
+		       comp->width == width && comp->height == height;
+
+	// In place only with the same regions at the same places, none overlapping another
+	for (display = ctx->display_list; display; display = display->next)
+	{
+		region = get_region(ctx, display->region_id);
+		if (!region)
+			continue;
+		if (n < DVBSUB_MAX_COMPOSED_REGIONS)
+		{
+			if (comp->regions[n].id != region->id || comp->regions[n].x_pos != display->x_pos ||
+			    comp->regions[n].y_pos != display->y_pos || comp->regions[n].width != region->width ||
+			    comp->regions[n].height != region->height)
+				in_place = 0;
+			comp->regions[n].id = region->id;
+			comp->regions[n].x_pos = display->x_pos;
+			comp->regions[n].y_pos = display->y_pos;
+			comp->regions[n].width = region->width;
+			comp->regions[n].height = region->height;
+		}
+		n++;
+	}
+	if (n != comp->nb_regions)
+		in_place = 0;
+	comp->nb_regions = n <= DVBSUB_MAX_COMPOSED_REGIONS ? n : -1;
+	for (int i = 0; i < comp->nb_regions; i++)
+	{
+		for (int j = i + 1; j < comp->nb_regions; j++)
+		{
+			if (comp->regions[i].x_pos < comp->regions[j].x_pos + comp->regions[j].width &&
+			    comp->regions[j].x_pos < comp->regions[i].x_pos + comp->regions[i].width &&
+			    comp->regions[i].y_pos < comp->regions[j].y_pos + comp->regions[j].height &&
+			    comp->regions[j].y_pos < comp->regions[i].y_pos + comp->regions[i].height)
+			{
+				in_place = 0;
+				comp->nb_regions = -1;
+			}
+		}
+	}
+
+	if (!in_place)
+	{
+		if (width * height > comp->buf_size)
+		{
+			freep(&comp->buf);
+			comp->buf = (uint8_t *)malloc(width * height);
+			if (!comp->buf)
+			{
+				fatal(EXIT_NOT_ENOUGH_MEMORY, "In dvbsub_compose: Out of memory allocating composition (%d * %d = %d bytes).", width, height, width * height);
+			}
+			comp->buf_size = width * height;
+		}
+		memset(comp->buf, 0x0, width * height);
+		comp->x = x_pos;
+		comp->y = y_pos;
+		comp->width = width;
+		comp->height = height;
+	}
+
+	for (display = ctx->display_list; display; display = display->next)
+	{
+		region = get_region(ctx, display->region_id);
+		if (!region)
+			continue;
+		if (!in_place || region->changed)
+			dvbsub_copy_region(comp, region, display);
+		region->changed = 0;
+	}
+}
+
 /**
  * Write Subtitle in cc_subtitle structure in CC_BITMAP format
  * when OCR subsystem is present then it also write recognised text in
@@ -1659,9 +1622,10 @@ static int write_dvb_sub(struct lib_cc_decode *dec_ctx, struct cc_subtitle *sub)
 	rect->h = height;
 	rect->linesize0 = width;
 
-	// The second loop, to generate the merged image
+	// Then the merged image, from the composition of the page
 
 	dbg_print(CCX_DMT_DVB, "\nCreating a data[0] of %d bytes (%d x %d)\n", width * height, width, height);
+	dvbsub_compose(ctx, x_pos, y_pos, width, height);
 	rect->data0 = (uint8_t *)malloc(width * height);
 	if (!rect->data0)
 	{
@@ -1669,37 +1633,7 @@ static int write_dvb_sub(struct lib_cc_decode *dec_ctx, struct cc_subtitle *sub)
 		free(rect);
 		fatal(EXIT_NOT_ENOUGH_MEMORY, "In write_dvb_sub: Out of memory allocating data0 (%d * %d = %d bytes).", width, height, width * height);
 	}
-	memset(rect->data0, 0x0, width * height);
-
-	for (display = ctx->display_list; display; display = display->next)
-	{
-		region = get_region(ctx, display->region_id);
-		if (!region)
-			continue;
-
-		int x_off = display->x_pos - x_pos;
-		int y_off = display->y_pos - y_pos;
-		for (int y = 0; y < region->height; y++)
-		{
-			for (int x = 0; x < region->width; x++)
-			{
-				int offset = ((y + y_off) * width) + x_off + x;
-				if (offset >= (width * height) || offset < 0)
-				{
-					mprint("write_dvb_sub(): Offset %d (out of bounds!) ignored.\n",
-					       offset);
-					mprint("  Formula: offset=((y + y_off) * width) + x_off + x\n");
-					mprint("  y=%d, y_off=%d, width=%d, x_off=%d, x=%d\n",
-					       y, y_off, width, x_off, x);
-				}
-				else
-				{
-					uint8_t c = (uint8_t)region->pbuf[y * region->width + x];
-					rect->data0[offset] = c;
-				}
-			}
-		}
-	}
+	memcpy(rect->data0, ctx->composition->buf, width * height);
 
 	sub->nb_data = 1; // Set nb_data to 1 since we have merged the images into one image.
 
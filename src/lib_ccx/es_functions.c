@@ -439,7 +439,7 @@ static int sequence_header(struct lib_cc_decode *ctx, struct bitstream *esstream
 			ctx->current_vert_size = vert_size;
 			ctx->current_aspect_ratio = aspect_ratio;
 			ctx->current_frame_rate = frame_rate;
-			current_fps = framerates_values[ctx->current_frame_rate];
+			ctx->timing->current_fps = framerates_values[ctx->current_frame_rate];
 			activity_video_info(hor_size, vert_size,
 					    aspect_ratio_types[aspect_ratio],
 					    framerates_types[frame_rate]);
@@ -566,12 +566,12 @@ static int gop_header(struct encoder_ctx *enc_ctx, struct lib_cc_decode *dec_ctx
 	gtc.time_code_seconds = (int)read_bits(esstream, 6);
 	gtc.time_code_pictures = (int)read_bits(esstream, 6);
 	gtc.inited = 1;
-	calculate_ms_gop_time(&gtc);
+	calculate_ms_gop_time(dec_ctx->timing, &gtc);
 
 	if (esstream->bitsleft < 0)
 		return 0;
 
-	if (gop_accepted(&gtc))
+	if (gop_accepted(dec_ctx->timing, &gtc))
 	{
 		// Do GOP padding during GOP header. The previous GOP and all
 		// included captions are written. Use the current GOP time to
@@ -596,48 +596,48 @@ static int gop_header(struct encoder_ctx *enc_ctx, struct lib_cc_decode *dec_ctx
 
 		// Report synchronization jumps between GOPs. Warn if there
 		// are 20% or more deviation.
-		if ((ccx_options.debug_mask & CCX_DMT_TIME) && ((gtc.ms - gop_time.ms // more than 20% longer
-								 > dec_ctx->frames_since_last_gop * 1000.0 / current_fps * 1.2) ||
-								(gtc.ms - gop_time.ms // or 20% shorter
-								 < dec_ctx->frames_since_last_gop * 1000.0 / current_fps * 0.8)) &&
-		    first_gop_time.inited)
+		if ((ccx_options.debug_mask & CCX_DMT_TIME) && ((gtc.ms - dec_ctx->timing->gop_time.ms // more than 20% longer
+								 > dec_ctx->frames_since_last_gop * 1000.0 / dec_ctx->timing->current_fps * 1.2) ||
+								(gtc.ms - dec_ctx->timing->gop_time.ms // or 20% shorter
+								 < dec_ctx->frames_since_last_gop * 1000.0 / dec_ctx->timing->current_fps * 0.8)) &&
+		    dec_ctx->timing->first_gop_time.inited)
 		{
 			mprint("\rWarning: Jump in GOP timing.\n");
 			mprint("  (old) %s",
-			       print_mstime_static(gop_time.ms));
+			       print_mstime_static(dec_ctx->timing->gop_time.ms));
 			mprint("  +  %s (%uF)",
-			       print_mstime_static((LLONG)(dec_ctx->frames_since_last_gop * 1000.0 / current_fps)),
+			       print_mstime_static((LLONG)(dec_ctx->frames_since_last_gop * 1000.0 / dec_ctx->timing->current_fps)),
 			       dec_ctx->frames_since_last_gop);
 			mprint("  !=  (new) %s\n",
 			       print_mstime_static(gtc.ms));
 		}
 
-		if (first_gop_time.inited == 0)
+		if (dec_ctx->timing->first_gop_time.inited == 0)
 		{
-			first_gop_time = gtc;
+			dec_ctx->timing->first_gop_time = gtc;
 
 			// It needs to be "+1" because the frame count starts at 0 and we
 			// need the length of all frames.
-			if (total_frames_count == 0)
+			if (dec_ctx->timing->total_frames_count == 0)
 			{ // If this is the first frame there cannot be an offset
 				dec_ctx->timing->fts_fc_offset = 0;
 				// first_gop_time.ms stays unchanged
 			}
 			else
 			{
-				dec_ctx->timing->fts_fc_offset = (LLONG)((total_frames_count + 1) * 1000.0 / current_fps);
+				dec_ctx->timing->fts_fc_offset = (LLONG)((dec_ctx->timing->total_frames_count + 1) * 1000.0 / dec_ctx->timing->current_fps);
 				// Compensate for those written before
-				first_gop_time.ms -= dec_ctx->timing->fts_fc_offset;
+				dec_ctx->timing->first_gop_time.ms -= dec_ctx->timing->fts_fc_offset;
 			}
 
 			dbg_print(CCX_DMT_TIME, "\nFirst GOP time: %02u:%02u:%02u:%03u %+lldms\n",
 				  gtc.time_code_hours,
 				  gtc.time_code_minutes, gtc.time_code_seconds,
-				  (unsigned)(1000.0 * gtc.time_code_pictures / current_fps),
+				  (unsigned)(1000.0 * gtc.time_code_pictures / dec_ctx->timing->current_fps),
 				  dec_ctx->timing->fts_fc_offset);
 		}
 
-		gop_time = gtc;
+		dec_ctx->timing->gop_time = gtc;
 
 		dec_ctx->frames_since_last_gop = 0;
 		// Indicate that we read a gop header (since last frame number 0)
@@ -648,9 +648,9 @@ static int gop_header(struct encoder_ctx *enc_ctx, struct lib_cc_decode *dec_ctx
 		{
 			set_current_pts(dec_ctx->timing, gtc.ms * (MPEG_CLOCK_FREQ / 1000));
 			dec_ctx->timing->current_tref = 0;
-			frames_since_ref_time = 0;
+			dec_ctx->timing->frames_since_ref_time = 0;
 			set_fts(dec_ctx->timing);
-			fts_at_gop_start = get_fts_max(dec_ctx->timing);
+			dec_ctx->timing->fts_at_gop_start = get_fts_max(dec_ctx->timing);
 		}
 		else
 		{
@@ -659,7 +659,7 @@ static int gop_header(struct encoder_ctx *enc_ctx, struct lib_cc_decode *dec_ctx
 			// next GOP.
 			// This effect will also lead to captions being one GOP early
 			// for DVD captions.
-			fts_at_gop_start = get_fts_max(dec_ctx->timing) + (LLONG)(1000.0 / current_fps);
+			dec_ctx->timing->fts_at_gop_start = get_fts_max(dec_ctx->timing) + (LLONG)(1000.0 / dec_ctx->timing->current_fps);
 		}
 
 		if (ccx_options.debug_mask & CCX_DMT_TIME)
@@ -748,13 +748,13 @@ static int read_pic_info(struct encoder_ctx *enc_ctx, struct lib_cc_decode *dec_
 		{
 			// This time (fts_at_gop_start) that was set in the
 			// GOP header and it might be off by one GOP. See the comment there.
-			frames_since_ref_time = dec_ctx->frames_since_last_gop; // Should this be 0?
+			dec_ctx->timing->frames_since_ref_time = dec_ctx->frames_since_last_gop; // Should this be 0?
 		}
 		else
 		{
 			// No GOP header, use the current values
-			fts_at_gop_start = get_fts(dec_ctx->timing, dec_ctx->current_field);
-			frames_since_ref_time = 0;
+			dec_ctx->timing->fts_at_gop_start = get_fts(dec_ctx->timing, dec_ctx->current_field);
+			dec_ctx->timing->frames_since_ref_time = 0;
 		}
 
 		if (ccx_options.debug_mask & CCX_DMT_TIME)
@@ -795,9 +795,9 @@ static int read_pic_info(struct encoder_ctx *enc_ctx, struct lib_cc_decode *dec_
 	}
 
 	dec_ctx->total_pulldownframes += extraframe;
-	total_frames_count += 1 + extraframe;
+	dec_ctx->timing->total_frames_count += 1 + extraframe;
 	dec_ctx->frames_since_last_gop += 1 + extraframe;
-	frames_since_ref_time += 1 + extraframe;
+	dec_ctx->timing->frames_since_ref_time += 1 + extraframe;
 
 	debug("Read PIC Info - processed\n\n");
 
@@ -65,7 +65,7 @@ int user_data(struct encoder_ctx *enc_ctx, struct lib_cc_decode *dec_ctx, struct
 		// last GOP.  Only useful when there are frames before
 		// the GOP.
 		if (dec_ctx->timing->fts_max > 0)
-			dec_ctx->timing->fts_now = dec_ctx->timing->fts_max + (LLONG)(1000.0 / current_fps);
+			dec_ctx->timing->fts_now = dec_ctx->timing->fts_max + (LLONG)(1000.0 / dec_ctx->timing->current_fps);
 
 		int rcbcount = 0;
 		for (int i = 0; i < capcount; i++)
@@ -281,7 +281,7 @@ int user_data(struct encoder_ctx *enc_ctx, struct lib_cc_decode *dec_ctx, struct
 		// To process this with the HDTV framework we create a "HDTV" caption
 		// format compatible array. Two times 3 bytes plus one for the 0xFF
 		// marker at the end. Pre-init to field 1 and set the 0xFF marker.
-		static unsigned char dishdata[7] = {0x04, 0, 0, 0x04, 0, 0, 0xFF};
+		unsigned char dishdata[7] = {0x04, 0, 0, 0x04, 0, 0, 0xFF};
 		int cc_count;
 
 		dbg_print(CCX_DMT_VERBOSE, "Reading Dish Network user data\n");
@@ -53,11 +53,11 @@ static size_t inline buffered_read(struct ccx_demuxer *ctx, unsigned char *buffe
 	else
 	{
 		result = buffered_read_opt(ctx, buffer, bytes);
-		if (ccx_options.gui_mode_reports && ccx_options.input_source == CCX_DS_NETWORK)
+		if (ctx->gui_mode_reports && ccx_options.input_source == CCX_DS_NETWORK)
 		{
-			net_activity_gui++;
-			if (!(net_activity_gui % 1000))
-				activity_report_data_read();
+			ctx->net_activity_gui++;
+			if (!(ctx->net_activity_gui % 1000))
+				activity_report_data_read(ctx->net_activity_gui);
 		}
 	}
 	return result;
@@ -64,6 +64,8 @@ LLONG get_total_file_size(struct lib_ccx_ctx *ctx) // -1 if one of the file(s) f
 
 void prepare_for_new_file(struct lib_ccx_ctx *ctx)
 {
+	struct lib_cc_decode *dec_ctx;
+
 	// Init per file variables
 	ctx->last_reported_progress = -1;
 	ctx->stat_numuserheaders = 0;
@@ -74,14 +76,16 @@ void prepare_for_new_file(struct lib_ccx_ctx *ctx)
 	ctx->stat_dishheaders = 0;
 	ctx->stat_hdtv = 0;
 	ctx->stat_divicom = 0;
-	total_frames_count = 0;
 	ctx->false_pict_header = 0;
-	frames_since_ref_time = 0;
-	gop_time.inited = 0;
-	first_gop_time.inited = 0;
-	gop_rollover = 0;
-	printed_gop.inited = 0;
-	pts_big_change = 0;
+	list_for_each_entry(dec_ctx, &ctx->dec_ctx_head, list, struct lib_cc_decode)
+	{
+		dec_ctx->timing->total_frames_count = 0;
+		dec_ctx->timing->frames_since_ref_time = 0;
+		dec_ctx->timing->gop_time.inited = 0;
+		dec_ctx->timing->first_gop_time.inited = 0;
+		dec_ctx->timing->gop_rollover = 0;
+		dec_ctx->timing->pts_big_change = 0;
+	}
 	firstcall = 1;
 
 	if (ctx->epg_inited)
@@ -94,8 +98,10 @@ void prepare_for_new_file(struct lib_ccx_ctx *ctx)
 		for (int i = 0; i < TS_PMT_MAP_SIZE; i++)
 		{
 			ctx->eit_programs[i].array_len = 0;
+			memset(ctx->eit_programs[i].event_index, 0, sizeof(ctx->eit_programs[i].event_index));
 			ctx->eit_current_events[i] = -1;
 		}
+		ctx->epg_sections.nb_program = -1;
 		ctx->epg_last_output = -1;
 		ctx->epg_last_live_output = -1;
 	}
@@ -298,6 +304,12 @@ void return_to_buffer(struct ccx_demuxer *ctx, unsigned char *buffer, unsigned i
 	ctx->bytesinbuffer += bytes;
 }
 
+// Whether the extraction the demuxer belongs to was asked to stop
+static int demuxer_terminating(struct ccx_demuxer *ctx)
+{
+	return ctx->parent && ((struct lib_ccx_ctx *)ctx->parent)->terminate_asap;
+}
+
 /**
  * @param buffer can be NULL, in case when user want to just buffer it or skip some data.
  *
@@ -327,7 +339,7 @@ size_t buffered_read_opt(struct ccx_demuxer *ctx, unsigned char *buffer, size_t
 
 		while ((!eof || ccx_options.live_stream) && bytes)
 		{
-			if (terminate_asap)
+			if (demuxer_terminating(ctx))
 				break;
 			if (eof)
 			{
@@ -400,7 +412,7 @@ size_t buffered_read_opt(struct ccx_demuxer *ctx, unsigned char *buffer, size_t
 					i = net_tcp_read(ctx->infd, (char *)ctx->filebuffer + keep, FILEBUFFERSIZE - keep);
 				else
 					i = net_udp_read(ctx->infd, (char *)ctx->filebuffer + keep, FILEBUFFERSIZE - keep, ccx_options.udpsrc, ccx_options.udpaddr);
-				if (terminate_asap) /* Looks like receiving a signal here will trigger a -1, so check that first */
+				if (demuxer_terminating(ctx)) /* Looks like receiving a signal here will trigger a -1, so check that first */
 					break;
 				if (i == -1)
 					fatal(EXIT_READ_ERROR, "Error reading input stream!\n");
@@ -439,7 +451,7 @@ size_t buffered_read_opt(struct ccx_demuxer *ctx, unsigned char *buffer, size_t
 			       ((i = read(ctx->infd, buffer, bytes)) != 0 || ccx_options.live_stream ||
 				(ccx_options.binary_concat && switch_to_next_file(ctx->parent, copied))))
 			{
-				if (terminate_asap)
+				if (demuxer_terminating(ctx))
 					break;
 				if (i == -1)
 					fatal(EXIT_READ_ERROR, "Error reading input file!\n");
@@ -457,7 +469,7 @@ size_t buffered_read_opt(struct ccx_demuxer *ctx, unsigned char *buffer, size_t
 		while (bytes != 0 && ctx->infd != -1)
 		{
 			LLONG op, np;
-			if (terminate_asap)
+			if (demuxer_terminating(ctx))
 				break;
 			op = LSEEK(ctx->infd, 0, SEEK_CUR); // Get current pos
 			if (op + bytes < 0)		    // Would mean moving beyond start of file: Not supported
@@ -19,8 +19,6 @@
 #include "dvd_subtitle_decoder.h"
 #include "ccx_demuxer_mxf.h"
 
-int end_of_file = 0; // End of file?
-
 // Program stream specific data grabber
 int ps_get_more_data(struct lib_ccx_ctx *ctx, struct demuxer_data **ppdata)
 {
@@ -65,7 +63,7 @@ int ps_get_more_data(struct lib_ccx_ctx *ctx, struct demuxer_data **ppdata)
 			if (result != 6)
 			{
 				// Consider this the end of the show.
-				end_of_file = 1;
+				ctx->end_of_file = 1;
 				break;
 			}
 
@@ -96,7 +94,7 @@ int ps_get_more_data(struct lib_ccx_ctx *ctx, struct demuxer_data **ppdata)
 					ctx->demux_ctx->past += result;
 					if (result != atpos)
 					{
-						end_of_file = 1;
+						ctx->end_of_file = 1;
 						break;
 					}
 				}
@@ -106,12 +104,12 @@ int ps_get_more_data(struct lib_ccx_ctx *ctx, struct demuxer_data **ppdata)
 					ctx->demux_ctx->past += result;
 					if (result != hlen)
 					{
-						end_of_file = 1;
+						ctx->end_of_file = 1;
 						break;
 					}
 				}
 			}
-			if (end_of_file)
+			if (ctx->end_of_file)
 			{
 				// No more headers
 				break;
@@ -128,7 +126,7 @@ int ps_get_more_data(struct lib_ccx_ctx *ctx, struct demuxer_data **ppdata)
 				if (result != 8)
 				{
 					// Consider this the end of the show.
-					end_of_file = 1;
+					ctx->end_of_file = 1;
 					break;
 				}
 
@@ -166,7 +164,7 @@ int ps_get_more_data(struct lib_ccx_ctx *ctx, struct demuxer_data **ppdata)
 				ctx->demux_ctx->past += 1;
 				if (ret != 1)
 				{
-					end_of_file = 1;
+					ctx->end_of_file = 1;
 					break;
 				}
 				buffered_skip(ctx->demux_ctx, (int)nextheader[6]);
@@ -177,7 +175,7 @@ int ps_get_more_data(struct lib_ccx_ctx *ctx, struct demuxer_data **ppdata)
 				ctx->demux_ctx->past += 1;
 				if (ret != 1)
 				{
-					end_of_file = 1;
+					ctx->end_of_file = 1;
 					break;
 				}
 
@@ -192,7 +190,7 @@ int ps_get_more_data(struct lib_ccx_ctx *ctx, struct demuxer_data **ppdata)
 					ctx->demux_ctx->past += datalen;
 					if (result != datalen)
 					{
-						end_of_file = 1;
+						ctx->end_of_file = 1;
 						break;
 					}
 					if (result > 0)
@@ -262,7 +260,7 @@ int ps_get_more_data(struct lib_ccx_ctx *ctx, struct demuxer_data **ppdata)
 				ret = read_video_pes_header(ctx->demux_ctx, data, nextheader, &hlen, 0);
 				if (ret < 0)
 				{
-					end_of_file = 1;
+					ctx->end_of_file = 1;
 					break;
 				}
 				else
@@ -298,7 +296,7 @@ int ps_get_more_data(struct lib_ccx_ctx *ctx, struct demuxer_data **ppdata)
 
 				if (result != want)
 				{ // Not complete - EOF
-					end_of_file = 1;
+					ctx->end_of_file = 1;
 					break;
 				}
 				enough = 1; // We got one PES
@@ -600,7 +598,7 @@ int raw_loop(struct lib_ccx_ctx *ctx)
 
 	do
 	{
-		if (terminate_asap)
+		if (ctx->terminate_asap)
 			break;
 
 		ret = general_get_more_data(ctx, &data);
@@ -648,7 +646,7 @@ int raw_loop(struct lib_ccx_ctx *ctx)
 			// so each chunk's timing is added incrementally.
 			// Note: Cast cb_field1 to LLONG to prevent 32-bit integer overflow
 			// when calculating ticks for large raw files (issue #1565).
-			add_current_pts(dec_ctx->timing, (LLONG)cb_field1 * 1001 / 30 * (MPEG_CLOCK_FREQ / 1000));
+			add_current_pts(dec_ctx->timing, (LLONG)dec_ctx->timing->cb_field1 * 1001 / 30 * (MPEG_CLOCK_FREQ / 1000));
 			set_fts(dec_ctx->timing);
 		}
 
@@ -745,7 +743,6 @@ int process_data(struct encoder_ctx *enc_ctx, struct lib_cc_decode *dec_ctx, str
 {
 	size_t got; // Means 'consumed' from buffer actually
 	int ret = 0;
-	static LLONG last_pts = 0x01FFFFFFFFLL;
 	struct cc_subtitle *dec_sub = &dec_ctx->dec_sub;
 
 	if (dec_ctx->hauppauge_mode)
@@ -820,7 +817,7 @@ int process_data(struct encoder_ctx *enc_ctx, struct lib_cc_decode *dec_ctx, str
 			dec_ctx->timing->pts_set = 1;
 		}
 
-		if (dec_ctx->timing->current_pts != last_pts)
+		if (dec_ctx->timing->current_pts != dec_ctx->last_data_pts)
 		{
 			// Only initialize the FTS values and reset the cb
 			// counters when the PTS is different. This happens frequently
@@ -829,15 +826,15 @@ int process_data(struct encoder_ctx *enc_ctx, struct lib_cc_decode *dec_ctx, str
 			if (dec_ctx->timing->min_pts == 0x01FFFFFFFFLL)
 			{
 				// First call
-				fts_at_gop_start = 0;
+				dec_ctx->timing->fts_at_gop_start = 0;
 			}
 			else
-				fts_at_gop_start = get_fts(dec_ctx->timing, dec_ctx->current_field);
+				dec_ctx->timing->fts_at_gop_start = get_fts(dec_ctx->timing, dec_ctx->current_field);
 
-			frames_since_ref_time = 0;
+			dec_ctx->timing->frames_since_ref_time = 0;
 			set_fts(dec_ctx->timing);
 
-			last_pts = dec_ctx->timing->current_pts;
+			dec_ctx->last_data_pts = dec_ctx->timing->current_pts;
 		}
 
 		dbg_print(CCX_DMT_VIDES, "PTS: %s (%8u)",
@@ -962,17 +959,17 @@ void segment_output_file(struct lib_ccx_ctx *ctx, struct lib_cc_decode *dec_ctx)
 			{
 				// list_del(&enc_ctx->list);
 				// dinit_encoder(&enc_ctx, t);
-				const char *extension = get_file_extension(ccx_options.enc_cfg.write_format);
+				const char *extension = get_file_extension(ctx->enc_cfg.write_format);
 				// Format: "%s_%06d%s" needs: basefilename + '_' + up to 10 digits + extension + null
 				size_t needed_len = strlen(ctx->basefilename) + 1 + 10 + strlen(extension) + 1;
-				freep(&ccx_options.enc_cfg.output_filename);
-				ccx_options.enc_cfg.output_filename = malloc(needed_len);
-				if (!ccx_options.enc_cfg.output_filename)
+				freep(&ctx->enc_cfg.output_filename);
+				ctx->enc_cfg.output_filename = malloc(needed_len);
+				if (!ctx->enc_cfg.output_filename)
 				{
 					fatal(EXIT_NOT_ENOUGH_MEMORY, "In segment handling: Out of memory allocating output filename.");
 				}
-				snprintf(ccx_options.enc_cfg.output_filename, needed_len, "%s_%06d%s", ctx->basefilename, ctx->segment_counter + 1, extension);
-				reset_output_ctx(enc_ctx, &ccx_options.enc_cfg);
+				snprintf(ctx->enc_cfg.output_filename, needed_len, "%s_%06d%s", ctx->basefilename, ctx->segment_counter + 1, extension);
+				reset_output_ctx(enc_ctx, &ctx->enc_cfg);
 			}
 		}
 	}
@@ -1153,7 +1150,7 @@ int process_non_multiprogram_general_loop(struct lib_ccx_ctx *ctx,
 		}
 
 		// Process the last subtitle for DVB
-		if (!(!terminate_asap && !end_of_file && is_decoder_processed_enough(ctx) == CCX_FALSE))
+		if (!(!ctx->terminate_asap && !ctx->end_of_file && is_decoder_processed_enough(ctx) == CCX_FALSE))
 		{
 			if ((*data_node)->bufferdatatype == CCX_DVB_SUBTITLE && (*dec_ctx)->dec_sub.prev->end_time == 0)
 			{
@@ -1223,16 +1220,16 @@ int general_loop(struct lib_ccx_ctx *ctx)
 			fatal(CCX_COMMON_EXIT_BUG_BUG, "In general_loop: Impossible value for stream_mode");
 	}
 
-	end_of_file = 0;
+	ctx->end_of_file = 0;
 
-	while (!terminate_asap && !end_of_file && is_decoder_processed_enough(ctx) == CCX_FALSE)
+	while (!ctx->terminate_asap && !ctx->end_of_file && is_decoder_processed_enough(ctx) == CCX_FALSE)
 	{
 		// GET MORE DATA IN BUFFER
 		position_sanity_check(ctx->demux_ctx);
 		ret = get_more_data(ctx, &datalist);
 		if (ret == CCX_EOF)
 		{
-			end_of_file = 1;
+			ctx->end_of_file = 1;
 		}
 		if (!datalist)
 			continue;
@@ -1350,7 +1347,7 @@ int general_loop(struct lib_ccx_ctx *ctx)
 						caps = 1;
 				}
 				// Process the last subtitle for DVB
-				if (!(!terminate_asap && !end_of_file && is_decoder_processed_enough(ctx) == CCX_FALSE))
+				if (!(!ctx->terminate_asap && !ctx->end_of_file && is_decoder_processed_enough(ctx) == CCX_FALSE))
 				{
 					if (data_node->bufferdatatype == CCX_DVB_SUBTITLE && dec_ctx && dec_ctx->dec_sub.prev && dec_ctx->dec_sub.prev->end_time == 0)
 					{
@@ -1473,7 +1470,7 @@ int rcwt_loop(struct lib_ccx_ctx *ctx)
 	if (result != 11)
 	{
 		mprint("Premature end of file!\n");
-		end_of_file = 1;
+		ctx->end_of_file = 1;
 		free(parsebuf);
 		return -1;
 	}
@@ -1545,7 +1542,7 @@ int rcwt_loop(struct lib_ccx_ctx *ctx)
 				mprint("Premature end of file!\n");
 
 			// We are done
-			end_of_file = 1;
+			ctx->end_of_file = 1;
 			break;
 		}
 		currfts = *((LLONG *)(parsebuf));
@@ -1573,7 +1570,7 @@ int rcwt_loop(struct lib_ccx_ctx *ctx)
 			if (result != cbcount * 3)
 			{
 				mprint("Premature end of file!\n");
-				end_of_file = 1;
+				ctx->end_of_file = 1;
 				break;
 			}
 
@@ -8,6 +8,7 @@
 #include <libavcodec/avcodec.h>
 #include <libavformat/avformat.h>
 #include <libavutil/imgutils.h>
+#include <libavutil/pixdesc.h>
 #include <libswscale/swscale.h>
 
 int hardsubx_process_data(struct lib_hardsubx_ctx *ctx, struct lib_ccx_ctx *ctx_normal)
@@ -71,15 +72,34 @@ int hardsubx_process_data(struct lib_hardsubx_ctx *ctx, struct lib_ccx_ctx *ctx_
 		fatal(EXIT_NOT_ENOUGH_MEMORY, "Not enough memory to initialize frame!");
 	}
 
+	// Only the subtitle band at the bottom of the frame is examined. Ticker text
+	// is searched for over the whole frame.
+	const AVPixFmtDescriptor *pix_desc = av_pix_fmt_desc_get(ctx->codec_ctx->pix_fmt);
+	int height = ctx->codec_ctx->height;
+	ctx->band_top = 0;
+	ctx->band_source = HARDSUBX_BAND_RGB;
+	if (!ctx->tickertext)
+	{
+		ctx->band_top = height - (int)(height * ctx->band_height / 100);
+		// Subsampled chroma planes have to be cropped on a whole chroma row
+		ctx->band_top &= ~((1 << pix_desc->log2_chroma_h) - 1);
+
+		// White text only needs luminance, which 8-bit YUV input already has in its Y plane
+		if (ctx->subcolor == HARDSUBX_COLOR_WHITE && !(pix_desc->flags & (AV_PIX_FMT_FLAG_RGB | AV_PIX_FMT_FLAG_PAL)) &&
+		    pix_desc->comp[0].plane == 0 && pix_desc->comp[0].step == 1 && pix_desc->comp[0].depth == 8)
+			ctx->band_source = HARDSUBX_BAND_LUMA;
+	}
+
+	// rgb_frame keeps the full frame geometry, but only the band rows are ever converted
 	int frame_bytes = av_image_get_buffer_size(AV_PIX_FMT_RGB24, ctx->codec_ctx->width, ctx->codec_ctx->height, 16);
-	ctx->rgb_buffer = (uint8_t *)av_malloc(frame_bytes * sizeof(uint8_t));
+	ctx->rgb_buffer = (uint8_t *)av_mallocz(frame_bytes * sizeof(uint8_t));
 
 	ctx->sws_ctx = sws_getContext(
 	    ctx->codec_ctx->width,
-	    ctx->codec_ctx->height,
+	    height - ctx->band_top,
 	    ctx->codec_ctx->pix_fmt,
 	    ctx->codec_ctx->width,
-	    ctx->codec_ctx->height,
+	    height - ctx->band_top,
 	    AV_PIX_FMT_RGB24,
 	    SWS_BILINEAR,
 	    NULL, NULL, NULL);
@@ -211,6 +231,15 @@ void _hardsubx_params_dump(struct ccx_s_options *options, struct lib_hardsubx_ct
 		mprint("OCR Italic Detection : Off\n");
 	}
 
+	if (ctx->band_height != 25.0)
+	{
+		mprint("Subtitle Band Height : %.2f%%\n", ctx->band_height);
+	}
+	else
+	{
+		mprint("Subtitle Band Height : %.2f%% (Default)\n", ctx->band_height);
+	}
+
 	if (ctx->min_sub_duration == 0.5)
 	{
 		mprint("Minimum subtitle duration : 0.5 seconds (Default)\n");
@@ -313,6 +342,7 @@ struct lib_hardsubx_ctx *_init_hardsubx(struct ccx_s_options *options)
 	ctx->conf_thresh = options->hardsubx_conf_thresh;
 	ctx->hue = options->hardsubx_hue;
 	ctx->lum_thresh = options->hardsubx_lum_thresh;
+	ctx->band_height = options->hardsubx_band_height;
 	ctx->hardsubx_and_common = options->hardsubx_and_common;
 
 	// Initialize subtitle structure memory
@@ -338,6 +368,10 @@ void _dinit_hardsubx(struct lib_hardsubx_ctx **ctx)
 	TessBaseAPIEnd(lctx->tess_handle);
 	TessBaseAPIDelete(lctx->tess_handle);
 
+	// Free subtitle band scratch images
+	pixDestroy(&lctx->band_gray);
+	pixDestroy(&lctx->band_lum);
+
 	// Free basefilename (allocated by get_basename in _init_hardsubx)
 	freep(&lctx->basefilename);
 
@@ -24,6 +24,23 @@ enum hardsubx_color_type
 	HARDSUBX_COLOR_CUSTOM = 7,
 };
 
+// Where the subtitle band of a sampled frame is read from
+enum hardsubx_band_source
+{
+	HARDSUBX_BAND_RGB = 0,		  // band rows of rgb_frame, converted by sws_scale
+	HARDSUBX_BAND_LUMA = 1,		  // Y plane of the decoded frame, limited range
+	HARDSUBX_BAND_LUMA_FULL_RANGE = 2, // Y plane of the decoded frame, full range
+};
+
+// Frames are sampled at most once every HARDSUBX_SAMPLE_FRAMES frames
+#define HARDSUBX_SAMPLE_FRAMES 25
+
+struct hardsubx_sampler
+{
+	int64_t interval; // in video stream time base units
+	int64_t next_pts; // frames before this timestamp are skipped
+};
+
 enum hardsubx_ocr_mode
 {
 	HARDSUBX_OCRMODE_FRAME = 0,
@@ -31,6 +48,20 @@ enum hardsubx_ocr_mode
 	HARDSUBX_OCRMODE_LETTER = 2,
 };
 
+// Luma signature of the subtitle band (bottom quarter of the frame), used to
+// skip OCR on sampled frames whose band has not changed since the last OCR.
+#define HARDSUBX_SIGNATURE_COLS 64
+#define HARDSUBX_SIGNATURE_ROWS 8
+// Largest change of a cell's mean luma that still counts as the same band
+#define HARDSUBX_SIGNATURE_MAX_DIFF 6
+
+struct hardsubx_ocr_gate
+{
+	int valid;
+	uint8_t signature[HARDSUBX_SIGNATURE_ROWS * HARDSUBX_SIGNATURE_COLS];
+	char *text; // OCR text of the frame the signature was taken from, owned by the gate
+};
+
 struct lib_hardsubx_ctx
 {
 	// The main context for hard subtitle extraction
@@ -78,6 +109,15 @@ struct lib_hardsubx_ctx
 	float conf_thresh;
 	float hue;
 	float lum_thresh;
+
+	// Subtitle band scratch images, reused across frames by _process_frame_white_basic
+	PIX *band_gray;
+	PIX *band_lum;
+
+	// Subtitle band: only the rows from band_top to the bottom of the frame are examined
+	float band_height; // percentage of the frame height
+	int band_top;
+	int band_source; // enum hardsubx_band_source
 };
 
 struct lib_hardsubx_ctx *_init_hardsubx(struct ccx_s_options *options);
@@ -92,9 +132,13 @@ int hardsubx_process_frames_tickertext(struct lib_hardsubx_ctx *ctx, struct enco
 void hardsubx_process_frames_binary(struct lib_hardsubx_ctx *ctx);
 char *_process_frame_white_basic(struct lib_hardsubx_ctx *ctx, AVFrame *frame, int width, int height, int index);
 char *_process_frame_color_basic(struct lib_hardsubx_ctx *ctx, AVFrame *frame, int width, int height, int index);
-void _display_frame(struct lib_hardsubx_ctx *ctx, AVFrame *frame, int width, int height, int timestamp);
 char *_process_frame_tickertext(struct lib_hardsubx_ctx *ctx, AVFrame *frame, int width, int height, int index);
 void process_hardsubx_linear_frames_and_normal_subs(struct lib_hardsubx_ctx *hard_ctx, struct encoder_ctx *enc_ctx, struct lib_ccx_ctx *ctx);
+void hardsubx_sampler_init(struct lib_hardsubx_ctx *ctx, struct hardsubx_sampler *sampler);
+int hardsubx_sample_frame(struct lib_hardsubx_ctx *ctx, struct hardsubx_sampler *sampler, int64_t *pts);
+void hardsubx_convert_band(struct lib_hardsubx_ctx *ctx);
+char *hardsubx_ocr_frame_gated(struct lib_hardsubx_ctx *ctx, struct hardsubx_ocr_gate *gate, int frame_number);
+void hardsubx_ocr_gate_free(struct hardsubx_ocr_gate *gate);
 
 // hardsubx_imgops.c
 void rgb_to_hsv(float R, float G, float B, float *H, float *S, float *V);
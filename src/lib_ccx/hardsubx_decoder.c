@@ -6,6 +6,7 @@
 #include <libavcodec/avcodec.h>
 #include <libavformat/avformat.h>
 #include <libavutil/imgutils.h>
+#include <libavutil/pixdesc.h>
 #include <libswscale/swscale.h>
 #include <leptonica/allheaders.h>
 #include <tesseract/capi.h>
@@ -14,83 +15,151 @@
 #include "ffmpeg_intgr.h"
 #endif
 
-void _display_frame(struct lib_hardsubx_ctx *ctx, AVFrame *frame, int width, int height, int timestamp)
+static void _roi_signature(struct lib_hardsubx_ctx *ctx, uint8_t *signature)
 {
-	// Debug: Display the frame after processing
-	PIX *im;
-	PIX *hue_im;
-	PIX *gray_im;
-	PIX *sobel_edge_im;
-	PIX *dilate_gray_im;
-	PIX *edge_im;
-	PIX *gray_im_2;
-	PIX *edge_im_2;
-	PIX *pixd;
-	PIX *feat_im;
-
-	im = pixCreate(width, height, 32);
-	hue_im = pixCreate(width, height, 32);
-
-	for (int i = 0; i < height; i++)
+	// Mean luma of each cell of a grid laid over the subtitle band, the rows
+	// _process_frame_white_basic and _process_frame_color_basic OCR.
+	uint32_t sums[HARDSUBX_SIGNATURE_ROWS * HARDSUBX_SIGNATURE_COLS] = {0};
+	uint32_t counts[HARDSUBX_SIGNATURE_ROWS * HARDSUBX_SIGNATURE_COLS] = {0};
+	int width = ctx->codec_ctx->width;
+	int height = ctx->codec_ctx->height;
+	int top = ctx->band_top;
+	int band_height = height - top;
+	AVFrame *frame = ctx->band_source == HARDSUBX_BAND_RGB ? ctx->rgb_frame : ctx->frame;
+
+	for (int i = top; i < height; i++)
 	{
+		const uint8_t *row = frame->data[0] + i * frame->linesize[0];
+		int cell_row = ((i - top) * HARDSUBX_SIGNATURE_ROWS / band_height) * HARDSUBX_SIGNATURE_COLS;
 		for (int j = 0; j < width; j++)
 		{
-			int p = j * 3 + i * frame->linesize[0];
-			int r = frame->data[0][p];
-			int g = frame->data[0][p + 1];
-			int b = frame->data[0][p + 2];
-			pixSetRGBPixel(im, j, i, r, g, b);
-			float H, S, V;
-			rgb_to_hsv((float)r, (float)g, (float)b, &H, &S, &V);
-			if (fabsf(H - ctx->hue) < 20)
+			int cell = cell_row + j * HARDSUBX_SIGNATURE_COLS / width;
+			if (ctx->band_source == HARDSUBX_BAND_RGB)
 			{
-				pixSetRGBPixel(hue_im, j, i, r, g, b);
+				const uint8_t *p = row + j * 3;
+				sums[cell] += (77 * p[0] + 150 * p[1] + 29 * p[2]) >> 8;
 			}
+			else
+				sums[cell] += row[j];
+			counts[cell]++;
 		}
 	}
 
-	gray_im = pixConvertRGBToGray(im, 0.0, 0.0, 0.0);
-	sobel_edge_im = pixSobelEdgeFilter(gray_im, L_VERTICAL_EDGES);
-	dilate_gray_im = pixDilateGray(sobel_edge_im, 21, 1);
-	edge_im = pixThresholdToBinary(dilate_gray_im, 50);
+	for (int k = 0; k < HARDSUBX_SIGNATURE_ROWS * HARDSUBX_SIGNATURE_COLS; k++)
+		signature[k] = counts[k] ? sums[k] / counts[k] : 0;
+}
 
-	gray_im_2 = pixConvertRGBToGray(hue_im, 0.0, 0.0, 0.0);
-	edge_im_2 = pixDilateGray(gray_im_2, 5, 5);
+static int _signature_matches(const uint8_t *a, const uint8_t *b)
+{
+	for (int k = 0; k < HARDSUBX_SIGNATURE_ROWS * HARDSUBX_SIGNATURE_COLS; k++)
+	{
+		if (abs(a[k] - b[k]) > HARDSUBX_SIGNATURE_MAX_DIFF)
+			return 0;
+	}
+	return 1;
+}
 
-	pixSauvolaBinarize(gray_im_2, 15, 0.3, 1, NULL, NULL, NULL, &pixd);
+void hardsubx_convert_band(struct lib_hardsubx_ctx *ctx)
+{
+	// Convert the subtitle band of the decoded frame to RGB24, into the same rows of
+	// rgb_frame. The rows above the band are never written.
+	const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(ctx->frame->format);
+	const uint8_t *src[4] = {NULL};
+	uint8_t *dst[4] = {NULL};
 
-	feat_im = pixCreate(width, height, 32);
-	for (int i = 3 * (height / 4); i < height; i++)
+	if (ctx->band_source != HARDSUBX_BAND_RGB)
 	{
-		for (int j = 0; j < width; j++)
-		{
-			unsigned int p1, p2, p3, p4;
-			pixGetPixel(edge_im, j, i, &p1);
-			pixGetPixel(pixd, j, i, &p2);
-			// pixGetPixel(hue_im,j,i,&p3);
-			pixGetPixel(edge_im_2, j, i, &p4);
-			if (p1 == 0 && p2 == 0 && p4 > 0) // if(p4>0&&p1==0)//if(p2==0&&p1==0&&p3>0)
-			{
-				pixSetRGBPixel(feat_im, j, i, 255, 255, 255);
-			}
-		}
+		ctx->band_source = ctx->frame->color_range == AVCOL_RANGE_JPEG ? HARDSUBX_BAND_LUMA_FULL_RANGE : HARDSUBX_BAND_LUMA;
+		return;
+	}
+
+	for (int i = 0; i < 4 && ctx->frame->data[i]; i++)
+	{
+		int rows = ctx->band_top;
+		if (i == 1 && (desc->flags & AV_PIX_FMT_FLAG_PAL))
+			rows = 0; // palette
+		else if (i == 1 || i == 2)
+			rows >>= desc->log2_chroma_h;
+		src[i] = ctx->frame->data[i] + rows * ctx->frame->linesize[i];
+	}
+	dst[0] = ctx->rgb_frame->data[0] + ctx->band_top * ctx->rgb_frame->linesize[0];
+
+	sws_scale(
+	    ctx->sws_ctx,
+	    src,
+	    ctx->frame->linesize,
+	    0,
+	    ctx->codec_ctx->height - ctx->band_top,
+	    dst,
+	    ctx->rgb_frame->linesize);
+}
+
+char *hardsubx_ocr_frame_gated(struct lib_hardsubx_ctx *ctx, struct hardsubx_ocr_gate *gate, int frame_number)
+{
+	// OCR the subtitle band of the current frame, unless its luma signature matches the
+	// last OCR'd frame, in which case that frame's text is returned again.
+	// The returned string is owned by the gate and stays valid until the next call.
+	uint8_t signature[HARDSUBX_SIGNATURE_ROWS * HARDSUBX_SIGNATURE_COLS];
+	int width = ctx->codec_ctx->width;
+	int height = ctx->codec_ctx->height;
+
+	_roi_signature(ctx, signature);
+	if (gate->valid && _signature_matches(signature, gate->signature))
+		return gate->text;
+
+	free_rust_c_string(gate->text);
+	if (ctx->subcolor == HARDSUBX_COLOR_WHITE)
+	{
+		AVFrame *band = ctx->band_source == HARDSUBX_BAND_RGB ? ctx->rgb_frame : ctx->frame;
+		gate->text = _process_frame_white_basic(ctx, band, width, height, frame_number);
 	}
+	else
+		gate->text = _process_frame_color_basic(ctx, ctx->rgb_frame, width, height, frame_number);
+
+	memcpy(gate->signature, signature, sizeof(signature));
+	gate->valid = 1;
+	return gate->text;
+}
+
+void hardsubx_ocr_gate_free(struct hardsubx_ocr_gate *gate)
+{
+	free_rust_c_string(gate->text);
+	gate->text = NULL;
+	gate->valid = 0;
+}
 
-	// char *txt=NULL;
-	// txt = get_ocr_text_simple(ctx, feat_im);
-	// txt=get_ocr_text_wordwise_threshold(ctx, feat_im, ctx->conf_thresh);
-	// if(txt != NULL)printf("%s\n", txt);
-
-	pixDestroy(&im);
-	pixDestroy(&hue_im);
-	pixDestroy(&gray_im);
-	pixDestroy(&sobel_edge_im);
-	pixDestroy(&dilate_gray_im);
-	pixDestroy(&edge_im);
-	pixDestroy(&gray_im_2);
-	pixDestroy(&edge_im_2);
-	pixDestroy(&pixd);
-	pixDestroy(&feat_im);
+void hardsubx_sampler_init(struct lib_hardsubx_ctx *ctx, struct hardsubx_sampler *sampler)
+{
+	// Sample one frame every HARDSUBX_SAMPLE_FRAMES frames, but never more often
+	// than the minimum subtitle duration.
+	AVStream *stream = ctx->format_ctx->streams[ctx->video_stream_id];
+	AVRational rate = stream->avg_frame_rate.num ? stream->avg_frame_rate : stream->r_frame_rate;
+	double seconds = ctx->min_sub_duration;
+
+	if (rate.num > 0 && rate.den > 0)
+		seconds = FFMAX(seconds, HARDSUBX_SAMPLE_FRAMES / av_q2d(rate));
+	sampler->interval = FFMAX(1, (int64_t)(seconds / av_q2d(stream->time_base)));
+	sampler->next_pts = INT64_MIN;
+
+	// Frames no other frame is predicted from are always dropped, also when a sample
+	// falls due: the sample then lands on the next reference frame instead.
+	ctx->codec_ctx->skip_frame = AVDISCARD_NONREF;
+}
+
+int hardsubx_sample_frame(struct lib_hardsubx_ctx *ctx, struct hardsubx_sampler *sampler, int64_t *pts)
+{
+	// Returns 1 if the frame just decoded into ctx->frame is due for processing,
+	// with its presentation timestamp in *pts.
+	int64_t frame_pts = ctx->frame->best_effort_timestamp;
+
+	if (frame_pts == AV_NOPTS_VALUE)
+		frame_pts = ctx->frame->pts;
+	if (frame_pts == AV_NOPTS_VALUE || frame_pts < sampler->next_pts)
+		return 0;
+
+	sampler->next_pts = frame_pts + sampler->interval;
+	*pts = frame_pts;
+	return 1;
 }
 
 int hardsubx_process_frames_tickertext(struct lib_hardsubx_ctx *ctx, struct encoder_ctx *enc_ctx)
@@ -109,15 +178,8 @@ int hardsubx_process_frames_tickertext(struct lib_hardsubx_ctx *ctx, struct enco
 			avcodec_send_packet(ctx->codec_ctx, &ctx->packet);
 			if (avcodec_receive_frame(ctx->codec_ctx, ctx->frame) == 0 && frame_number % 1000 == 0)
 			{
-				// sws_scale is used to convert the pixel format to RGB24 from all other cases
-				sws_scale(
-				    ctx->sws_ctx,
-				    (uint8_t const *const *)ctx->frame->data,
-				    ctx->frame->linesize,
-				    0,
-				    ctx->codec_ctx->height,
-				    ctx->rgb_frame->data,
-				    ctx->rgb_frame->linesize);
+				// Convert the subtitle band to RGB24 (a no-op when white text is read from the Y plane)
+				hardsubx_convert_band(ctx);
 
 				ticker_text = _process_frame_tickertext(ctx, ctx->rgb_frame, ctx->codec_ctx->width, ctx->codec_ctx->height, frame_number);
 				printf("frame_number: %d\n", frame_number);
@@ -146,9 +208,13 @@ void hardsubx_process_frames_linear(struct lib_hardsubx_ctx *ctx, struct encoder
 	int cur_sec = 0, total_sec, progress;
 	int frame_number = 0;
 	int64_t prev_begin_time = 0, prev_end_time = 0; // Begin and end time of previous seen subtitle
-	int64_t prev_packet_pts = 0;
+	int64_t frame_pts = 0, frame_ms = 0; // Timestamp of the sampled frame
 	char *subtitle_text = NULL;	 // Subtitle text of current frame
 	char *prev_subtitle_text = NULL; // Previously seen subtitle text
+	struct hardsubx_ocr_gate gate = {0};
+	struct hardsubx_sampler sampler;
+
+	hardsubx_sampler_init(ctx, &sampler);
 
 	while (av_read_frame(ctx->format_ctx, &ctx->packet) >= 0)
 	{
@@ -158,41 +224,24 @@ void hardsubx_process_frames_linear(struct lib_hardsubx_ctx *ctx, struct encoder
 
 			// Decode the video stream packet
 			avcodec_send_packet(ctx->codec_ctx, &ctx->packet);
-			if (avcodec_receive_frame(ctx->codec_ctx, ctx->frame) == 0 && frame_number % 25 == 0)
+			if (avcodec_receive_frame(ctx->codec_ctx, ctx->frame) == 0 && hardsubx_sample_frame(ctx, &sampler, &frame_pts))
 			{
-				float diff = (float)convert_pts_to_ms(ctx->packet.pts - prev_packet_pts, ctx->format_ctx->streams[ctx->video_stream_id]->time_base);
-				if (fabsf(diff) < 1000 * ctx->min_sub_duration) // If the minimum duration of a subtitle line is exceeded, process packet
-					continue;
-
-				// sws_scale is used to convert the pixel format to RGB24 from all other cases
-				sws_scale(
-				    ctx->sws_ctx,
-				    (uint8_t const *const *)ctx->frame->data,
-				    ctx->frame->linesize,
-				    0,
-				    ctx->codec_ctx->height,
-				    ctx->rgb_frame->data,
-				    ctx->rgb_frame->linesize);
-
-				// Send the frame to other functions for processing
-				if (ctx->subcolor == HARDSUBX_COLOR_WHITE)
-				{
-					subtitle_text = _process_frame_white_basic(ctx, ctx->rgb_frame, ctx->codec_ctx->width, ctx->codec_ctx->height, frame_number);
-				}
-				else
-				{
-					subtitle_text = _process_frame_color_basic(ctx, ctx->rgb_frame, ctx->codec_ctx->width, ctx->codec_ctx->height, frame_number);
-				}
-				_display_frame(ctx, ctx->rgb_frame, ctx->codec_ctx->width, ctx->codec_ctx->height, frame_number);
+				frame_ms = convert_pts_to_ms(frame_pts, ctx->format_ctx->streams[ctx->video_stream_id]->time_base);
 
-				cur_sec = (int)convert_pts_to_s(ctx->packet.pts, ctx->format_ctx->streams[ctx->video_stream_id]->time_base);
+				// Convert the subtitle band to RGB24 (a no-op when white text is read from the Y plane)
+				hardsubx_convert_band(ctx);
+
+				// Send the frame to other functions for processing, unless the subtitle band is unchanged
+				subtitle_text = hardsubx_ocr_frame_gated(ctx, &gate, frame_number);
+
+				cur_sec = (int)(frame_ms / 1000);
 				total_sec = (int)convert_pts_to_s(ctx->format_ctx->duration, AV_TIME_BASE_Q);
 				progress = (cur_sec * 100) / total_sec;
 				activity_progress(progress, cur_sec / 60, cur_sec % 60);
 
 				if ((!subtitle_text && !prev_subtitle_text) || (subtitle_text && !strlen(subtitle_text) && !prev_subtitle_text))
 				{
-					prev_end_time = convert_pts_to_ms(ctx->packet.pts, ctx->format_ctx->streams[ctx->video_stream_id]->time_base);
+					prev_end_time = frame_ms;
 				}
 
 				if (subtitle_text)
@@ -210,9 +259,8 @@ void hardsubx_process_frames_linear(struct lib_hardsubx_ctx *ctx, struct encoder
 						if (dist < (0.2 * MIN(strlen(subtitle_text), strlen(prev_subtitle_text))))
 						{
 							dist = -1;
-							free_rust_c_string(subtitle_text);
 							subtitle_text = NULL;
-							prev_end_time = convert_pts_to_ms(ctx->packet.pts, ctx->format_ctx->streams[ctx->video_stream_id]->time_base);
+							prev_end_time = frame_ms;
 						}
 					}
 					if (dist != -1)
@@ -223,7 +271,7 @@ void hardsubx_process_frames_linear(struct lib_hardsubx_ctx *ctx, struct encoder
 						free(prev_subtitle_text);
 						prev_subtitle_text = NULL;
 						prev_sub_encoded = 1;
-						prev_end_time = convert_pts_to_ms(ctx->packet.pts, ctx->format_ctx->streams[ctx->video_stream_id]->time_base);
+						prev_end_time = frame_ms;
 						if (subtitle_text)
 						{
 							prev_subtitle_text = strdup(subtitle_text);
@@ -249,14 +297,12 @@ void hardsubx_process_frames_linear(struct lib_hardsubx_ctx *ctx, struct encoder
 				if (!prev_subtitle_text && subtitle_text)
 				{
 					prev_begin_time = prev_end_time + 1;
-					prev_end_time = convert_pts_to_ms(ctx->packet.pts, ctx->format_ctx->streams[ctx->video_stream_id]->time_base);
+					prev_end_time = frame_ms;
 					prev_subtitle_text = strdup(subtitle_text);
 					prev_sub_encoded = 0;
 				}
-				prev_packet_pts = ctx->packet.pts;
 
-				// Free subtitle_text from this iteration (was allocated by Rust in _process_frame_*_basic)
-				free_rust_c_string(subtitle_text);
+				// subtitle_text is owned by the OCR gate
 				subtitle_text = NULL;
 			}
 		}
@@ -272,6 +318,7 @@ void hardsubx_process_frames_linear(struct lib_hardsubx_ctx *ctx, struct encoder
 
 	// Cleanup
 	free(prev_subtitle_text);
+	hardsubx_ocr_gate_free(&gate);
 	activity_progress(100, cur_sec / 60, cur_sec % 60);
 }
 
@@ -294,9 +341,13 @@ void process_hardsubx_linear_frames_and_normal_subs(struct lib_hardsubx_ctx *har
 	int cur_sec = 0, total_sec, progress;
 	int frame_number = 0;
 	int64_t prev_begin_time_hard = 0, prev_end_time_hard = 0; // Begin and end time of previous seen burnt-in subtitle
-	int64_t prev_packet_pts_hard = 0;
+	int64_t frame_pts = 0, frame_ms = 0; // Timestamp of the sampled frame
 	char *subtitle_text_hard = NULL;      // Subtitle text of current frame (burnt_in)
 	char *prev_subtitle_text_hard = NULL; // Previously seen burnt-in subtitle text
+	struct hardsubx_ocr_gate gate = {0};
+	struct hardsubx_sampler sampler;
+
+	hardsubx_sampler_init(hard_ctx, &sampler);
 
 	stream_mode = ctx->demux_ctx->get_stream_mode(ctx->demux_ctx);
 
@@ -340,7 +391,7 @@ void process_hardsubx_linear_frames_and_normal_subs(struct lib_hardsubx_ctx *har
 		default:
 			fatal(CCX_COMMON_EXIT_BUG_BUG, "In general_loop: Impossible value for stream_mode");
 	}
-	end_of_file = 0;
+	ctx->end_of_file = 0;
 	int status = 0;
 
 	int last_cc_encoded = 0;
@@ -348,18 +399,18 @@ void process_hardsubx_linear_frames_and_normal_subs(struct lib_hardsubx_ctx *har
 	while (true)
 	{
 
-		if (status < 0 && end_of_file == 1)
+		if (status < 0 && ctx->end_of_file == 1)
 		{
 			// status <= 0 implies either something is wrong or eof
 			break;
 		}
-		if ((!terminate_asap && !end_of_file && is_decoder_processed_enough(ctx) == CCX_FALSE) && ret != CCX_EINVAL)
+		if ((!ctx->terminate_asap && !ctx->end_of_file && is_decoder_processed_enough(ctx) == CCX_FALSE) && ret != CCX_EINVAL)
 		{
 			position_sanity_check(ctx->demux_ctx);
 			ret = get_more_data(ctx, &datalist);
 			if (ret == CCX_EOF)
 			{
-				end_of_file = 1;
+				ctx->end_of_file = 1;
 			}
 
 			if (datalist)
@@ -415,7 +466,7 @@ void process_hardsubx_linear_frames_and_normal_subs(struct lib_hardsubx_ctx *har
 					net_check_conn();
 			}
 		}
-		if (end_of_file && !last_cc_encoded)
+		if (ctx->end_of_file && !last_cc_encoded)
 		{
 			// the last closed caption needs to be encoded separately
 			// if EOF file has been hit for cc
@@ -425,7 +476,7 @@ void process_hardsubx_linear_frames_and_normal_subs(struct lib_hardsubx_ctx *har
 			encode_sub(enc_ctx, &dec_ctx->dec_sub);
 			last_cc_encoded = 1;
 		}
-		if (hard_ctx->dec_sub->start_time <= (dec_ctx->dec_sub).start_time || end_of_file == 1)
+		if (hard_ctx->dec_sub->start_time <= (dec_ctx->dec_sub).start_time || ctx->end_of_file == 1)
 		{
 			status = av_read_frame(hard_ctx->format_ctx, &hard_ctx->packet);
 
@@ -434,105 +485,73 @@ void process_hardsubx_linear_frames_and_normal_subs(struct lib_hardsubx_ctx *har
 				frame_number++;
 
 				avcodec_send_packet(hard_ctx->codec_ctx, &hard_ctx->packet);
-				if (avcodec_receive_frame(hard_ctx->codec_ctx,
-							  hard_ctx->frame) == 0 &&
-				    frame_number % 25 == 0)
+				if (avcodec_receive_frame(hard_ctx->codec_ctx, hard_ctx->frame) == 0 &&
+				    hardsubx_sample_frame(hard_ctx, &sampler, &frame_pts))
 				{
-					float diff = (float)convert_pts_to_ms(hard_ctx->packet.pts - prev_packet_pts_hard,
-									      hard_ctx->format_ctx->streams[hard_ctx->video_stream_id]->time_base);
+					frame_ms = convert_pts_to_ms(frame_pts, hard_ctx->format_ctx->streams[hard_ctx->video_stream_id]->time_base);
 
-					if (fabsf(diff) >= 1000 * hard_ctx->min_sub_duration)
-					{
+					// Convert the subtitle band to RGB24 (a no-op when white text is read from the Y plane)
+					hardsubx_convert_band(hard_ctx);
 
-						// sws_scale is used to convert the pixel format to RGB24 from all other cases
-						sws_scale(
-						    hard_ctx->sws_ctx,
-						    (uint8_t const *const *)hard_ctx->frame->data,
-						    hard_ctx->frame->linesize,
-						    0,
-						    hard_ctx->codec_ctx->height,
-						    hard_ctx->rgb_frame->data,
-						    hard_ctx->rgb_frame->linesize);
-
-						if (hard_ctx->subcolor == HARDSUBX_COLOR_WHITE)
-						{
-							subtitle_text_hard = _process_frame_white_basic(hard_ctx,
-													hard_ctx->rgb_frame,
-													hard_ctx->codec_ctx->width,
-													hard_ctx->codec_ctx->height,
-													frame_number);
-						}
-						else
-						{
-							subtitle_text_hard = _process_frame_color_basic(hard_ctx,
-													hard_ctx->rgb_frame,
-													hard_ctx->codec_ctx->width,
-													hard_ctx->codec_ctx->height,
-													frame_number);
-						}
+					subtitle_text_hard = hardsubx_ocr_frame_gated(hard_ctx, &gate, frame_number);
 
-						_display_frame(hard_ctx, hard_ctx->rgb_frame, hard_ctx->codec_ctx->width, hard_ctx->codec_ctx->height, frame_number);
-						cur_sec = (int)convert_pts_to_s(hard_ctx->packet.pts, hard_ctx->format_ctx->streams[hard_ctx->video_stream_id]->time_base);
-						total_sec = (int)convert_pts_to_s(hard_ctx->format_ctx->duration, AV_TIME_BASE_Q);
-						progress = (cur_sec * 100) / total_sec;
-						activity_progress(progress, cur_sec / 60, cur_sec % 60);
-						// progress on burnt-in extraction
-						if ((!subtitle_text_hard && !prev_subtitle_text_hard) || (subtitle_text_hard && !strlen(subtitle_text_hard) && !prev_subtitle_text_hard))
-						{
-							prev_end_time_hard = convert_pts_to_ms(hard_ctx->packet.pts, hard_ctx->format_ctx->streams[hard_ctx->video_stream_id]->time_base);
-						}
+					cur_sec = (int)(frame_ms / 1000);
+					total_sec = (int)convert_pts_to_s(hard_ctx->format_ctx->duration, AV_TIME_BASE_Q);
+					progress = (cur_sec * 100) / total_sec;
+					activity_progress(progress, cur_sec / 60, cur_sec % 60);
+					// progress on burnt-in extraction
+					if ((!subtitle_text_hard && !prev_subtitle_text_hard) || (subtitle_text_hard && !strlen(subtitle_text_hard) && !prev_subtitle_text_hard))
+					{
+						prev_end_time_hard = frame_ms;
+					}
 
-						if (subtitle_text_hard)
-						{
-							char *double_enter = strstr(subtitle_text_hard, "\n\n");
-							if (double_enter != NULL)
-								*(double_enter) = '\0';
-						}
+					if (subtitle_text_hard)
+					{
+						char *double_enter = strstr(subtitle_text_hard, "\n\n");
+						if (double_enter != NULL)
+							*(double_enter) = '\0';
+					}
 
-						if (!prev_sub_encoded_hard && prev_subtitle_text_hard)
+					if (!prev_sub_encoded_hard && prev_subtitle_text_hard)
+					{
+						if (subtitle_text_hard)
 						{
-							if (subtitle_text_hard)
-							{
-								dist = edit_distance(subtitle_text_hard, prev_subtitle_text_hard, (int)strlen(subtitle_text_hard), (int)strlen(prev_subtitle_text_hard));
-								if (dist < (0.2 * MIN(strlen(subtitle_text_hard), strlen(prev_subtitle_text_hard))))
-								{
-									dist = -1;
-									free_rust_c_string(subtitle_text_hard);
-									subtitle_text_hard = NULL;
-									prev_end_time_hard = convert_pts_to_ms(hard_ctx->packet.pts, hard_ctx->format_ctx->streams[hard_ctx->video_stream_id]->time_base);
-								}
-							}
-							if (dist != -1)
+							dist = edit_distance(subtitle_text_hard, prev_subtitle_text_hard, (int)strlen(subtitle_text_hard), (int)strlen(prev_subtitle_text_hard));
+							if (dist < (0.2 * MIN(strlen(subtitle_text_hard), strlen(prev_subtitle_text_hard))))
 							{
-								add_cc_sub_text(hard_ctx->dec_sub, prev_subtitle_text_hard, prev_begin_time_hard, prev_end_time_hard, "", "BURN", CCX_ENC_UTF_8);
-								encode_sub(enc_ctx, hard_ctx->dec_sub);
-								prev_begin_time_hard = prev_end_time_hard + 1;
-								free(prev_subtitle_text_hard);
-								prev_subtitle_text_hard = NULL;
-								prev_sub_encoded_hard = 1;
-								prev_end_time_hard = convert_pts_to_ms(hard_ctx->packet.pts, hard_ctx->format_ctx->streams[hard_ctx->video_stream_id]->time_base);
-								if (subtitle_text_hard)
-								{
-									prev_subtitle_text_hard = strdup(subtitle_text_hard);
-									prev_sub_encoded_hard = 0;
-								}
+								dist = -1;
+								subtitle_text_hard = NULL;
+								prev_end_time_hard = frame_ms;
 							}
-							dist = 0;
 						}
-
-						if (!prev_subtitle_text_hard && subtitle_text_hard)
+						if (dist != -1)
 						{
+							add_cc_sub_text(hard_ctx->dec_sub, prev_subtitle_text_hard, prev_begin_time_hard, prev_end_time_hard, "", "BURN", CCX_ENC_UTF_8);
+							encode_sub(enc_ctx, hard_ctx->dec_sub);
 							prev_begin_time_hard = prev_end_time_hard + 1;
-							prev_end_time_hard = convert_pts_to_ms(hard_ctx->packet.pts, hard_ctx->format_ctx->streams[hard_ctx->video_stream_id]->time_base);
-							prev_subtitle_text_hard = strdup(subtitle_text_hard);
-							prev_sub_encoded_hard = 0;
+							free(prev_subtitle_text_hard);
+							prev_subtitle_text_hard = NULL;
+							prev_sub_encoded_hard = 1;
+							prev_end_time_hard = frame_ms;
+							if (subtitle_text_hard)
+							{
+								prev_subtitle_text_hard = strdup(subtitle_text_hard);
+								prev_sub_encoded_hard = 0;
+							}
 						}
-						prev_packet_pts_hard = hard_ctx->packet.pts;
+						dist = 0;
+					}
 
-						// Free subtitle_text_hard from this iteration (allocated by Rust)
-						free_rust_c_string(subtitle_text_hard);
-						subtitle_text_hard = NULL;
+					if (!prev_subtitle_text_hard && subtitle_text_hard)
+					{
+						prev_begin_time_hard = prev_end_time_hard + 1;
+						prev_end_time_hard = frame_ms;
+						prev_subtitle_text_hard = strdup(subtitle_text_hard);
+						prev_sub_encoded_hard = 0;
 					}
+
+					// subtitle_text_hard is owned by the OCR gate
+					subtitle_text_hard = NULL;
 				}
 			}
 			av_packet_unref(&hard_ctx->packet);
@@ -547,6 +566,7 @@ void process_hardsubx_linear_frames_and_normal_subs(struct lib_hardsubx_ctx *har
 
 	// Cleanup
 	free(prev_subtitle_text_hard);
+	hardsubx_ocr_gate_free(&gate);
 	activity_progress(100, cur_sec / 60, cur_sec % 60);
 }
 
@@ -580,17 +600,8 @@ void hardsubx_process_frames_binary(struct lib_hardsubx_ctx *ctx)
 						if (ctx->packet.pts < seek_time)
 							continue;
 						// printf("GOT FRAME: %d\n",ctx->packet.pts);
-						// sws_scale is used to convert the pixel format to RGB24 from all other cases
-						sws_scale(
-						    ctx->sws_ctx,
-						    (uint8_t const *const *)ctx->frame->data,
-						    ctx->frame->linesize,
-						    0,
-						    ctx->codec_ctx->height,
-						    ctx->rgb_frame->data,
-						    ctx->rgb_frame->linesize);
-						// Send the frame to other functions for processing
-						_display_frame(ctx, ctx->rgb_frame, ctx->codec_ctx->width, ctx->codec_ctx->height, seconds_time);
+						// Convert the subtitle band to RGB24 (a no-op when white text is read from the Y plane)
+						hardsubx_convert_band(ctx);
 						break;
 					}
 				}
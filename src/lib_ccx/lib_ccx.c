@@ -5,8 +5,49 @@
 #include "dvb_subtitle_decoder.h"
 #include "ccx_decoders_708.h"
 #include "ccx_decoders_isdb.h"
+#include "ccx_encoders_helpers.h"
 
 struct ccx_common_logging_t ccx_common_logging;
+
+// Contexts that exist. The first one sets up what all of them share
+static int live_contexts = 0;
+static ccx_static_lock live_contexts_lock = CCX_STATIC_LOCK_INIT;
+
+/* Counts a new context. Contexts that exist at the same time share the logging functions,
+   tables and timing settings set up for the first one, so they must come from the same options. */
+static void acquire_context(struct ccx_s_options *opt)
+{
+	ccx_static_lock_acquire(&live_contexts_lock);
+	if (!live_contexts)
+	{
+		activity_header(); // Brag about writing it :-)
+
+		// Set logging functions for libraries
+		ccx_common_logging.debug_ftn = &dbg_print;
+		ccx_common_logging.debug_mask = opt->debug_mask;
+		ccx_common_logging.fatal_ftn = &fatal;
+		ccx_common_logging.log_ftn = &mprint;
+		ccx_common_logging.gui_ftn = &activity_library_process;
+
+		// The word lists are final once the parameters are parsed
+		ccx_encoders_helpers_build_word_matchers();
+		build_parity_table();
+
+		// Shared, so it can't point at the position of one context's file
+		ccx_common_timing_init(NULL, opt->nosync);
+	}
+	live_contexts++;
+	ccx_static_lock_release(&live_contexts_lock);
+}
+
+static void release_context(void)
+{
+	ccx_static_lock_acquire(&live_contexts_lock);
+	if (!--live_contexts)
+		freep(&ccx_options.enc_cfg.output_filename);
+	ccx_static_lock_release(&live_contexts_lock);
+}
+
 static struct ccx_decoders_common_settings_t *init_decoder_setting(
     struct ccx_s_options *opt)
 {
@@ -26,8 +67,18 @@ static struct ccx_decoders_common_settings_t *init_decoder_setting(
 	memcpy(&setting->extraction_start, &opt->extraction_start, sizeof(struct ccx_boundary_time));
 	memcpy(&setting->extraction_end, &opt->extraction_end, sizeof(struct ccx_boundary_time));
 	setting->cc_to_stdout = opt->cc_to_stdout;
-	setting->settings_608 = &opt->settings_608;
-	setting->settings_dtvcc = &opt->settings_dtvcc;
+	// Copies, as each context puts its own reports and timing in them
+	setting->settings_608 = malloc(sizeof(struct ccx_decoder_608_settings));
+	setting->settings_dtvcc = malloc(sizeof(ccx_decoder_dtvcc_settings));
+	if (!setting->settings_608 || !setting->settings_dtvcc)
+	{
+		free(setting->settings_608);
+		free(setting->settings_dtvcc);
+		free(setting);
+		return NULL;
+	}
+	*setting->settings_608 = opt->settings_608;
+	*setting->settings_dtvcc = opt->settings_dtvcc;
 	setting->cc_channel = opt->cc_channel;
 	setting->send_to_srv = opt->send_to_srv;
 	setting->hauppauge_mode = opt->hauppauge_mode;
@@ -39,6 +90,11 @@ static struct ccx_decoders_common_settings_t *init_decoder_setting(
 }
 static void dinit_decoder_setting(struct ccx_decoders_common_settings_t **setting)
 {
+	if (*setting)
+	{
+		freep(&(*setting)->settings_608);
+		freep(&(*setting)->settings_dtvcc);
+	}
 	freep(setting);
 }
 
@@ -94,14 +150,7 @@ struct lib_ccx_ctx *init_libraries(struct ccx_s_options *opt)
 {
 	int ret = 0;
 
-	activity_header(); // Brag about writing it :-)
-
-	// Set logging functions for libraries
-	ccx_common_logging.debug_ftn = &dbg_print;
-	ccx_common_logging.debug_mask = opt->debug_mask;
-	ccx_common_logging.fatal_ftn = &fatal;
-	ccx_common_logging.log_ftn = &mprint;
-	ccx_common_logging.gui_ftn = &activity_library_process;
+	acquire_context(opt);
 
 	struct lib_ccx_ctx *ctx = malloc(sizeof(struct lib_ccx_ctx));
 	if (!ctx)
@@ -154,6 +203,7 @@ struct lib_ccx_ctx *init_libraries(struct ccx_s_options *opt)
 		free(report_dtvcc);
 		EPG_free(ctx);
 		free(ctx);
+		release_context();
 		return NULL;
 	}
 
@@ -187,14 +237,21 @@ struct lib_ccx_ctx *init_libraries(struct ccx_s_options *opt)
 	ctx->hauppauge_mode = opt->hauppauge_mode;
 	ctx->live_stream = opt->live_stream;
 	ctx->binary_concat = opt->binary_concat;
-	build_parity_table();
 
 	ctx->demux_ctx = init_demuxer(ctx, &opt->demux_cfg);
+	ctx->demux_ctx->gui_mode_reports = opt->gui_mode_reports;
 	INIT_LIST_HEAD(&ctx->dec_ctx_head);
 	INIT_LIST_HEAD(&ctx->enc_ctx_head);
 
-	// Init timing
-	ccx_common_timing_init(&ctx->demux_ctx->past, opt->nosync);
+	// The encoders get their output file names from this copy
+	ctx->enc_cfg = opt->enc_cfg;
+	if (opt->enc_cfg.output_filename)
+	{
+		ctx->enc_cfg.output_filename = strdup(opt->enc_cfg.output_filename);
+		if (!ctx->enc_cfg.output_filename)
+			ccx_common_logging.fatal_ftn(EXIT_NOT_ENOUGH_MEMORY, "init_libraries: Not enough memory copying the output file name");
+	}
+
 	ctx->multiprogram = opt->multiprogram;
 	ctx->write_format = opt->write_format;
 	ctx->out_interval = opt->out_interval;
@@ -210,6 +267,7 @@ end:
 		free(ctx->freport.data_from_708);
 		EPG_free(ctx);
 		free(ctx);
+		release_context();
 		return NULL;
 	}
 	return ctx;
@@ -269,13 +327,14 @@ void dinit_libraries(struct lib_ccx_ctx **ctx)
 	freep(&lctx->freport.data_from_708);
 	ccx_demuxer_delete(&lctx->demux_ctx);
 	dinit_decoder_setting(&lctx->dec_global_setting);
-	freep(&ccx_options.enc_cfg.output_filename);
+	freep(&lctx->enc_cfg.output_filename);
 	freep(&lctx->basefilename);
 	freep(&lctx->pesheaderbuf);
 	for (i = 0; i < lctx->num_input_files; i++)
 		freep(&lctx->inputfile[i]);
 	freep(&lctx->inputfile);
 	freep(ctx);
+	release_context();
 }
 
 int is_decoder_processed_enough(struct lib_ccx_ctx *ctx)
@@ -400,7 +459,8 @@ struct encoder_ctx *update_encoder_list_cinfo(struct lib_ccx_ctx *ctx, struct ca
 	unsigned int pn = 0;
 	unsigned char in_format = 1;
 
-	if (ctx->write_format == CCX_OF_NULL)
+	// Without an output, an encoder is only needed to report subtitles to a library user
+	if (ctx->write_format == CCX_OF_NULL && !ctx->enc_cfg.subtitle_callback)
 		return NULL;
 
 	if (cinfo)
@@ -422,8 +482,8 @@ struct encoder_ctx *update_encoder_list_cinfo(struct lib_ccx_ctx *ctx, struct ca
 			return enc_ctx;
 	}
 
-	const char *extension = get_file_extension(ccx_options.enc_cfg.write_format);
-	if (!extension && ccx_options.enc_cfg.write_format != CCX_OF_CURL)
+	const char *extension = get_file_extension(ctx->enc_cfg.write_format);
+	if (!extension && ctx->enc_cfg.write_format != CCX_OF_CURL && ctx->enc_cfg.write_format != CCX_OF_NULL)
 		return NULL;
 
 	if (ctx->multiprogram == CCX_FALSE)
@@ -433,20 +493,20 @@ struct encoder_ctx *update_encoder_list_cinfo(struct lib_ccx_ctx *ctx, struct ca
 			// Format: "%s_%06d%s" needs: basefilename + '_' + up to 10 digits + extension + null
 			size_t len = strlen(ctx->basefilename) + 1 + 10 + strlen(extension) + 1;
 
-			freep(&ccx_options.enc_cfg.output_filename);
-			ccx_options.enc_cfg.output_filename = malloc(len);
-			if (!ccx_options.enc_cfg.output_filename)
+			freep(&ctx->enc_cfg.output_filename);
+			ctx->enc_cfg.output_filename = malloc(len);
+			if (!ctx->enc_cfg.output_filename)
 			{
 				return NULL;
 			}
 
-			snprintf(ccx_options.enc_cfg.output_filename, len, "%s_%06d%s", ctx->basefilename, ctx->segment_counter + 1, extension);
+			snprintf(ctx->enc_cfg.output_filename, len, "%s_%06d%s", ctx->basefilename, ctx->segment_counter + 1, extension);
 		}
 		if (list_empty(&ctx->enc_ctx_head))
 		{
-			ccx_options.enc_cfg.program_number = pn;
-			ccx_options.enc_cfg.in_format = in_format;
-			enc_ctx = init_encoder(&ccx_options.enc_cfg);
+			ctx->enc_cfg.program_number = pn;
+			ctx->enc_cfg.in_format = in_format;
+			enc_ctx = init_encoder(&ctx->enc_cfg);
 			if (!enc_ctx)
 				return NULL;
 			list_add_tail(&(enc_ctx->list), &(ctx->enc_ctx_head));
@@ -457,23 +517,24 @@ struct encoder_ctx *update_encoder_list_cinfo(struct lib_ccx_ctx *ctx, struct ca
 		// Format: "%s_%d%s" needs: basefilename + '_' + up to 10 digits + extension + null
 		size_t len = strlen(ctx->basefilename) + 1 + 10 + strlen(extension) + 1;
 
-		ccx_options.enc_cfg.program_number = pn;
-		ccx_options.enc_cfg.output_filename = malloc(len);
-		if (!ccx_options.enc_cfg.output_filename)
+		ctx->enc_cfg.program_number = pn;
+		freep(&ctx->enc_cfg.output_filename);
+		ctx->enc_cfg.output_filename = malloc(len);
+		if (!ctx->enc_cfg.output_filename)
 		{
 			return NULL;
 		}
 
-		snprintf(ccx_options.enc_cfg.output_filename, len, "%s_%d%s", ctx->basefilename, pn, extension);
-		enc_ctx = init_encoder(&ccx_options.enc_cfg);
+		snprintf(ctx->enc_cfg.output_filename, len, "%s_%d%s", ctx->basefilename, pn, extension);
+		enc_ctx = init_encoder(&ctx->enc_cfg);
 		if (!enc_ctx)
 		{
-			freep(&ccx_options.enc_cfg.output_filename);
+			freep(&ctx->enc_cfg.output_filename);
 			return NULL;
 		}
 
 		list_add_tail(&(enc_ctx->list), &(ctx->enc_ctx_head));
-		freep(ccx_options.enc_cfg.output_filename);
+		freep(&ctx->enc_cfg.output_filename);
 	}
 	// DVB related
 	enc_ctx->prev = NULL;
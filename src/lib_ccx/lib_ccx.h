@@ -133,10 +133,14 @@ struct lib_ccx_ctx
 	int epg_inited;
 	struct PSI_buffer *epg_buffers;
 	struct EIT_program *eit_programs;
+	struct EPG_section_cache epg_sections;
 	int32_t *eit_current_events;
 	int16_t *ATSC_source_pg_map;
 	int epg_last_output;
 	int epg_last_live_output;
+	FILE *epg_journal;	       // Live XMLTV output, only appended to between snapshots
+	int epg_journal_channels;      // Programs whose <channel> is in the journal
+	unsigned epg_journal_entries;  // Programmes in the journal, superseded versions included
 	struct file_report freport;
 
 	unsigned int hauppauge_mode; // If 1, use PID=1003, process specially and so on
@@ -149,11 +153,15 @@ struct lib_ccx_ctx
 
 	struct ccx_demuxer *demux_ctx;
 	struct list_head enc_ctx_head;
+	struct encoder_cfg enc_cfg; // Copy of the options' one, with this extraction's output file name
 	struct ccx_s_mp4Cfg mp4_cfg;
 	int out_interval;
 	int segment_on_key_frames_only;
 	int segment_counter;
 	LLONG system_start_time;
+
+	int end_of_file;	     // 1 once the input has no more data
+	volatile int terminate_asap; // Set, e.g. from a signal handler, to stop this extraction as soon as possible
 };
 
 struct lib_ccx_ctx *init_libraries(struct ccx_s_options *opt);
@@ -190,8 +198,7 @@ int ccxr_is_scc_file(const unsigned char *buffer, unsigned int len);
 int general_loop(struct lib_ccx_ctx *ctx);
 void process_hex(struct lib_ccx_ctx *ctx, char *filename);
 int rcwt_loop(struct lib_ccx_ctx *ctx);
-
-extern int end_of_file;
+void delete_datalist(struct demuxer_data *list);
 
 int ccx_mxf_getmoredata(struct lib_ccx_ctx *ctx, struct demuxer_data **ppdata);
 
@@ -245,15 +252,15 @@ int detect_myth(struct ccx_demuxer *ctx);
 int read_video_pes_header(struct ccx_demuxer *ctx, struct demuxer_data *data, unsigned char *nextheader, int *headerlength, int sbuflen);
 
 // ts_functions.c
-void init_ts(struct ccx_demuxer *ctx);
 int ts_readpacket(struct ccx_demuxer *ctx, struct ts_payload *payload);
 int64_t ts_readstream(struct ccx_demuxer *ctx, struct demuxer_data **data);
 int ts_get_more_data(struct lib_ccx_ctx *ctx, struct demuxer_data **data);
+void cinfo_cremation(struct ccx_demuxer *ctx, struct demuxer_data **data);
 int write_section(struct ccx_demuxer *ctx, struct ts_payload *payload, unsigned char *buf, int size, struct program_info *pinfo);
 void ts_buffer_psi_packet(struct ccx_demuxer *ctx);
 int parse_PMT(struct ccx_demuxer *ctx, unsigned char *buf, int len, struct program_info *pinfo);
 int parse_PAT(struct ccx_demuxer *ctx);
-void parse_EPG_packet(struct lib_ccx_ctx *ctx);
+void parse_EPG_packet(struct lib_ccx_ctx *ctx, unsigned char *tspacket);
 void EPG_free(struct lib_ccx_ctx *ctx);
 char *EPG_DVB_decode_string(uint8_t *in, size_t size);
 void parse_SDT(struct ccx_demuxer *ctx);
@@ -283,6 +290,7 @@ int hex_to_int(char high, char low);
 int hex_string_to_int(char *string, int len);
 void timestamp_to_srttime(uint64_t timestamp, char *buffer);
 int levenshtein_dist(const uint64_t *s1, const uint64_t *s2, unsigned s1len, unsigned s2len);
+int levenshtein_dist_bounded(const uint64_t *s1, const uint64_t *s2, unsigned s1len, unsigned s2len, unsigned max);
 void millis_to_date(uint64_t timestamp, char *buffer, enum ccx_output_date_format date_format, char millis_separator);
 void signal_handler(int sig_type);
 struct encoder_ctx *change_filename(struct encoder_ctx *);
@@ -310,10 +318,8 @@ extern int firstcall;
 
 // From ts_functions
 // extern struct ts_payload payload;
-extern unsigned char tspacket[188];
 extern unsigned char *last_pat_payload;
 extern unsigned last_pat_length;
-extern volatile int terminate_asap;
 
 #define HAUPPAGE_CCPID 1003 // PID for CC's in some Hauppauge recordings
 
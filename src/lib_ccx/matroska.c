@@ -7,6 +7,9 @@
 #include <assert.h>
 #include "dvb_subtitle_decoder.h"
 #include "vobsub_decoder.h"
+#ifndef _WIN32
+#include <pthread.h>
+#endif
 
 void skip_bytes(FILE *file, ULLONG n)
 {
@@ -1435,15 +1438,9 @@ static int is_text_output_format(enum ccx_output_format format)
 		format == CCX_OF_SAMI || format == CCX_OF_SMPTETT);
 }
 
-/* VOBSUB support: Process VOBSUB track with OCR and output text format */
-static void process_vobsub_track_ocr(struct matroska_ctx *mkv_ctx, struct matroska_sub_track *track)
+/* VOBSUB support: Start a decoder with OCR for a VOBSUB track */
+static struct vobsub_ctx *init_vobsub_track_ocr(struct matroska_sub_track *track)
 {
-	if (track->sentence_count == 0)
-	{
-		mprint("\nNo VOBSUB subtitles to process");
-		return;
-	}
-
 	/* Check if OCR is available */
 	if (!vobsub_ocr_available())
 	{
@@ -1466,39 +1463,121 @@ static void process_vobsub_track_ocr(struct matroska_ctx *mkv_ctx, struct matros
 	{
 		vobsub_parse_palette(vob_ctx, track->header);
 	}
+	return vob_ctx;
+}
 
-	mprint("\nProcessing VOBSUB track with OCR (%d subtitles)", track->sentence_count);
+/* VOBSUB support: Decode subtitle i of a VOBSUB track and run OCR on it */
+static int decode_vobsub_sentence(struct vobsub_ctx *vob_ctx, struct matroska_sub_track *track, int i, struct cc_subtitle *sub)
+{
+	struct matroska_sub_sentence *sentence = track->sentences[i];
 
-	/* Get encoder context for output */
-	struct encoder_ctx *enc_ctx = update_encoder_list(mkv_ctx->ctx);
+	/* Calculate end time (use next subtitle start if not specified) */
+	ULLONG end_time = sentence->time_end;
+	if (end_time == 0 && i + 1 < track->sentence_count)
+	{
+		end_time = track->sentences[i + 1]->time_start - 1;
+	}
+	else if (end_time == 0)
+	{
+		end_time = sentence->time_start + 5000; /* Default 5 second duration */
+	}
 
-	/* Process each subtitle */
-	for (int i = 0; i < track->sentence_count; i++)
+	memset(sub, 0, sizeof(*sub));
+	return vobsub_decode_spu(vob_ctx,
+				 (unsigned char *)sentence->text,
+				 sentence->text_size,
+				 sentence->time_start,
+				 end_time,
+				 sub);
+}
+
+/* VOBSUB support: Free what the decoder and the encoder left of a subtitle */
+static void free_vobsub_subtitle(struct cc_subtitle *sub)
+{
+	if (sub->data)
 	{
-		struct matroska_sub_sentence *sentence = track->sentences[i];
-		mkv_ctx->sentence_count++;
+		struct cc_bitmap *rect = (struct cc_bitmap *)sub->data;
+		for (int j = 0; j < sub->nb_data; j++)
+		{
+			if (rect[j].data0)
+				free(rect[j].data0);
+			if (rect[j].data1)
+				free(rect[j].data1);
+#ifdef ENABLE_OCR
+			if (rect[j].ocr_text)
+				free(rect[j].ocr_text);
+#endif
+		}
+		free(sub->data);
+		sub->data = NULL;
+	}
+}
+
+#ifndef _WIN32
+/* VOBSUB support: Run OCR on a whole VOBSUB track ahead of process_vobsub_track_ocr(), which
+ * lets it happen away from the encoder, on a thread. Of each bitmap only the text is kept,
+ * since that is all the text output formats use. Subtitles that could not be decoded have
+ * no output */
+static struct cc_subtitle *recognize_vobsub_track(struct vobsub_ctx *vob_ctx, struct matroska_sub_track *track)
+{
+	struct cc_subtitle *subs = calloc(track->sentence_count > 0 ? track->sentence_count : 1, sizeof(struct cc_subtitle));
+	if (subs == NULL)
+		fatal(EXIT_NOT_ENOUGH_MEMORY, "In recognize_vobsub_track: Out of memory.");
 
-		/* Calculate end time (use next subtitle start if not specified) */
-		ULLONG end_time = sentence->time_end;
-		if (end_time == 0 && i + 1 < track->sentence_count)
+	for (int i = 0; i < track->sentence_count; i++)
+	{
+		struct cc_subtitle *sub = &subs[i];
+		if (decode_vobsub_sentence(vob_ctx, track, i, sub) != 0 || !sub->got_output)
 		{
-			end_time = track->sentences[i + 1]->time_start - 1;
+			free_vobsub_subtitle(sub);
+			memset(sub, 0, sizeof(*sub));
+			continue;
 		}
-		else if (end_time == 0)
+		struct cc_bitmap *rect = (struct cc_bitmap *)sub->data;
+		for (int j = 0; j < sub->nb_data; j++)
 		{
-			end_time = sentence->time_start + 5000; /* Default 5 second duration */
+			freep(&rect[j].data0);
+			freep(&rect[j].data1);
 		}
+	}
+	return subs;
+}
+#endif
+
+/* VOBSUB support: Process VOBSUB track with OCR and output text format. recognized holds
+ * the result of recognize_vobsub_track() if the OCR already ran, otherwise it is NULL and
+ * the OCR happens here. Either way, the subtitles are encoded in order, and recognized is
+ * freed */
+static void process_vobsub_track_ocr(struct matroska_ctx *mkv_ctx, struct matroska_sub_track *track, struct cc_subtitle *recognized)
+{
+	if (track->sentence_count == 0)
+	{
+		mprint("\nNo VOBSUB subtitles to process");
+		free(recognized);
+		return;
+	}
+
+	struct vobsub_ctx *vob_ctx = recognized ? NULL : init_vobsub_track_ocr(track);
+
+	mprint("\nProcessing VOBSUB track with OCR (%d subtitles)", track->sentence_count);
+
+	/* Get encoder context for output */
+	struct encoder_ctx *enc_ctx = update_encoder_list(mkv_ctx->ctx);
 
+	/* Process each subtitle */
+	for (int i = 0; i < track->sentence_count; i++)
+	{
 		/* Decode SPU and run OCR */
 		struct cc_subtitle sub;
-		memset(&sub, 0, sizeof(sub));
+		int ret;
 
-		int ret = vobsub_decode_spu(vob_ctx,
-					    (unsigned char *)sentence->text,
-					    sentence->text_size,
-					    sentence->time_start,
-					    end_time,
-					    &sub);
+		if (recognized)
+		{
+			sub = recognized[i];
+			ret = 0;
+		}
+		else
+			ret = decode_vobsub_sentence(vob_ctx, track, i, &sub);
 
 		if (ret == 0 && sub.got_output)
 		{
@@ -1506,22 +1585,7 @@ static void process_vobsub_track_ocr(struct matroska_ctx *mkv_ctx, struct matros
 			encode_sub(enc_ctx, &sub);
 
 			/* Free subtitle data */
-			if (sub.data)
-			{
-				struct cc_bitmap *rect = (struct cc_bitmap *)sub.data;
-				for (int j = 0; j < sub.nb_data; j++)
-				{
-					if (rect[j].data0)
-						free(rect[j].data0);
-					if (rect[j].data1)
-						free(rect[j].data1);
-#ifdef ENABLE_OCR
-					if (rect[j].ocr_text)
-						free(rect[j].ocr_text);
-#endif
-				}
-				free(sub.data);
-			}
+			free_vobsub_subtitle(&sub);
 		}
 
 		/* Progress indicator */
@@ -1531,7 +1595,9 @@ static void process_vobsub_track_ocr(struct matroska_ctx *mkv_ctx, struct matros
 		}
 	}
 
-	delete_vobsub_decoder(&vob_ctx);
+	if (vob_ctx)
+		delete_vobsub_decoder(&vob_ctx);
+	free(recognized);
 	mprint("\nVOBSUB OCR processing complete");
 }
 
@@ -1625,7 +1691,6 @@ static void save_vobsub_track(struct matroska_ctx *mkv_ctx, struct matroska_sub_
 	for (int i = 0; i < track->sentence_count; i++)
 	{
 		struct matroska_sub_sentence *sentence = track->sentences[i];
-		mkv_ctx->sentence_count++;
 
 		// Convert timestamp to 90kHz PTS
 		ULLONG pts_90khz = sentence->time_start * 90;
@@ -1681,7 +1746,7 @@ void save_sub_track(struct matroska_ctx *mkv_ctx, struct matroska_sub_track *tra
 		    is_text_output_format(ccx_options.enc_cfg.write_format))
 		{
 			// Use OCR to convert VOBSUB to text
-			process_vobsub_track_ocr(mkv_ctx, track);
+			process_vobsub_track_ocr(mkv_ctx, track, NULL);
 		}
 		else
 		{
@@ -1713,7 +1778,6 @@ void save_sub_track(struct matroska_ctx *mkv_ctx, struct matroska_sub_track *tra
 	for (int i = 0; i < track->sentence_count; i++)
 	{
 		struct matroska_sub_sentence *sentence = track->sentences[i];
-		mkv_ctx->sentence_count++;
 
 		if (track->codec_id == MATROSKA_TRACK_SUBTITLE_CODEC_ID_WEBVTT)
 		{
@@ -1845,6 +1909,9 @@ void save_sub_track(struct matroska_ctx *mkv_ctx, struct matroska_sub_track *tra
 			free(timestamp_end);
 		}
 	}
+
+	if (desc != 1)
+		close(desc);
 }
 
 void free_sub_track(struct matroska_sub_track *track)
@@ -1868,24 +1935,132 @@ void free_sub_track(struct matroska_sub_track *track)
 	free(track);
 }
 
+static int is_vobsub_ocr_track(struct matroska_sub_track *track)
+{
+	return track->codec_id == MATROSKA_TRACK_SUBTITLE_CODEC_ID_VOBSUB &&
+	       ccx_options.write_format_rewritten && is_text_output_format(ccx_options.enc_cfg.write_format);
+}
+
+// Tracks are handed to threads unless they all go into stdout. VOBSUB tracks with OCR
+// only get recognized there, they go through the shared encoder afterwards.
+static int can_save_in_parallel(struct matroska_ctx *mkv_ctx, struct matroska_sub_track *track)
+{
+	if (mkv_ctx->ctx->cc_to_stdout == CCX_TRUE)
+		return 0;
+	return !is_vobsub_ocr_track(track) || vobsub_ocr_available();
+}
+
+// A track for the threads. For VOBSUB tracks with OCR, they fill recognized
+struct sub_track_job
+{
+	struct matroska_sub_track *track;
+	struct cc_subtitle *recognized;
+};
+
+#ifndef _WIN32
+// Tracks shared by the save_sub_track_worker() threads, taken one at a time
+struct sub_track_queue
+{
+	struct matroska_ctx *mkv_ctx;
+	struct sub_track_job *jobs;
+	int count;
+	int next;
+	pthread_mutex_t lock;
+};
+
+static void *save_sub_track_worker(void *arg)
+{
+	struct sub_track_queue *queue = arg;
+	for (;;)
+	{
+		pthread_mutex_lock(&queue->lock);
+		int i = queue->next++;
+		pthread_mutex_unlock(&queue->lock);
+		if (i >= queue->count)
+			return NULL;
+
+		struct sub_track_job *job = &queue->jobs[i];
+		if (is_vobsub_ocr_track(job->track))
+		{
+			// Finding the Tesseract data goes through static state in ocr.c
+			pthread_mutex_lock(&queue->lock);
+			struct vobsub_ctx *vob_ctx = init_vobsub_track_ocr(job->track);
+			pthread_mutex_unlock(&queue->lock);
+			job->recognized = recognize_vobsub_track(vob_ctx, job->track);
+			delete_vobsub_decoder(&vob_ctx);
+		}
+		else
+			save_sub_track(queue->mkv_ctx, job->track);
+	}
+}
+
+// Runs the jobs with up to threads threads. Returns how many jobs could not be handed to
+// a thread, which are left at the start of jobs for the caller.
+static int save_sub_tracks_parallel(struct matroska_ctx *mkv_ctx, struct sub_track_job *jobs, int count, int threads)
+{
+	struct sub_track_queue queue = {.mkv_ctx = mkv_ctx, .jobs = jobs, .count = count};
+	pthread_t *workers = malloc(sizeof(pthread_t) * threads);
+	int started = 0;
+
+	if (workers == NULL)
+		fatal(EXIT_NOT_ENOUGH_MEMORY, "In save_sub_tracks_parallel: Out of memory.");
+	pthread_mutex_init(&queue.lock, NULL);
+	while (started < threads && pthread_create(&workers[started], NULL, save_sub_track_worker, &queue) == 0)
+		started++;
+	if (started == 0)
+	{
+		// No thread at all, the caller writes everything
+		pthread_mutex_destroy(&queue.lock);
+		free(workers);
+		return count;
+	}
+	for (int i = 0; i < started; i++)
+		pthread_join(workers[i], NULL);
+	pthread_mutex_destroy(&queue.lock);
+	free(workers);
+	return 0;
+}
+#endif
+
 void matroska_save_all(struct matroska_ctx *mkv_ctx, char *lang)
 {
-	char *match;
+	struct sub_track_job *parallel = calloc(mkv_ctx->sub_tracks_count + 1, sizeof(struct sub_track_job));
+	int parallel_count = 0;
+
+	if (parallel == NULL)
+		fatal(EXIT_NOT_ENOUGH_MEMORY, "In matroska_save_all: Out of memory.");
+
 	for (int i = 0; i < mkv_ctx->sub_tracks_count; i++)
 	{
-		if (lang)
+		struct matroska_sub_track *track = mkv_ctx->sub_tracks[i];
+		// Try to match against IETF tag first if available, fall back to 3-letter code
+		if (lang && !(track->lang_ietf && strstr(lang, track->lang_ietf)) && !strstr(lang, track->lang))
+			continue;
+
+		mkv_ctx->sentence_count += track->sentence_count;
+		if (ccx_options.mkv_threads > 1 && can_save_in_parallel(mkv_ctx, track))
+			parallel[parallel_count++].track = track;
+		else
+			save_sub_track(mkv_ctx, track);
+	}
+
+	if (parallel_count > 0)
+	{
+		int left = parallel_count;
+#ifndef _WIN32
+		int threads = ccx_options.mkv_threads < parallel_count ? ccx_options.mkv_threads : parallel_count;
+		left = threads > 1 ? save_sub_tracks_parallel(mkv_ctx, parallel, parallel_count, threads) : parallel_count;
+#endif
+		for (int i = 0; i < left; i++)
+			save_sub_track(mkv_ctx, parallel[i].track);
+		// The OCR is done, the text goes into the shared encoder in track order
+		for (int i = left; i < parallel_count; i++)
 		{
-			// Try to match against IETF tag first if available
-			if (mkv_ctx->sub_tracks[i]->lang_ietf &&
-			    (match = strstr(lang, mkv_ctx->sub_tracks[i]->lang_ietf)) != NULL)
-				save_sub_track(mkv_ctx, mkv_ctx->sub_tracks[i]);
-			// Fall back to 3-letter code
-			else if ((match = strstr(lang, mkv_ctx->sub_tracks[i]->lang)) != NULL)
-				save_sub_track(mkv_ctx, mkv_ctx->sub_tracks[i]);
+			if (parallel[i].recognized)
+				process_vobsub_track_ocr(mkv_ctx, parallel[i].track, parallel[i].recognized);
 		}
-		else
-			save_sub_track(mkv_ctx, mkv_ctx->sub_tracks[i]);
 	}
+	free(parallel);
 
 	// EIA-608
 	update_decoder_list(mkv_ctx->ctx);
@@ -1,6 +1,7 @@
 #include <stdio.h>
 #include <time.h>
 #include <stdlib.h>
+#include <ctype.h>
 
 #include <gpac/isomedia.h>
 #include <gpac/mpeg4_odf.h>
@@ -13,6 +14,7 @@
 #include "activity.h"
 #include "ccx_dtvcc.h"
 #include "vobsub_decoder.h"
+#include "file_buffer.h"
 
 #define MEDIA_TYPE(type, subtype) (((u64)(type) << 32) + (subtype))
 
@@ -26,6 +28,17 @@
 #define GF_ISOM_SUBTYPE_HVC1 GF_4CC('h', 'v', 'c', '1')
 #endif
 
+// Sample entries only met in fragmented MP4 streams (avc3, WebVTT and TTML)
+#ifndef GF_ISOM_SUBTYPE_AVC3_H264
+#define GF_ISOM_SUBTYPE_AVC3_H264 GF_4CC('a', 'v', 'c', '3')
+#endif
+#ifndef GF_ISOM_SUBTYPE_WVTT
+#define GF_ISOM_SUBTYPE_WVTT GF_4CC('w', 'v', 't', 't')
+#endif
+#ifndef GF_ISOM_SUBTYPE_STPP
+#define GF_ISOM_SUBTYPE_STPP GF_4CC('s', 't', 'p', 'p')
+#endif
+
 // VOBSUB subtype (mp4s or MPEG)
 #ifndef GF_ISOM_SUBTYPE_MPEG4
 #define GF_ISOM_SUBTYPE_MPEG4 GF_4CC('M', 'P', 'E', 'G')
@@ -50,82 +63,253 @@ static struct
 	unsigned type[32];
 } s_nalu_stats;
 
-static int process_avc_sample(struct lib_ccx_ctx *ctx, u32 timescale, GF_AVCConfig *c, GF_ISOSample *s, struct cc_subtitle *sub)
+// Bytes of a coded slice read for slice_header(), which only parses its first few fields
+#define MP4_SLICE_HEADER_BYTES 64
+
+// Reads the NAL units of AVC and HEVC samples. Only the parts do_NAL() looks at are read,
+// with positioned reads from the input file, so the slice data that makes up nearly all of
+// a video access unit is never loaded. Samples whose data GPAC can't locate in the input
+// file are loaded whole by GPAC instead, into the same reused sample.
+struct mp4_sample_reader
 {
-	int status = 0;
-	u32 i;
-	s32 signed_cts = (s32)s->CTS_Offset; // Convert from unsigned to signed. GPAC uses u32 but unsigned values are legal.
-	struct lib_cc_decode *dec_ctx = NULL;
-	struct encoder_ctx *enc_ctx = NULL;
+	struct mp4_nal_reader nal; // NAL units of the current sample
+	GF_ISOSample *sample;	   // Current sample, without data when read through nal.fd
+};
 
-	dec_ctx = update_decoder_list(ctx);
-	enc_ctx = update_encoder_list(ctx);
+static void mp4_reader_init(struct mp4_sample_reader *r, const char *file)
+{
+	memset(r, 0, sizeof(*r));
+	r->nal.fd = OPEN(file, O_RDONLY | O_BINARY);
+	r->sample = gf_isom_sample_new();
+}
 
-	set_current_pts(dec_ctx->timing, (s->DTS + signed_cts) * MPEG_CLOCK_FREQ / timescale);
-	set_fts(dec_ctx->timing);
+static void mp4_reader_free(struct mp4_sample_reader *r)
+{
+	if (r->nal.fd >= 0)
+		close(r->nal.fd);
+	gf_isom_sample_del(&r->sample);
+	freep(&r->nal.buf);
+}
 
-	for (i = 0; i < s->dataLength;)
+// Reads len bytes at offset of the input file into the reader buffer, after the first keep bytes.
+static int mp4_nal_reader_read(struct mp4_nal_reader *r, u64 offset, u32 keep, u32 len)
+{
+	if (keep + len > r->buf_size)
+	{
+		unsigned char *buf = realloc(r->buf, keep + len);
+		if (!buf)
+			fatal(EXIT_NOT_ENOUGH_MEMORY, "In mp4_nal_reader_read: Out of memory reading NAL unit.");
+		r->buf = buf;
+		r->buf_size = keep + len;
+	}
+	for (u32 done = 0; done < len;)
 	{
-		u32 nal_length;
+#ifdef _WIN32
+		int ret = -1;
+		if (LSEEK(r->fd, offset + done, SEEK_SET) >= 0)
+			ret = read(r->fd, r->buf + keep + done, len - done);
+#else
+		ssize_t ret = pread(r->fd, r->buf + keep + done, len - done, (off_t)(offset + done));
+#endif
+		if (ret <= 0)
+			return -1;
+		done += ret;
+	}
+	return 0;
+}
 
-		if (i + c->nal_unit_size > s->dataLength)
+// Moves to sample sample_number of the track. Returns the sample, NULL if it can't be read.
+static GF_ISOSample *mp4_reader_next_sample(struct mp4_sample_reader *r, GF_ISOFile *f, u32 track, u32 sample_number, u32 *sdi)
+{
+	GF_ISOSample *s;
+
+	r->nal.pos = 0;
+	r->nal.data = NULL;
+	if (r->nal.fd >= 0)
+	{
+		if (gf_isom_get_sample_info_ex(f, track, sample_number, sdi, &r->nal.offset, r->sample) == NULL)
+			return NULL;
+		if (gf_isom_is_self_contained(f, track, *sdi))
 		{
-			mprint("Corrupted packet detected in process_avc_sample. dataLength "
-			       "%u is less than index %u + nal_unit_size %u. Ignoring.\n",
-			       s->dataLength, i, c->nal_unit_size);
-			// The packet is likely corrupted, it's unsafe to read this many bytes
-			// even to detect the length of the next `nal`. Ignoring this error,
-			// hopefully the outer loop in `process_avc_track` can recover.
-			return status;
+			r->nal.length = r->sample->dataLength;
+			return r->sample;
 		}
-		switch (c->nal_unit_size)
+	}
+	s = gf_isom_get_sample_ex(f, track, sample_number, sdi, r->sample, &r->nal.offset);
+	if (s)
+	{
+		r->nal.data = (const unsigned char *)s->data;
+		r->nal.length = s->dataLength;
+	}
+	return s;
+}
+
+// How many bytes of a NAL unit do_NAL() uses: parameter sets and SEI whole, the start of
+// AVC slices for their header, nothing of anything else.
+static u32 nal_bytes_used(int is_hevc, unsigned char header, u32 nal_length)
+{
+	if (is_hevc)
+	{
+		switch ((header >> 1) & 0x3F)
 		{
-			case 1:
-				nal_length = s->data[i];
-				break;
-			case 2:
-				nal_length = bswap16(*(int16_t *)&s->data[i]);
-				break;
-			case 4:
-				nal_length = bswap32(*(int32_t *)&s->data[i]);
-				break;
+			case HEVC_NAL_VPS:
+			case HEVC_NAL_SPS:
+			case HEVC_NAL_PPS:
+			case HEVC_NAL_PREFIX_SEI:
+			case HEVC_NAL_SUFFIX_SEI:
+				return nal_length;
 		}
-		const u32 previous_index = i;
-		i += c->nal_unit_size;
-		if (i + nal_length <= previous_index || i + nal_length > s->dataLength)
+		return 0;
+	}
+	switch (header & 0x1F)
+	{
+		case CCX_NAL_TYPE_SEI:
+		case CCX_NAL_TYPE_SEQUENCE_PARAMETER_SET_7:
+		case CCX_NAL_TYPE_PICTURE_PARAMETER_SET:
+			return nal_length;
+		case CCX_NAL_TYPE_CODED_SLICE_NON_IDR_PICTURE_1:
+		case CCX_NAL_TYPE_CODED_SLICE_IDR_PICTURE:
+			return nal_length < MP4_SLICE_HEADER_BYTES ? nal_length : MP4_SLICE_HEADER_BYTES;
+	}
+	return 0;
+}
+
+int mp4_nal_reader_next(struct mp4_nal_reader *r, const char *caller, u32 nal_unit_size, int is_hevc,
+			unsigned char **nal, u32 *nal_length, u32 *used)
+{
+	const u32 length = r->length;
+	const u32 i = r->pos;
+	unsigned char *p;
+	u32 peek = 0;
+
+	if (i >= length)
+		return 0;
+	if (i + nal_unit_size > length)
+	{
+		mprint("Corrupted packet detected in %s. dataLength "
+		       "%u is less than index %u + nal_unit_size %u. Ignoring.\n",
+		       caller, length, i, nal_unit_size);
+		// The packet is likely corrupted, it's unsafe to read this many bytes
+		// even to detect the length of the next `nal`. Ignoring this error,
+		// hopefully the outer loop can recover.
+		return -1;
+	}
+
+	if (!r->data)
+	{
+		// One read covers the length prefix, the header and most SEI and slice headers
+		peek = length - i < nal_unit_size + MP4_SLICE_HEADER_BYTES ? length - i : nal_unit_size + MP4_SLICE_HEADER_BYTES;
+		if (mp4_nal_reader_read(r, r->offset + i, 0, peek) != 0)
 		{
-			mprint("Corrupted sample detected in process_avc_sample. dataLength %u "
-			       "is less than index %u + nal_unit_size %u + nal_length %u. Ignoring.\n",
-			       s->dataLength, previous_index, c->nal_unit_size, nal_length);
-			// The packet is likely corrupted, it's unsafe to procell nal_length bytes
-			// because they are past the sample end. Ignoring this error, hopefully
-			// the outer loop in `process_avc_track` can recover.
-			return status;
+			mprint("Failed to read sample data in %s. Ignoring.\n", caller);
+			return -1;
 		}
+		p = r->buf;
+	}
+	else
+		p = (unsigned char *)r->data + i;
 
+	switch (nal_unit_size)
+	{
+		case 1:
+			*nal_length = p[0];
+			break;
+		case 2:
+			*nal_length = (u16)bswap16(*(int16_t *)p);
+			break;
+		case 4:
+			*nal_length = bswap32(*(int32_t *)p);
+			break;
+		default:
+			mprint("Unexpected nal_unit_size %u in %s\n", nal_unit_size, caller);
+			return -1;
+	}
+	if (i + nal_unit_size + *nal_length <= i || i + nal_unit_size + *nal_length > length)
+	{
+		mprint("Corrupted sample detected in %s. dataLength %u "
+		       "is less than index %u + nal_unit_size %u + nal_length %u. Ignoring.\n",
+		       caller, length, i, nal_unit_size, *nal_length);
+		// The packet is likely corrupted, it's unsafe to process nal_length bytes
+		// because they are past the sample end. Ignoring this error, hopefully
+		// the outer loop can recover.
+		return -1;
+	}
+
+	*nal = p + nal_unit_size;
+	// An empty NAL unit has no header byte, which may be past the end of the sample
+	*used = *nal_length > 0 ? nal_bytes_used(is_hevc, (*nal)[0], *nal_length) : 0;
+	if (!r->data && nal_unit_size + *used > peek)
+	{
+		// Parameter sets and SEI larger than the first read
+		u32 have = peek - nal_unit_size;
+		if (mp4_nal_reader_read(r, r->offset + i + peek, peek, *used - have) != 0)
+		{
+			mprint("Failed to read sample data in %s. Ignoring.\n", caller);
+			return -1;
+		}
+		*nal = r->buf + nal_unit_size;
+	}
+
+	r->pos = i + nal_unit_size + *nal_length;
+	return 1;
+}
+
+static int process_avc_sample(struct lib_ccx_ctx *ctx, u32 timescale, GF_AVCConfig *c, struct mp4_sample_reader *r, struct cc_subtitle *sub)
+{
+	int status = 0;
+	GF_ISOSample *s = r->sample;
+	s32 signed_cts = (s32)s->CTS_Offset; // Convert from unsigned to signed. GPAC uses u32 but unsigned values are legal.
+	struct lib_cc_decode *dec_ctx = NULL;
+	struct encoder_ctx *enc_ctx = NULL;
+	unsigned char *nal;
+	u32 nal_length, used;
+
+	dec_ctx = update_decoder_list(ctx);
+	enc_ctx = update_encoder_list(ctx);
+
+	set_current_pts(dec_ctx->timing, (s->DTS + signed_cts) * MPEG_CLOCK_FREQ / timescale);
+	set_fts(dec_ctx->timing);
+
+	while (mp4_nal_reader_next(&r->nal, "process_avc_sample", c->nal_unit_size, 0, &nal, &nal_length, &used) > 0)
+	{
 		s_nalu_stats.total += 1;
 		temp_debug = 0;
 
 		if (nal_length > 0)
 		{
-			// s->data[i] is only relevant and safe to access here.
-			s_nalu_stats.type[s->data[i] & 0x1F] += 1;
-			do_NAL(enc_ctx, dec_ctx, (unsigned char *)&(s->data[i]), nal_length, sub);
+			// nal[0] is only relevant and safe to access here.
+			s_nalu_stats.type[nal[0] & 0x1F] += 1;
+			if (used > 0)
+				do_NAL(enc_ctx, dec_ctx, nal, used, sub);
 		}
-		i += nal_length;
-	} // outer for
-	assert(i == s->dataLength);
+	}
 
 	return status;
 }
 
-static int process_hevc_sample(struct lib_ccx_ctx *ctx, u32 timescale, GF_HEVCConfig *c, GF_ISOSample *s, struct cc_subtitle *sub)
+// For HEVC, we need to flush CC data after each sample (unlike H.264 which does this in slice_header)
+// This is because HEVC SEI messages contain the CC data and we don't parse slice headers
+static void flush_hevc_cc_data(struct encoder_ctx *enc_ctx, struct lib_cc_decode *dec_ctx, struct cc_subtitle *sub)
+{
+	if (dec_ctx->avc_ctx->cc_count > 0)
+	{
+		// Store the CC data for processing
+		store_hdcc(enc_ctx, dec_ctx, dec_ctx->avc_ctx->cc_data, dec_ctx->avc_ctx->cc_count,
+			   dec_ctx->timing->current_tref, dec_ctx->timing->fts_now, sub);
+		dec_ctx->avc_ctx->cc_buffer_saved = CCX_TRUE;
+		dec_ctx->avc_ctx->cc_count = 0;
+	}
+}
+
+static int process_hevc_sample(struct lib_ccx_ctx *ctx, u32 timescale, GF_HEVCConfig *c, struct mp4_sample_reader *r, struct cc_subtitle *sub)
 {
 	int status = 0;
-	u32 i;
+	GF_ISOSample *s = r->sample;
 	s32 signed_cts = (s32)s->CTS_Offset;
 	struct lib_cc_decode *dec_ctx = NULL;
 	struct encoder_ctx *enc_ctx = NULL;
+	unsigned char *nal;
+	u32 nal_length, used;
 
 	dec_ctx = update_decoder_list(ctx);
 	enc_ctx = update_encoder_list(ctx);
@@ -136,67 +320,23 @@ static int process_hevc_sample(struct lib_ccx_ctx *ctx, u32 timescale, GF_HEVCCo
 	set_current_pts(dec_ctx->timing, (s->DTS + signed_cts) * MPEG_CLOCK_FREQ / timescale);
 	set_fts(dec_ctx->timing);
 
-	for (i = 0; i < s->dataLength;)
+	while (mp4_nal_reader_next(&r->nal, "process_hevc_sample", c->nal_unit_size, 1, &nal, &nal_length, &used) > 0)
 	{
-		u32 nal_length;
-
-		if (i + c->nal_unit_size > s->dataLength)
-		{
-			mprint("Corrupted packet detected in process_hevc_sample. dataLength "
-			       "%u is less than index %u + nal_unit_size %u. Ignoring.\n",
-			       s->dataLength, i, c->nal_unit_size);
-			return status;
-		}
-		switch (c->nal_unit_size)
-		{
-			case 1:
-				nal_length = s->data[i];
-				break;
-			case 2:
-				nal_length = bswap16(*(int16_t *)&s->data[i]);
-				break;
-			case 4:
-				nal_length = bswap32(*(int32_t *)&s->data[i]);
-				break;
-			default:
-				mprint("Unexpected nal_unit_size %u in HEVC config\n", c->nal_unit_size);
-				return status;
-		}
-		const u32 previous_index = i;
-		i += c->nal_unit_size;
-		if (i + nal_length <= previous_index || i + nal_length > s->dataLength)
-		{
-			mprint("Corrupted sample detected in process_hevc_sample. dataLength %u "
-			       "is less than index %u + nal_unit_size %u + nal_length %u. Ignoring.\n",
-			       s->dataLength, previous_index, c->nal_unit_size, nal_length);
-			return status;
-		}
-
 		s_nalu_stats.total += 1;
 		temp_debug = 0;
 
 		if (nal_length > 0)
 		{
 			// For HEVC, NAL type is in bits [6:1] of byte 0
-			u8 nal_type = (s->data[i] >> 1) & 0x3F;
+			u8 nal_type = (nal[0] >> 1) & 0x3F;
 			if (nal_type < 32)
 				s_nalu_stats.type[nal_type] += 1;
-			do_NAL(enc_ctx, dec_ctx, (unsigned char *)&(s->data[i]), nal_length, sub);
+			if (used > 0)
+				do_NAL(enc_ctx, dec_ctx, nal, used, sub);
 		}
-		i += nal_length;
 	}
-	assert(i == s->dataLength);
 
-	// For HEVC, we need to flush CC data after each sample (unlike H.264 which does this in slice_header)
-	// This is because HEVC SEI messages contain the CC data and we don't parse slice headers
-	if (dec_ctx->avc_ctx->cc_count > 0)
-	{
-		// Store the CC data for processing
-		store_hdcc(enc_ctx, dec_ctx, dec_ctx->avc_ctx->cc_data, dec_ctx->avc_ctx->cc_count,
-			   dec_ctx->timing->current_tref, dec_ctx->timing->fts_now, sub);
-		dec_ctx->avc_ctx->cc_buffer_saved = CCX_TRUE;
-		dec_ctx->avc_ctx->cc_count = 0;
-	}
+	flush_hevc_cc_data(enc_ctx, dec_ctx, sub);
 
 	return status;
 }
@@ -226,11 +366,13 @@ static int process_xdvb_track(struct lib_ccx_ctx *ctx, const char *basename, GF_
 
 	status = 0;
 
+	// The MPEG-2 parser needs whole pictures, but one buffer serves all of them
+	GF_ISOSample *sample = gf_isom_sample_new();
 	for (i = 0; i < sample_count; i++)
 	{
 		u32 sdi;
 
-		GF_ISOSample *s = gf_isom_get_sample(f, track, i + 1, &sdi);
+		GF_ISOSample *s = gf_isom_get_sample_ex(f, track, i + 1, &sdi, sample, NULL);
 		if (s != NULL)
 		{
 			s32 signed_cts = (s32)s->CTS_Offset; // Convert from unsigned to signed. GPAC uses u32 but unsigned values are legal.
@@ -238,7 +380,6 @@ static int process_xdvb_track(struct lib_ccx_ctx *ctx, const char *basename, GF_
 			set_fts(dec_ctx->timing);
 
 			process_m2v(enc_ctx, dec_ctx, (unsigned char *)s->data, s->dataLength, sub);
-			gf_isom_sample_del(&s);
 		}
 
 		int progress = (int)((i * 100) / sample_count);
@@ -249,6 +390,7 @@ static int process_xdvb_track(struct lib_ccx_ctx *ctx, const char *basename, GF_
 			ctx->last_reported_progress = progress;
 		}
 	}
+	gf_isom_sample_del(&sample);
 	int cur_sec = (int)(get_fts(dec_ctx->timing, dec_ctx->current_field) / 1000);
 	activity_progress(100, cur_sec / 60, cur_sec % 60);
 
@@ -261,6 +403,7 @@ static int process_avc_track(struct lib_ccx_ctx *ctx, const char *basename, GF_I
 	int status;
 	GF_AVCConfig *c = NULL;
 	struct lib_cc_decode *dec_ctx = NULL;
+	struct mp4_sample_reader reader;
 
 	dec_ctx = update_decoder_list(ctx);
 
@@ -276,6 +419,7 @@ static int process_avc_track(struct lib_ccx_ctx *ctx, const char *basename, GF_I
 	}
 
 	timescale = gf_isom_get_media_timescale(f, track);
+	mp4_reader_init(&reader, basename);
 
 	status = 0;
 
@@ -283,7 +427,7 @@ static int process_avc_track(struct lib_ccx_ctx *ctx, const char *basename, GF_I
 	{
 		u32 sdi;
 
-		GF_ISOSample *s = gf_isom_get_sample(f, track, i + 1, &sdi);
+		GF_ISOSample *s = mp4_reader_next_sample(&reader, f, track, i + 1, &sdi);
 
 		if (s != NULL)
 		{
@@ -297,7 +441,6 @@ static int process_avc_track(struct lib_ccx_ctx *ctx, const char *basename, GF_I
 
 				if ((c = gf_isom_avc_config_get(f, track, sdi)) == NULL)
 				{
-					gf_isom_sample_del(&s);
 					status = -1;
 					break;
 				}
@@ -305,9 +448,7 @@ static int process_avc_track(struct lib_ccx_ctx *ctx, const char *basename, GF_I
 				last_sdi = sdi;
 			}
 
-			status = process_avc_sample(ctx, timescale, c, s, sub);
-
-			gf_isom_sample_del(&s);
+			status = process_avc_sample(ctx, timescale, c, &reader, sub);
 
 			if (status != 0)
 			{
@@ -331,6 +472,7 @@ static int process_avc_track(struct lib_ccx_ctx *ctx, const char *basename, GF_I
 		gf_odf_avc_cfg_del(c);
 		c = NULL;
 	}
+	mp4_reader_free(&reader);
 
 	return status;
 }
@@ -341,6 +483,7 @@ static int process_hevc_track(struct lib_ccx_ctx *ctx, const char *basename, GF_
 	int status;
 	GF_HEVCConfig *c = NULL;
 	struct lib_cc_decode *dec_ctx = NULL;
+	struct mp4_sample_reader reader;
 
 	dec_ctx = update_decoder_list(ctx);
 
@@ -359,6 +502,7 @@ static int process_hevc_track(struct lib_ccx_ctx *ctx, const char *basename, GF_
 	}
 
 	timescale = gf_isom_get_media_timescale(f, track);
+	mp4_reader_init(&reader, basename);
 
 	status = 0;
 
@@ -366,7 +510,7 @@ static int process_hevc_track(struct lib_ccx_ctx *ctx, const char *basename, GF_
 	{
 		u32 sdi;
 
-		GF_ISOSample *s = gf_isom_get_sample(f, track, i + 1, &sdi);
+		GF_ISOSample *s = mp4_reader_next_sample(&reader, f, track, i + 1, &sdi);
 
 		if (s != NULL)
 		{
@@ -380,7 +524,6 @@ static int process_hevc_track(struct lib_ccx_ctx *ctx, const char *basename, GF_
 
 				if ((c = gf_isom_hevc_config_get(f, track, sdi)) == NULL)
 				{
-					gf_isom_sample_del(&s);
 					status = -1;
 					break;
 				}
@@ -388,9 +531,7 @@ static int process_hevc_track(struct lib_ccx_ctx *ctx, const char *basename, GF_
 				last_sdi = sdi;
 			}
 
-			status = process_hevc_sample(ctx, timescale, c, s, sub);
-
-			gf_isom_sample_del(&s);
+			status = process_hevc_sample(ctx, timescale, c, &reader, sub);
 
 			if (status != 0)
 			{
@@ -414,6 +555,7 @@ static int process_hevc_track(struct lib_ccx_ctx *ctx, const char *basename, GF_
 		gf_odf_hevc_cfg_del(c);
 		c = NULL;
 	}
+	mp4_reader_free(&reader);
 
 	return status;
 }
@@ -487,7 +629,8 @@ static int process_vobsub_track(struct lib_ccx_ctx *ctx, GF_ISOFile *f, u32 trac
 			if (i + 1 < sample_count)
 			{
 				u32 next_sdi;
-				GF_ISOSample *next_s = gf_isom_get_sample(f, track, i + 2, &next_sdi);
+				// Only the timing is needed, not the data
+				GF_ISOSample *next_s = gf_isom_get_sample_info(f, track, i + 2, &next_sdi, NULL);
 				if (next_s)
 				{
 					s32 next_signed_cts = (s32)next_s->CTS_Offset;
@@ -754,7 +897,7 @@ static int process_clcp(struct lib_ccx_ctx *ctx, struct encoder_ctx *enc_ctx,
 #else
 				dtvcc_process_data(dec_ctx->dtvcc, (unsigned char *)temp);
 #endif
-				cb_708++;
+				dec_ctx->timing->cb_708++;
 			}
 			if (ctx->write_format == CCX_OF_MCC)
 			{
@@ -781,7 +924,7 @@ static int process_clcp(struct lib_ccx_ctx *ctx, struct encoder_ctx *enc_ctx,
 				ret = process608((unsigned char *)tdata, len > 2 ? 2 : len, dec_ctx, dec_sub);
 				len -= ret;
 				tdata += ret;
-				cb_field1++;
+				dec_ctx->timing->cb_field1++;
 				if (dec_sub->got_output)
 				{
 					*mp4_ret = 1;
@@ -1097,10 +1240,11 @@ int processmp4(struct lib_ccx_ctx *ctx, struct ccx_s_mp4Cfg *cfg, char *file)
 				mprint("%u timescale\n", (unsigned)timescale);
 				mprint("%u duration\n", (unsigned)duration);
 #endif
+				GF_ISOSample *cc_sample = gf_isom_sample_new();
 				for (unsigned k = 0; k < num_samples; k++)
 				{
 					u32 StreamDescriptionIndex;
-					GF_ISOSample *sample = gf_isom_get_sample(f, i + 1, k + 1, &StreamDescriptionIndex);
+					GF_ISOSample *sample = gf_isom_get_sample_ex(f, i + 1, k + 1, &StreamDescriptionIndex, cc_sample, NULL);
 					if (ProcessingStreamDescriptionIndex && ProcessingStreamDescriptionIndex != StreamDescriptionIndex)
 					{
 						mprint("This sample seems to have more than one description. This isn't supported yet.\n");
@@ -1169,8 +1313,6 @@ int processmp4(struct lib_ccx_ctx *ctx, struct ccx_s_mp4Cfg *cfg, char *file)
 							break; // error happened or process of the sample is finished
 						atomStart += atom_length;
 					}
-					free(sample->data);
-					free(sample);
 
 					// End of change
 					int progress = (int)((k * 100) / num_samples);
@@ -1181,6 +1323,7 @@ int processmp4(struct lib_ccx_ctx *ctx, struct ccx_s_mp4Cfg *cfg, char *file)
 						ctx->last_reported_progress = progress;
 					}
 				}
+				gf_isom_sample_del(&cc_sample);
 
 				// Encode the last subtitle
 				if (subtype == GF_ISOM_SUBTYPE_TX3G)
@@ -1288,3 +1431,1094 @@ int dumpchapters(struct lib_ccx_ctx *ctx, struct ccx_s_mp4Cfg *cfg, char *file)
 		gf_fclose(t);
 	return mp4_ret;
 }
+
+/*
+	Streaming fragmented MP4
+
+	GPAC needs the whole file to open it, so fragmented MP4 (CMAF) arriving on stdin, over the
+	network or as a growing --live-stream file is read here box by box instead, through the
+	demuxer's buffered input. The init segment's moov gives the tracks, each moof the sample
+	table of its fragment, and the samples of the selected track are then taken from the mdat
+	as it streams past. Only the current moof and the caption bytes of one sample are held in
+	memory, however long the stream runs.
+*/
+
+#define FMP4_MAX_TRACKS 32
+// Largest moov, moof or caption sample kept in memory, bigger ones are skipped
+#define FMP4_MAX_BOX_SIZE (32 * 1024 * 1024)
+// Most samples accepted from a single track run
+#define FMP4_MAX_RUN_SAMPLES (1024 * 1024)
+
+enum fmp4_codec
+{
+	FMP4_CODEC_OTHER,
+	FMP4_CODEC_AVC,
+	FMP4_CODEC_HEVC,
+	FMP4_CODEC_C608,
+	FMP4_CODEC_C708,
+	FMP4_CODEC_TX3G,
+	FMP4_CODEC_WVTT,
+	FMP4_CODEC_STPP,
+};
+
+// What the times in TTML (stpp) samples count from, found from the first sample that tells
+enum fmp4_ttml_clock
+{
+	FMP4_TTML_UNKNOWN, // Only samples at media time 0 so far, where both clocks agree
+	FMP4_TTML_MEDIA,   // The track's media timeline
+	FMP4_TTML_SAMPLE,  // The start of each sample, as some packagers write them
+};
+
+struct fmp4_track
+{
+	u32 id;
+	u32 timescale;
+	u32 subtype; // Sample entry type, e.g. avc1 or wvtt
+	enum fmp4_codec codec;
+	const unsigned char *config; // avcC or hvcC payload, only valid while the moov is parsed
+	u32 config_size;
+	u32 nal_unit_size;
+	u32 default_duration; // From trex, for fragments that don't give their own
+	u32 default_size;
+	u64 next_dts; // Decode time following the last fragment, for fragments without tfdt
+	enum fmp4_ttml_clock ttml_clock;
+};
+
+struct fmp4_sample
+{
+	u64 offset; // Stream position of the sample data
+	u32 size;
+	u32 duration;
+	u64 dts;
+	s32 cts_offset;
+};
+
+struct fmp4_stream
+{
+	struct lib_ccx_ctx *ctx;
+	struct ccx_demuxer *demux;
+	struct lib_cc_decode *dec_ctx;
+	struct encoder_ctx *enc_ctx;
+	struct cc_subtitle dec_sub;
+	int mp4_ret;
+	u64 pos; // Stream position of the next byte read
+
+	struct fmp4_track tracks[FMP4_MAX_TRACKS];
+	u32 track_count;
+	struct fmp4_track *track; // The track captions are extracted from
+	int fragmented;		  // The moov announces movie fragments (mvex)
+
+	// Samples of `track` in the current fragment, in stream order
+	struct fmp4_sample *samples;
+	u32 sample_count;
+	u32 samples_allocated;
+
+	unsigned char *buf;
+	u32 buf_size;
+};
+
+static u64 fmp4_rb64(const unsigned char *p)
+{
+	return ((u64)RB32(p) << 32) | RB32(p + 4);
+}
+
+// Converts media time to the 90 kHz MPEG clock, without overflowing on the large decode
+// times live streams start at
+static LLONG fmp4_to_mpeg_clock(s64 t, u32 timescale)
+{
+	return (t / timescale) * MPEG_CLOCK_FREQ + (t % timescale) * MPEG_CLOCK_FREQ / timescale;
+}
+
+static int fmp4_read(struct fmp4_stream *s, unsigned char *buf, u32 len)
+{
+	size_t got = buffered_read(s->demux, buf, len);
+	s->pos += got;
+	return got == len ? 0 : -1;
+}
+
+static int fmp4_skip(struct fmp4_stream *s, u64 len)
+{
+	while (len > 0)
+	{
+		unsigned int chunk = len > (1u << 30) ? (1u << 30) : (unsigned int)len;
+		size_t got = buffered_skip(s->demux, chunk);
+		s->pos += got;
+		if (got != chunk)
+			return -1;
+		len -= chunk;
+	}
+	return 0;
+}
+
+// Grows the scratch buffer to at least `size` bytes
+static void fmp4_buffer(struct fmp4_stream *s, u32 size)
+{
+	if (size <= s->buf_size)
+		return;
+	unsigned char *buf = realloc(s->buf, size);
+	if (!buf)
+		fatal(EXIT_NOT_ENOUGH_MEMORY, "In fmp4_buffer: Out of memory allocating %u bytes.", size);
+	s->buf = buf;
+	s->buf_size = size;
+}
+
+// Reads the next `size` bytes of the stream into the scratch buffer, NUL terminated for the
+// text formats
+static int fmp4_load(struct fmp4_stream *s, u32 size)
+{
+	fmp4_buffer(s, size + 1);
+	if (fmp4_read(s, s->buf, size))
+		return -1;
+	s->buf[size] = '\0';
+	return 0;
+}
+
+// Reads the header of the next top level box. Returns 0 with its type and payload size
+// (UINT64_MAX for a box running to the end of the stream), -1 at the end of the stream.
+static int fmp4_read_box_header(struct fmp4_stream *s, u32 *type, u64 *payload)
+{
+	unsigned char h[16];
+	u64 size;
+	u32 header = 8;
+
+	if (fmp4_read(s, h, 8))
+		return -1;
+	size = RB32(h);
+	*type = RB32(h + 4);
+	if (size == 0)
+	{
+		*payload = UINT64_MAX;
+		return 0;
+	}
+	if (size == 1)
+	{
+		if (fmp4_read(s, h + 8, 8))
+			return -1;
+		size = fmp4_rb64(h + 8);
+		header = 16;
+	}
+	if (size < header)
+	{
+		mprint("Invalid box size %llu in fragmented MP4 stream, giving up.\n", (unsigned long long)size);
+		return -1;
+	}
+	*payload = size - header;
+	return 0;
+}
+
+// Moves *p past the next of the boxes in [*p, end). Returns 1 with its type and payload,
+// 0 when no complete box is left.
+static int fmp4_next_box(const unsigned char **p, const unsigned char *end, u32 *type,
+			 const unsigned char **payload, u32 *size)
+{
+	u64 box_size;
+	u32 header = 8;
+
+	if (end - *p < 8)
+		return 0;
+	box_size = RB32(*p);
+	*type = RB32(*p + 4);
+	if (box_size == 1)
+	{
+		if (end - *p < 16)
+			return 0;
+		box_size = fmp4_rb64(*p + 8);
+		header = 16;
+	}
+	else if (box_size == 0)
+		box_size = end - *p;
+	if (box_size < header || box_size > (u64)(end - *p))
+		return 0;
+	*payload = *p + header;
+	*size = (u32)(box_size - header);
+	*p += box_size;
+	return 1;
+}
+
+// Finds the first box of `type` among the ones in [p, end)
+static int fmp4_find_box(const unsigned char *p, const unsigned char *end, u32 type,
+			 const unsigned char **payload, u32 *size)
+{
+	u32 t;
+	while (fmp4_next_box(&p, end, &t, payload, size))
+		if (t == type)
+			return 1;
+	return 0;
+}
+
+static enum fmp4_codec fmp4_codec(u32 subtype)
+{
+	switch (subtype)
+	{
+		case GF_ISOM_SUBTYPE_AVC_H264:
+		case GF_ISOM_SUBTYPE_AVC3_H264:
+			return FMP4_CODEC_AVC;
+		case GF_ISOM_SUBTYPE_HEV1:
+		case GF_ISOM_SUBTYPE_HVC1:
+			return FMP4_CODEC_HEVC;
+		case GF_QT_SUBTYPE_C608:
+			return FMP4_CODEC_C608;
+		case GF_ISOM_SUBTYPE_C708:
+			return FMP4_CODEC_C708;
+		case GF_ISOM_SUBTYPE_TX3G:
+			return FMP4_CODEC_TX3G;
+		case GF_ISOM_SUBTYPE_WVTT:
+			return FMP4_CODEC_WVTT;
+		case GF_ISOM_SUBTYPE_STPP:
+			return FMP4_CODEC_STPP;
+	}
+	return FMP4_CODEC_OTHER;
+}
+
+static struct fmp4_track *fmp4_track_by_id(struct fmp4_stream *s, u32 id)
+{
+	for (u32 i = 0; i < s->track_count; i++)
+		if (s->tracks[i].id == id)
+			return &s->tracks[i];
+	return NULL;
+}
+
+static void fmp4_parse_trak(struct fmp4_stream *s, const unsigned char *trak, const unsigned char *end)
+{
+	const unsigned char *tkhd, *mdia, *mdhd, *minf, *stbl, *stsd, *entry, *entry_payload;
+	u32 tkhd_size, mdia_size, mdhd_size, minf_size, stbl_size, stsd_size, entry_size, type;
+	u32 tkhd_times, mdhd_times;
+	struct fmp4_track *t;
+
+	if (s->track_count == FMP4_MAX_TRACKS)
+		return;
+	if (!fmp4_find_box(trak, end, GF_4CC('t', 'k', 'h', 'd'), &tkhd, &tkhd_size) ||
+	    !fmp4_find_box(trak, end, GF_4CC('m', 'd', 'i', 'a'), &mdia, &mdia_size) ||
+	    !fmp4_find_box(mdia, mdia + mdia_size, GF_4CC('m', 'd', 'h', 'd'), &mdhd, &mdhd_size) ||
+	    !fmp4_find_box(mdia, mdia + mdia_size, GF_4CC('m', 'i', 'n', 'f'), &minf, &minf_size) ||
+	    !fmp4_find_box(minf, minf + minf_size, GF_4CC('s', 't', 'b', 'l'), &stbl, &stbl_size) ||
+	    !fmp4_find_box(stbl, stbl + stbl_size, GF_4CC('s', 't', 's', 'd'), &stsd, &stsd_size))
+		return;
+
+	// Version 1 of tkhd and mdhd has 64 bit creation and modification times
+	tkhd_times = tkhd_size > 0 && tkhd[0] == 1 ? 16 : 8;
+	mdhd_times = mdhd_size > 0 && mdhd[0] == 1 ? 16 : 8;
+	if (tkhd_size < 8 + tkhd_times || mdhd_size < 8 + mdhd_times || stsd_size < 8)
+		return;
+	// Only the first sample description is used, as for MP4 files
+	entry = stsd + 8;
+	if (!fmp4_next_box(&entry, stsd + stsd_size, &type, &entry_payload, &entry_size))
+		return;
+
+	t = &s->tracks[s->track_count++];
+	memset(t, 0, sizeof(*t));
+	t->id = RB32(tkhd + 4 + tkhd_times);
+	t->timescale = RB32(mdhd + 4 + mdhd_times);
+	t->subtype = type;
+	t->codec = t->timescale ? fmp4_codec(type) : FMP4_CODEC_OTHER;
+	// Visual sample entries have 78 bytes of fields before their child boxes
+	if ((t->codec == FMP4_CODEC_AVC || t->codec == FMP4_CODEC_HEVC) && entry_size > 78)
+		fmp4_find_box(entry_payload + 78, entry_payload + entry_size,
+			      t->codec == FMP4_CODEC_AVC ? GF_4CC('a', 'v', 'c', 'C') : GF_4CC('h', 'v', 'c', 'C'),
+			      &t->config, &t->config_size);
+}
+
+static void fmp4_parse_moov(struct fmp4_stream *s, const unsigned char *moov, u32 size)
+{
+	const unsigned char *p = moov, *payload, *q, *trex;
+	u32 type, box_size, trex_size;
+
+	s->track_count = 0;
+	s->track = NULL;
+	s->fragmented = 0;
+	while (fmp4_next_box(&p, moov + size, &type, &payload, &box_size))
+		if (type == GF_4CC('t', 'r', 'a', 'k'))
+			fmp4_parse_trak(s, payload, payload + box_size);
+
+	p = moov;
+	while (fmp4_next_box(&p, moov + size, &type, &payload, &box_size))
+	{
+		if (type != GF_4CC('m', 'v', 'e', 'x'))
+			continue;
+		s->fragmented = 1;
+		for (q = payload; fmp4_next_box(&q, payload + box_size, &type, &trex, &trex_size);)
+		{
+			struct fmp4_track *t;
+			if (type != GF_4CC('t', 'r', 'e', 'x') || trex_size < 24 || !(t = fmp4_track_by_id(s, RB32(trex + 4))))
+				continue;
+			t->default_duration = RB32(trex + 12);
+			t->default_size = RB32(trex + 16);
+		}
+	}
+}
+
+// Hands one length prefixed parameter set of an avcC or hvcC to do_NAL(). Returns the
+// position after it, NULL if it's truncated.
+static const unsigned char *fmp4_parameter_set(struct fmp4_stream *s, const unsigned char *p, const unsigned char *end)
+{
+	u32 size;
+
+	if (end - p < 2)
+		return NULL;
+	size = RB16(p);
+	p += 2;
+	if (size > end - p)
+		return NULL;
+	if (size > 0)
+		do_NAL(s->enc_ctx, s->dec_ctx, (unsigned char *)p, size, &s->dec_sub);
+	return p + size;
+}
+
+// Sets the decoder up for the selected video track and passes it the parameter sets of the
+// track's configuration record
+static void fmp4_init_video(struct fmp4_stream *s)
+{
+	struct fmp4_track *t = s->track;
+	const unsigned char *p = t->config, *end = t->config + t->config_size;
+	u32 sets, count;
+
+	// As for MP4 files, see process_avc_track()
+	s->dec_ctx->in_bufferdatatype = CCX_H264;
+	t->nal_unit_size = 4;
+	if (t->codec == FMP4_CODEC_HEVC)
+	{
+		s->dec_ctx->avc_ctx->is_hevc = 1;
+		if (t->config_size < 23)
+			return;
+		t->nal_unit_size = (p[21] & 3) + 1;
+		sets = p[22];
+		p += 23;
+		for (; sets > 0 && p && end - p >= 3; sets--)
+		{
+			count = RB16(p + 1);
+			for (p += 3; count > 0 && p; count--)
+				p = fmp4_parameter_set(s, p, end);
+		}
+	}
+	else
+	{
+		if (t->config_size < 6)
+			return;
+		t->nal_unit_size = (p[4] & 3) + 1;
+		// Only the sequence parameter sets, as for MP4 files
+		sets = p[5] & 0x1F;
+		for (p += 6; sets > 0 && p; sets--)
+			p = fmp4_parameter_set(s, p, end);
+	}
+}
+
+// Picks the track to extract captions from. Only one track can be followed through the
+// interleaved fragments; like processmp4(), dedicated caption tracks are preferred unless
+// --mp4vidtrack asks for the video.
+static void fmp4_select_track(struct fmp4_stream *s, struct ccx_s_mp4Cfg *cfg)
+{
+	struct fmp4_track *video = NULL, *captions = NULL;
+	u32 i, usable = 0, cc_track_count = 0;
+
+	for (i = 0; i < s->track_count; i++)
+	{
+		struct fmp4_track *t = &s->tracks[i];
+		mprint("Track %u, id=%u subtype=%c%c%c%c\n", i + 1, t->id,
+		       (unsigned char)(t->subtype >> 24), (unsigned char)(t->subtype >> 16),
+		       (unsigned char)(t->subtype >> 8), (unsigned char)t->subtype);
+		switch (t->codec)
+		{
+			case FMP4_CODEC_OTHER:
+				continue;
+			case FMP4_CODEC_AVC:
+			case FMP4_CODEC_HEVC:
+				if (!video)
+					video = t;
+				break;
+			default:
+				cc_track_count++;
+				if (!captions)
+					captions = t;
+		}
+		usable++;
+	}
+	s->ctx->freport.mp4_cc_track_cnt = cc_track_count;
+
+	s->track = captions && (!video || !cfg->mp4vidtrack) ? captions : video;
+	if (!s->track)
+	{
+		mprint("No track with captions in the init segment.\n");
+		return;
+	}
+	if (usable > 1)
+		mprint("Extracting captions from track id %u only.\n", s->track->id);
+	if (s->track->codec == FMP4_CODEC_AVC || s->track->codec == FMP4_CODEC_HEVC)
+		fmp4_init_video(s);
+
+	// The configuration records pointed into the moov
+	for (i = 0; i < s->track_count; i++)
+	{
+		s->tracks[i].config = NULL;
+		s->tracks[i].config_size = 0;
+	}
+}
+
+static void fmp4_add_sample(struct fmp4_stream *s, const struct fmp4_sample *sample)
+{
+	if (s->sample_count == s->samples_allocated)
+	{
+		u32 allocated = s->samples_allocated ? s->samples_allocated * 2 : 256;
+		struct fmp4_sample *samples = realloc(s->samples, allocated * sizeof(*samples));
+		if (!samples)
+			fatal(EXIT_NOT_ENOUGH_MEMORY, "In fmp4_add_sample: Out of memory allocating the sample table.");
+		s->samples = samples;
+		s->samples_allocated = allocated;
+	}
+	s->samples[s->sample_count++] = *sample;
+}
+
+static int fmp4_compare_samples(const void *a, const void *b)
+{
+	const struct fmp4_sample *x = a, *y = b;
+	return x->offset < y->offset ? -1 : x->offset > y->offset;
+}
+
+// Adds the samples of the selected track in one traf to the fragment's sample table
+static void fmp4_parse_traf(struct fmp4_stream *s, u64 moof_start, const unsigned char *traf, const unsigned char *end)
+{
+	const unsigned char *p, *payload, *q;
+	u32 type, size, flags, count, i, header, fields;
+	u32 default_duration = s->track->default_duration, default_size = s->track->default_size;
+	u64 base = moof_start, data_pos, dts = s->track->next_dts;
+
+	if (!fmp4_find_box(traf, end, GF_4CC('t', 'f', 'h', 'd'), &payload, &size) || size < 8 ||
+	    RB32(payload + 4) != s->track->id)
+		return;
+	flags = RB24(payload + 1);
+	header = 8 + (flags & 0x01 ? 8 : 0) + (flags & 0x02 ? 4 : 0) + (flags & 0x08 ? 4 : 0) +
+		 (flags & 0x10 ? 4 : 0) + (flags & 0x20 ? 4 : 0);
+	if (size < header)
+		return;
+	q = payload + 8;
+	// Without an explicit base offset the data is relative to the moof, which is all CMAF allows
+	if (flags & 0x01)
+	{
+		base = fmp4_rb64(q);
+		q += 8;
+	}
+	if (flags & 0x02)
+		q += 4;
+	if (flags & 0x08)
+	{
+		default_duration = RB32(q);
+		q += 4;
+	}
+	if (flags & 0x10)
+		default_size = RB32(q);
+
+	if (fmp4_find_box(traf, end, GF_4CC('t', 'f', 'd', 't'), &payload, &size) && size >= 8)
+		dts = payload[0] == 1 && size >= 12 ? fmp4_rb64(payload + 4) : RB32(payload + 4);
+
+	data_pos = base;
+	for (p = traf; fmp4_next_box(&p, end, &type, &payload, &size);)
+	{
+		if (type != GF_4CC('t', 'r', 'u', 'n') || size < 8)
+			continue;
+		flags = RB24(payload + 1);
+		count = RB32(payload + 4);
+		header = 8 + (flags & 0x01 ? 4 : 0) + (flags & 0x04 ? 4 : 0);
+		fields = 4 * (!!(flags & 0x100) + !!(flags & 0x200) + !!(flags & 0x400) + !!(flags & 0x800));
+		if (size < header || count > (fields ? (size - header) / fields : FMP4_MAX_RUN_SAMPLES))
+		{
+			mprint("Invalid trun box in fragmented MP4 stream, skipping it.\n");
+			continue;
+		}
+		q = payload + 8;
+		if (flags & 0x01)
+		{
+			data_pos = base + (s64)(s32)RB32(q);
+			q += 4;
+		}
+		if (flags & 0x04)
+			q += 4;
+		for (i = 0; i < count; i++)
+		{
+			struct fmp4_sample sample = {data_pos, default_size, default_duration, dts, 0};
+			if (flags & 0x100)
+			{
+				sample.duration = RB32(q);
+				q += 4;
+			}
+			if (flags & 0x200)
+			{
+				sample.size = RB32(q);
+				q += 4;
+			}
+			if (flags & 0x400)
+				q += 4;
+			if (flags & 0x800)
+			{
+				// Version 0 offsets are unsigned, but negative ones are used the same way, see process_avc_sample()
+				sample.cts_offset = (s32)RB32(q);
+				q += 4;
+			}
+			if (sample.size > 0)
+				fmp4_add_sample(s, &sample);
+			data_pos += sample.size;
+			dts += sample.duration;
+		}
+	}
+	s->track->next_dts = dts;
+}
+
+static void fmp4_parse_moof(struct fmp4_stream *s, u64 moof_start, const unsigned char *moof, u32 size)
+{
+	const unsigned char *p = moof, *payload;
+	u32 type, box_size;
+
+	s->sample_count = 0;
+	while (fmp4_next_box(&p, moof + size, &type, &payload, &box_size))
+		if (type == GF_4CC('t', 'r', 'a', 'f'))
+			fmp4_parse_traf(s, moof_start, payload, payload + box_size);
+	// Track runs aren't required to be in data order, the mdat is only read forward
+	qsort(s->samples, s->sample_count, sizeof(*s->samples), fmp4_compare_samples);
+}
+
+// Reads the NAL units of a video sample, loading only the bytes do_NAL() uses and skipping
+// over the rest, see nal_bytes_used()
+static int fmp4_process_video_sample(struct fmp4_stream *s, u32 size)
+{
+	const int is_hevc = s->track->codec == FMP4_CODEC_HEVC;
+	const u32 nal_unit_size = s->track->nal_unit_size;
+	unsigned char prefix[4], header;
+	u32 i = 0, k, nal_length, used;
+
+	while (i < size)
+	{
+		if (size - i < nal_unit_size)
+		{
+			mprint("Corrupted sample detected in fragmented MP4 stream, %u bytes left for a NAL unit length. Ignoring.\n", size - i);
+			return fmp4_skip(s, size - i);
+		}
+		if (fmp4_read(s, prefix, nal_unit_size))
+			return -1;
+		i += nal_unit_size;
+		for (nal_length = 0, k = 0; k < nal_unit_size; k++)
+			nal_length = nal_length << 8 | prefix[k];
+		if (nal_length > size - i)
+		{
+			mprint("Corrupted sample detected in fragmented MP4 stream, NAL unit length %u "
+			       "is more than the %u bytes left. Ignoring.\n",
+			       nal_length, size - i);
+			return fmp4_skip(s, size - i);
+		}
+		i += nal_length;
+		if (nal_length == 0)
+			continue;
+
+		if (fmp4_read(s, &header, 1))
+			return -1;
+		used = nal_bytes_used(is_hevc, header, nal_length);
+		if (used > 0)
+		{
+			fmp4_buffer(s, used);
+			s->buf[0] = header;
+			if (fmp4_read(s, s->buf + 1, used - 1))
+				return -1;
+		}
+		if (fmp4_skip(s, nal_length - (used > 0 ? used : 1)))
+			return -1;
+
+		s_nalu_stats.total += 1;
+		temp_debug = 0;
+		if (is_hevc)
+		{
+			u8 nal_type = (header >> 1) & 0x3F;
+			if (nal_type < 32)
+				s_nalu_stats.type[nal_type] += 1;
+		}
+		else
+			s_nalu_stats.type[header & 0x1F] += 1;
+		if (used > 0)
+			do_NAL(s->enc_ctx, s->dec_ctx, s->buf, used, &s->dec_sub);
+	}
+
+	if (is_hevc)
+		flush_hevc_cc_data(s->enc_ctx, s->dec_ctx, &s->dec_sub);
+	return 0;
+}
+
+// Copies the text of a WebVTT cue or TTML paragraph to `out`, which must hold `len` + 1 bytes.
+// Markup other than <i>, <b> and <u> is dropped, <br> becomes a line break and the common
+// entities are decoded. With `collapse_space`, runs of XML white space become single spaces.
+static void fmp4_copy_text(char *out, const char *in, u32 len, int collapse_space)
+{
+	static const struct
+	{
+		const char *name;
+		char c;
+	} entities[] = {{"&amp;", '&'}, {"&lt;", '<'}, {"&gt;", '>'}, {"&quot;", '"'}, {"&apos;", '\''}, {"&nbsp;", ' '}};
+	const char *end = in + len;
+	char *o = out;
+	size_t k;
+
+	while (in < end)
+	{
+		if (*in == '<')
+		{
+			const char *gt = memchr(in, '>', end - in), *name = in + 1, *e;
+			int closing = *name == '/';
+			if (!gt)
+				break;
+			for (name += closing, e = name; e < gt && !isspace((unsigned char)*e) && *e != '/'; e++)
+				if (*e == ':')
+					name = e + 1;
+			if (e - name == 2 && !strncmp(name, "br", 2))
+			{
+				if (o > out && o[-1] == ' ')
+					o--;
+				*o++ = '\n';
+			}
+			else if (e - name == 1 && strchr("ibu", *name))
+			{
+				*o++ = '<';
+				if (closing)
+					*o++ = '/';
+				*o++ = *name;
+				*o++ = '>';
+			}
+			in = gt + 1;
+		}
+		else if (*in == '&')
+		{
+			for (k = 0; k < sizeof(entities) / sizeof(*entities); k++)
+				if ((size_t)(end - in) >= strlen(entities[k].name) && !strncmp(in, entities[k].name, strlen(entities[k].name)))
+					break;
+			if (k < sizeof(entities) / sizeof(*entities))
+			{
+				*o++ = entities[k].c;
+				in += strlen(entities[k].name);
+			}
+			else
+				*o++ = *in++;
+		}
+		else if (collapse_space && isspace((unsigned char)*in))
+		{
+			if (o > out && o[-1] != ' ' && o[-1] != '\n')
+				*o++ = ' ';
+			in++;
+		}
+		else
+			*o++ = *in++;
+	}
+	while (o > out && (o[-1] == ' ' || o[-1] == '\n'))
+		o--;
+	*o = '\0';
+}
+
+// Line breaks in `text` are written as the teletext decoder writes the rows of a page
+static void fmp4_add_text(struct fmp4_stream *s, char *text, LLONG start, LLONG end, char *mode)
+{
+	const char *br = "\r\n";
+	char *lines, *o;
+
+	if (!*text)
+		return;
+	if (s->dec_ctx->write_format == CCX_OF_TRANSCRIPT)
+		br = " ";
+	else if (s->dec_ctx->write_format == CCX_OF_SMPTETT)
+		br = "<br/>";
+	lines = malloc(strlen(text) * strlen(br) + 1);
+	if (!lines)
+		fatal(EXIT_NOT_ENOUGH_MEMORY, "In fmp4_add_text: Out of memory allocating subtitle text.");
+	for (o = lines; *text; text++)
+	{
+		if (*text == '\n')
+		{
+			strcpy(o, br);
+			o += strlen(br);
+		}
+		else
+			*o++ = *text;
+	}
+	*o = '\0';
+	add_cc_sub_text(&s->dec_sub, lines, start, end, "NA", mode, CCX_ENC_UTF_8);
+	free(lines);
+	encode_sub(s->enc_ctx, &s->dec_sub);
+	s->dec_sub.got_output = 0;
+	s->mp4_ret = 1;
+}
+
+// A WebVTT sample holds a cue box (vttc) with a payl for each cue shown during the sample,
+// or only a vtte when there is none
+static void fmp4_process_wvtt(struct fmp4_stream *s, u32 size, LLONG start, LLONG end)
+{
+	const unsigned char *p = s->buf, *cue, *payl;
+	u32 type, cue_size, payl_size;
+	char *text = malloc(size + 1), *o = text;
+
+	if (!text)
+		fatal(EXIT_NOT_ENOUGH_MEMORY, "In fmp4_process_wvtt: Out of memory allocating cue text.");
+	*o = '\0';
+	while (fmp4_next_box(&p, s->buf + size, &type, &cue, &cue_size))
+	{
+		if (type != GF_4CC('v', 't', 't', 'c') ||
+		    !fmp4_find_box(cue, cue + cue_size, GF_4CC('p', 'a', 'y', 'l'), &payl, &payl_size))
+			continue;
+		if (o != text)
+			*o++ = '\n';
+		fmp4_copy_text(o, (const char *)payl, payl_size, 0);
+		o += strlen(o);
+	}
+	fmp4_add_text(s, text, start, end, "WVTT");
+	free(text);
+}
+
+// Finds the next start tag (or end tag with `closing`) named `name` in the NUL terminated
+// `xml`, whatever its namespace prefix. Returns its '<' and sets *after past its '>'.
+static const char *fmp4_find_tag(const char *xml, const char *name, int closing, const char **after)
+{
+	const size_t len = strlen(name);
+	const char *p, *n, *e, *gt;
+
+	for (p = strchr(xml, '<'); p; p = strchr(p + 1, '<'))
+	{
+		n = p + 1;
+		if (closing != (*n == '/'))
+			continue;
+		for (n += closing, e = n; *e && !isspace((unsigned char)*e) && *e != '>' && *e != '/'; e++)
+			if (*e == ':')
+				n = e + 1;
+		if ((size_t)(e - n) != len || strncmp(n, name, len))
+			continue;
+		if (!(gt = strchr(e, '>')))
+			return NULL;
+		*after = gt + 1;
+		return p;
+	}
+	return NULL;
+}
+
+// Value in milliseconds of the time attribute `name` of the tag in [tag, tag_end), -1 if it's
+// missing. Clock times (hh:mm:ss.fff, frames are ignored) and offsets (12.5s, 1500ms) are read.
+static LLONG fmp4_ttml_time(const char *tag, const char *tag_end, const char *name)
+{
+	const size_t len = strlen(name);
+	const char *a, *v;
+	unsigned h, m;
+	double t;
+	int n;
+
+	for (a = tag; a + len + 2 < tag_end; a++)
+	{
+		if (!isspace((unsigned char)a[0]) || strncmp(a + 1, name, len) || a[len + 1] != '=')
+			continue;
+		v = a + len + 2;
+		if (*v != '"' && *v != '\'')
+			continue;
+		v++;
+		if (sscanf(v, "%u:%u:%lf", &h, &m, &t) == 3)
+			return (LLONG)(h * 3600000LL + m * 60000LL + t * 1000 + 0.5);
+		if (sscanf(v, "%lf%n", &t, &n) != 1)
+			return -1;
+		switch (v[n])
+		{
+			case 'h':
+				return (LLONG)(t * 3600000 + 0.5);
+			case 'm':
+				return (LLONG)(v[n + 1] == 's' ? t + 0.5 : t * 60000 + 0.5);
+			case 's':
+				return (LLONG)(t * 1000 + 0.5);
+		}
+		return -1;
+	}
+	return -1;
+}
+
+// Maps a TTML time to the output timeline, clamped to the sample. Times on the media timeline
+// are offset by media_ms, the sample's media time.
+static LLONG fmp4_ttml_cue_time(LLONG t, LLONG fallback, LLONG start, LLONG end, enum fmp4_ttml_clock clock, LLONG media_ms)
+{
+	if (t < 0)
+		return fallback;
+	t = clock == FMP4_TTML_MEDIA ? start + t - media_ms : start + t;
+	return t < start ? start : t > end ? end : t;
+}
+
+// Finds what the times of a track's TTML count from, from its first sample after media time 0
+// that has any. A cue shown during a sample ends after the sample's media time, so times none
+// of which is later count from the sample.
+static void fmp4_ttml_find_clock(struct fmp4_track *t, const char *doc, LLONG media_ms)
+{
+	const char *p = doc, *content;
+	LLONG latest = -1, time;
+
+	if (t->ttml_clock != FMP4_TTML_UNKNOWN || media_ms <= 0)
+		return;
+	while ((p = fmp4_find_tag(p, "p", 0, &content)) != NULL)
+	{
+		if ((time = fmp4_ttml_time(p, content, "begin")) > latest)
+			latest = time;
+		if ((time = fmp4_ttml_time(p, content, "end")) > latest)
+			latest = time;
+		p = content;
+	}
+	if (latest >= 0)
+		t->ttml_clock = latest <= media_ms ? FMP4_TTML_SAMPLE : FMP4_TTML_MEDIA;
+}
+
+// A TTML (stpp) sample is a whole document. Each <p> in it becomes a subtitle, timed by its
+// begin and end attributes or else by the sample.
+static void fmp4_process_stpp(struct fmp4_stream *s, u32 size, LLONG start, LLONG end, LLONG media_ms)
+{
+	const char *p = (const char *)s->buf, *content, *close, *next;
+	char *text = malloc(size + 1);
+
+	if (!text)
+		fatal(EXIT_NOT_ENOUGH_MEMORY, "In fmp4_process_stpp: Out of memory allocating cue text.");
+	fmp4_ttml_find_clock(s->track, p, media_ms);
+	while ((p = fmp4_find_tag(p, "p", 0, &content)) != NULL)
+	{
+		// Empty <p/>
+		if (content[-2] == '/')
+		{
+			p = content;
+			continue;
+		}
+		if (!(close = fmp4_find_tag(content, "p", 1, &next)))
+			break;
+		fmp4_copy_text(text, content, close - content, 1);
+		fmp4_add_text(s, text,
+			      fmp4_ttml_cue_time(fmp4_ttml_time(p, content, "begin"), start, start, end, s->track->ttml_clock, media_ms),
+			      fmp4_ttml_cue_time(fmp4_ttml_time(p, content, "end"), end, start, end, s->track->ttml_clock, media_ms),
+			      "TTML");
+		p = next;
+	}
+	free(text);
+}
+
+// Processes the sample at the current stream position, consuming exactly its bytes
+static int fmp4_process_sample(struct fmp4_stream *s, const struct fmp4_sample *sample)
+{
+	const struct fmp4_track *t = s->track;
+	struct lib_cc_decode *dec_ctx = s->dec_ctx;
+	const s64 time = (s64)sample->dts + sample->cts_offset;
+	int atom_length;
+	u32 i;
+
+	set_current_pts(dec_ctx->timing, fmp4_to_mpeg_clock(time, t->timescale));
+	// Caption tracks have no frames, see processmp4()
+	if (t->codec != FMP4_CODEC_AVC && t->codec != FMP4_CODEC_HEVC)
+		dec_ctx->timing->current_picture_coding_type = CCX_FRAME_TYPE_I_FRAME;
+	set_fts(dec_ctx->timing);
+
+	switch (t->codec)
+	{
+		case FMP4_CODEC_AVC:
+		case FMP4_CODEC_HEVC:
+			if (fmp4_process_video_sample(s, sample->size))
+				return -1;
+			break;
+
+		case FMP4_CODEC_WVTT:
+		case FMP4_CODEC_STPP:
+		{
+			const LLONG start = dec_ctx->timing->fts_now;
+			const LLONG end = start + (LLONG)sample->duration * 1000 / t->timescale;
+			if (sample->size > FMP4_MAX_BOX_SIZE)
+				return fmp4_skip(s, sample->size);
+			if (fmp4_load(s, sample->size))
+				return -1;
+			if (t->codec == FMP4_CODEC_WVTT)
+				fmp4_process_wvtt(s, sample->size, start, end);
+			else
+				fmp4_process_stpp(s, sample->size, start, end, fmp4_to_mpeg_clock(time, t->timescale) / (MPEG_CLOCK_FREQ / 1000));
+			break;
+		}
+
+		default: // c608, c708 and tx3g, atom by atom as in processmp4()
+			if (sample->size > FMP4_MAX_BOX_SIZE)
+				return fmp4_skip(s, sample->size);
+			if (fmp4_load(s, sample->size))
+				return -1;
+			for (i = 0; i < sample->size; i += atom_length)
+			{
+				char *data = (char *)s->buf + i;
+				if (t->codec == FMP4_CODEC_TX3G)
+					atom_length = process_tx3g(s->ctx, s->enc_ctx, dec_ctx, &s->dec_sub, &s->mp4_ret,
+								   data, sample->size - i, 0);
+				else if (sample->size - i >= 8)
+					atom_length = process_clcp(s->ctx, s->enc_ctx, dec_ctx, &s->dec_sub, &s->mp4_ret,
+								   t->subtype, data, sample->size - i);
+				else
+					break;
+				if (atom_length <= 0)
+					break; // error happened or process of the sample is finished
+			}
+	}
+
+	if (s->dec_sub.got_output)
+	{
+		s->mp4_ret = 1;
+		encode_sub(s->enc_ctx, &s->dec_sub);
+		s->dec_sub.got_output = 0;
+	}
+	return 0;
+}
+
+// Processes the samples of the current fragment found in an mdat whose header was just read,
+// reading forward only. Returns -1 at the end of the stream.
+static int fmp4_process_mdat(struct fmp4_stream *s, u64 payload)
+{
+	const u64 data_end = payload == UINT64_MAX ? UINT64_MAX : s->pos + payload;
+
+	for (u32 i = 0; i < s->sample_count; i++)
+	{
+		const struct fmp4_sample *sample = &s->samples[i];
+		// Samples of another mdat, or overlapping one already read
+		if (sample->offset < s->pos || sample->offset >= data_end)
+			continue;
+		if (sample->size > data_end - sample->offset)
+		{
+			mprint("Sample runs past the end of its mdat box, skipping the rest of the fragment.\n");
+			break;
+		}
+		if (fmp4_skip(s, sample->offset - s->pos) || fmp4_process_sample(s, sample))
+			return -1;
+		if (s->ctx->terminate_asap)
+			return -1;
+	}
+	if (payload == UINT64_MAX)
+		return -1;
+	return fmp4_skip(s, data_end - s->pos);
+}
+
+int is_fragmented_mp4(const char *file)
+{
+	FILE *f = fopen(file, "rb");
+	unsigned char h[16];
+	u64 size, pos = 0, moov_end;
+	u32 type, header;
+	int fragmented = 1; // Until a moov without mvex comes before the media data
+
+	if (!f)
+		return 0;
+	while (fread(h, 1, 8, f) == 8)
+	{
+		size = RB32(h);
+		type = RB32(h + 4);
+		header = 8;
+		if (size == 1)
+		{
+			if (fread(h + 8, 1, 8, f) != 8)
+				break;
+			size = fmp4_rb64(h + 8);
+			header = 16;
+		}
+		if (type == GF_4CC('m', 'o', 'o', 'v'))
+		{
+			fragmented = 0;
+			moov_end = size == 0 ? UINT64_MAX : pos + size;
+			for (pos += header; pos + 8 <= moov_end && !FSEEK(f, pos, SEEK_SET) && fread(h, 1, 8, f) == 8; pos += size)
+			{
+				size = RB32(h);
+				if (RB32(h + 4) == GF_4CC('m', 'v', 'e', 'x'))
+					fragmented = 1;
+				if (fragmented || size < 8)
+					break;
+			}
+			break;
+		}
+		if (type == GF_4CC('m', 'o', 'o', 'f') || type == GF_4CC('m', 'd', 'a', 't') || size < header)
+			break;
+		pos += size;
+		if (FSEEK(f, pos, SEEK_SET))
+			break;
+	}
+	fclose(f);
+	return fragmented;
+}
+
+int processmp4_stream(struct lib_ccx_ctx *ctx, struct ccx_s_mp4Cfg *cfg)
+{
+	struct fmp4_stream s;
+	u32 type;
+	u64 payload, box_start;
+	int status = 0;
+
+	memset(&s, 0, sizeof(s));
+	s.ctx = ctx;
+	s.demux = ctx->demux_ctx;
+	s.dec_ctx = update_decoder_list(ctx);
+	s.enc_ctx = update_encoder_list(ctx);
+
+	if (s.enc_ctx)
+		s.enc_ctx->timing = s.dec_ctx->timing;
+
+		// WARN: otherwise cea-708 will not work
+#ifndef DISABLE_RUST
+	ccxr_dtvcc_set_encoder(s.dec_ctx->dtvcc_rust, s.enc_ctx);
+#else
+	s.dec_ctx->dtvcc->encoder = (void *)s.enc_ctx;
+#endif
+
+	while (status == 0 && !ctx->terminate_asap)
+	{
+		box_start = s.pos;
+		if (fmp4_read_box_header(&s, &type, &payload))
+			break;
+		switch (type)
+		{
+			case GF_4CC('m', 'o', 'o', 'v'):
+			case GF_4CC('m', 'o', 'o', 'f'):
+				if (payload > FMP4_MAX_BOX_SIZE)
+				{
+					mprint("Skipping %c%c%c%c box of %llu bytes in fragmented MP4 stream, it's too large.\n",
+					       (unsigned char)(type >> 24), (unsigned char)(type >> 16), (unsigned char)(type >> 8),
+					       (unsigned char)type, (unsigned long long)payload);
+					status = payload == UINT64_MAX ? -1 : fmp4_skip(&s, payload);
+					break;
+				}
+				if ((status = fmp4_load(&s, (u32)payload)) != 0)
+					break;
+				if (type == GF_4CC('m', 'o', 'o', 'v'))
+				{
+					fmp4_parse_moov(&s, s.buf, (u32)payload);
+					if (!s.fragmented)
+						mprint("This MP4 isn't fragmented (no mvex box), it can only be read from a file.\n");
+					fmp4_select_track(&s, cfg);
+				}
+				else if (s.track)
+				{
+					fmp4_parse_moof(&s, box_start, s.buf, (u32)payload);
+					if (ctx->inputsize > 0)
+					{
+						int progress = (int)((s.pos * 100) / ctx->inputsize);
+						if (ctx->last_reported_progress != progress)
+						{
+							int cur_sec = (int)(get_fts(s.dec_ctx->timing, s.dec_ctx->current_field) / 1000);
+							activity_progress(progress, cur_sec / 60, cur_sec % 60);
+							ctx->last_reported_progress = progress;
+						}
+					}
+				}
+				break;
+			case GF_4CC('m', 'd', 'a', 't'):
+				status = fmp4_process_mdat(&s, payload);
+				break;
+			default:
+				status = payload == UINT64_MAX ? -1 : fmp4_skip(&s, payload);
+		}
+	}
+
+	// Encode the last subtitle
+	if (s.track && s.track->codec == FMP4_CODEC_TX3G)
+		process_tx3g(ctx, s.enc_ctx, s.dec_ctx, &s.dec_sub, &s.mp4_ret, NULL, 0, 1);
+	if (s.dec_sub.got_output)
+	{
+		s.mp4_ret = 1;
+		encode_sub(s.enc_ctx, &s.dec_sub);
+		s.dec_sub.got_output = 0;
+	}
+
+	int cur_sec = (int)(get_fts(s.dec_ctx->timing, s.dec_ctx->current_field) / 1000);
+	activity_progress(100, cur_sec / 60, cur_sec % 60);
+
+	free(s.samples);
+	free(s.buf);
+
+	if ((s.dec_ctx->write_format == CCX_OF_MCC) && (s.dec_ctx->saw_caption_block == CCX_TRUE))
+		s.mp4_ret = 1;
+
+	return s.mp4_ret;
+}
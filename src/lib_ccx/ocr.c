@@ -205,12 +205,33 @@ char *probe_tessdata_location(const char *lang)
 	return NULL;
 }
 
+/* A Tesseract set up by preload_ocr() before --batch forks its workers.
+   The first init_ocr() of each worker takes it over, so the workers share
+   the loaded tessdata instead of each loading it again. */
+static struct ocrCtx *preloaded_ocr = NULL;
+
+void preload_ocr(void)
+{
+	/* Without --ocrlang the language only comes with the stream */
+	if (ccx_options.ocrlang && !preloaded_ocr)
+		preloaded_ocr = init_ocr(0);
+}
+
 void *init_ocr(int lang_index)
 {
 	int ret = -1;
 	struct ocrCtx *ctx;
 	const char *lang = NULL, *tessdata_path = NULL;
 
+	/* With --ocrlang every context is set up alike, whatever lang_index is.
+	   Callers that set up OCR from threads do so one at a time. */
+	if (preloaded_ocr && ccx_options.ocrlang)
+	{
+		ctx = preloaded_ocr;
+		preloaded_ocr = NULL;
+		return ctx;
+	}
+
 	ctx = (struct ocrCtx *)malloc(sizeof(struct ocrCtx));
 	if (!ctx)
 		return NULL;
@@ -15,6 +15,7 @@ struct image_copy // A copy of the original OCR image, used for color detection
 void delete_ocr(void **arg);
 char *probe_tessdata_location(const char *lang);
 void *init_ocr(int lang_index);
+void preload_ocr(void);
 char *ocr_bitmap(void *arg, png_color *palette, png_byte *alpha, unsigned char *indata, int w, int h, struct image_copy *copy);
 int ocr_rect(void *arg, struct cc_bitmap *rect, char **str, int bgcolor, int ocr_quantmode);
 char *paraof_ocrtext(struct cc_subtitle *sub, struct encoder_ctx *context);
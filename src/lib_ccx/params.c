@@ -177,6 +177,14 @@ void print_usage(void)
 	mprint("                                 in specified input. Don't produce any file\n");
 	mprint("                                 output\n\n");
 	mprint("       --srt, --dvdraw, --sami, --webvtt, --txt, --ttxt and --null can be used as shorts.\n\n");
+	mprint("  --also-out=format[,format...]: Also write the captions in these formats, from\n");
+	mprint("                       the same pass over the input. Each file is named like\n");
+	mprint("                       the --out one, with the extension of its format. Can be\n");
+	mprint("                       srt, ass, ssa, ccd, scc, webvtt, sami, txt, g608,\n");
+	mprint("                       smptett, spupng or simplexml,\n");
+	mprint("                       e.g. --also-out=webvtt,scc,smptett,txt\n");
+	mprint("    --also-out-threads: Write each of the --also-out formats on a thread of\n");
+	mprint("                       its own, so the extraction doesn't wait for them.\n\n");
 
 	mprint("Options that affect how input files will be processed.\n");
 
@@ -235,6 +243,13 @@ void print_usage(void)
 	mprint("         --autoprogram: If there's more than one program in the stream, just use\n");
 	mprint("                       the first one we find that contains a suitable stream.\n");
 	mprint("        --multiprogram: Uses multiple programs from the same input stream.\n");
+	mprint("               --batch: Process each input file on its own, as an independent\n");
+	mprint("                       job, several of them at the same time. Each output file\n");
+	mprint("                       is named after its input file, so -o can't be used.\n");
+	mprint("              --jobs n: With --batch, how many files to process at the same\n");
+	mprint("                       time. Defaults to the number of processors.\n");
+	mprint("   --batch-report file: With --batch, write a JSON report with the result of\n");
+	mprint("                       every job to this file.\n");
 	mprint("             --datapid: Don't try to find out the stream for caption/teletext\n");
 	mprint("                       data, just use this one instead.\n");
 	mprint("      --datastreamtype: Instead of selecting the stream by its PID, select it\n");
@@ -354,6 +369,8 @@ void print_usage(void)
 	mprint("          --xmltv mode: produce an XMLTV file containing the EPG data from\n");
 	mprint("                       the source TS file. Mode: 1 = full output\n");
 	mprint("                       2 = live output. 3 = both\n");
+	mprint("                       Live output is appended to a single _epg_live.xml\n");
+	mprint("                       file, rewritten compacted when mostly superseded.\n");
 	mprint(" --xmltvliveinterval x: interval of x seconds between writing live mode xmltv output.\n");
 	mprint("--xmltvoutputinterval x: interval of x seconds between writing full file xmltv output.\n");
 	mprint("    --xmltvonlycurrent: Only print current events for xmltv output.\n");
@@ -414,6 +431,12 @@ void print_usage(void)
 	mprint("                       ISO-639-2 form (like \"fre\" for french) or a language\n");
 	mprint("                       code followed by a dash and a country code for specialities\n");
 	mprint("                       in languages (like \"fre-ca\" for Canadian French).\n");
+	mprint("         --mkv-threads: For MKV subtitles, write up to this many subtitle\n");
+	mprint("                       tracks at the same time, each to its own file.\n");
+	mprint("                       VOBSUB tracks converted with OCR are recognized at\n");
+	mprint("                       the same time, each with its own Tesseract, and then\n");
+	mprint("                       written in order. The default value is 1\n");
+	mprint("                       e.g. --mkv-threads 4\n");
 	mprint("          --no-spupngocr When processing DVB don't use the OCR to write the text as\n");
 	mprint("                       comments in the XML file.\n");
 	mprint("                --font: Specify the full path of the font that is to be used when\n");
@@ -426,6 +449,14 @@ void print_usage(void)
 	mprint("                       have the default font installed (Helvetica Oblique for macOS, Calibri Italic\n");
 	mprint("                       for Windows, and NotoSans Italic for other operating systems at their)\n");
 	mprint("                       default location)\n");
+	mprint("         --png-threads: Compress and write SPUPNG images on this many threads,\n");
+	mprint("                       so the extraction doesn't wait for them. The default\n");
+	mprint("                       value is 1 (images are written as they are produced)\n");
+	mprint("                       e.g. --png-threads 4\n");
+	mprint("     --png-compression: zlib compression level of SPUPNG images, from 0 (none,\n");
+	mprint("                       fastest) to 9 (smallest files). Default: libpng's.\n");
+	mprint("          --png-filter: PNG row filter for SPUPNG images: none, sub, up, avg,\n");
+	mprint("                       paeth or all (try each one per row). Default: libpng's.\n");
 	mprint("\n");
 	mprint("Options that affect how ccextractor reads and writes (buffering):\n");
 
@@ -635,6 +666,13 @@ void print_usage(void)
 	mprint("                     Recommended values are in the range 80 to 100.\n");
 	mprint("                     The default value is 95\n");
 	mprint("\n");
+	mprint("  --sub-band-height : Specify the height of the band at the bottom of the \n");
+	mprint("                     frame that is searched for subtitles, as a percentage\n");
+	mprint("                     of the frame height between 1 and 100.\n");
+	mprint("                     Only this band is converted and OCR'd.\n");
+	mprint("                     The default value is 25\n");
+	mprint("                     e.g. --sub-band-height 30\n");
+	mprint("\n");
 	mprint("		--hcc	   : This option will be used if the file should have both\n");
 	mprint("					 closed captions and burned in subtitles\n");
 	mprint("            An example command for burned-in subtitle extraction is as follows:\n");
@@ -728,10 +766,9 @@ void print_usage(void)
 	mprint("\n");
 }
 
-unsigned char sha256_buf[16384];
-
-char *calculateSHA256(char *location)
+char *calculateSHA256(char *location, char digest[SHA256_DIGEST_STRING_LENGTH])
 {
+	unsigned char buffer[16384];
 	int size_read, bytes_read, fh = 0;
 	SHA256_CTX ctx256;
 
@@ -748,19 +785,19 @@ char *calculateSHA256(char *location)
 		return "Could not open file";
 	}
 	size_read = 0;
-	while ((bytes_read = read(fh, sha256_buf, 16384)) > 0)
+	while ((bytes_read = read(fh, buffer, sizeof(buffer))) > 0)
 	{
 		size_read += bytes_read;
-		CC_SHA256_Update(&ctx256, (unsigned char *)sha256_buf, bytes_read);
+		CC_SHA256_Update(&ctx256, buffer, bytes_read);
 	}
 	close(fh);
-	SHA256_End(&ctx256, sha256_buf);
-	return sha256_buf;
+	return SHA256_End(&ctx256, digest);
 }
 
 void version(char *location)
 {
-	char *hash = calculateSHA256(location);
+	char digest[SHA256_DIGEST_STRING_LENGTH];
+	char *hash = calculateSHA256(location, digest);
 	mprint("CCExtractor detailed version info\n");
 	mprint("	Version: %s\n", VERSION);
 	mprint("	Git commit: %s\n", GIT_COMMIT);
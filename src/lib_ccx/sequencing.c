@@ -47,7 +47,7 @@ void store_hdcc(struct encoder_ctx *enc_ctx, struct lib_cc_decode *dec_ctx, unsi
 	// the right time according to the sequence number.
 	if (ccx_options.use_gop_as_pts == 1)
 	{
-		current_fts_now += (LLONG)(sequence_number * 1000.0 / current_fps);
+		current_fts_now += (LLONG)(sequence_number * 1000.0 / dec_ctx->timing->current_fps);
 	}
 
 	if (cc_count)
@@ -123,9 +123,9 @@ void process_hdcc(struct encoder_ctx *enc_ctx, struct lib_cc_decode *dec_ctx, st
 		}
 		if (reset_cb == 1)
 		{
-			cb_field1 = 0;
-			cb_field2 = 0;
-			cb_708 = 0;
+			dec_ctx->timing->cb_field1 = 0;
+			dec_ctx->timing->cb_field2 = 0;
+			dec_ctx->timing->cb_708 = 0;
 		}
 
 		// Skip sequence numbers without data
@@ -141,8 +141,7 @@ void process_hdcc(struct encoder_ctx *enc_ctx, struct lib_cc_decode *dec_ctx, st
 		}
 
 		// Re-create original time
-		dec_ctx->timing->fts_now = dec_ctx->cc_fts[seq];
-		process_cc_data(enc_ctx, dec_ctx, dec_ctx->cc_data_pkts[seq], dec_ctx->cc_data_count[seq], sub);
+		process_cc_data(enc_ctx, dec_ctx, dec_ctx->cc_data_pkts[seq], dec_ctx->cc_data_count[seq], dec_ctx->cc_fts[seq], sub);
 	}
 
 	// Restore the value
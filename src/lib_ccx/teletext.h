@@ -41,6 +41,18 @@ typedef struct
 	uint8_t receiving_data;		// Currently receiving data for this page
 } teletext_page_state_t;
 
+// Number of magazines in a teletext service; magazine 8 is transmitted with address 0
+#define TELETEXT_MAGAZINES 8
+
+// Per-magazine reception state. In parallel transmission mode each magazine carries
+// its own page, terminated only by the next header in the same magazine (ETS 300 706, chapter 7.2.1)
+typedef struct
+{
+	uint16_t page_number;	     // BCD-encoded page being received in this magazine (0 = none yet)
+	uint8_t receiving_data;	     // flag indicating if incoming data should be processed or ignored
+	teletext_page_t page_buffer; // Current page content being received
+} teletext_magazine_t;
+
 // application states -- flags for notices that should be printed only once
 struct s_states
 {
@@ -48,6 +60,25 @@ struct s_states
 	uint8_t pts_initialized;
 };
 
+typedef enum
+{
+	LATIN = 0,
+	CYRILLIC1,
+	CYRILLIC2,
+	CYRILLIC3,
+	GREEK,
+	ARABIC,
+	HEBREW
+} g0_charsets_type;
+
+// current charset (charset can be -- and always is -- changed during transmission)
+struct s_primary_charset
+{
+	uint8_t current;
+	uint8_t g0_m29;
+	uint8_t g0_x28;
+};
+
 typedef enum
 {
 	TRANSMISSION_MODE_PARALLEL = 0,
@@ -91,9 +122,11 @@ struct TeletextCtx
 	int current_page_idx;                                       // Index of page currently receiving data (-1 = none)
 	int multi_page_mode;                                        // 1 = multi-page mode active
 
+	// Pages being received, indexed by magazine - 1
+	teletext_magazine_t magazines[TELETEXT_MAGAZINES];
+
 	// Current and previous page buffers (legacy single-page mode)
 	// These are still used when multi_page_mode == 0 for backward compatibility
-	teletext_page_t page_buffer;
 	char *page_buffer_prev;
 	char *page_buffer_cur;
 	unsigned page_buffer_cur_size;
@@ -120,9 +153,6 @@ struct TeletextCtx
 	uint32_t tlt_packet_counter;
 	// teletext transmission mode
 	transmission_mode_t transmission_mode;
-	// flag indicating if incoming data should be processed or ignored
-	uint8_t receiving_data;
-
 	uint8_t using_pts;
 	int64_t delta;
 	uint32_t t0;
@@ -130,6 +160,13 @@ struct TeletextCtx
 	int sentence_cap; // Set to 1 if -sc is passed
 	int new_sentence;
 	int splitbysentence;
+
+	// G0 charsets with the Latin National Option Sub-set currently in use
+	uint16_t G0[5][96];
+	g0_charsets_type default_g0_charset;
+	struct s_primary_charset primary_charset;
+	int de_ctr;	       // a keeps count of packets with flag subtitle ON and data packets
+	uint64_t last_pes_pts; // PTS of last PES packet (debug purposes)
 };
 
 int tlt_print_seen_pages(struct lib_cc_decode *dec_ctx);
@@ -48,8 +48,6 @@ int _CRT_fmode = _O_BINARY;
 #include <commctrl.h>
 #endif
 
-uint64_t last_pes_pts = 0; // PTS of last PES packet (debug purposes)
-static int de_ctr = 0;	   // a keeps count of packets with flag subtitle ON and data packets
 static const char *TTXT_COLOURS[8] = {
     // black,   red,       green,     yellow,    blue,      magenta,   cyan,      white
     "#000000", "#ff0000", "#00ff00", "#ffff00", "#0000ff", "#ff00ff", "#00ffff", "#ffffff"};
@@ -73,15 +71,6 @@ struct ccx_s_teletext_config tlt_config = {0};
 // macro -- output only when increased verbosity was turned on
 #define VERBOSE_ONLY if (tlt_config.verbose == YES)
 
-// current charset (charset can be -- and always is -- changed during transmission)
-struct s_primary_charset
-{
-	uint8_t current;
-	uint8_t g0_m29;
-	uint8_t g0_x28;
-} primary_charset = {
-    0x00, UNDEFINED, UNDEFINED};
-
 // entities, used in colour mode, to replace unsafe HTML tag chars
 struct
 {
@@ -108,25 +97,13 @@ struct
 // extracts page number from teletext page
 #define PAGE(p) (p & 0xff)
 
-typedef enum
-{
-	LATIN = 0,
-	CYRILLIC1,
-	CYRILLIC2,
-	CYRILLIC3,
-	GREEK,
-	ARABIC,
-	HEBREW
-} g0_charsets_type;
-
-g0_charsets_type default_g0_charset;
-
 // Note: All characters are encoded in UCS-2
 
 // --- G0 ----------------------------------------------------------------------
 
-// G0 charsets
-uint16_t G0[5][96] = {
+// G0 charsets, as transmitted before any national subset is selected. Each
+// context works on its own copy, since remap_g0_charset() patches the Latin set
+static const uint16_t G0[5][96] = {
     {// Latin G0 Primary Set
      0x0020, 0x0021, 0x0022, 0x00a3, 0x0024, 0x0025, 0x0026, 0x0027, 0x0028, 0x0029, 0x002a, 0x002b, 0x002c, 0x002d, 0x002e, 0x002f,
      0x0030, 0x0031, 0x0032, 0x0033, 0x0034, 0x0035, 0x0036, 0x0037, 0x0038, 0x0039, 0x003a, 0x003b, 0x003c, 0x003d, 0x003e, 0x003f,
@@ -379,13 +356,9 @@ uint8_t unham_8_4(uint8_t a)
 // ETS 300 706, chapter 8.3
 uint32_t unham_24_18(uint32_t a)
 {
-	uint8_t test = 0;
-
-	// Tests A-F correspond to bits 0-6 respectively in 'test'.
-	for (uint8_t i = 0; i < 23; i++)
-		test ^= ((a >> i) & 0x01) * (i + 33);
-	// Only parity bit is tested for bit 24
-	test ^= ((a >> 23) & 0x01) * 32;
+	// Tests A-F correspond to bits 0-6 respectively in 'test'; only parity bit is tested for bit 24.
+	// The per-bit contributions are folded into one table per byte of the triplet.
+	uint8_t test = UNHAM_24_18_PAR[0][a & 0xff] ^ UNHAM_24_18_PAR[1][(a >> 8) & 0xff] ^ UNHAM_24_18_PAR[2][(a >> 16) & 0xff];
 
 	if ((test & 0x1f) != 0x1f)
 	{
@@ -403,36 +376,36 @@ uint32_t unham_24_18(uint32_t a)
 }
 
 // Default G0 Character Set
-void set_g0_charset(uint32_t triplet)
+void set_g0_charset(struct TeletextCtx *ctx, uint32_t triplet)
 {
 	// ETS 300 706, Table 32
 	// If user requested to force Latin charset, always use it (issue #1395)
 	// Some broadcasts incorrectly signal Cyrillic when content is actually Latin
 	if (tlt_config.forceg0latin)
 	{
-		default_g0_charset = LATIN;
+		ctx->default_g0_charset = LATIN;
 		return;
 	}
 
 	if ((triplet & 0x3c00) == 0x1000)
 	{
 		if ((triplet & 0x0380) == 0x0000)
-			default_g0_charset = CYRILLIC1;
+			ctx->default_g0_charset = CYRILLIC1;
 		else if ((triplet & 0x0380) == 0x0200)
-			default_g0_charset = CYRILLIC2;
+			ctx->default_g0_charset = CYRILLIC2;
 		else if ((triplet & 0x0380) == 0x0280)
-			default_g0_charset = CYRILLIC3;
+			ctx->default_g0_charset = CYRILLIC3;
 		else
-			default_g0_charset = LATIN;
+			ctx->default_g0_charset = LATIN;
 	}
 	else
-		default_g0_charset = LATIN;
+		ctx->default_g0_charset = LATIN;
 }
 
 // Latin National Subset Selection
-void remap_g0_charset(uint8_t c)
+void remap_g0_charset(struct TeletextCtx *ctx, uint8_t c)
 {
-	if (c != primary_charset.current)
+	if (c != ctx->primary_charset.current)
 	{
 		uint8_t m = G0_LATIN_NATIONAL_SUBSETS_MAP[c];
 		if (m == 0xff)
@@ -442,9 +415,9 @@ void remap_g0_charset(uint8_t c)
 		else
 		{
 			for (uint8_t j = 0; j < 13; j++)
-				G0[LATIN][G0_LATIN_NATIONAL_SUBSETS_POSITIONS[j]] = G0_LATIN_NATIONAL_SUBSETS[m].characters[j];
+				ctx->G0[LATIN][G0_LATIN_NATIONAL_SUBSETS_POSITIONS[j]] = G0_LATIN_NATIONAL_SUBSETS[m].characters[j];
 			VERBOSE_ONLY fprintf(stderr, "- Using G0 Latin National Subset ID 0x%1x.%1x (%s)\n", (c >> 3), (c & 0x7), G0_LATIN_NATIONAL_SUBSETS[m].language);
-			primary_charset.current = c;
+			ctx->primary_charset.current = c;
 		}
 	}
 }
@@ -474,7 +447,7 @@ void ucs2_to_utf8(char *r, uint16_t ch)
 }
 
 // check parity and translate any reasonable teletext character into ucs2
-uint16_t telx_to_ucs2(uint8_t c)
+uint16_t telx_to_ucs2(struct TeletextCtx *ctx, uint8_t c)
 {
 	if (PARITY_8[c] == 0)
 	{
@@ -484,7 +457,7 @@ uint16_t telx_to_ucs2(uint8_t c)
 
 	uint16_t r = c & 0x7f;
 	if (r >= 0x20)
-		r = G0[default_g0_charset][r - 0x20];
+		r = ctx->G0[ctx->default_g0_charset][r - 0x20];
 	return r;
 }
 
@@ -577,7 +550,8 @@ int fuzzy_memcmp(const char *c1, const char *c2, const uint64_t *ucs2_buf1, unsi
 		max = tlt_config.levdistmincnt;
 
 	// For the second string, only take the first chars (up to the first string length, that's upto).
-	l = (size_t)levenshtein_dist(ucs2_buf1, ucs2_buf2, ucs2_buf1_len, upto);
+	// Past max the exact distance doesn't matter, so let the comparison give up early.
+	l = (size_t)levenshtein_dist_bounded(ucs2_buf1, ucs2_buf2, ucs2_buf1_len, upto, max);
 	int res = (l > max);
 	dbg_print(CCX_DMT_LEVENSHTEIN, "\rLEV | %s | %s | Max: %d | Calc: %d | Match: %d\n", c1, c2, max, l, !res);
 	return res;
@@ -938,6 +912,27 @@ static int is_multi_page_mode(void)
 	return (tlt_config.extract_all_pages || tlt_config.num_user_pages > 1);
 }
 
+// Output the page pending in a magazine, hiding it at hide_timestamp
+static void telx_flush_magazine(struct TeletextCtx *ctx, teletext_magazine_t *mag, uint64_t hide_timestamp, struct cc_subtitle *sub)
+{
+	// Convert telx to UCS-2 before processing
+	for (uint8_t yt = 1; yt <= 23; ++yt)
+	{
+		for (uint8_t it = 0; it < 40; it++)
+		{
+			if (mag->page_buffer.text[yt][it] != 0x00 && mag->page_buffer.g2_char_present[yt][it] == 0)
+				mag->page_buffer.text[yt][it] = telx_to_ucs2(ctx, mag->page_buffer.text[yt][it]);
+		}
+	}
+	mag->page_buffer.hide_timestamp = hide_timestamp;
+
+	// process_page() labels its output with tlt_config.page, which must be the page of this magazine
+	if (is_multi_page_mode() && mag->page_number != 0)
+		tlt_config.page = mag->page_number;
+	process_page(ctx, &mag->page_buffer, sub);
+	mag->page_buffer.tainted = NO;
+}
+
 void process_telx_packet(struct TeletextCtx *ctx, data_unit_t data_unit_id, teletext_packet_payload_t *packet, uint64_t timestamp, struct cc_subtitle *sub)
 {
 	// variable names conform to ETS 300 706, chapter 7.1.2
@@ -948,12 +943,18 @@ void process_telx_packet(struct TeletextCtx *ctx, data_unit_t data_unit_id, tele
 		m = 8;
 	y = (address >> 3) & 0x1f;
 	designation_code = (y > 25) ? unham_8_4(packet->data[0]) : 0x00;
+	teletext_magazine_t *mag = &ctx->magazines[m - 1];
 	if (y == 0)
 	{
+		// ETS 300 706, chapter 9.3.1: page address and control bits, each Hamming 8/4 byte decoded once
+		uint8_t page_units = unham_8_4(packet->data[0]);
+		uint8_t page_tens = unham_8_4(packet->data[1]);
+		uint8_t control_c4_c6 = unham_8_4(packet->data[5]);
+		uint8_t control_c11_c14 = unham_8_4(packet->data[7]);
 
 		// CC map
-		uint8_t i = (unham_8_4(packet->data[1]) << 4) | unham_8_4(packet->data[0]);
-		uint8_t flag_subtitle = (unham_8_4(packet->data[5]) & 0x08) >> 3;
+		uint8_t i = (page_tens << 4) | page_units;
+		uint8_t flag_subtitle = (control_c4_c6 & 0x08) >> 3;
 		uint16_t page_number;
 		uint8_t charset;
 		uint8_t c;
@@ -961,7 +962,7 @@ void process_telx_packet(struct TeletextCtx *ctx, data_unit_t data_unit_id, tele
 
 		if ((flag_subtitle == YES) && (i < 0xff))
 		{
-			int thisp = (m << 8) | (unham_8_4(packet->data[1]) << 4) | unham_8_4(packet->data[0]);
+			int thisp = (m << 8) | i;
 			char t1[10];
 			snprintf(t1, sizeof(t1), "%x", thisp); // Example: 1928 -> 788
 			thisp = atoi(t1);
@@ -978,13 +979,13 @@ void process_telx_packet(struct TeletextCtx *ctx, data_unit_t data_unit_id, tele
 		// Auto-detect page if none specified (and not in extract_all mode)
 		if ((tlt_config.page == 0) && !tlt_config.extract_all_pages && (tlt_config.num_user_pages == 0) && (flag_subtitle == YES) && (i < 0xff))
 		{
-			tlt_config.page = (m << 8) | (unham_8_4(packet->data[1]) << 4) | unham_8_4(packet->data[0]);
+			tlt_config.page = (m << 8) | i;
 			mprint("- No teletext page specified, first received suitable page is %03x, not guaranteed\n", tlt_config.page);
 		}
 
 		// Page number and control bits
-		page_number = (m << 8) | (unham_8_4(packet->data[1]) << 4) | unham_8_4(packet->data[0]);
-		charset = ((unham_8_4(packet->data[7]) & 0x08) | (unham_8_4(packet->data[7]) & 0x04) | (unham_8_4(packet->data[7]) & 0x02)) >> 1;
+		page_number = (m << 8) | i;
+		charset = (control_c11_c14 & 0x0e) >> 1;
 		// uint8_t flag_suppress_header = unham_8_4(packet->data[6]) & 0x01;
 		// uint8_t flag_inhibit_display = (unham_8_4(packet->data[6]) & 0x08) >> 3;
 
@@ -996,33 +997,55 @@ void process_telx_packet(struct TeletextCtx *ctx, data_unit_t data_unit_id, tele
 		// The same setting shall be used for all page headers in the service.
 		// ETS 300 706, chapter 7.2.1: Page is terminated by and excludes the next page header packet
 		// having the same magazine address in parallel transmission mode, or any magazine address in serial transmission mode.
-		ctx->transmission_mode = (transmission_mode_t)(unham_8_4(packet->data[7]) & 0x01);
+		ctx->transmission_mode = (transmission_mode_t)(control_c11_c14 & 0x01);
 
 		// FIXME: Well, this is not ETS 300 706 kosher, however we are interested in DATA_UNIT_EBU_TELETEXT_SUBTITLE only
-		if ((ctx->transmission_mode == TRANSMISSION_MODE_PARALLEL) && (data_unit_id != DATA_UNIT_EBU_TELETEXT_SUBTITLE) && !(de_ctr && flag_subtitle && ctx->receiving_data == YES))
+		if ((ctx->transmission_mode == TRANSMISSION_MODE_PARALLEL) && (data_unit_id != DATA_UNIT_EBU_TELETEXT_SUBTITLE) && !(ctx->de_ctr && flag_subtitle && mag->receiving_data == YES))
 			return;
 
 		// Check if this page should be accepted for extraction (issue #665)
 		int accept_this_page = should_accept_page(page_number, flag_subtitle);
 
-		// Handle page transition - if we were receiving a different page, stop
-		if ((ctx->receiving_data == YES) && (((ctx->transmission_mode == TRANSMISSION_MODE_SERIAL) && (PAGE(page_number) != PAGE(tlt_config.page))) ||
-						     ((ctx->transmission_mode == TRANSMISSION_MODE_PARALLEL) && (PAGE(page_number) != PAGE(tlt_config.page)) && (m == MAGAZINE(tlt_config.page)))))
+		// Handle page transition - if we were receiving a different page, stop.
+		// In serial mode any header terminates the page of every magazine, in parallel mode only its own one.
+		int terminated = NO;
+		for (int j = 0; j < TELETEXT_MAGAZINES; j++)
 		{
-			ctx->receiving_data = NO;
-			if (!(de_ctr && flag_subtitle))
+			teletext_magazine_t *other = &ctx->magazines[j];
+			if ((other != mag) && (ctx->transmission_mode != TRANSMISSION_MODE_SERIAL))
+				continue;
+			if ((other->receiving_data == YES) && (PAGE(page_number) != PAGE(other->page_number)))
 			{
-				// In multi-page mode, check if this new page should be accepted
-				if (!accept_this_page)
-					return;
+				other->receiving_data = NO;
+				terminated = YES;
 			}
 		}
+		if (terminated && !(ctx->de_ctr && flag_subtitle))
+		{
+			// In multi-page mode, check if this new page should be accepted
+			if (!accept_this_page)
+				return;
+		}
 
 		// Page transmission is terminated, however now we are waiting for our new page
 		// Modified for multi-page support (issue #665)
-		if (!accept_this_page && !(de_ctr && flag_subtitle && ctx->receiving_data == YES))
+		if (!accept_this_page && !(ctx->de_ctr && flag_subtitle && mag->receiving_data == YES))
 			return;
 
+		// Now we have the begining of page transmission; if there is page_buffer pending in this
+		// magazine, or a terminated one in any other magazine, process it.
+		// It would be nice, if subtitle hides on previous video frame, so we contract 40 ms (1 frame @25 fps)
+		uint64_t hide_timestamp = (timestamp >= 40) ? timestamp - 40 : 0;
+		for (int j = 0; j < TELETEXT_MAGAZINES; j++)
+		{
+			teletext_magazine_t *pending = &ctx->magazines[j];
+			if ((pending->page_buffer.tainted == YES) && ((pending == mag) || (pending->receiving_data == NO)))
+			{
+				telx_flush_magazine(ctx, pending, hide_timestamp, sub);
+				ctx->de_ctr = 0;
+			}
+		}
+
 		// Update tlt_config.page to track the current page being received (multi-page mode only)
 		// In single-page mode, tlt_config.page is set by auto-detect logic or user specification
 		// This prevents overwriting auto-detect selection with an arbitrary page number
@@ -1030,51 +1053,31 @@ void process_telx_packet(struct TeletextCtx *ctx, data_unit_t data_unit_id, tele
 		{
 			tlt_config.page = page_number;
 		}
-
-		// Now we have the begining of page transmission; if there is page_buffer pending, process it
-		if (ctx->page_buffer.tainted == YES)
+		if (accept_this_page)
+			mag->page_number = page_number;
+
+		mag->page_buffer.show_timestamp = timestamp;
+		mag->page_buffer.hide_timestamp = 0;
+		memset(mag->page_buffer.text, 0x00, sizeof(mag->page_buffer.text));
+		memset(mag->page_buffer.g2_char_present, 0x00, sizeof(mag->page_buffer.g2_char_present));
+		mag->page_buffer.tainted = NO;
+		mag->receiving_data = YES;
+		if (ctx->default_g0_charset == LATIN) // G0 Character National Option Sub-sets selection required only for Latin Character Sets
 		{
-			// Convert telx to UCS-2 before processing
-			for (uint8_t yt = 1; yt <= 23; ++yt)
-			{
-				for (uint8_t it = 0; it < 40; it++)
-				{
-					if (ctx->page_buffer.text[yt][it] != 0x00 && ctx->page_buffer.g2_char_present[yt][it] == 0)
-						ctx->page_buffer.text[yt][it] = telx_to_ucs2(ctx->page_buffer.text[yt][it]);
-				}
-			}
-			// it would be nice, if subtitle hides on previous video frame, so we contract 40 ms (1 frame @25 fps)
-			ctx->page_buffer.hide_timestamp = timestamp - 40;
-			if (ctx->page_buffer.hide_timestamp > timestamp)
-			{
-				ctx->page_buffer.hide_timestamp = 0;
-			}
-			process_page(ctx, &ctx->page_buffer, sub);
-			de_ctr = 0;
-		}
-
-		ctx->page_buffer.show_timestamp = timestamp;
-		ctx->page_buffer.hide_timestamp = 0;
-		memset(ctx->page_buffer.text, 0x00, sizeof(ctx->page_buffer.text));
-		memset(ctx->page_buffer.g2_char_present, 0x00, sizeof(ctx->page_buffer.g2_char_present));
-		ctx->page_buffer.tainted = NO;
-		ctx->receiving_data = YES;
-		if (default_g0_charset == LATIN) // G0 Character National Option Sub-sets selection required only for Latin Character Sets
-		{
-			primary_charset.g0_x28 = UNDEFINED;
-			c = (primary_charset.g0_m29 != UNDEFINED) ? primary_charset.g0_m29 : charset;
-			remap_g0_charset(c);
+			ctx->primary_charset.g0_x28 = UNDEFINED;
+			c = (ctx->primary_charset.g0_m29 != UNDEFINED) ? ctx->primary_charset.g0_m29 : charset;
+			remap_g0_charset(ctx, c);
 		}
 		/*
 		// I know -- not needed; in subtitles we will never need disturbing teletext page status bar
 		// displaying tv station name, current time etc.
 		if (flag_suppress_header == NO) {
-			for (uint8_t i = 14; i < 40; i++) page_buffer.text[y][i] = telx_to_ucs2(packet->data[i]);
+			for (uint8_t i = 14; i < 40; i++) page_buffer.text[y][i] = telx_to_ucs2(ctx, packet->data[i]);
 			//page_buffer.tainted = YES;
 		}
 		*/
 	}
-	else if ((m == MAGAZINE(tlt_config.page)) && (y >= 1) && (y <= 23) && (ctx->receiving_data == YES))
+	else if ((y >= 1) && (y <= 23) && (mag->receiving_data == YES))
 	{
 		// ETS 300 706, chapter 9.4.1: Packets X/26 at presentation Levels 1.5, 2.5, 3.5 are used for addressing
 		// a character location and overwriting the existing character defined on the Level 1 page
@@ -1083,13 +1086,13 @@ void process_telx_packet(struct TeletextCtx *ctx, data_unit_t data_unit_id, tele
 		// in frame number 26, skip original G0 character
 		for (uint8_t i = 0; i < 40; i++)
 		{
-			if (ctx->page_buffer.text[y][i] == 0x00)
-				ctx->page_buffer.text[y][i] = packet->data[i];
+			if (mag->page_buffer.text[y][i] == 0x00)
+				mag->page_buffer.text[y][i] = packet->data[i];
 		}
-		ctx->page_buffer.tainted = YES;
-		--de_ctr;
+		mag->page_buffer.tainted = YES;
+		--ctx->de_ctr;
 	}
-	else if ((m == MAGAZINE(tlt_config.page)) && (y == 26) && (ctx->receiving_data == YES))
+	else if ((y == 26) && (mag->receiving_data == YES))
 	{
 		// ETS 300 706, chapter 12.3.2: X/26 definition
 		uint8_t x26_row = 0;
@@ -1136,8 +1139,8 @@ void process_telx_packet(struct TeletextCtx *ctx, data_unit_t data_unit_id, tele
 				x26_col = address;
 				if (data > 31)
 				{
-					ctx->page_buffer.text[x26_row][x26_col] = G2[0][data - 0x20];
-					ctx->page_buffer.g2_char_present[x26_row][x26_col] = 1;
+					mag->page_buffer.text[x26_row][x26_col] = G2[0][data - 0x20];
+					mag->page_buffer.g2_char_present[x26_row][x26_col] = 1;
 				}
 			}
 
@@ -1147,8 +1150,8 @@ void process_telx_packet(struct TeletextCtx *ctx, data_unit_t data_unit_id, tele
 				x26_col = address;
 				if (data == 64) // check for @ symbol
 				{
-					remap_g0_charset(0);
-					ctx->page_buffer.text[x26_row][x26_col] = 0x40;
+					remap_g0_charset(ctx, 0);
+					mag->page_buffer.text[x26_row][x26_col] = 0x40;
 				}
 			}
 
@@ -1159,19 +1162,19 @@ void process_telx_packet(struct TeletextCtx *ctx, data_unit_t data_unit_id, tele
 
 				// A - Z
 				if ((data >= 65) && (data <= 90))
-					ctx->page_buffer.text[x26_row][x26_col] = G2_ACCENTS[mode - 0x11][data - 65];
+					mag->page_buffer.text[x26_row][x26_col] = G2_ACCENTS[mode - 0x11][data - 65];
 				// a - z
 				else if ((data >= 97) && (data <= 122))
-					ctx->page_buffer.text[x26_row][x26_col] = G2_ACCENTS[mode - 0x11][data - 71];
+					mag->page_buffer.text[x26_row][x26_col] = G2_ACCENTS[mode - 0x11][data - 71];
 				// other
 				else
-					ctx->page_buffer.text[x26_row][x26_col] = telx_to_ucs2(data);
+					mag->page_buffer.text[x26_row][x26_col] = telx_to_ucs2(ctx, data);
 
-				ctx->page_buffer.g2_char_present[x26_row][x26_col] = 1;
+				mag->page_buffer.g2_char_present[x26_row][x26_col] = 1;
 			}
 		}
 	}
-	else if ((m == MAGAZINE(tlt_config.page)) && (y == 28) && (ctx->receiving_data == YES))
+	else if ((y == 28) && (mag->receiving_data == YES))
 	{
 		// TODO:
 		//   ETS 300 706, chapter 9.4.7: Packet X/28/4
@@ -1193,17 +1196,17 @@ void process_telx_packet(struct TeletextCtx *ctx, data_unit_t data_unit_id, tele
 				if ((triplet0 & 0x0f) == 0x00)
 				{
 					// ETS 300 706, Table 32
-					set_g0_charset(triplet0); // Deciding G0 Character Set
-					if (default_g0_charset == LATIN)
+					set_g0_charset(ctx, triplet0); // Deciding G0 Character Set
+					if (ctx->default_g0_charset == LATIN)
 					{
-						primary_charset.g0_x28 = (triplet0 & 0x3f80) >> 7;
-						remap_g0_charset(primary_charset.g0_x28);
+						ctx->primary_charset.g0_x28 = (triplet0 & 0x3f80) >> 7;
+						remap_g0_charset(ctx, ctx->primary_charset.g0_x28);
 					}
 				}
 			}
 		}
 	}
-	else if ((m == MAGAZINE(tlt_config.page)) && (y == 29))
+	else if (((m == MAGAZINE(tlt_config.page)) || (mag->page_number != 0)) && (y == 29))
 	{
 		// TODO:
 		//   ETS 300 706, chapter 9.5.1 Packet M/29/0
@@ -1225,14 +1228,14 @@ void process_telx_packet(struct TeletextCtx *ctx, data_unit_t data_unit_id, tele
 				// ETS 300 706, table 13: Coding of Packet M/29/4
 				if ((triplet0 & 0xff) == 0x00)
 				{
-					set_g0_charset(triplet0);
-					if (default_g0_charset == LATIN)
+					set_g0_charset(ctx, triplet0);
+					if (ctx->default_g0_charset == LATIN)
 					{
-						primary_charset.g0_m29 = (triplet0 & 0x3f80) >> 7;
+						ctx->primary_charset.g0_m29 = (triplet0 & 0x3f80) >> 7;
 						// X/28 takes precedence over M/29
-						if (primary_charset.g0_x28 == UNDEFINED)
+						if (ctx->primary_charset.g0_x28 == UNDEFINED)
 						{
-							remap_g0_charset(primary_charset.g0_m29);
+							remap_g0_charset(ctx, ctx->primary_charset.g0_m29);
 						}
 					}
 				}
@@ -1253,7 +1256,7 @@ void process_telx_packet(struct TeletextCtx *ctx, data_unit_t data_unit_id, tele
 				for (uint8_t i = 20; i < 40; i++)
 				{
 					char u[4] = {0, 0, 0, 0};
-					uint8_t c = telx_to_ucs2(packet->data[i]);
+					uint8_t c = telx_to_ucs2(ctx, packet->data[i]);
 					// strip any control codes from PID, eg. TVP station
 					if (c < 0x20)
 						continue;
@@ -1518,9 +1521,9 @@ int tlt_process_pes_packet(struct lib_cc_decode *dec_ctx, uint8_t *buffer, uint1
 		{
 			// printf("# Associated PTS: %d \n", pts);
 			printf("# Associated PTS: %" PRId64 " # ", pts);
-			printf("Diff: %" PRIu64 "\n", pts - last_pes_pts);
-			// printf("Diff: %d # ", pts - last_pes_pts);
-			last_pes_pts = pts;
+			printf("Diff: %" PRIu64 "\n", pts - ctx->last_pes_pts);
+			// printf("Diff: %d # ", pts - ctx->last_pes_pts);
+			ctx->last_pes_pts = pts;
 		}
 	}
 
@@ -1564,9 +1567,13 @@ int tlt_process_pes_packet(struct lib_cc_decode *dec_ctx, uint8_t *buffer, uint1
 			// teletext payload has always size 44 bytes
 			if (data_unit_len == 44)
 			{
-				// reverse endianess (via lookup table), ETS 300 706, chapter 7.1
+				// reverse endianess, ETS 300 706, chapter 7.1
+#ifndef DISABLE_RUST
+				ccxr_reverse_bytes(&buffer[i], data_unit_len);
+#else
 				for (uint8_t j = 0; j < data_unit_len; j++)
 					buffer[i + j] = REVERSE_8[buffer[i + j]];
+#endif
 
 				if (tlt_config.write_format == CCX_OF_RCWT)
 					tlt_write_rcwt(dec_ctx, data_unit_id, &buffer[i], ctx->last_timestamp, sub);
@@ -1612,12 +1619,11 @@ void *telxcc_init(void)
 
 	// Buffer timestamp
 	ctx->last_timestamp = 0;
-	memset(&ctx->page_buffer, 0, sizeof(teletext_page_t));
+	memset(ctx->magazines, 0, sizeof(ctx->magazines));
 	ctx->states.programme_info_processed = NO;
 	ctx->states.pts_initialized = NO;
 	ctx->tlt_packet_counter = 0;
 	ctx->transmission_mode = TRANSMISSION_MODE_SERIAL;
-	ctx->receiving_data = NO;
 
 	ctx->using_pts = UNDEFINED;
 	ctx->delta = 0;
@@ -1627,6 +1633,12 @@ void *telxcc_init(void)
 	ctx->new_sentence = 0;
 	ctx->splitbysentence = 0;
 
+	memcpy(ctx->G0, G0, sizeof(ctx->G0));
+	ctx->default_g0_charset = LATIN;
+	ctx->primary_charset.current = 0x00;
+	ctx->primary_charset.g0_m29 = UNDEFINED;
+	ctx->primary_charset.g0_x28 = UNDEFINED;
+
 	return ctx;
 }
 
@@ -1653,20 +1665,11 @@ void telxcc_close(void **ctx, struct cc_subtitle *sub)
 	if (tlt_config.write_format != CCX_OF_RCWT && sub)
 	{
 		// output any pending close caption
-		if (ttext->page_buffer.tainted == YES)
+		for (int j = 0; j < TELETEXT_MAGAZINES; j++)
 		{
-			// Convert telx to UCS-2 before processing
-			for (uint8_t yt = 1; yt <= 23; ++yt)
-			{
-				for (uint8_t it = 0; it < 40; it++)
-				{
-					if (ttext->page_buffer.text[yt][it] != 0x00 && ttext->page_buffer.g2_char_present[yt][it] == 0)
-						ttext->page_buffer.text[yt][it] = telx_to_ucs2(ttext->page_buffer.text[yt][it]);
-				}
-			}
 			// this time we do not subtract any frames, there will be no more frames
-			ttext->page_buffer.hide_timestamp = ttext->last_timestamp;
-			process_page(ttext, &ttext->page_buffer, sub);
+			if (ttext->magazines[j].page_buffer.tainted == YES)
+				telx_flush_magazine(ttext, &ttext->magazines[j], ttext->last_timestamp, sub);
 		}
 
 		telxcc_dump_prev_page(ttext, sub);
@@ -15,17 +15,33 @@
 
 #define RAI_MASK 0x40 // byte mask to check if RAI bit is set (random access indicator)
 
-unsigned char tspacket[188]; // Current packet
-
 // struct ts_payload payload;
 
-static unsigned char *haup_capbuf = NULL;
-static long haup_capbufsize = 0;
-static long haup_capbuflen = 0; // Bytes read in haup_capbuf
-uint64_t last_pts = 0;		// PTS of last PES packet (debug purposes)
-
-// Descriptions for ts ccx_stream_type
-const char *desc[256];
+// Descriptions for ts ccx_stream_type, constant so that demuxers can share them
+const char *desc[256] = {
+    [CCX_STREAM_TYPE_UNKNOWNSTREAM] = "Unknown",
+    [CCX_STREAM_TYPE_VIDEO_MPEG1] = "MPEG-1 video",
+    [CCX_STREAM_TYPE_VIDEO_MPEG2] = "MPEG-2 video",
+    [CCX_STREAM_TYPE_AUDIO_MPEG1] = "MPEG-1 audio",
+    [CCX_STREAM_TYPE_AUDIO_MPEG2] = "MPEG-2 audio",
+    [CCX_STREAM_TYPE_MHEG_PACKETS] = "MHEG Packets",
+    [CCX_STREAM_TYPE_PRIVATE_TABLE_MPEG2] = "MPEG-2 private table sections",
+    [CCX_STREAM_TYPE_PRIVATE_MPEG2] = "MPEG-2 private data",
+    [CCX_STREAM_TYPE_MPEG2_ANNEX_A_DSM_CC] = "MPEG-2 Annex A DSM CC",
+    [CCX_STREAM_TYPE_ITU_T_H222_1] = "ITU-T Rec. H.222.1",
+    [CCX_STREAM_TYPE_AUDIO_AAC] = "AAC audio",
+    [CCX_STREAM_TYPE_VIDEO_MPEG4] = "MPEG-4 video",
+    [CCX_STREAM_TYPE_VIDEO_H264] = "H.264 video",
+    [CCX_STREAM_TYPE_VIDEO_HEVC] = "HEVC video",
+    [CCX_STREAM_TYPE_PRIVATE_USER_MPEG2] = "MPEG-2 User Private",
+    [CCX_STREAM_TYPE_AUDIO_AC3] = "AC3 audio",
+    [CCX_STREAM_TYPE_AUDIO_DTS] = "DTS audio",
+    [CCX_STREAM_TYPE_AUDIO_HDMV_DTS] = "HDMV audio",
+    [CCX_STREAM_TYPE_ISO_IEC_13818_6_TYPE_A] = "ISO/IEC 13818-6 type A",
+    [CCX_STREAM_TYPE_ISO_IEC_13818_6_TYPE_B] = "ISO/IEC 13818-6 type B",
+    [CCX_STREAM_TYPE_ISO_IEC_13818_6_TYPE_C] = "ISO/IEC 13818-6 type C",
+    [CCX_STREAM_TYPE_ISO_IEC_13818_6_TYPE_D] = "ISO/IEC 13818-6 type D",
+};
 
 char *get_buffer_type_str(struct cap_info *cinfo)
 {
@@ -66,7 +82,7 @@ char *get_buffer_type_str(struct cap_info *cinfo)
 		return NULL;
 	}
 }
-void pes_header_dump(uint8_t *buffer, long len)
+void pes_header_dump(struct ccx_demuxer *ctx, uint8_t *buffer, long len)
 {
 	// Write the PES Header to console
 	uint64_t pes_prefix;
@@ -119,9 +135,9 @@ void pes_header_dump(uint8_t *buffer, long len)
 		pts |= ((buffer[13] & 0xfe) >> 1);
 		// printf("# Associated PTS: %d \n", pts);
 		printf("# Associated PTS: %" PRId64 " # ", pts);
-		printf("Diff: %" PRIu64 "\n", pts - last_pts);
+		printf("Diff: %" PRIu64 "\n", pts - ctx->last_pes_header_pts);
 		// printf("Diff: %d # ", pts - last_pts);
-		last_pts = pts;
+		ctx->last_pes_header_pts = pts;
 	}
 }
 enum ccx_bufferdata_type get_buffer_type(struct cap_info *cinfo)
@@ -166,32 +182,6 @@ enum ccx_bufferdata_type get_buffer_type(struct cap_info *cinfo)
 		return CCX_EINVAL;
 	}
 }
-void init_ts(struct ccx_demuxer *ctx)
-{
-	// Constants
-	desc[CCX_STREAM_TYPE_UNKNOWNSTREAM] = "Unknown";
-	desc[CCX_STREAM_TYPE_VIDEO_MPEG1] = "MPEG-1 video";
-	desc[CCX_STREAM_TYPE_VIDEO_MPEG2] = "MPEG-2 video";
-	desc[CCX_STREAM_TYPE_AUDIO_MPEG1] = "MPEG-1 audio";
-	desc[CCX_STREAM_TYPE_AUDIO_MPEG2] = "MPEG-2 audio";
-	desc[CCX_STREAM_TYPE_MHEG_PACKETS] = "MHEG Packets";
-	desc[CCX_STREAM_TYPE_PRIVATE_TABLE_MPEG2] = "MPEG-2 private table sections";
-	desc[CCX_STREAM_TYPE_PRIVATE_MPEG2] = "MPEG-2 private data";
-	desc[CCX_STREAM_TYPE_MPEG2_ANNEX_A_DSM_CC] = "MPEG-2 Annex A DSM CC";
-	desc[CCX_STREAM_TYPE_ITU_T_H222_1] = "ITU-T Rec. H.222.1";
-	desc[CCX_STREAM_TYPE_AUDIO_AAC] = "AAC audio";
-	desc[CCX_STREAM_TYPE_VIDEO_MPEG4] = "MPEG-4 video";
-	desc[CCX_STREAM_TYPE_VIDEO_H264] = "H.264 video";
-	desc[CCX_STREAM_TYPE_VIDEO_HEVC] = "HEVC video";
-	desc[CCX_STREAM_TYPE_PRIVATE_USER_MPEG2] = "MPEG-2 User Private";
-	desc[CCX_STREAM_TYPE_AUDIO_AC3] = "AC3 audio";
-	desc[CCX_STREAM_TYPE_AUDIO_DTS] = "DTS audio";
-	desc[CCX_STREAM_TYPE_AUDIO_HDMV_DTS] = "HDMV audio";
-	desc[CCX_STREAM_TYPE_ISO_IEC_13818_6_TYPE_A] = "ISO/IEC 13818-6 type A";
-	desc[CCX_STREAM_TYPE_ISO_IEC_13818_6_TYPE_B] = "ISO/IEC 13818-6 type B";
-	desc[CCX_STREAM_TYPE_ISO_IEC_13818_6_TYPE_C] = "ISO/IEC 13818-6 type C";
-	desc[CCX_STREAM_TYPE_ISO_IEC_13818_6_TYPE_D] = "ISO/IEC 13818-6 type D";
-}
 
 // Return 1 for successfully read ts packet
 int ts_readpacket(struct ccx_demuxer *ctx, struct ts_payload *payload)
@@ -199,6 +189,21 @@ int ts_readpacket(struct ccx_demuxer *ctx, struct ts_payload *payload)
 	unsigned int adaptation_field_length = 0;
 	unsigned int adaptation_field_control;
 	long long result;
+	if (ctx->push_input)
+	{
+		// Pushed input has no file to read more from: skip to the next sync byte
+		// and leave a partial packet for the next chunk
+		unsigned int packet_size = ctx->m2ts ? 192 : 188;
+		unsigned int sync_offset = ctx->m2ts ? 4 : 0;
+		while (ctx->bytesinbuffer - ctx->filebuffer_pos >= packet_size &&
+		       ctx->filebuffer[ctx->filebuffer_pos + sync_offset] != 0x47)
+		{
+			ctx->filebuffer_pos++;
+			ctx->past++;
+		}
+		if (ctx->bytesinbuffer - ctx->filebuffer_pos < packet_size)
+			return CCX_EAGAIN;
+	}
 	if (ctx->m2ts)
 	{
 		/* M2TS just adds 4 bytes to each packet (so size goes from 188 to 192)
@@ -218,7 +223,7 @@ int ts_readpacket(struct ccx_demuxer *ctx, struct ts_payload *payload)
 		}
 	}
 
-	result = buffered_read(ctx, tspacket, 188);
+	result = buffered_read(ctx, ctx->tspacket, 188);
 	ctx->past += result;
 	if (result != 188)
 	{
@@ -228,30 +233,30 @@ int ts_readpacket(struct ccx_demuxer *ctx, struct ts_payload *payload)
 	}
 
 	int printtsprob = 1;
-	while (tspacket[0] != 0x47)
+	while (ctx->tspacket[0] != 0x47)
 	{
 		if (printtsprob)
 		{
 			dbg_print(CCX_DMT_DUMPDEF, "\nProblem: No TS header mark (filepos=%lld). Received bytes:\n", ctx->past);
-			dump(CCX_DMT_DUMPDEF, tspacket, 4, 0, 0);
+			dump(CCX_DMT_DUMPDEF, ctx->tspacket, 4, 0, 0);
 
 			dbg_print(CCX_DMT_DUMPDEF, "Skip forward to the next TS header mark.\n");
 			printtsprob = 0;
 		}
 
 		unsigned char *tstemp;
-		// The amount of bytes read into tspacket
+		// The amount of bytes read into the packet
 		int tslen = 188;
 
-		// Check for 0x47 in the remaining bytes of tspacket
-		tstemp = (unsigned char *)memchr(tspacket + 1, 0x47, tslen - 1);
+		// Check for 0x47 in the remaining bytes of the packet
+		tstemp = (unsigned char *)memchr(ctx->tspacket + 1, 0x47, tslen - 1);
 		if (tstemp != NULL)
 		{
 			// Found it
-			int atpos = tstemp - tspacket;
+			int atpos = tstemp - ctx->tspacket;
 
-			memmove(tspacket, tstemp, (size_t)(tslen - atpos));
-			result = buffered_read(ctx, tspacket + (tslen - atpos), atpos);
+			memmove(ctx->tspacket, tstemp, (size_t)(tslen - atpos));
+			result = buffered_read(ctx, ctx->tspacket + (tslen - atpos), atpos);
 			ctx->past += result;
 			if (result != atpos)
 			{
@@ -262,7 +267,7 @@ int ts_readpacket(struct ccx_demuxer *ctx, struct ts_payload *payload)
 		else
 		{
 			// Read the next 188 bytes.
-			result = buffered_read(ctx, tspacket, tslen);
+			result = buffered_read(ctx, ctx->tspacket, tslen);
 			ctx->past += result;
 			if (result != tslen)
 			{
@@ -283,47 +288,47 @@ int ts_readpacket(struct ccx_demuxer *ctx, struct ts_payload *payload)
 	savepacket = fopen(spfn, "ab");
 	if (savepacket)
 	{
-		fwrite(tspacket, 188, 1, savepacket);
+		fwrite(ctx->tspacket, 188, 1, savepacket);
 		fclose(savepacket);
 	}
 #endif
 
-	payload->transport_error = (tspacket[1] & 0x80) >> 7;
-	payload->pesstart = (tspacket[1] & 0x40) >> 6;
+	payload->transport_error = (ctx->tspacket[1] & 0x80) >> 7;
+	payload->pesstart = (ctx->tspacket[1] & 0x40) >> 6;
 	// unsigned transport_priority = (tspacket[1]&0x20)>>5;
-	payload->pid = (((tspacket[1] & 0x1F) << 8) | tspacket[2]) & 0x1FFF;
+	payload->pid = (((ctx->tspacket[1] & 0x1F) << 8) | ctx->tspacket[2]) & 0x1FFF;
 	// unsigned transport_scrambling_control = (tspacket[3]&0xC0)>>6;
-	adaptation_field_control = (tspacket[3] & 0x30) >> 4;
-	payload->counter = tspacket[3] & 0xF;
+	adaptation_field_control = (ctx->tspacket[3] & 0x30) >> 4;
+	payload->counter = ctx->tspacket[3] & 0xF;
 
 	if (payload->transport_error)
 	{
 		dbg_print(CCX_DMT_DUMPDEF, "Warning: Defective (error indicator on) TS packet (filepos=%lld):\n", ctx->past);
-		dump(CCX_DMT_DUMPDEF, tspacket, 188, 0, 0);
+		dump(CCX_DMT_DUMPDEF, ctx->tspacket, 188, 0, 0);
 	}
 
-	payload->start = tspacket + 4;
+	payload->start = ctx->tspacket + 4;
 	payload->length = 188 - 4;
 	if (adaptation_field_control & 2)
 	{
 		// Take the PCR (Program Clock Reference) from here, in case PTS is not available (copied from telxcc).
-		adaptation_field_length = tspacket[4];
+		adaptation_field_length = ctx->tspacket[4];
 
-		payload->have_pcr = (tspacket[5] & 0x10) >> 4;
+		payload->have_pcr = (ctx->tspacket[5] & 0x10) >> 4;
 		if (payload->have_pcr)
 		{
 			payload->pcr = 0;
-			payload->pcr |= (tspacket[6] << 25);
-			payload->pcr |= (tspacket[7] << 17);
-			payload->pcr |= (tspacket[8] << 9);
-			payload->pcr |= (tspacket[9] << 1);
-			payload->pcr |= (tspacket[10] >> 7);
+			payload->pcr |= (ctx->tspacket[6] << 25);
+			payload->pcr |= (ctx->tspacket[7] << 17);
+			payload->pcr |= (ctx->tspacket[8] << 9);
+			payload->pcr |= (ctx->tspacket[9] << 1);
+			payload->pcr |= (ctx->tspacket[10] >> 7);
 			/* Ignore 27 Mhz clock since we dont deal in nanoseconds*/
 			// payload->pcr = ((tspacket[10] & 0x01) << 8);
 			// payload->pcr |= tspacket[11];
 		}
 
-		payload->has_random_access_indicator = (tspacket[5] & RAI_MASK) != 0;
+		payload->has_random_access_indicator = (ctx->tspacket[5] & RAI_MASK) != 0;
 
 		// Catch bad packages with adaptation_field_length > 184 and
 		// the unsigned nature of payload_length leading to huge numbers.
@@ -583,7 +588,7 @@ int copy_capbuf_demux_data(struct ccx_demuxer *ctx, struct demuxer_data **data,
 	vpesdatalen = read_video_pes_header(ctx, ptr, cinfo->capbuf, &pesheaderlen, cinfo->capbuflen);
 	if (ccx_options.pes_header_to_stdout && cinfo->codec == CCX_CODEC_DVB) // for teletext we have its own header dump
 	{
-		pes_header_dump(cinfo->capbuf, pesheaderlen);
+		pes_header_dump(ctx, cinfo->capbuf, pesheaderlen);
 	}
 	if (vpesdatalen < 0)
 	{
@@ -596,9 +601,9 @@ int copy_capbuf_demux_data(struct ccx_demuxer *ctx, struct demuxer_data **data,
 
 	if (ccx_options.hauppauge_mode)
 	{
-		if (haup_capbuflen % 12 != 0)
+		if (ctx->haup_capbuflen % 12 != 0)
 			mprint("Warning: Inconsistent Hauppage's buffer length\n");
-		if (!haup_capbuflen)
+		if (!ctx->haup_capbuflen)
 		{
 			// Do this so that we always return something until EOF. This will be skipped.
 			ptr->buffer[ptr->len++] = 0xFA;
@@ -606,10 +611,10 @@ int copy_capbuf_demux_data(struct ccx_demuxer *ctx, struct demuxer_data **data,
 			ptr->buffer[ptr->len++] = 0x80;
 		}
 
-		for (int i = 0; i < haup_capbuflen; i += 12)
+		for (int i = 0; i < ctx->haup_capbuflen; i += 12)
 		{
-			unsigned haup_stream_id = haup_capbuf[i + 3];
-			if (haup_stream_id == 0xbd && haup_capbuf[i + 4] == 0 && haup_capbuf[i + 5] == 6)
+			unsigned haup_stream_id = ctx->haup_capbuf[i + 3];
+			if (haup_stream_id == 0xbd && ctx->haup_capbuf[i + 4] == 0 && ctx->haup_capbuf[i + 5] == 6)
 			{
 				// Because I (CFS) don't have a lot of samples for this, for now I make sure everything is like the one I have:
 				// 12 bytes total length, stream id = 0xbd (Private non-video and non-audio), etc
@@ -620,14 +625,14 @@ int copy_capbuf_demux_data(struct ccx_demuxer *ctx, struct demuxer_data **data,
 					      "Please send bug report!",
 					      BUFSIZE - ptr->len);
 				}
-				if (haup_capbuf[i + 9] == 1 || haup_capbuf[i + 9] == 2) // Field match. // TODO: If extract==12 this won't work!
+				if (ctx->haup_capbuf[i + 9] == 1 || ctx->haup_capbuf[i + 9] == 2) // Field match. // TODO: If extract==12 this won't work!
 				{
-					if (haup_capbuf[i + 9] == 1)
+					if (ctx->haup_capbuf[i + 9] == 1)
 						ptr->buffer[ptr->len++] = 4; // Field 1 + cc_valid=1
 					else
 						ptr->buffer[ptr->len++] = 5; // Field 2 + cc_valid=1
-					ptr->buffer[ptr->len++] = haup_capbuf[i + 10];
-					ptr->buffer[ptr->len++] = haup_capbuf[i + 11];
+					ptr->buffer[ptr->len++] = ctx->haup_capbuf[i + 10];
+					ptr->buffer[ptr->len++] = ctx->haup_capbuf[i + 11];
 				}
 				/*
 				   if (inbuf>1024) // Just a way to send the bytes to the decoder from time to time, otherwise the buffer will fill up.
@@ -636,7 +641,7 @@ int copy_capbuf_demux_data(struct ccx_demuxer *ctx, struct demuxer_data **data,
 				   continue; */
 			}
 		}
-		haup_capbuflen = 0;
+		ctx->haup_capbuflen = 0;
 	}
 	databuf = cinfo->capbuf + pesheaderlen;
 	databuflen = cinfo->capbuflen - pesheaderlen;
@@ -763,7 +768,6 @@ int64_t ts_readstream(struct ccx_demuxer *ctx, struct demuxer_data **data)
 	struct cap_info *cinfo;
 	struct ts_payload payload;
 	int j;
-	static int no_pat_warning_shown = 0;
 
 	memset(&payload, 0, sizeof(payload));
 
@@ -801,9 +805,9 @@ int64_t ts_readstream(struct ccx_demuxer *ctx, struct demuxer_data **data)
 		}
 
 		if (ccx_options.xmltv >= 1 && payload.pid == 0x12) // This is DVB EIT
-			parse_EPG_packet(ctx->parent);
+			parse_EPG_packet(ctx->parent, ctx->tspacket);
 		if (ccx_options.xmltv >= 1 && payload.pid >= 0x1000) // This may be ATSC EPG packet
-			parse_EPG_packet(ctx->parent);
+			parse_EPG_packet(ctx->parent, ctx->tspacket);
 
 		for (j = 0; j < ctx->nb_program; j++)
 		{
@@ -847,11 +851,11 @@ int64_t ts_readstream(struct ccx_demuxer *ctx, struct demuxer_data **data)
 		if (ctx->nb_program == 0 && ctx->past > NO_PAT_THRESHOLD && !packet_analysis_mode)
 		{
 			packet_analysis_mode = 1;
-			if (!no_pat_warning_shown)
+			if (!ctx->warning_no_pat_shown)
 			{
 				mprint("\nNo PAT/PMT found after %lld bytes. Enabling packet analysis mode to detect video streams.\n",
 				       ctx->past);
-				no_pat_warning_shown = 1;
+				ctx->warning_no_pat_shown = 1;
 			}
 		}
 
@@ -926,20 +930,20 @@ int64_t ts_readstream(struct ccx_demuxer *ctx, struct demuxer_data **data)
 		{
 			// Haup packets processed separately, because we can't mix payloads. So they go in their own buffer
 			// copy payload to capbuf
-			int haup_newcapbuflen = haup_capbuflen + payload.length;
-			if (haup_newcapbuflen > haup_capbufsize)
+			int haup_newcapbuflen = ctx->haup_capbuflen + payload.length;
+			if (haup_newcapbuflen > ctx->haup_capbufsize)
 			{
-				unsigned char *new_haup_capbuf = (unsigned char *)realloc(haup_capbuf, haup_newcapbuflen);
+				unsigned char *new_haup_capbuf = (unsigned char *)realloc(ctx->haup_capbuf, haup_newcapbuflen);
 				if (!new_haup_capbuf)
 				{
-					free(haup_capbuf);
+					free(ctx->haup_capbuf);
 					fatal(EXIT_NOT_ENOUGH_MEMORY, "Not enough memory to store hauppauge packets");
 				}
-				haup_capbuf = new_haup_capbuf;
-				haup_capbufsize = haup_newcapbuflen;
+				ctx->haup_capbuf = new_haup_capbuf;
+				ctx->haup_capbufsize = haup_newcapbuflen;
 			}
-			memcpy(haup_capbuf + haup_capbuflen, payload.start, payload.length);
-			haup_capbuflen = haup_newcapbuflen;
+			memcpy(ctx->haup_capbuf + ctx->haup_capbuflen, payload.start, payload.length);
+			ctx->haup_capbuflen = haup_newcapbuflen;
 		}
 
 		// Skip packets with no payload.  This also fixes the problems
@@ -65,14 +65,36 @@ struct EPG_event
 	uint8_t *categories;
 	uint32_t num_categories;
 	uint16_t service_id;
+	uint64_t raw_start_time; // start time and duration as broadcast, to spot changed events
+	uint32_t raw_duration;
 	long long int count; // incremented by one each time the event is updated
 	uint8_t live_output; // boolean flag, true if this event has been output
 };
 
 #define EPG_MAX_EVENTS 60 * 24 * 7
+#define EPG_EVENT_INDEX_BITS 14 // 16384 slots, more than twice EPG_MAX_EVENTS
 struct EIT_program
 {
 	uint32_t array_len;
 	struct EPG_event epg_events[EPG_MAX_EVENTS];
+	// Hash index of epg_events by service and event id: index + 1, 0 for a free slot
+	uint16_t event_index[1 << EPG_EVENT_INDEX_BITS];
+};
+
+// Version and CRC of an EIT section the last time it was decoded
+struct EPG_section_version
+{
+	uint32_t key; // table_id << 24 | service_id << 8 | section_number, 0 for a free slot
+	uint8_t version;
+	uint32_t crc;
+};
+
+// EIT sections already decoded, so their continuous repetitions can be skipped
+struct EPG_section_cache
+{
+	struct EPG_section_version *entries;
+	uint32_t size; // Power of two
+	uint32_t count;
+	int nb_program; // Programs known when the sections were decoded, -1 to start over
 };
 #endif
@@ -5,7 +5,6 @@
 #include "utility.h"
 #include "activity.h"
 
-static unsigned pmt_warning_shown = 0; // Only display warning once
 void process_ccx_mpeg_descriptor(unsigned char *data, unsigned length);
 
 unsigned get_printable_stream_type(enum ccx_stream_type stream_type)
@@ -231,10 +230,10 @@ int parse_PMT(struct ccx_demuxer *ctx, unsigned char *buf, int len, struct progr
 	dbg_print(CCX_DMT_PMT, "  PCR_PID: %u  data length: %u  payload_length: %u\n",
 		  pinfo->pcr_pid, stream_data, len);
 
-	if (!pmt_warning_shown && stream_data + 4 > len)
+	if (!ctx->warning_incomplete_pmt_shown && stream_data + 4 > len) // Only display warning once
 	{
 		dbg_print(CCX_DMT_GENERIC_NOTICES, "\rWarning: Probably parsing incomplete PMT, expected data longer than available payload.\n");
-		pmt_warning_shown = 1;
+		ctx->warning_incomplete_pmt_shown = 1;
 	}
 	// Make a note of the program number for all PIDs, so we can report it later
 	for (unsigned i = 0; i < stream_data && (i + 4) < len; i += 5)
@@ -507,6 +506,7 @@ int parse_PMT(struct ccx_demuxer *ctx, unsigned char *buf, int len, struct progr
 
 void ts_buffer_psi_packet(struct ccx_demuxer *ctx)
 {
+	unsigned char *tspacket = ctx->tspacket;
 	unsigned char *payload_start = tspacket + 4;
 	unsigned payload_length = 188 - 4;
 	//	unsigned transport_error_indicator = (tspacket[1]&0x80)>>7;
@@ -406,41 +406,10 @@ void EPG_output_net(struct lib_ccx_ctx *ctx)
 	}
 }
 
-// Creates fills and closes a new XMLTV file for live mode output.
-// File should include only events not previously output.
-void EPG_output_live(struct lib_ccx_ctx *ctx)
+// Writes the <channel> element of every program from index `first` on.
+static void EPG_print_channels(struct lib_ccx_ctx *ctx, int first, FILE *f)
 {
-	int c = false, i, j;
-	FILE *f;
-	char *filename, *finalfilename;
-	for (i = 0; i < ctx->demux_ctx->nb_program; i++)
-	{
-		for (j = 0; j < ctx->eit_programs[i].array_len; j++)
-			if (ctx->eit_programs[i].epg_events[j].live_output == false)
-			{
-				c = true;
-			}
-	}
-	if (!c)
-		return;
-
-	size_t filename_size = strlen(ctx->basefilename) + 30;
-	filename = malloc(filename_size);
-	if (!filename)
-	{
-		fatal(EXIT_NOT_ENOUGH_MEMORY, "In EPG_output_live: Out of memory allocating filename.");
-	}
-	snprintf(filename, filename_size, "%s_%i.xml.part", ctx->basefilename, ctx->epg_last_live_output);
-	f = fopen(filename, "w");
-	if (!f)
-	{
-		dbg_print(CCX_DMT_GENERIC_NOTICES, "\rUnable to open %s\n", filename);
-		free(filename);
-		return;
-	}
-
-	fprintf(f, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<!DOCTYPE tv SYSTEM \"xmltv.dtd\">\n\n<tv>\n");
-	for (i = 0; i < ctx->demux_ctx->nb_program; i++)
+	for (int i = first; i < ctx->demux_ctx->nb_program; i++)
 	{
 		fprintf(f, "  <channel id=\"%i\">\n", ctx->demux_ctx->pinfo[i].program_number);
 
@@ -469,29 +438,106 @@ void EPG_output_live(struct lib_ccx_ctx *ctx)
 
 		fprintf(f, "  </channel>\n");
 	}
+}
+
+// Writes the live XMLTV journal afresh, with every channel and every event in memory, and
+// reopens it for appending. The document is left open, </tv> is only written by EPG_free.
+static void EPG_write_journal(struct lib_ccx_ctx *ctx)
+{
+	FILE *f;
+	char *filename, *partfilename;
+	int i, j;
+
+	if (ctx->epg_journal)
+	{
+		fclose(ctx->epg_journal);
+		ctx->epg_journal = NULL;
+	}
+
+	size_t filename_size = strlen(ctx->basefilename) + 20;
+	filename = malloc(filename_size);
+	partfilename = malloc(filename_size + 5);
+	if (!filename || !partfilename)
+	{
+		fatal(EXIT_NOT_ENOUGH_MEMORY, "In EPG_write_journal: Out of memory allocating filename.");
+	}
+	snprintf(filename, filename_size, "%s_epg_live.xml", ctx->basefilename);
+	snprintf(partfilename, filename_size + 5, "%s.part", filename);
+	f = fopen(partfilename, "w");
+	if (!f)
+	{
+		dbg_print(CCX_DMT_GENERIC_NOTICES, "\rUnable to open %s\n", partfilename);
+		free(filename);
+		free(partfilename);
+		return;
+	}
+
+	fprintf(f, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<!DOCTYPE tv SYSTEM \"xmltv.dtd\">\n\n<tv>\n");
+	EPG_print_channels(ctx, 0, f);
+	ctx->epg_journal_channels = ctx->demux_ctx->nb_program;
+	ctx->epg_journal_entries = 0;
+	for (i = 0; i < ctx->demux_ctx->nb_program; i++)
+	{
+		for (j = 0; j < ctx->eit_programs[i].array_len; j++)
+		{
+			ctx->eit_programs[i].epg_events[j].live_output = true;
+			EPG_print_event(&ctx->eit_programs[i].epg_events[j], ctx->demux_ctx->pinfo[i].program_number, f);
+			ctx->epg_journal_entries++;
+		}
+	}
+	fclose(f);
+
+	// Readers following the journal see the old one until the snapshot is complete
+	rename(partfilename, filename);
+	ctx->epg_journal = fopen(filename, "a");
+	if (!ctx->epg_journal)
+		dbg_print(CCX_DMT_GENERIC_NOTICES, "\rUnable to open %s\n", filename);
+	free(filename);
+	free(partfilename);
+}
 
+// Appends the events not output yet, new or updated, to the live XMLTV journal
+// <basefilename>_epg_live.xml, so readers can follow it as it grows. Updated events are
+// appended again, so once most of the journal is superseded versions it is replaced by a
+// compacted snapshot of the events in memory.
+void EPG_output_live(struct lib_ccx_ctx *ctx)
+{
+	int i, j;
+	unsigned pending = 0, stored = 0;
+	for (i = 0; i < ctx->demux_ctx->nb_program; i++)
+	{
+		stored += ctx->eit_programs[i].array_len;
+		for (j = 0; j < ctx->eit_programs[i].array_len; j++)
+			if (ctx->eit_programs[i].epg_events[j].live_output == false)
+				pending++;
+	}
+	if (!pending)
+		return;
+
+	if (!ctx->epg_journal || ctx->epg_journal_entries + pending > 2 * stored)
+	{
+		EPG_write_journal(ctx);
+		return;
+	}
+
+	if (ctx->demux_ctx->nb_program > ctx->epg_journal_channels)
+	{
+		EPG_print_channels(ctx, ctx->epg_journal_channels, ctx->epg_journal);
+		ctx->epg_journal_channels = ctx->demux_ctx->nb_program;
+	}
 	for (i = 0; i < ctx->demux_ctx->nb_program; i++)
 	{
 		for (j = 0; j < ctx->eit_programs[i].array_len; j++)
 			if (ctx->eit_programs[i].epg_events[j].live_output == false)
 			{
 				ctx->eit_programs[i].epg_events[j].live_output = true;
-				EPG_print_event(&ctx->eit_programs[i].epg_events[j], ctx->demux_ctx->pinfo[i].program_number, f);
+				EPG_print_event(&ctx->eit_programs[i].epg_events[j], ctx->demux_ctx->pinfo[i].program_number, ctx->epg_journal);
 			}
 	}
-	fprintf(f, "</tv>");
-	fclose(f);
-	finalfilename = malloc(strlen(filename) + 30);
-	if (!finalfilename)
-	{
-		free(filename);
-		fatal(EXIT_NOT_ENOUGH_MEMORY, "In EPG_output_live: Out of memory allocating finalfilename.");
-	}
-	memcpy(finalfilename, filename, strlen(filename) - 5);
-	finalfilename[strlen(filename) - 5] = '\0';
-	rename(filename, finalfilename);
-	free(filename);
-	free(finalfilename);
+	ctx->epg_journal_entries += pending;
+	// Everything written so far reaches the file now. Readers can still see a partial element
+	// before this, when the stdio buffer fills in the middle of one
+	fflush(ctx->epg_journal);
 }
 
 // Creates fills and closes a new XMLTV file for full output mode.
@@ -518,35 +564,7 @@ void EPG_output(struct lib_ccx_ctx *ctx)
 	freep(&filename);
 
 	fprintf(f, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<!DOCTYPE tv SYSTEM \"xmltv.dtd\">\n\n<tv>\n");
-	for (i = 0; i < ctx->demux_ctx->nb_program; i++)
-	{
-		fprintf(f, "  <channel id=\"%i\">\n", ctx->demux_ctx->pinfo[i].program_number);
-
-		// Output virtual channel number if available (e.g., "2.1")
-		if (ctx->demux_ctx->pinfo[i].virtual_channel[0] != '\0')
-		{
-			fprintf(f, "    <display-name>%s</display-name>\n",
-				ctx->demux_ctx->pinfo[i].virtual_channel);
-		}
-
-		// Output call sign if available (e.g., "KTVU-HD")
-		if (ctx->demux_ctx->pinfo[i].name[0] != '\0')
-		{
-			fprintf(f, "    <display-name>");
-			EPG_fprintxml(f, ctx->demux_ctx->pinfo[i].name);
-			fprintf(f, "</display-name>\n");
-		}
-
-		// Fallback to program number if nothing else available
-		if (ctx->demux_ctx->pinfo[i].name[0] == '\0' &&
-		    ctx->demux_ctx->pinfo[i].virtual_channel[0] == '\0')
-		{
-			fprintf(f, "    <display-name>%i</display-name>\n",
-				ctx->demux_ctx->pinfo[i].program_number);
-		}
-
-		fprintf(f, "  </channel>\n");
-	}
+	EPG_print_channels(ctx, 0, f);
 
 	if (ccx_options.xmltvonlycurrent == 0)
 	{ // print all events
@@ -599,37 +617,70 @@ void EPG_free_event(struct EPG_event *event)
 // compare 2 events. Return false if they are different.
 int EPG_event_cmp(struct EPG_event *e1, struct EPG_event *e2)
 {
-	if (e1->id != e2->id || (strcmp(e1->start_time_string, e2->start_time_string) != 0) || (strcmp(e1->end_time_string, e2->end_time_string) != 0))
+	// The time strings are formatted from the raw values, no need to compare them
+	if (e1->id != e2->id || e1->raw_start_time != e2->raw_start_time || e1->raw_duration != e2->raw_duration)
 		return false;
 	// could add full checking of strings here if desired.
 	return true;
 }
 
-// Add given event to array of events.
+// Slot of the program's event index holding the given event, or the free slot where it goes.
+// The index is never more than about half full, so probes stay short.
+static uint32_t EPG_event_slot(struct EIT_program *program, uint32_t id, uint16_t service_id)
+{
+	const uint32_t mask = (1 << EPG_EVENT_INDEX_BITS) - 1;
+	uint32_t slot = ((id ^ ((uint32_t)service_id << 16)) * 2654435761u) >> (32 - EPG_EVENT_INDEX_BITS);
+
+	while (program->event_index[slot])
+	{
+		struct EPG_event *e = &program->epg_events[program->event_index[slot] - 1];
+		if (e->id == id && e->service_id == service_id)
+			break;
+		slot = (slot + 1) & mask;
+	}
+	return slot;
+}
+
+// Returns the stored event with this id, NULL if there is none.
+struct EPG_event *EPG_find_event(struct EIT_program *program, uint32_t id, uint16_t service_id)
+{
+	uint32_t slot = EPG_event_slot(program, id, service_id);
+	return program->event_index[slot] ? &program->epg_events[program->event_index[slot] - 1] : NULL;
+}
+
+// Add given event to array of events, which takes over its strings.
 // Return FALSE if nothing changed, TRUE if this is a new or updated event.
 int EPG_add_event(struct lib_ccx_ctx *ctx, int32_t pmt_map, struct EPG_event *event)
 {
-	int j;
+	struct EIT_program *program = &ctx->eit_programs[pmt_map];
+	uint32_t slot = EPG_event_slot(program, event->id, event->service_id);
 
-	for (j = 0; j < ctx->eit_programs[pmt_map].array_len; j++)
+	if (program->event_index[slot])
 	{
-		if (ctx->eit_programs[pmt_map].epg_events[j].id == event->id)
+		struct EPG_event *old = &program->epg_events[program->event_index[slot] - 1];
+		if (EPG_event_cmp(event, old))
 		{
-			if (EPG_event_cmp(event, &ctx->eit_programs[pmt_map].epg_events[j]))
-				return false; // event already in array, nothing to do
-			else
-			{ // event with this id is already in the array but something has changed. Update it.
-				event->count = ctx->eit_programs[pmt_map].epg_events[j].count;
-				EPG_free_event(&ctx->eit_programs[pmt_map].epg_events[j]);
-				memcpy(&ctx->eit_programs[pmt_map].epg_events[j], event, sizeof(struct EPG_event));
-				return true;
-			}
+			// event already in array, nothing to do
+			EPG_free_event(event);
+			return false;
 		}
+		// event with this id is already in the array but something has changed. Update it.
+		event->count = old->count;
+		EPG_free_event(old);
+		memcpy(old, event, sizeof(struct EPG_event));
+		return true;
+	}
+	if (program->array_len == EPG_MAX_EVENTS)
+	{
+		dbg_print(CCX_DMT_GENERIC_NOTICES, "\rWarning: Too many EPG events in one program, ignoring event %u.\n", event->id);
+		EPG_free_event(event);
+		return false;
 	}
 	// id not in array. Add new event;
 	event->count = 0;
-	memcpy(&ctx->eit_programs[pmt_map].epg_events[ctx->eit_programs[pmt_map].array_len], event, sizeof(struct EPG_event));
-	ctx->eit_programs[pmt_map].array_len++;
+	memcpy(&program->epg_events[program->array_len], event, sizeof(struct EPG_event));
+	program->array_len++;
+	program->event_index[slot] = program->array_len;
 	return true;
 }
 
@@ -1116,6 +1167,8 @@ void EPG_ATSC_decode_EIT(struct lib_ccx_ctx *ctx, uint8_t *payload_start, uint32
 		EPG_ATSC_calc_time(event.start_time_string, start_time);
 		length_in_seconds = (((offset[6] & 0x0F) << 16) | (offset[7] << 8) | (offset[8] << 0));
 		EPG_ATSC_calc_time(event.end_time_string, start_time + length_in_seconds);
+		event.raw_start_time = start_time;
+		event.raw_duration = length_in_seconds;
 
 		title_length = offset[9];
 		// XXX cant decode data more then size of payload
@@ -1181,7 +1234,7 @@ void EPG_ATSC_decode_ETT(struct lib_ccx_ctx *ctx, uint8_t *payload_start, uint32
 	uint32_t ETM_id;
 	uint16_t source_id;
 	int32_t pmt_map = -1;
-	int i, j;
+	int i;
 	uint32_t extended_text_offset;
 
 	if (size < 14)
@@ -1216,32 +1269,22 @@ void EPG_ATSC_decode_ETT(struct lib_ccx_ctx *ctx, uint8_t *payload_start, uint32
 	// First try exact match in the mapped program
 	if (pmt_map < TS_PMT_MAP_SIZE)
 	{
-		for (j = 0; j < ctx->eit_programs[pmt_map].array_len; j++)
+		struct EPG_event *event = EPG_find_event(&ctx->eit_programs[pmt_map], ETM_id, source_id);
+		if (event != NULL)
 		{
-			struct EPG_event *event = &ctx->eit_programs[pmt_map].epg_events[j];
-			if (event->id == ETM_id)
-			{
-				EPG_ATSC_decode_ETT_text(payload_start + extended_text_offset,
-							 size - extended_text_offset, event);
-				found_match = 1;
-				break;
-			}
+			EPG_ATSC_decode_ETT_text(payload_start + extended_text_offset,
+						 size - extended_text_offset, event);
+			found_match = 1;
 		}
 	}
 
 	// If not found, try fallback storage (TS_PMT_MAP_SIZE)
 	if (!found_match)
 	{
-		for (j = 0; j < ctx->eit_programs[TS_PMT_MAP_SIZE].array_len; j++)
-		{
-			struct EPG_event *event = &ctx->eit_programs[TS_PMT_MAP_SIZE].epg_events[j];
-			if (event->id == ETM_id)
-			{
-				EPG_ATSC_decode_ETT_text(payload_start + extended_text_offset,
-							 size - extended_text_offset, event);
-				break;
-			}
-		}
+		struct EPG_event *event = EPG_find_event(&ctx->eit_programs[TS_PMT_MAP_SIZE], ETM_id, source_id);
+		if (event != NULL)
+			EPG_ATSC_decode_ETT_text(payload_start + extended_text_offset,
+						 size - extended_text_offset, event);
 	}
 }
 
@@ -1308,6 +1351,9 @@ void EPG_ATSC_decode_VCT(struct lib_ccx_ctx *ctx, uint8_t *payload_start, uint32
 
 		offset += 32 + descriptors_loop_length;
 
+		// EIT sections of this source decoded so far went to another program
+		if (ctx->ATSC_source_pg_map[source_id] != program_number)
+			ctx->epg_sections.nb_program = -1;
 		ctx->ATSC_source_pg_map[source_id] = program_number;
 
 		// Convert short_name and store in program info
@@ -1365,6 +1411,8 @@ void EPG_DVB_decode_EIT(struct lib_ccx_ctx *ctx, uint8_t *payload_start, uint32_
 	uint32_t events_length;
 	uint8_t *offset;
 	uint32_t remaining;
+	struct EPG_event *stored;
+	int unchanged;
 
 	if (size < 13)
 		return;
@@ -1411,10 +1459,10 @@ void EPG_DVB_decode_EIT(struct lib_ccx_ctx *ctx, uint8_t *payload_start, uint32_
 
 		// 40 bits
 		start_time = ((uint64_t)offset[16] << 32) | ((uint64_t)offset[17] << 24) | ((uint64_t)offset[18] << 16) | ((uint64_t)offset[19] << 8) | ((uint64_t)offset[20] << 0);
-		EPG_DVB_calc_start_time(&event, start_time);
 		// 24 bits
 		duration = (offset[21] << 16) | (offset[22] << 8) | (offset[23] << 0);
-		EPG_DVB_calc_end_time(&event, start_time, duration);
+		event.raw_start_time = start_time;
+		event.raw_duration = duration;
 		event.running_status = (offset[24] & 0xE0) >> 5;
 		event.free_ca_mode = (offset[24] & 0x10) >> 4;
 		// 12 bits
@@ -1425,7 +1473,16 @@ void EPG_DVB_decode_EIT(struct lib_ccx_ctx *ctx, uint8_t *payload_start, uint32_
 			dbg_print(CCX_DMT_GENERIC_NOTICES, "\rWarning: Invalid EIT descriptors_loop_length detected.\n");
 			return;
 		}
-		while (descp < &(offset[26]) + descriptors_loop_length)
+
+		// An event already stored unchanged would be dropped by EPG_add_event(), don't decode its strings again
+		stored = EPG_find_event(&ctx->eit_programs[pmt_map], event.id, service_id);
+		unchanged = stored != NULL && EPG_event_cmp(&event, stored);
+		if (!unchanged)
+		{
+			EPG_DVB_calc_start_time(&event, start_time);
+			EPG_DVB_calc_end_time(&event, start_time, duration);
+		}
+		while (!unchanged && descp < &(offset[26]) + descriptors_loop_length)
 		{
 			if (descp + descp[1] + 2 > payload_start + size)
 			{
@@ -1451,7 +1508,8 @@ void EPG_DVB_decode_EIT(struct lib_ccx_ctx *ctx, uint8_t *payload_start, uint32_
 		}
 		remaining = remaining - (descriptors_loop_length + 12);
 		offset = offset + descriptors_loop_length + 12;
-		hasnew |= EPG_add_event(ctx, pmt_map, &event);
+		if (!unchanged)
+			hasnew |= EPG_add_event(ctx, pmt_map, &event);
 
 		if (hasnew && section_number == 0 && table_id == 0x4e)
 			ctx->eit_current_events[pmt_map] = event.id;
@@ -1485,6 +1543,70 @@ void EPG_handle_output(struct lib_ccx_ctx *ctx)
 	}
 }
 
+// Returns true if this EIT section was already decoded with the same version and CRC, and
+// remembers it otherwise. Schedules are repeated every few seconds, nearly always unchanged.
+static int EPG_section_seen(struct lib_ccx_ctx *ctx, uint8_t *section, uint32_t size)
+{
+	struct EPG_section_cache *cache = &ctx->epg_sections;
+	uint32_t section_length, key, crc, slot, i;
+	uint8_t version;
+
+	if (size < 3)
+		return false;
+	section_length = (section[1] & 0x0F) << 8 | section[2];
+	// Incomplete sections aren't decoded either, see EPG_DVB_decode_EIT()
+	if (section_length < 9 || section_length + 3 > size)
+		return false;
+	key = (uint32_t)section[0] << 24 | section[3] << 16 | section[4] << 8 | section[6];
+	version = (section[5] >> 1) & 0x1F;
+	crc = (uint32_t)section[section_length - 1] << 24 | section[section_length] << 16 |
+	      section[section_length + 1] << 8 | section[section_length + 2];
+
+	// Sections decoded before their program was known went to the fallback storage
+	if (cache->nb_program != ctx->demux_ctx->nb_program)
+	{
+		if (cache->entries)
+			memset(cache->entries, 0, cache->size * sizeof(struct EPG_section_version));
+		cache->count = 0;
+		cache->nb_program = ctx->demux_ctx->nb_program;
+	}
+
+	if (2 * (cache->count + 1) > cache->size)
+	{
+		struct EPG_section_cache grown = *cache;
+		grown.size = cache->size ? cache->size * 2 : 1024;
+		grown.entries = calloc(grown.size, sizeof(struct EPG_section_version));
+		if (!grown.entries)
+			fatal(EXIT_NOT_ENOUGH_MEMORY, "In EPG_section_seen: Out of memory allocating section cache.");
+		for (i = 0; i < cache->size; i++)
+		{
+			if (!cache->entries[i].key)
+				continue;
+			for (slot = (cache->entries[i].key * 2654435761u) & (grown.size - 1); grown.entries[slot].key;)
+				slot = (slot + 1) & (grown.size - 1);
+			grown.entries[slot] = cache->entries[i];
+		}
+		free(cache->entries);
+		*cache = grown;
+	}
+
+	for (slot = (key * 2654435761u) & (cache->size - 1); cache->entries[slot].key; slot = (slot + 1) & (cache->size - 1))
+	{
+		if (cache->entries[slot].key != key)
+			continue;
+		if (cache->entries[slot].version == version && cache->entries[slot].crc == crc)
+			return true;
+		cache->entries[slot].version = version;
+		cache->entries[slot].crc = crc;
+		return false;
+	}
+	cache->entries[slot].key = key;
+	cache->entries[slot].version = version;
+	cache->entries[slot].crc = crc;
+	cache->count++;
+	return false;
+}
+
 // determine table type and call the correct function to handle it
 void EPG_parse_table(struct lib_ccx_ctx *ctx, uint8_t *b, uint32_t size)
 {
@@ -1502,7 +1624,8 @@ void EPG_parse_table(struct lib_ccx_ctx *ctx, uint8_t *b, uint32_t size)
 		case 0xCE:
 		case 0xCF:
 		case 0xD0:
-			EPG_ATSC_decode_EIT(ctx, payload_start, size - (payload_start - b));
+			if (!EPG_section_seen(ctx, payload_start, size - (payload_start - b)))
+				EPG_ATSC_decode_EIT(ctx, payload_start, size - (payload_start - b));
 			break;
 
 		// ATSC ETT (Extended Text Table)
@@ -1517,7 +1640,7 @@ void EPG_parse_table(struct lib_ccx_ctx *ctx, uint8_t *b, uint32_t size)
 			break;
 		default:
 			// DVB EIT tables
-			if (table_id >= 0x4E && table_id <= 0x6F)
+			if (table_id >= 0x4E && table_id <= 0x6F && !EPG_section_seen(ctx, payload_start, size - (payload_start - b)))
 			{
 				EPG_DVB_decode_EIT(ctx, payload_start, size - (payload_start - b));
 			}
@@ -1527,7 +1650,7 @@ void EPG_parse_table(struct lib_ccx_ctx *ctx, uint8_t *b, uint32_t size)
 }
 
 // reconstructs DVB EIT and ATSC tables
-void parse_EPG_packet(struct lib_ccx_ctx *ctx)
+void parse_EPG_packet(struct lib_ccx_ctx *ctx, unsigned char *tspacket)
 {
 	unsigned char *payload_start = tspacket + 4;
 	unsigned payload_length = 188 - 4;
@@ -1611,9 +1734,16 @@ void EPG_free(struct lib_ccx_ctx *ctx)
 			else
 				EPG_output_live(ctx);
 		}
+		if (ctx->epg_journal)
+		{
+			fprintf(ctx->epg_journal, "</tv>");
+			fclose(ctx->epg_journal);
+			ctx->epg_journal = NULL;
+		}
 	}
 	free(ctx->epg_buffers);
 	free(ctx->eit_programs);
+	free(ctx->epg_sections.entries);
 	free(ctx->eit_current_events);
 	free(ctx->ATSC_source_pg_map);
 }
@@ -12,6 +12,8 @@ volatile sig_atomic_t change_filename_requested = 0;
 extern int ccxr_verify_crc32(uint8_t *buf, int len);
 extern int ccxr_levenshtein_dist(const uint64_t *s1, const uint64_t *s2, unsigned s1len, unsigned s2len);
 extern int ccxr_levenshtein_dist_char(const char *s1, const char *s2, unsigned s1len, unsigned s2len);
+extern int ccxr_levenshtein_dist_bounded(const uint64_t *s1, const uint64_t *s2, unsigned s1len, unsigned s2len, unsigned max);
+extern int ccxr_levenshtein_dist_char_bounded(const char *s1, const char *s2, unsigned s1len, unsigned s2len, unsigned max);
 extern void ccxr_timestamp_to_srttime(uint64_t timestamp, char *buffer);
 extern void ccxr_timestamp_to_vtttime(uint64_t timestamp, char *buffer);
 extern void ccxr_millis_to_date(uint64_t timestamp, char *buffer, enum ccx_output_date_format date_format, char millis_separator);
@@ -113,6 +115,17 @@ int levenshtein_dist_char(const char *s1, const char *s2, unsigned s1len, unsign
 	return ccxr_levenshtein_dist_char(s1, s2, s1len, s2len);
 }
 
+// Same as levenshtein_dist(), but stops as soon as the distance exceeds max and returns max + 1
+int levenshtein_dist_bounded(const uint64_t *s1, const uint64_t *s2, unsigned s1len, unsigned s2len, unsigned max)
+{
+	return ccxr_levenshtein_dist_bounded(s1, s2, s1len, s2len, max);
+}
+
+int levenshtein_dist_char_bounded(const char *s1, const char *s2, unsigned s1len, unsigned s2len, unsigned max)
+{
+	return ccxr_levenshtein_dist_char_bounded(s1, s2, s1len, s2len, max);
+}
+
 void millis_to_date(uint64_t timestamp, char *buffer, enum ccx_output_date_format date_format, char millis_separator)
 {
 	return ccxr_millis_to_date(timestamp, buffer, date_format, millis_separator);
@@ -192,16 +205,22 @@ void mprint(const char *fmt, ...)
 	va_end(args);
 }
 
-/* Shorten some debug output code. */
-void dbg_print(LLONG mask, const char *fmt, ...)
+/* Whether dbg_print() would output messages of this mask, so callers can skip building them. */
+int dbg_enabled(LLONG mask)
 {
-	va_list args;
 	LLONG t;
 	if (!ccx_options.messages_target)
-		return;
+		return 0;
 	t = temp_debug ? (ccx_options.debug_mask_on_debug | ccx_options.debug_mask) : ccx_options.debug_mask; // Mask override?
+	return (mask & t) != 0;
+}
+
+/* Shorten some debug output code. */
+void dbg_print(LLONG mask, const char *fmt, ...)
+{
+	va_list args;
 
-	if (mask & t)
+	if (dbg_enabled(mask))
 	{
 		va_start(args, fmt);
 		if (ccx_options.messages_target == CCX_MESSAGES_STDOUT)
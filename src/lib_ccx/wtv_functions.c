@@ -496,7 +496,7 @@ LLONG get_data(struct lib_ccx_ctx *ctx, struct wtv_chunked_buffer *cb, struct de
 				}
 				// pts_set = 2 (MinPtsSet) is required for proper fts_now calculation
 				dec_ctx->timing->pts_set = 2;
-				frames_since_ref_time = 0;
+				dec_ctx->timing->frames_since_ref_time = 0;
 				set_fts(dec_ctx->timing);
 			}
 			else if (time == WTV_CC_TIMESTAMP_MAGIC && stream_id != alt_stream)
@@ -518,7 +518,7 @@ LLONG get_data(struct lib_ccx_ctx *ctx, struct wtv_chunked_buffer *cb, struct de
 			memcpy(data->buffer + data->len, cb->buffer, len);
 			data->len += len;
 			bytesread += (int)len;
-			frames_since_ref_time++;
+			dec_ctx->timing->frames_since_ref_time++;
 			set_fts(dec_ctx->timing);
 			if (pad > 0)
 			{ // Make sure we skip any padding too, since we are returning here
@@ -566,7 +566,7 @@ LLONG get_data(struct lib_ccx_ctx *ctx, struct wtv_chunked_buffer *cb, struct de
 			bytesread += (int)(14 + len);
 			data->codec = CCX_CODEC_TELETEXT;
 			data->bufferdatatype = CCX_TELETEXT;
-			frames_since_ref_time++;
+			dec_ctx->timing->frames_since_ref_time++;
 			set_fts(dec_ctx->timing);
 			if (pad > 0)
 			{
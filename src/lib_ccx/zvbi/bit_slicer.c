@@ -25,6 +25,23 @@
 #include "bit_slicer.h"
 #include "../ccx_common_common.h"
 
+/* SSE2 is part of every x86-64 CPU, so it needs no run time check.
+   Build with -DHAVE_SSE2_SLICER=0 for the plain C slicers only. */
+#ifndef HAVE_SSE2_SLICER
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HAVE_SSE2_SLICER 1
+#else
+#define HAVE_SSE2_SLICER 0
+#endif
+#endif
+
+#if HAVE_SSE2_SLICER
+#include <emmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
 #define VBI_PIXFMT_Y8 VBI_PIXFMT_YUV420
 #define VBI_PIXFMT_RGB24_LE VBI_PIXFMT_RGB24
 #define VBI_PIXFMT_BGR24_LE VBI_PIXFMT_BGR24
@@ -136,7 +153,12 @@
 				break;                                        \
                                                                               \
 			case 1: /* octets, lsb first */                       \
-				for (j = bs->payload; j > 0; --j)             \
+				j = bs->payload;                              \
+				if (SSE2_Y8(pixfmt) && !collect_points)       \
+					j -= payload_octets_lsb_Y8_sse2(      \
+					    &buffer, raw, &i, bs->step, tr,   \
+					    j);                               \
+				for (; j > 0; --j)                            \
 				{                                             \
 					for (k = 0, c = 0; k < 8; ++k)        \
 					{                                     \
@@ -195,6 +217,7 @@
 				c = c * 2 + b;                                     \
 				if ((c & bs->cri_mask) == bs->cri)                 \
 				{                                                  \
+					bs->thresh = thresh;                       \
 					PAYLOAD();                                 \
 					if (collect_points)                        \
 					{                                          \
@@ -217,7 +240,7 @@
 		const uint8_t *raw_start;                                     \
 		unsigned int i, j, k;                                         \
 		unsigned int cl;      /* clock */                             \
-		unsigned int thresh0; /* old 0/1 threshold */                 \
+		unsigned int thresh;  /* 0/1 threshold, kept in a register */ \
 		unsigned int tr;      /* current threshold */                 \
 		unsigned int c;	      /* current byte */                      \
 		unsigned int t;	      /* t = raw[0] * j + raw[1] * (1 - j) */ \
@@ -225,7 +248,7 @@
 		unsigned int raw1;                                            \
 		unsigned char b1; /* previous bit */                          \
                                                                               \
-		thresh0 = bs->thresh;                                         \
+		thresh = bs->thresh;                                          \
 		raw_start = raw;                                              \
 		raw += bs->skip;                                              \
                                                                               \
@@ -233,13 +256,18 @@
 		c = 0;                                                        \
 		b1 = 0;                                                       \
                                                                               \
-		for (i = bs->cri_samples; i > 0; --i)                         \
+		i = bs->cri_samples;                                          \
+		if (SSE2_Y8(pixfmt) && 4 == oversampling && !collect_points)  \
+			i -= cri_search_Y8_sse2(bs, &raw, i, thresh_frac,     \
+						&thresh, &cl, &c, &b1);       \
+                                                                              \
+		for (; i > 0; --i)                                            \
 		{                                                             \
-			tr = bs->thresh >> thresh_frac;                       \
+			tr = thresh >> thresh_frac;                           \
 			raw0 = GREEN(raw);                                    \
 			raw1 = GREEN(raw + bpp);                              \
 			raw1 -= raw0;                                         \
-			bs->thresh += (int)(raw0 - tr) * (int)ABS((int)raw1); \
+			thresh += (int)(raw0 - tr) * (int)ABS((int)raw1);     \
 			t = raw0 * oversampling;                              \
                                                                               \
 			for (j = oversampling; j > 0; --j)                    \
@@ -248,7 +276,7 @@
 			raw += bpp;                                           \
 		}                                                             \
                                                                               \
-		bs->thresh = thresh0;                                         \
+		/* No CRI found, bs->thresh keeps its start value. */         \
                                                                               \
 		if (collect_points)                                           \
 			*n_points = points - points_start;                    \
@@ -256,6 +284,245 @@
 		return CCX_FALSE;                                             \
 	} while (0)
 
+/* Whether the SSE2 versions below can stand in for parts of a
+   bit slicer for this pixfmt. pixfmt is const. */
+#define SSE2_Y8(pixfmt) (HAVE_SSE2_SLICER && VBI_PIXFMT_Y8 == (pixfmt))
+
+#if HAVE_SSE2_SLICER
+
+/* Moves bit n of the 16 bits in x to bit 4 * n. */
+static uint64_t
+spread_4(unsigned int x)
+{
+	uint64_t v = x & 0xFFFF;
+
+	v = (v | (v << 24)) & 0x000000FF000000FFULL;
+	v = (v | (v << 12)) & 0x000F000F000F000FULL;
+	v = (v | (v << 6)) & 0x0303030303030303ULL;
+	v = (v | (v << 3)) & 0x1111111111111111ULL;
+
+	return v;
+}
+
+static unsigned int
+lowest_bit_64(uint64_t x)
+{
+#ifdef _MSC_VER
+	unsigned long n;
+
+	if (_BitScanForward(&n, (unsigned long)x))
+		return n;
+	_BitScanForward(&n, (unsigned long)(x >> 32));
+	return n + 32;
+#else
+	return __builtin_ctzll(x);
+#endif
+}
+
+/* Sample k of 4 between the 16 bit samples a and b, like t in CRI(). */
+static __m128i
+cri_level(__m128i a, __m128i b, int k)
+{
+	__m128i sum;
+
+	sum = _mm_add_epi16(_mm_mullo_epi16(a, _mm_set1_epi16(4 - k)),
+			    _mm_mullo_epi16(b, _mm_set1_epi16(k)));
+
+	return _mm_srli_epi16(_mm_add_epi16(sum, _mm_set1_epi16(2)), 2);
+}
+
+/* Bit s set if level s of 16 is at or above the threshold in
+   trm1 + 1. */
+static unsigned int
+cri_bits(__m128i level_lo, __m128i level_hi, __m128i trm1_lo, __m128i trm1_hi)
+{
+	return _mm_movemask_epi8(_mm_packs_epi16(_mm_cmpgt_epi16(level_lo, trm1_lo),
+						 _mm_cmpgt_epi16(level_hi, trm1_hi)));
+}
+
+/* The CRI search of CORE() for Y8 with 4 times oversampling, 16
+   samples at a time. The 0/1 decisions of a block are made with
+   SSE2. The threshold still advances once per sample and the clock
+   once per run of equal bits, which gives the same state as the
+   scalar loop. A block in which the CRI may end is left to the
+   scalar loop, to find it there. Returns the number of samples
+   done, with the state updated to match. */
+static unsigned int
+cri_search_Y8_sse2(const vbi3_bit_slicer *bs,
+		   const uint8_t **rawp,
+		   unsigned int samples,
+		   unsigned int thresh_frac,
+		   unsigned int *threshp,
+		   unsigned int *clp,
+		   unsigned int *cp,
+		   unsigned char *b1p)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i one = _mm_set1_epi16(1);
+	const uint8_t *raw = *rawp;
+	unsigned int done;
+
+	for (done = 0; samples - done >= 16; done += 16, raw += 16)
+	{
+		uint16_t tr[16];
+		unsigned int thresh, cl, c;
+		unsigned int s, pos;
+		uint64_t bits, edges;
+		__m128i a, b, a_lo, a_hi, b_lo, b_hi, trm1_lo, trm1_hi;
+
+		thresh = *threshp;
+		for (s = 0; s < 16; ++s)
+		{
+			unsigned int t = thresh >> thresh_frac;
+			unsigned int raw0 = raw[s];
+			unsigned int raw1 = raw[s + 1] - raw0;
+
+			/* Levels are at most 255, higher thresholds
+			   all decide alike. */
+			tr[s] = MIN(t, 256U);
+			thresh += (int)(raw0 - t) * (int)ABS((int)raw1);
+		}
+
+		/* Reads raw[16], as the scalar loop reads raw[bpp]. */
+		a = _mm_loadu_si128((const __m128i *)raw);
+		b = _mm_loadu_si128((const __m128i *)(raw + 1));
+		a_lo = _mm_unpacklo_epi8(a, zero);
+		a_hi = _mm_unpackhi_epi8(a, zero);
+		b_lo = _mm_unpacklo_epi8(b, zero);
+		b_hi = _mm_unpackhi_epi8(b, zero);
+		trm1_lo = _mm_sub_epi16(_mm_loadu_si128((const __m128i *)tr), one);
+		trm1_hi = _mm_sub_epi16(_mm_loadu_si128((const __m128i *)(tr + 8)), one);
+
+		/* Bit 4 * s + k is bit k of 4 oversampled at sample s. */
+		bits = spread_4(cri_bits(a_lo, a_hi, trm1_lo, trm1_hi));
+		for (s = 1; s < 4; ++s)
+			bits |= spread_4(cri_bits(cri_level(a_lo, b_lo, s), cri_level(a_hi, b_hi, s),
+						  trm1_lo, trm1_hi))
+				<< s;
+
+		/* A bit differing from the one before restarts the clock,
+		   every other bit advances it. */
+		edges = bits ^ ((bits << 1) | *b1p);
+		cl = *clp;
+		c = *cp;
+		for (pos = 0; pos < 64;)
+		{
+			unsigned int b_pos = (bits >> pos) & 1;
+			unsigned int end;
+			uint64_t rest, clock;
+
+			if ((edges >> pos) & 1)
+			{
+				cl = bs->oversampling_rate >> 1;
+				++pos;
+			}
+
+			rest = (pos < 64) ? edges >> pos : 0;
+			end = rest ? pos + lowest_bit_64(rest) : 64;
+
+			/* cri_rate < oversampling_rate, so at most one bit
+			   per step, as in CRI(). */
+			clock = cl + (uint64_t)(end - pos) * bs->cri_rate;
+			while (clock >= bs->oversampling_rate)
+			{
+				clock -= bs->oversampling_rate;
+				c = c * 2 + b_pos;
+				if ((c & bs->cri_mask) == bs->cri)
+					goto finish;
+			}
+			cl = (unsigned int)clock;
+			pos = end;
+		}
+
+		*threshp = thresh;
+		*clp = cl;
+		*cp = c;
+		*b1p = (unsigned char)(bits >> 63);
+	}
+
+finish:
+	*rawp = raw;
+
+	return done;
+}
+
+/* The octets, lsb first part of PAYLOAD() for Y8, 8 bits at a time
+   with SSE2. Reads the same two samples per bit as SAMPLE(). tr is
+   the threshold times 256. Returns the number of octets done, with
+   buffer and i advanced past them. */
+static unsigned int
+payload_octets_lsb_Y8_sse2(uint8_t **bufferp,
+			   const uint8_t *raw,
+			   unsigned int *ip,
+			   unsigned int step,
+			   unsigned int tr,
+			   unsigned int octets)
+{
+	const __m128i low = _mm_set1_epi16(0xFF);
+	const __m128i full = _mm_set1_epi16(256);
+	__m128i steps, thr;
+	uint8_t *buffer = *bufferp;
+	unsigned int i = *ip;
+	unsigned int n;
+
+	/* Levels are at most 255 * 256. */
+	if (tr > 0xFFFF)
+		return 0;
+
+	steps = _mm_setr_epi16(0, (short)step, (short)(2 * step), (short)(3 * step),
+			       (short)(4 * step), (short)(5 * step), (short)(6 * step),
+			       (short)(7 * step));
+	thr = _mm_set1_epi16((short)tr);
+
+	for (n = 0; n < octets; ++n)
+	{
+		__m128i pairs = _mm_setzero_si128();
+		__m128i frac, level, below;
+
+#define SAMPLE_PAIR(k)                                                    \
+	do                                                                \
+	{                                                                 \
+		const uint8_t *r = raw + ((i + (k) * step) >> 8);         \
+		pairs = _mm_insert_epi16(pairs, r[0] | (r[1] << 8), (k)); \
+	} while (0)
+
+		SAMPLE_PAIR(0);
+		SAMPLE_PAIR(1);
+		SAMPLE_PAIR(2);
+		SAMPLE_PAIR(3);
+		SAMPLE_PAIR(4);
+		SAMPLE_PAIR(5);
+		SAMPLE_PAIR(6);
+		SAMPLE_PAIR(7);
+
+#undef SAMPLE_PAIR
+
+		/* The low 8 bits of i + k * step, as in SAMPLE(). */
+		frac = _mm_and_si128(_mm_add_epi16(_mm_set1_epi16((short)i), steps), low);
+
+		/* raw0 * (256 - frac) + raw1 * frac, no more than 255 * 256. */
+		level = _mm_add_epi16(_mm_mullo_epi16(_mm_and_si128(pairs, low), _mm_sub_epi16(full, frac)),
+				      _mm_mullo_epi16(_mm_srli_epi16(pairs, 8), frac));
+		below = _mm_subs_epu16(thr, level);
+
+		*buffer++ = (uint8_t)_mm_movemask_epi8(_mm_packs_epi16(_mm_cmpeq_epi16(below, _mm_setzero_si128()),
+								       _mm_setzero_si128()));
+		i += 8 * step;
+	}
+
+	*bufferp = buffer;
+	*ip = i;
+
+	return octets;
+}
+
+#else /* !HAVE_SSE2_SLICER */
+
+#define cri_search_Y8_sse2(bs, rawp, samples, thresh_frac, threshp, clp, cp, b1p) 0
+#define payload_octets_lsb_Y8_sse2(bufferp, raw, ip, step, tr, octets) 0
+
+#endif /* !HAVE_SSE2_SLICER */
+
 #define BIT_SLICER(fmt, os, tf)                                          \
 	static int                                                       \
 	    bit_slicer_##fmt(vbi3_bit_slicer *bs,                        \
@@ -297,7 +564,7 @@ low_pass_bit_slicer_Y8(vbi3_bit_slicer *bs,
 	const uint8_t *raw_start;
 	unsigned int i, j, k, m;
 	unsigned int cl;      /* clock */
-	unsigned int thresh0; /* old 0/1 threshold */
+	unsigned int thresh;  /* 0/1 threshold, kept in a register */
 	unsigned int tr;      /* current threshold */
 	unsigned int c;	      /* current byte */
 	unsigned int raw0;    /* oversampling temporary */
@@ -312,7 +579,7 @@ low_pass_bit_slicer_Y8(vbi3_bit_slicer *bs,
 
 	bps = bs->bytes_per_sample;
 
-	thresh0 = bs->thresh;
+	thresh = bs->thresh;
 
 	c = -1;
 	cl = 0;
@@ -330,11 +597,11 @@ low_pass_bit_slicer_Y8(vbi3_bit_slicer *bs,
 	{
 		unsigned char b; /* current bit */
 
-		tr = bs->thresh >> bs->thresh_frac;
+		tr = thresh >> bs->thresh_frac;
 		raw0 = raw0sum;
 		raw0sum = raw0sum + raw[bps << LP_AVG] - raw[0];
 		raw += bps;
-		bs->thresh += (int)(raw0 - tr) * (int)ABS((int)(raw0sum - raw0));
+		thresh += (int)(raw0 - tr) * (int)ABS((int)(raw0sum - raw0));
 
 		b = (raw0 >= tr);
 
@@ -361,6 +628,7 @@ low_pass_bit_slicer_Y8(vbi3_bit_slicer *bs,
 				c = c * 2 + b;
 				if ((c & bs->cri_mask) == bs->cri)
 				{
+					bs->thresh = thresh;
 					break;
 				}
 			}
@@ -370,8 +638,6 @@ low_pass_bit_slicer_Y8(vbi3_bit_slicer *bs,
 
 		if (0 == --i)
 		{
-			bs->thresh = thresh0;
-
 			if (unlikely(NULL != points))
 				*n_points = points - points_start;
 
@@ -0,0 +1,81 @@
+//! Micro-benchmarks for the byte-batch kernels in `lib_ccxr::util::bits`.
+//!
+//! Run with `cargo bench --bench bits`. Each kernel is compared against the per-byte table
+//! lookup it replaces, over a buffer of teletext-sized packets.
+
+use std::hint::black_box;
+use std::time::{Duration, Instant};
+
+use lib_ccxr::util::bits::*;
+
+const PACKET_SIZE: usize = 44;
+const PACKETS: usize = 16 * 1024;
+const ROUNDS: u32 = 50;
+
+fn bench(name: &str, data: &[u8], mut f: impl FnMut(&mut [u8])) -> Duration {
+    let mut buffer = data.to_vec();
+    let start = Instant::now();
+    for _ in 0..ROUNDS {
+        for packet in buffer.chunks_mut(PACKET_SIZE) {
+            f(black_box(packet));
+        }
+    }
+    let elapsed = start.elapsed();
+    let bytes = data.len() as f64 * ROUNDS as f64;
+    println!(
+        "{name:<40} {:>8.3} ms  {:>6.3} ns/byte",
+        elapsed.as_secs_f64() * 1e3,
+        elapsed.as_nanos() as f64 / bytes
+    );
+    elapsed
+}
+
+fn main() {
+    // Deterministic pseudo-random payload (xorshift), so runs are comparable
+    let mut state: u32 = 0x2545_f491;
+    let data: Vec<u8> = (0..PACKET_SIZE * PACKETS)
+        .map(|_| {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            state as u8
+        })
+        .collect();
+    let mut nibbles = vec![0u8; PACKET_SIZE];
+
+    bench("reverse: per-byte table", &data, |p| {
+        for b in p.iter_mut() {
+            *b = get_reverse_byte(*b);
+        }
+    });
+    bench("reverse: reverse_bytes", &data, reverse_bytes);
+
+    bench("hamming 8/4: per-byte decode", &data, |p| {
+        for (out, &b) in nibbles.iter_mut().zip(p.iter()) {
+            *out = decode_hamming_8_4(b).unwrap_or(0x0f);
+        }
+        black_box(&nibbles);
+    });
+    let mut nibbles = vec![0u8; PACKET_SIZE];
+    bench("hamming 8/4: decode_hamming_8_4_bytes", &data, |p| {
+        black_box(decode_hamming_8_4_bytes(p, &mut nibbles));
+    });
+
+    let triplets: Vec<u32> = data
+        .chunks_exact(3)
+        .map(|t| (t[2] as u32) << 16 | (t[1] as u32) << 8 | t[0] as u32)
+        .collect();
+    let start = Instant::now();
+    for _ in 0..ROUNDS {
+        for &t in &triplets {
+            black_box(decode_hamming_24_18(black_box(t)));
+        }
+    }
+    let elapsed = start.elapsed();
+    println!(
+        "{:<40} {:>8.3} ms  {:>6.3} ns/triplet",
+        "hamming 24/18: decode",
+        elapsed.as_secs_f64() * 1e3,
+        elapsed.as_nanos() as f64 / (triplets.len() as f64 * ROUNDS as f64)
+    );
+}
@@ -0,0 +1,97 @@
+//! Micro-benchmarks for `lib_ccxr::util::levenshtein`.
+//!
+//! Run with `cargo bench --bench levenshtein`. The bit-parallel distance is compared against
+//! the column-by-column dynamic programming it replaces, on teletext rows (as in `fuzzy_cmp`)
+//! and on sentence-sized byte strings (as in the sentence splitter).
+
+use std::hint::black_box;
+use std::time::{Duration, Instant};
+
+use lib_ccxr::util::levenshtein::*;
+
+const PAIRS: usize = 4096;
+const ROUNDS: u32 = 20;
+
+/// The previous implementation, kept here as the baseline.
+fn dynamic_programming<T: PartialEq>(a: &[T], b: &[T]) -> usize {
+    let mut column: Vec<usize> = (0..=a.len()).collect();
+    for x in 1..=b.len() {
+        column[0] = x;
+        let mut lastdiag = x - 1;
+        for y in 1..=a.len() {
+            let olddiag = column[y];
+            column[y] = (column[y] + 1)
+                .min(column[y - 1] + 1)
+                .min(lastdiag + (a[y - 1] != b[x - 1]) as usize);
+            lastdiag = olddiag;
+        }
+    }
+    column[a.len()]
+}
+
+fn bench<T>(name: &str, pairs: &[(Vec<T>, Vec<T>)], f: impl Fn(&[T], &[T]) -> usize) -> Duration {
+    let start = Instant::now();
+    for _ in 0..ROUNDS {
+        for (a, b) in pairs {
+            black_box(f(black_box(a), black_box(b)));
+        }
+    }
+    let elapsed = start.elapsed();
+    println!(
+        "{name:<40} {:>8.3} ms  {:>8.1} ns/pair",
+        elapsed.as_secs_f64() * 1e3,
+        elapsed.as_nanos() as f64 / (pairs.len() as f64 * ROUNDS as f64)
+    );
+    elapsed
+}
+
+/// Pairs of `len` symbols where the second one has up to `edits` random substitutions.
+fn pairs<T: Copy>(len: usize, edits: u32, alphabet: &[T]) -> Vec<(Vec<T>, Vec<T>)> {
+    // Deterministic pseudo-random data (xorshift), so runs are comparable
+    let mut state: u32 = 0x2545_f491;
+    let mut next = move |n: usize| {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        state as usize % n
+    };
+    (0..PAIRS)
+        .map(|_| {
+            let a: Vec<T> = (0..len).map(|_| alphabet[next(alphabet.len())]).collect();
+            let mut b = a.clone();
+            for _ in 0..next(edits as usize + 1) {
+                let pos = next(len);
+                b[pos] = alphabet[next(alphabet.len())];
+            }
+            (a, b)
+        })
+        .collect()
+}
+
+fn main() {
+    let letters: Vec<u16> = (b'a'..=b'z').chain([b' '; 6]).map(u16::from).collect();
+    let rows = pairs(40, 4, &letters);
+    bench(
+        "teletext row: dynamic programming",
+        &rows,
+        dynamic_programming,
+    );
+    bench("teletext row: levenshtein", &rows, levenshtein);
+    // fuzzy_cmp with the default 10% / 2 characters thresholds
+    bench("teletext row: levenshtein_bounded(3)", &rows, |a, b| {
+        levenshtein_bounded(a, b, 3).unwrap_or(4)
+    });
+
+    let bytes: Vec<u8> = (b'a'..=b'z').chain([b' '; 6]).collect();
+    let sentences = pairs(200, 30, &bytes);
+    bench(
+        "sentence: dynamic programming",
+        &sentences,
+        dynamic_programming,
+    );
+    bench("sentence: levenshtein", &sentences, levenshtein);
+    // The sentence splitter accepts up to one error per five characters
+    bench("sentence: levenshtein_bounded(40)", &sentences, |a, b| {
+        levenshtein_bounded(a, b, 40).unwrap_or(41)
+    });
+}
@@ -3,6 +3,8 @@ use std::ffi::OsStr;
 use strum_macros::{EnumString, FromRepr};
 
 pub const DTVCC_MAX_SERVICES: usize = 63;
+/// How many formats `--also-out` can add to `--out`
+pub const MAX_EXTRA_OUTPUTS: usize = 8;
 
 /// An enum of all the available formats for the subtitle output.
 #[derive(Default, Copy, Clone, Debug, PartialEq, Eq)]
@@ -258,6 +258,8 @@ impl Default for EncoderConfig {
             services_enabled: [false; DTVCC_MAX_SERVICES],
             services_charsets: DtvccServiceCharset::None,
             extract_only_708: false,
+            extra_write_formats: Vec::new(),
+            threaded_outputs: false,
         }
     }
 }
@@ -345,6 +347,11 @@ pub struct EncoderConfig {
     pub services_charsets: DtvccServiceCharset,
     // true if only 708 subs extraction is enabled
     pub extract_only_708: bool,
+
+    /// Formats also written from the same decoding pass (--also-out)
+    pub extra_write_formats: Vec<OutputFormat>,
+    /// true to give each of the extra outputs its own thread
+    pub threaded_outputs: bool,
 }
 
 /// Options from user parameters
@@ -468,6 +475,14 @@ pub struct Options {
     pub ocr_blacklist: bool,
     /// The name of the language stream for MKV
     pub mkvlang: Option<Language>,
+    /// How many MKV subtitle tracks are written at the same time
+    pub mkv_threads: u32,
+    /// How many threads compress and write SPUPNG images
+    pub png_threads: u32,
+    /// zlib level of SPUPNG images, -1 for libpng's default
+    pub png_compression_level: i32,
+    /// libpng PNG_FILTER_* mask for SPUPNG images, 0 for libpng's default
+    pub png_filters: i32,
     /// If true, the video stream will be processed even if we're using a different one for subtitles.
     pub analyze_video_stream: bool,
 
@@ -478,6 +493,8 @@ pub struct Options {
     pub hardsubx_conf_thresh: f64,
     pub hardsubx_hue: ColorHue,
     pub hardsubx_lum_thresh: f64,
+    /// Height of the subtitle band at the bottom of the frame, in percent of the frame height.
+    pub hardsubx_band_height: f64,
 
     /// Keeps the settings for generating transcript output files.
     pub transcript_settings: EncodersTranscriptFormat,
@@ -519,6 +536,12 @@ pub struct Options {
     /// Sometimes this parameter is required for DVB subs with > 30s pause time
     pub ignore_pts_jumps: bool,
     pub multiprogram: bool,
+    /// Process every input file as an independent job (--batch)
+    pub batch_mode: bool,
+    /// Jobs to run at the same time in batch mode, 0 for one per processor
+    pub batch_jobs: i32,
+    /// File to write the JSON report of a batch to
+    pub batch_report: Option<String>,
     pub out_interval: i32,
     pub segment_on_key_frames_only: bool,
     /// SCC input framerate: 0=29.97 (default), 1=24, 2=25, 3=30
@@ -591,6 +614,10 @@ impl Default for Options {
             ocr_line_split: false, // Don't split images into lines by default
             ocr_blacklist: true, // Use character blacklist by default to prevent | vs I errors
             mkvlang: Default::default(),
+            mkv_threads: 1,
+            png_threads: 1,
+            png_compression_level: -1,
+            png_filters: 0,
             analyze_video_stream: Default::default(),
             hardsubx_ocr_mode: Default::default(),
             hardsubx_min_sub_duration: Timestamp::from_millis(500),
@@ -598,6 +625,7 @@ impl Default for Options {
             hardsubx_conf_thresh: Default::default(),
             hardsubx_hue: Default::default(),
             hardsubx_lum_thresh: 95.0,
+            hardsubx_band_height: 25.0,
             transcript_settings: Default::default(),
             date_format: Default::default(),
             send_to_srv: Default::default(),
@@ -624,6 +652,9 @@ impl Default for Options {
             pes_header_to_stdout: Default::default(),
             ignore_pts_jumps: Default::default(),
             multiprogram: Default::default(),
+            batch_mode: Default::default(),
+            batch_jobs: 0,
+            batch_report: Default::default(),
             out_interval: -1,
             segment_on_key_frames_only: Default::default(),
             scc_framerate: 0, // 0 = 29.97fps (default)
@@ -40,10 +40,12 @@ use std::sync::RwLock;
 use crate::common::OutputFormat;
 use crate::subtitle::Subtitle;
 use crate::time::units::{Timestamp, TimestampFormat};
-use crate::util::bits::{decode_hamming_24_18, decode_hamming_8_4, get_parity};
-use crate::util::encoders_helper::telx_correct_case;
+use crate::util::bits::{
+    decode_hamming_24_18, decode_hamming_8_4, decode_hamming_8_4_bytes, get_parity,
+};
+use crate::util::encoders_helper::{telx_correct_case, WordMatcher};
 use crate::util::encoding::{Ucs2Char, Ucs2String};
-use crate::util::levenshtein::levenshtein;
+use crate::util::levenshtein::levenshtein_bounded;
 use crate::util::log::{debug, info, logger, DebugMessageFlag};
 
 /// UTC referential value.
@@ -721,6 +723,31 @@ pub struct TeletextPage {
     tainted: bool,                     // true = text variable contains any data
 }
 
+impl TeletextPage {
+    fn new() -> TeletextPage {
+        TeletextPage {
+            show_timestamp: Timestamp::from_millis(0),
+            hide_timestamp: Timestamp::from_millis(0),
+            text: [[0; 40]; 25],
+            g2_char_present: [[false; 40]; 25],
+            tainted: false,
+        }
+    }
+}
+
+/// Number of magazines in a teletext service. Magazine 8 is transmitted with address 0.
+const TELETEXT_MAGAZINES: usize = 8;
+
+/// Reception state of one magazine.
+///
+/// In parallel transmission mode each magazine carries its own page, terminated only by the next
+/// header in the same magazine (ETS 300 706, chapter 7.2.1).
+struct TeletextMagazine {
+    page_number: TeletextPageNumber, // page being received in this magazine (0 = none yet)
+    receiving_data: bool, // flag indicating if incoming data should be processed or ignored
+    page_buffer: TeletextPage, // current page content being received
+}
+
 /// Maximum number of teletext pages to extract simultaneously (must match C MAX_TLT_PAGES_EXTRACT)
 pub const MAX_TLT_PAGES_EXTRACT: usize = 8;
 
@@ -810,9 +837,10 @@ pub struct TeletextContext<'a> {
     seen_sub_page: [bool; MAX_TLT_PAGES],
     global_timestamp: Timestamp,
 
+    // Pages being received, indexed by magazine - 1
+    magazines: [TeletextMagazine; TELETEXT_MAGAZINES],
     // Current and previous page buffers. This is the output written to file when
     // the time comes.
-    page_buffer: TeletextPage,
     page_buffer_prev: Option<String>,
     page_buffer_cur: Option<String>,
     // Current and previous page compare strings. This is plain text (no colors,
@@ -831,8 +859,6 @@ pub struct TeletextContext<'a> {
     tlt_packet_counter: u32,
     // teletext transmission mode
     transmission_mode: TransmissionMode,
-    // flag indicating if incoming data should be processed or ignored
-    receiving_data: bool,
 
     using_pts: Option<bool>,
     delta: Timestamp,
@@ -853,13 +879,11 @@ impl<'a> TeletextContext<'a> {
             config,
             seen_sub_page: [false; MAX_TLT_PAGES],
             global_timestamp: Timestamp::from_millis(0),
-            page_buffer: TeletextPage {
-                show_timestamp: Timestamp::from_millis(0),
-                hide_timestamp: Timestamp::from_millis(0),
-                text: [[0; 40]; 25],
-                g2_char_present: [[false; 40]; 25],
-                tainted: false,
-            },
+            magazines: std::array::from_fn(|_| TeletextMagazine {
+                page_number: 0.into(),
+                receiving_data: false,
+                page_buffer: TeletextPage::new(),
+            }),
             page_buffer_prev: None,
             page_buffer_cur: None,
             ucs2_buffer_prev: None,
@@ -874,7 +898,6 @@ impl<'a> TeletextContext<'a> {
             },
             tlt_packet_counter: 0,
             transmission_mode: TransmissionMode::Serial,
-            receiving_data: false,
             using_pts: None,
             delta: Timestamp::from_millis(0),
             t0: Timestamp::from_millis(0),
@@ -889,7 +912,7 @@ impl<'a> TeletextContext<'a> {
     ///
     /// This method will convert the first character of a sentence to uppercase and the rest of the
     /// characters to lowercase.
-    fn telx_case_fix(&mut self, capitalization_list: &[String]) {
+    fn telx_case_fix(&mut self, capitalization: &WordMatcher) {
         let page_buffer_cur = match self.page_buffer_cur.as_mut() {
             None => return,
             Some(p) => p,
@@ -926,7 +949,7 @@ impl<'a> TeletextContext<'a> {
 
         *page_buffer_cur = fixed_string;
 
-        telx_correct_case(page_buffer_cur, capitalization_list);
+        telx_correct_case(page_buffer_cur, capitalization);
     }
 
     /// Reset the page buffers and return its contents in the form of a [`Subtitle`].
@@ -948,27 +971,31 @@ impl<'a> TeletextContext<'a> {
         ))
     }
 
-    fn process_page(&mut self, capitalization_list: &[String]) -> Option<Subtitle> {
+    fn process_page(
+        &mut self,
+        page: &mut TeletextPage,
+        capitalization: &WordMatcher,
+    ) -> Option<Subtitle> {
         let mut ans = None;
 
         if self
             .config
             .extraction_start
-            .map(|start| self.page_buffer.hide_timestamp < start)
+            .map(|start| page.hide_timestamp < start)
             .unwrap_or(false)
             || self
                 .config
                 .extraction_end
-                .map(|end| self.page_buffer.show_timestamp > end)
+                .map(|end| page.show_timestamp > end)
                 .unwrap_or(false)
-            || self.page_buffer.hide_timestamp.millis() == 0
+            || page.hide_timestamp.millis() == 0
         {
             return None;
         }
 
         #[cfg(feature = "debug")]
         {
-            for (index, row) in self.page_buffer.text.iter().enumerate().skip(1) {
+            for (index, row) in page.text.iter().enumerate().skip(1) {
                 print!("DEBUG[{index:02}]: ");
                 for c in row {
                     print!("{c:3x} ")
@@ -982,7 +1009,7 @@ impl<'a> TeletextContext<'a> {
         let mut page_is_empty = true;
         for col in 0..40 {
             for row in 1..25 {
-                if self.page_buffer.text[row][col] == 0x0b {
+                if page.text[row][col] == 0x0b {
                     page_is_empty = false;
                     break;
                 }
@@ -997,19 +1024,17 @@ impl<'a> TeletextContext<'a> {
             return None;
         }
 
-        if self.page_buffer.show_timestamp > self.page_buffer.hide_timestamp {
-            self.page_buffer.hide_timestamp = self.page_buffer.show_timestamp;
+        if page.show_timestamp > page.hide_timestamp {
+            page.hide_timestamp = page.show_timestamp;
         }
 
         let mut line_count: u8 = 0;
         let mut time_reported = false;
-        let timecode_show = self
-            .page_buffer
+        let timecode_show = page
             .show_timestamp
             .to_srt_time()
             .expect("could not format to SRT time");
-        let timecode_hide = self
-            .page_buffer
+        let timecode_hide = page
             .hide_timestamp
             .to_srt_time()
             .expect("could not format to SRT time");
@@ -1024,24 +1049,24 @@ impl<'a> TeletextContext<'a> {
                 // replace all 0/B and 0/A characters with 0/20, as specified in ETS 300 706:
                 // Unless operating in "Hold Mosaics" mode, each character space occupied by a
                 // spacing attribute is displayed as a SPACE
-                if self.page_buffer.text[row][col] == 0x0b {
+                if page.text[row][col] == 0x0b {
                     // open the box
                     if col_start == 40 {
                         col_start = col;
                         line_count += 1;
                     } else {
-                        self.page_buffer.text[row][col] = 0x20;
+                        page.text[row][col] = 0x20;
                     }
                     box_open = true;
-                } else if self.page_buffer.text[row][col] == 0xa {
+                } else if page.text[row][col] == 0xa {
                     // close the box
-                    self.page_buffer.text[row][col] = 0x20;
+                    page.text[row][col] = 0x20;
                     box_open = false;
                 }
                 // characters between 0xA and 0xB shouldn't be displayed
                 // page->text[row][col] > 0x20 added to preserve color information
-                else if !box_open && col_start < 40 && self.page_buffer.text[row][col] > 0x20 {
-                    self.page_buffer.text[row][col] = 0x20;
+                else if !box_open && col_start < 40 && page.text[row][col] > 0x20 {
+                    page.text[row][col] = 0x20;
                 }
             }
             // line is empty
@@ -1086,7 +1111,7 @@ impl<'a> TeletextContext<'a> {
 
             for col in 0..=col_stop {
                 // v is just a shortcut
-                let mut v = self.page_buffer.text[row][col];
+                let mut v = page.text[row][col];
 
                 if col < col_start && v <= 0x7 {
                     foreground_color = v as u8;
@@ -1177,7 +1202,7 @@ impl<'a> TeletextContext<'a> {
         }
 
         if self.sentence_cap {
-            self.telx_case_fix(capitalization_list)
+            self.telx_case_fix(capitalization)
         }
 
         match self.config.write_format {
@@ -1185,7 +1210,7 @@ impl<'a> TeletextContext<'a> {
                 let page_buffer_prev_len =
                     self.page_buffer_prev.as_ref().map(|s| s.len()).unwrap_or(0);
                 if page_buffer_prev_len == 0 {
-                    self.prev_show_timestamp = self.page_buffer.show_timestamp;
+                    self.prev_show_timestamp = page.show_timestamp;
                 }
 
                 let page_buffer_prev = self.page_buffer_prev.as_deref().unwrap_or("");
@@ -1216,19 +1241,19 @@ impl<'a> TeletextContext<'a> {
                     // current page and do nothing. Wait until we see more.
                     self.page_buffer_prev = self.page_buffer_cur.take();
                     self.ucs2_buffer_prev = self.ucs2_buffer_cur.take();
-                    self.prev_hide_timestamp = self.page_buffer.hide_timestamp;
+                    self.prev_hide_timestamp = page.hide_timestamp;
                 } else {
                     // OK, the old and new buffer don't match. So write the old
                     ans = self.telxcc_dump_prev_page();
-                    self.prev_hide_timestamp = self.page_buffer.hide_timestamp;
-                    self.prev_show_timestamp = self.page_buffer.show_timestamp;
+                    self.prev_hide_timestamp = page.hide_timestamp;
+                    self.prev_show_timestamp = page.show_timestamp;
                 }
             }
             _ => {
                 ans = Some(Subtitle::new_text(
                     self.page_buffer_cur.take().unwrap().into(),
-                    self.page_buffer.show_timestamp,
-                    self.page_buffer.hide_timestamp + Timestamp::from_millis(1),
+                    page.show_timestamp,
+                    page.hide_timestamp + Timestamp::from_millis(1),
                     None,
                     "TLT".into(),
                 ));
@@ -1241,6 +1266,34 @@ impl<'a> TeletextContext<'a> {
         ans
     }
 
+    /// Outputs the page pending in the magazine at `index`, hiding it at `hide_timestamp`.
+    fn flush_magazine(
+        &mut self,
+        index: usize,
+        hide_timestamp: Timestamp,
+        capitalization: &WordMatcher,
+    ) -> Option<Subtitle> {
+        let mut page =
+            std::mem::replace(&mut self.magazines[index].page_buffer, TeletextPage::new());
+
+        // Convert telx to UCS-2 before processing
+        for yt in 1..=23 {
+            for it in 0..40 {
+                if page.text[yt][it] != 0x00 && !page.g2_char_present[yt][it] {
+                    page.text[yt][it] = self
+                        .g0_charset
+                        .ucs2_char(page.text[yt][it].try_into().unwrap());
+                }
+            }
+        }
+        page.hide_timestamp = hide_timestamp;
+        let sub = self.process_page(&mut page, capitalization);
+
+        page.tainted = false;
+        self.magazines[index].page_buffer = page;
+        sub
+    }
+
     /// Process the teletext `packet` and append the extracted subtitles in `subtitles`.
     pub fn process_telx_packet(
         &mut self,
@@ -1248,35 +1301,44 @@ impl<'a> TeletextContext<'a> {
         packet: &TeletextPacketPayload,
         timestamp: Timestamp,
         subtitles: &mut Vec<Subtitle>,
-        capitalization_list: &[String],
+        capitalization: &WordMatcher,
     ) {
         // variable names conform to ETS 300 706, chapter 7.1.2
-        let address = (decode_hamming_8_4(packet.address[1]).unwrap() << 4)
-            | decode_hamming_8_4(packet.address[0]).unwrap();
+        // Bytes that cannot be corrected decode to 0x0f, as unham_8_4() does in telxcc.c
+        let mut address_nibbles = [0; 2];
+        decode_hamming_8_4_bytes(&packet.address, &mut address_nibbles);
+        let address = (address_nibbles[1] << 4) | address_nibbles[0];
         let mut m = address & 0x7;
         if m == 0 {
             m = 8;
         }
         let y = (address >> 3) & 0x1f;
         let designation_code = if y > 25 {
-            decode_hamming_8_4(packet.data[0]).unwrap()
+            decode_hamming_8_4(packet.data[0]).unwrap_or(0x0f)
         } else {
             0x00
         };
 
+        let mi = m as usize - 1;
+
         if y == 0 {
+            // ETS 300 706, chapter 9.3.1: page address, subcode and control bits, all Hamming 8/4
+            let mut header = [0; 8];
+            decode_hamming_8_4_bytes(&packet.data[..8], &mut header);
+            let page_units = header[0];
+            let page_tens = header[1];
+            let control_c4_c6 = header[5];
+            let control_c11_c14 = header[7];
+
             // CC map
-            let i = (decode_hamming_8_4(packet.data[1]).unwrap() << 4)
-                | decode_hamming_8_4(packet.data[0]).unwrap();
-            let flag_subtitle = (decode_hamming_8_4(packet.data[5]).unwrap() & 0x08) >> 3;
+            let i = (page_tens << 4) | page_units;
+            let flag_subtitle = (control_c4_c6 & 0x08) >> 3;
             self.cc_map[i as usize] |= flag_subtitle << (m - 1);
 
             let flag_subtitle = flag_subtitle != 0;
 
             if flag_subtitle && (i < 0xff) {
-                let mut thisp = ((m as u32) << 8)
-                    | ((decode_hamming_8_4(packet.data[1]).unwrap() as u32) << 4)
-                    | (decode_hamming_8_4(packet.data[0]).unwrap() as u32);
+                let mut thisp = ((m as u32) << 8) | (i as u32);
                 let t1 = format!("{thisp:x}"); // Example: 1928 -> 788
                 thisp = t1.parse().unwrap();
                 if !self.seen_sub_page[thisp as usize] {
@@ -1288,26 +1350,17 @@ impl<'a> TeletextContext<'a> {
                 }
             }
             if (self.config.page.get() == 0.into()) && flag_subtitle && (i < 0xff) {
-                self.config.page.replace(
-                    (((m as u16) << 8)
-                        | ((decode_hamming_8_4(packet.data[1]).unwrap() as u16) << 4)
-                        | (decode_hamming_8_4(packet.data[0]).unwrap() as u16))
-                        .into(),
-                );
+                self.config
+                    .page
+                    .replace((((m as u16) << 8) | (i as u16)).into());
                 info!("- No teletext page specified, first received suitable page is {}, not guaranteed\n", self.config.page.get());
             }
 
             // Page number and control bits
-            let page_number: TeletextPageNumber = (((m as u16) << 8)
-                | ((decode_hamming_8_4(packet.data[1]).unwrap() as u16) << 4)
-                | (decode_hamming_8_4(packet.data[0]).unwrap() as u16))
-                .into();
-            let charset = ((decode_hamming_8_4(packet.data[7]).unwrap() & 0x08)
-                | (decode_hamming_8_4(packet.data[7]).unwrap() & 0x04)
-                | (decode_hamming_8_4(packet.data[7]).unwrap() & 0x02))
-                >> 1;
-            // let flag_suppress_header = decode_hamming_8_4(packet.data[6]).unwrap() & 0x01;
-            // let flag_inhibit_display = (decode_hamming_8_4(packet.data[6]).unwrap() & 0x08) >> 3;
+            let page_number: TeletextPageNumber = (((m as u16) << 8) | (i as u16)).into();
+            let charset = (control_c11_c14 & 0x0e) >> 1;
+            // let flag_suppress_header = header[6] & 0x01;
+            // let flag_inhibit_display = (header[6] & 0x08) >> 3;
 
             // ETS 300 706, chapter 9.3.1.3:
             // When set to '1' the service is designated to be in Serial mode and the transmission of a page is terminated
@@ -1317,7 +1370,7 @@ impl<'a> TeletextContext<'a> {
             // The same setting shall be used for all page headers in the service.
             // ETS 300 706, chapter 7.2.1: Page is terminated by and excludes the next page header packet
             // having the same magazine address in parallel transmission mode, or any magazine address in serial transmission mode.
-            self.transmission_mode = if decode_hamming_8_4(packet.data[7]).unwrap() & 0x01 == 0 {
+            self.transmission_mode = if control_c11_c14 & 0x01 == 0 {
                 TransmissionMode::Parallel
             } else {
                 TransmissionMode::Serial
@@ -1326,62 +1379,59 @@ impl<'a> TeletextContext<'a> {
             // FIXME: Well, this is not ETS 300 706 kosher, however we are interested in EBU_TELETEXT_SUBTITLE only
             if (self.transmission_mode == TransmissionMode::Parallel)
                 && (data_unit != DataUnit::EbuTeletextSubtitle)
-                && !(self.de_ctr != 0 && flag_subtitle && self.receiving_data)
+                && !(self.de_ctr != 0 && flag_subtitle && self.magazines[mi].receiving_data)
             {
                 return;
             }
 
-            if self.receiving_data
-                && (((self.transmission_mode == TransmissionMode::Serial)
-                    && (page_number.page() != self.config.page.get().page()))
-                    || ((self.transmission_mode == TransmissionMode::Parallel)
-                        && (page_number.page() != self.config.page.get().page())
-                        && (m == self.config.page.get().magazine())))
-            {
-                self.receiving_data = false;
-                if !(self.de_ctr != 0 && flag_subtitle) {
-                    return;
+            // In serial mode any header terminates the page of every magazine, in parallel mode only its own one
+            let mut terminated = false;
+            for (j, magazine) in self.magazines.iter_mut().enumerate() {
+                if j != mi && self.transmission_mode != TransmissionMode::Serial {
+                    continue;
+                }
+                if magazine.receiving_data && page_number.page() != magazine.page_number.page() {
+                    magazine.receiving_data = false;
+                    terminated = true;
                 }
             }
+            if terminated && !(self.de_ctr != 0 && flag_subtitle) {
+                return;
+            }
 
             // Page transmission is terminated, however now we are waiting for our new page
-            if page_number != self.config.page.get()
-                && !(self.de_ctr != 0 && flag_subtitle && self.receiving_data)
+            let accept_this_page = page_number == self.config.page.get();
+            if !accept_this_page
+                && !(self.de_ctr != 0 && flag_subtitle && self.magazines[mi].receiving_data)
             {
                 return;
             }
 
-            // Now we have the begining of page transmission; if there is page_buffer pending, process it
-            if self.page_buffer.tainted {
-                // Convert telx to UCS-2 before processing
-                for yt in 1..=23 {
-                    for it in 0..40 {
-                        if self.page_buffer.text[yt][it] != 0x00
-                            && !self.page_buffer.g2_char_present[yt][it]
-                        {
-                            self.page_buffer.text[yt][it] = self
-                                .g0_charset
-                                .ucs2_char(self.page_buffer.text[yt][it].try_into().unwrap());
-                        }
+            // Now we have the begining of page transmission; if there is page_buffer pending in this
+            // magazine, or a terminated one in any other magazine, process it.
+            // It would be nice, if subtitle hides on previous video frame, so we contract 40 ms (1 frame @25 fps)
+            let mut hide_timestamp = timestamp - Timestamp::from_millis(40);
+            if hide_timestamp > timestamp {
+                hide_timestamp = Timestamp::from_millis(0);
+            }
+            for j in 0..TELETEXT_MAGAZINES {
+                let pending = &self.magazines[j];
+                if pending.page_buffer.tainted && (j == mi || !pending.receiving_data) {
+                    if let Some(sub) = self.flush_magazine(j, hide_timestamp, capitalization) {
+                        subtitles.push(sub);
                     }
+                    self.de_ctr = 0;
                 }
-                // it would be nice, if subtitle hides on previous video frame, so we contract 40 ms (1 frame @25 fps)
-                self.page_buffer.hide_timestamp = timestamp - Timestamp::from_millis(40);
-                if self.page_buffer.hide_timestamp > timestamp {
-                    self.page_buffer.hide_timestamp = Timestamp::from_millis(0);
-                }
-                if let Some(sub) = self.process_page(capitalization_list) {
-                    subtitles.push(sub);
-                }
-                self.de_ctr = 0;
             }
 
-            self.page_buffer.show_timestamp = timestamp;
-            self.page_buffer.hide_timestamp = Timestamp::from_millis(0);
-            self.page_buffer.text = [[0; 40]; 25];
-            self.page_buffer.g2_char_present = [[false; 40]; 25];
-            self.page_buffer.tainted = false;
-            self.receiving_data = false;
+            let magazine = &mut self.magazines[mi];
+            if accept_this_page {
+                magazine.page_number = page_number;
+            }
+            magazine.page_buffer = TeletextPage::new();
+            magazine.page_buffer.show_timestamp = timestamp;
+            // Rows 1-23 of the page follow, as telxcc.c sets receiving_data = YES here
+            magazine.receiving_data = true;
             if self.g0_charset.charset_type == G0CharsetType::Latin {
                 // G0 Character National Option Sub-sets selection required only for Latin Character Sets
                 self.g0_charset.remove_g0_x28_latin_subset(charset.into())
@@ -1394,23 +1444,20 @@ impl<'a> TeletextContext<'a> {
                 //page_buffer.tainted = YES;
             }
             */
-        } else if (m == self.config.page.get().magazine())
-            && (1..=23).contains(&y)
-            && self.receiving_data
-        {
+        } else if (1..=23).contains(&y) && self.magazines[mi].receiving_data {
             // ETS 300 706, chapter 9.4.1: Packets X/26 at presentation Levels 1.5, 2.5, 3.5 are used for addressing
             // a character location and overwriting the existing character defined on the Level 1 page
             // ETS 300 706, annex B.2.2: Packets with Y = 26 shall be transmitted before any packets with Y = 1 to Y = 25;
             // so page_buffer.text[y][i] may already contain any character received
             // in frame number 26, skip original G0 character
             for i in 0..40 {
-                if self.page_buffer.text[y as usize][i] == 0x00 {
-                    self.page_buffer.text[y as usize][i] = packet.data[i] as Ucs2Char;
+                if self.magazines[mi].page_buffer.text[y as usize][i] == 0x00 {
+                    self.magazines[mi].page_buffer.text[y as usize][i] = packet.data[i] as Ucs2Char;
                 }
             }
-            self.page_buffer.tainted = true;
+            self.magazines[mi].page_buffer.tainted = true;
             self.de_ctr -= 1;
-        } else if (m == self.config.page.get().magazine()) && (y == 26) && self.receiving_data {
+        } else if (y == 26) && self.magazines[mi].receiving_data {
             // ETS 300 706, chapter 12.3.2: X/26 definition
             let mut x26_row: u8 = 0;
 
@@ -1451,38 +1498,40 @@ impl<'a> TeletextContext<'a> {
 
                 // ETS 300 706, chapter 12.3.1, table 27: character from G2 set
                 if (mode == 0x0f) && !row_address_group && data > 31 {
-                    self.page_buffer.text[x26_row as usize][address as usize] =
+                    self.magazines[mi].page_buffer.text[x26_row as usize][address as usize] =
                         G2Charset::G2_CHARSET[0][data as usize - 0x20];
-                    self.page_buffer.g2_char_present[x26_row as usize][address as usize] = true;
+                    self.magazines[mi].page_buffer.g2_char_present[x26_row as usize]
+                        [address as usize] = true;
                 }
 
                 // ETS 300 706 v1.2.1, chapter 12.3.4, Table 29: G0 character without diacritical mark (display '@' instead of '*')
                 if (mode == 0x10) && !row_address_group && data == 64 {
                     // check for @ symbol
                     self.g0_charset.remap_g0_charset(0.into());
-                    self.page_buffer.text[x26_row as usize][address as usize] = 0x40;
+                    self.magazines[mi].page_buffer.text[x26_row as usize][address as usize] = 0x40;
                 }
 
                 // ETS 300 706, chapter 12.3.1, table 27: G0 character with diacritical mark
                 if (0x11..=0x1f).contains(&mode) && !row_address_group {
                     // A - Z
                     if (65..=90).contains(&data) {
-                        self.page_buffer.text[x26_row as usize][address as usize] =
+                        self.magazines[mi].page_buffer.text[x26_row as usize][address as usize] =
                             G2Charset::G2_ACCENTS[mode as usize - 0x11][data as usize - 65];
                     }
                     // a - z
                     else if (97..=122).contains(&data) {
-                        self.page_buffer.text[x26_row as usize][address as usize] =
+                        self.magazines[mi].page_buffer.text[x26_row as usize][address as usize] =
                             G2Charset::G2_ACCENTS[mode as usize - 0x11][data as usize - 71];
                     // other
                     } else {
-                        self.page_buffer.text[x26_row as usize][address as usize] =
+                        self.magazines[mi].page_buffer.text[x26_row as usize][address as usize] =
                             self.g0_charset.ucs2_char(data);
                     }
-                    self.page_buffer.g2_char_present[x26_row as usize][address as usize] = true;
+                    self.magazines[mi].page_buffer.g2_char_present[x26_row as usize]
+                        [address as usize] = true;
                 }
             }
-        } else if (m == self.config.page.get().magazine()) && (y == 28) && self.receiving_data {
+        } else if (y == 28) && self.magazines[mi].receiving_data {
             // TODO:
             //   ETS 300 706, chapter 9.4.7: Packet X/28/4
             //   Where packets 28/0 and 28/4 are both transmitted as part of a page, packet 28/0 takes precedence over 28/4 for all but the colour map entry coding.
@@ -1507,7 +1556,10 @@ impl<'a> TeletextContext<'a> {
                     debug!(msg_type = DebugMessageFlag::TELETEXT; "! Unrecoverable data error; UNHAM24/18()={:04x}\n", 0xffffffffu32);
                 }
             }
-        } else if (m == self.config.page.get().magazine()) && (y == 29) {
+        } else if ((m == self.config.page.get().magazine())
+            || (self.magazines[mi].page_number != 0.into()))
+            && (y == 29)
+        {
             // TODO:
             //   ETS 300 706, chapter 9.5.1 Packet M/29/0
             //   Where M/29/0 and M/29/4 are transmitted for the same magazine, M/29/0 takes precedence over M/29/4.
@@ -1601,7 +1653,7 @@ impl<'a> TeletextContext<'a> {
     }
 
     /// Consumes the [`TeletextContext`] and appends the pending extracted subtitles in `subtitles`.
-    pub fn close(mut self, subtitles: Option<&mut Vec<Subtitle>>, capitalization_list: &[String]) {
+    pub fn close(mut self, subtitles: Option<&mut Vec<Subtitle>>, capitalization: &WordMatcher) {
         info!(
             "\nTeletext decoder: {} packets processed \n",
             self.tlt_packet_counter
@@ -1609,24 +1661,14 @@ impl<'a> TeletextContext<'a> {
         if self.config.write_format != OutputFormat::Rcwt {
             if let Some(subtitles) = subtitles {
                 // output any pending close caption
-                if self.page_buffer.tainted {
-                    // Convert telx to UCS-2 before processing
-                    for yt in 1..=23 {
-                        for it in 0..40 {
-                            if self.page_buffer.text[yt][it] != 0x00
-                                && !self.page_buffer.g2_char_present[yt][it]
-                            {
-                                self.page_buffer.text[yt][it] = self
-                                    .g0_charset
-                                    .ucs2_char(self.page_buffer.text[yt][it].try_into().unwrap());
-                            }
+                for j in 0..TELETEXT_MAGAZINES {
+                    if self.magazines[j].page_buffer.tainted {
+                        // this time we do not subtract any frames, there will be no more frames
+                        let hide_timestamp = self.last_timestamp;
+                        if let Some(sub) = self.flush_magazine(j, hide_timestamp, capitalization) {
+                            subtitles.push(sub);
                         }
                     }
-                    // this time we do not subtract any frames, there will be no more frames
-                    self.page_buffer.hide_timestamp = self.last_timestamp;
-                    if let Some(sub) = self.process_page(capitalization_list) {
-                        subtitles.push(sub);
-                    }
                 }
 
                 self.telxcc_dump_prev_page();
@@ -1679,8 +1721,12 @@ pub fn fuzzy_cmp(
     );
 
     // For the second string, only take the first chars (up to the first string length, that's short_len).
-    let l = levenshtein(ucs2_buf1, &ucs2_buf2[..short_len]);
-    let is_same = l < max;
+    // Distances of max or more all mean a mismatch, so they are not computed exactly and shown as max.
+    let l = max
+        .checked_sub(1)
+        .and_then(|bound| levenshtein_bounded(ucs2_buf1, &ucs2_buf2[..short_len], bound));
+    let is_same = l.is_some();
+    let l = l.unwrap_or(max);
     debug!(msg_type = DebugMessageFlag::LEVENSHTEIN; "\rLEV | {} | {} | Max: {} | Calc: {} | Match: {}\n", c1, c2, max, l, is_same);
     is_same
 }
@@ -35,7 +35,12 @@
 //! | `print_debug_timing`                      | [`TimingContext::print_debug_timing`]                 |
 //! | `gop_accepted`                            | [`GopTimeCode::did_rollover`] + some additional logic |
 //! | `calculate_ms_gop_time`                   | [`GopTimeCode::new`], [`GopTimeCode::timestamp`]      |
-//! | `cb_708`, `cb_field1`, `cb_field2`, `pts_big_change`, `current_fps`, `frames_since_ref_time`, `total_frames_count`, `gop_time`, `first_gop_time`, `fts_at_gop_start`, `gop_rollover`, `ccx_common_timing_settings` | [`GlobalTimingInfo`], [`GLOBAL_TIMING_INFO`]          |
+//! | `ccx_common_timing_ctx.cb_708`, `cb_field1`, `cb_field2`, `pts_big_change`, `current_fps`, `frames_since_ref_time`, `total_frames_count`, `gop_time`, `first_gop_time`, `fts_at_gop_start`, `gop_rollover`, `ccx_common_timing_settings` | [`GlobalTimingInfo`], [`GLOBAL_TIMING_INFO`]          |
+//!
+//! The fields of `ccx_common_timing_ctx` listed in the last row belong to one context in C. The
+//! exports in the main crate copy them into [`GLOBAL_TIMING_INFO`] before each call and back
+//! afterwards, one call at a time, so contexts of extractions running on different threads
+//! don't mix.
 
 pub mod c_functions;
 pub mod timing;
@@ -5,6 +5,7 @@
 //! - [`get_reverse_byte`]: Reverse the bits in an 8-bit value.
 //! - [`decode_hamming_8_4`]: Decode a Hamming(8,4) encoded byte.
 //! - [`decode_hamming_24_18`]: Decode a Hamming(24,18) encoded value.
+//! - [`reverse_bytes`], [`decode_hamming_8_4_bytes`]: The same operations over a whole packet.
 //!
 //! # Conversion Guide
 //!
@@ -16,6 +17,8 @@
 //! | `unham_24_18`                              | [`decode_hamming_24_18`]       |
 //! | `crc32_table`                              | [`get_crc32_byte`]             |
 //! | `verify_crc32`                             | [`verify_crc32`]               |
+//! | `REVERSE_8` loop over a teletext packet    | [`reverse_bytes`]              |
+//! | `unham_8_4` on several packet bytes        | [`decode_hamming_8_4_bytes`]   |
 
 /// Equivalent to `PARITY_8[256]` const in `hamming.h` C code.
 /// Instead use [`get_parity`] function to get parity bit based on your input.
@@ -83,6 +86,39 @@ const HAMMING_8_4_DECODER_TABLE: [u8; 256] = [
     0x08, 0xff, 0xff, 0x05, 0xff, 0x0e, 0x0d, 0xff, 0xff, 0x0e, 0x0f, 0xff, 0x0e, 0x0e, 0xff, 0x0e,
 ];
 
+/// Equivalent to `UNHAM_24_18_PAR[3][256]` const in `hamming.h` C code.
+/// Holds the Hamming 24/18 test results A-F of one byte of the triplet, so that the
+/// tests of a whole triplet are three lookups instead of a loop over 24 bits.
+const HAMMING_24_18_TEST_TABLE: [[u8; 256]; 3] = build_hamming_24_18_test_table();
+
+const fn build_hamming_24_18_test_table() -> [[u8; 256]; 3] {
+    let mut table = [[0u8; 256]; 3];
+    let mut byte = 0;
+    while byte < 3 {
+        let mut value = 0;
+        while value < 256 {
+            let mut test = 0u8;
+            let mut bit = 0;
+            while bit < 8 {
+                let position = byte * 8 + bit;
+                if (value >> bit) & 0x01 == 1 {
+                    // Only parity bit is tested for bit 24
+                    test ^= if position == 23 {
+                        32
+                    } else {
+                        position as u8 + 33
+                    };
+                }
+                bit += 1;
+            }
+            table[byte][value] = test;
+            value += 1;
+        }
+        byte += 1;
+    }
+    table
+}
+
 /// Equivalent to `crc32_table[256]` const in `utility.c` C code
 /// Instead use [`get_crc32_byte`] function to get CRC32 bit.
 const CRC32_TABLE: [u32; 256] = [
@@ -172,15 +208,10 @@ pub fn decode_hamming_8_4(value: u8) -> Option<u8> {
 /// assert_eq!(decode_hamming_24_18(0x00000001), None);
 /// ```
 pub fn decode_hamming_24_18(mut value: u32) -> Option<u32> {
-    let mut test: u8 = 0;
-
     // Tests A-F correspond to bits 0-6 respectively in 'test'.
-    for i in 0..23 {
-        test ^= (((value >> i) & 0x01) as u8) * (i + 33);
-    }
-
-    // Only parity bit is tested for bit 24
-    test ^= (((value >> 23) & 0x01) as u8) * 32u8;
+    let test = HAMMING_24_18_TEST_TABLE[0][(value & 0xff) as usize]
+        ^ HAMMING_24_18_TEST_TABLE[1][((value >> 8) & 0xff) as usize]
+        ^ HAMMING_24_18_TEST_TABLE[2][((value >> 16) & 0xff) as usize];
 
     if (test & 0x1f) != 0x1f {
         // Not all tests A-E correct
@@ -223,6 +254,52 @@ pub fn verify_crc32(buf: &[u8]) -> bool {
     crc == 0
 }
 
+/// Reverses the bits of every byte in `data` in place.
+///
+/// Bytes are processed as 64-bit words: reversing all bits of a word and then swapping its bytes
+/// back leaves every byte bit-reversed in its original position.
+///
+/// # Examples
+/// ```rust
+/// # use lib_ccxr::util::bits::*;
+/// let mut data = [0x01, 0x80, 0x0f];
+/// reverse_bytes(&mut data);
+/// assert_eq!(data, [0x80, 0x01, 0xf0]);
+/// ```
+pub fn reverse_bytes(data: &mut [u8]) {
+    let mut chunks = data.chunks_exact_mut(8);
+    for chunk in &mut chunks {
+        let word = u64::from_ne_bytes(chunk.try_into().unwrap());
+        chunk.copy_from_slice(&word.reverse_bits().swap_bytes().to_ne_bytes());
+    }
+    for byte in chunks.into_remainder() {
+        *byte = get_reverse_byte(*byte);
+    }
+}
+
+/// Decodes the \[8,4\] hamming code bytes of `src` into `dst`, one nibble per byte.
+///
+/// Unrecoverable bytes decode to `0x0f`, as `unham_8_4` does in C,
+/// and make the function return `false`. Only `min(src.len(), dst.len())` bytes are decoded.
+///
+/// # Examples
+/// ```rust
+/// # use lib_ccxr::util::bits::*;
+/// let mut out = [0; 2];
+/// assert!(decode_hamming_8_4_bytes(&[0x00, 0xff], &mut out));
+/// assert_eq!(out, [0x01, 0x0e]);
+/// assert!(!decode_hamming_8_4_bytes(&[0x01], &mut out));
+/// ```
+pub fn decode_hamming_8_4_bytes(src: &[u8], dst: &mut [u8]) -> bool {
+    let mut errors = 0;
+    for (out, &byte) in dst.iter_mut().zip(src) {
+        let decoded = HAMMING_8_4_DECODER_TABLE[byte as usize];
+        errors |= decoded & 0xf0;
+        *out = decoded & 0x0f;
+    }
+    errors == 0
+}
+
 #[cfg(test)]
 mod tests {
     use super::*;
@@ -261,6 +338,50 @@ mod tests {
         );
     }
 
+    #[test]
+    fn test_hamming_24_18_table_matches_bitwise_tests() {
+        for value in 0u32..1 << 24 {
+            let mut test: u8 = 0;
+            for i in 0..23 {
+                test ^= (((value >> i) & 0x01) as u8) * (i + 33);
+            }
+            test ^= (((value >> 23) & 0x01) as u8) * 32u8;
+
+            let table = HAMMING_24_18_TEST_TABLE[0][(value & 0xff) as usize]
+                ^ HAMMING_24_18_TEST_TABLE[1][((value >> 8) & 0xff) as usize]
+                ^ HAMMING_24_18_TEST_TABLE[2][((value >> 16) & 0xff) as usize];
+            assert_eq!(table, test, "triplet {value:06x}");
+        }
+    }
+
+    #[test]
+    fn test_reverse_bytes_matches_table() {
+        let mut data: Vec<u8> = (0..=255).chain(0..=12).collect();
+        let expected: Vec<u8> = data.iter().map(|&b| get_reverse_byte(b)).collect();
+        reverse_bytes(&mut data);
+        assert_eq!(data, expected);
+    }
+
+    #[test]
+    fn test_decode_hamming_8_4_bytes() {
+        let src: Vec<u8> = (0..=255).collect();
+        let mut dst = vec![0; 256];
+        assert!(!decode_hamming_8_4_bytes(&src, &mut dst));
+        for (&byte, &out) in src.iter().zip(&dst) {
+            assert_eq!(
+                decode_hamming_8_4(byte).unwrap_or(HAMMING_8_4_DECODER_TABLE[byte as usize] & 0x0f),
+                out
+            );
+        }
+
+        let valid: Vec<u8> = src
+            .iter()
+            .copied()
+            .filter(|&b| decode_hamming_8_4(b).is_some())
+            .collect();
+        assert!(decode_hamming_8_4_bytes(&valid, &mut dst));
+    }
+
     #[test]
     fn test_get_crc32_byte() {
         assert_eq!(get_crc32_byte(0), 0x00000000);
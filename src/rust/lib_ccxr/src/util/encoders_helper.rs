@@ -75,75 +75,127 @@ pub fn censor_word(index: usize, word: &mut String, profane: &[String]) {
     ); // 0x98 is the asterisk in EIA-608
 }
 
-pub fn telx_correct_case(sub_line: &mut String, capitalization_list: &[String]) {
-    let delim: [char; 35] = [
-        ' ',
-        '\n',
-        '\r',
-        0x89 as char,
-        0x99 as char,
-        '!',
-        '"',
-        '#',
-        '%',
-        '&',
-        '\'',
-        '(',
-        ')',
-        ';',
-        '<',
-        '=',
-        '>',
-        '?',
-        '[',
-        '\\',
-        ']',
-        '*',
-        '+',
-        ',',
-        '-',
-        '.',
-        '/',
-        ':',
-        '^',
-        '_',
-        '{',
-        '|',
-        '}',
-        '~',
-        '\0',
-    ];
-
-    let line = sub_line.clone();
-
-    let mut start = 0;
-    let splitted: Vec<(usize, &str)> = line
-        .split(|c| delim.contains(&c))
-        .map(|part| {
-            let end = start + part.len();
-            let result = (start, part);
-            start = end + 1;
-            result
-        })
-        .collect();
-
-    for (index, c) in splitted {
-        // check if c is in capitalization_list
-        if capitalization_list.contains(&(c as &str).to_string()) {
-            // get the correct_c from capitalization_list
-            let correct_c: &String = capitalization_list
-                .iter()
-                .find(|&x| x == &c.to_string())
-                .unwrap();
-
-            // get the length of correct_c
-            let len = correct_c.len();
-            // replace c with correct_c in sub_line
-            sub_line.replace_range(index..index + len, correct_c);
+/// Word delimiters of the capitalization and profanity lists, as in `ccx_encoders_helpers.c`,
+/// apart from 0x89 and 0x99 which take two bytes in UTF-8.
+const DELIMITERS: [u8; 33] = [
+    b' ', b'\n', b'\r', b'!', b'"', b'#', b'%', b'&', b'\'', b'(', b')', b';', b'<', b'=', b'>',
+    b'?', b'[', b'\\', b']', b'*', b'+', b',', b'-', b'.', b'/', b':', b'^', b'_', b'{', b'|',
+    b'}', b'~', b'\0',
+];
+
+/// First byte of the 0x89 and 0x99 delimiters (transparent spaces) encoded in UTF-8.
+const CONTROL_DELIMITER_LEAD: u8 = 0xc2;
+
+fn hash_step(hash: u32, byte: u8) -> u32 {
+    (hash ^ byte.to_ascii_lowercase() as u32).wrapping_mul(16777619) // FNV-1a
+}
+
+const HASH_INIT: u32 = 2166136261;
+
+/// A case-insensitive set of words, such as the capitalization or profanity list.
+///
+/// Built once from the list, it finds every listed word of a line in a single pass without
+/// allocating, whatever the number of words.
+#[derive(Debug, Default)]
+pub struct WordMatcher {
+    words: Vec<String>,
+    /// Open addressing table of (hash, index in `words` plus one), 0 for a free slot.
+    slots: Vec<(u32, u32)>,
+    max_len: usize,
+}
+
+impl WordMatcher {
+    pub fn new(list: &[String]) -> Self {
+        let mut matcher = WordMatcher::default();
+        if list.is_empty() {
+            return matcher;
+        }
+        matcher.slots = vec![(0, 0); (list.len() * 2).next_power_of_two().max(16)];
+        let mask = matcher.slots.len() - 1;
+
+        for word in list {
+            let hash = word.bytes().fold(HASH_INIT, hash_step);
+            // With duplicates differing only in case, the first one wins
+            if matcher.find(word.as_bytes(), hash).is_some() {
+                continue;
+            }
+            matcher.words.push(word.clone());
+            matcher.max_len = matcher.max_len.max(word.len());
+            let mut slot = hash as usize & mask;
+            while matcher.slots[slot].1 != 0 {
+                slot = (slot + 1) & mask;
+            }
+            matcher.slots[slot] = (hash, matcher.words.len() as u32);
+        }
+        matcher
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.words.is_empty()
+    }
+
+    fn find(&self, token: &[u8], hash: u32) -> Option<&str> {
+        if self.slots.is_empty() || token.len() > self.max_len {
+            return None;
+        }
+        let mask = self.slots.len() - 1;
+        let mut slot = hash as usize & mask;
+        while self.slots[slot].1 != 0 {
+            let (slot_hash, index) = self.slots[slot];
+            let word = &self.words[index as usize - 1];
+            if slot_hash == hash && word.as_bytes().eq_ignore_ascii_case(token) {
+                return Some(word);
+            }
+            slot = (slot + 1) & mask;
+        }
+        None
+    }
+
+    /// Calls `f` with each listed word of `line` and its listed spelling, which only differs
+    /// from it in ASCII case.
+    pub fn for_each_match(&self, line: &mut [u8], mut f: impl FnMut(&mut [u8], &str)) {
+        if self.is_empty() {
+            return;
+        }
+        let mut start = 0;
+        let mut hash = HASH_INIT;
+        let mut i = 0;
+        while i <= line.len() {
+            let delimiter_len = match line.get(i) {
+                None => 1,
+                Some(b) if DELIMITERS.contains(b) => 1,
+                Some(&CONTROL_DELIMITER_LEAD) if matches!(line.get(i + 1), Some(0x89 | 0x99)) => 2,
+                Some(_) => 0,
+            };
+            if delimiter_len == 0 {
+                hash = hash_step(hash, line[i]);
+                i += 1;
+                continue;
+            }
+            if i > start {
+                if let Some(word) = self.find(&line[start..i], hash) {
+                    f(&mut line[start..i], word);
+                }
+            }
+            if line.get(i) == Some(&0) {
+                break;
+            }
+            i += delimiter_len;
+            start = i;
+            hash = HASH_INIT;
         }
     }
 }
 
+/// Replaces the words of `sub_line` found in the capitalization list with their listed spelling.
+pub fn telx_correct_case(sub_line: &mut String, capitalization: &WordMatcher) {
+    // SAFETY: matches are only rewritten in ASCII case, so the line stays valid UTF-8
+    let bytes = unsafe { sub_line.as_bytes_mut() };
+    capitalization.for_each_match(bytes, |word, spelling| {
+        word.copy_from_slice(spelling.as_bytes())
+    });
+}
+
 pub fn add_builtin_capitalization(list: &mut Vec<String>) {
     for word in CAPITALIZED_BUILTIN.iter() {
         list.push(word.to_string());
@@ -155,3 +207,45 @@ pub fn add_builtin_profane(list: &mut Vec<String>) {
         list.push(word.to_string());
     }
 }
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn capitalization() -> WordMatcher {
+        let mut list = Vec::new();
+        add_builtin_capitalization(&mut list);
+        list.push("iPhone".to_string());
+        list.push("IPHONE".to_string());
+        WordMatcher::new(&list)
+    }
+
+    #[test]
+    fn test_telx_correct_case() {
+        let matcher = capitalization();
+        let mut line = "on monday, i went to spain with my iphone.".to_string();
+        telx_correct_case(&mut line, &matcher);
+        assert_eq!(line, "on Monday, I went to Spain with my iPhone.");
+
+        // Only whole words match, and words with delimiters in them never do
+        let mut line = "mondays in the united states\u{89}france".to_string();
+        telx_correct_case(&mut line, &matcher);
+        assert_eq!(line, "mondays in the united states\u{89}France");
+
+        // Nothing after a NUL
+        let mut line = "june\0june".to_string();
+        telx_correct_case(&mut line, &matcher);
+        assert_eq!(line, "June\0june");
+    }
+
+    #[test]
+    fn test_word_matcher_censor() {
+        let mut list = Vec::new();
+        add_builtin_profane(&mut list);
+        let matcher = WordMatcher::new(&list);
+        let mut line = "\u{99}Damn, what the hell-holy crap".as_bytes().to_vec();
+        matcher.for_each_match(&mut line, |word, _| word.fill(b'*'));
+        assert_eq!(line, "\u{99}****, what the ****-**** ****".as_bytes());
+        assert!(WordMatcher::new(&[]).is_empty());
+    }
+}
@@ -1,6 +1,11 @@
 //! Provides function for calculating levenshtein distance.
+//!
+//! The distance is computed with Myers' bit-parallel algorithm (in the multi-word form
+//! described by Hyyrö), which processes 64 rows of the dynamic programming matrix per
+//! machine word. [`levenshtein_bounded`] additionally gives up as soon as the distance is
+//! known to exceed a threshold, which is all that the fuzzy caption comparisons need.
 
-use std::cmp::min;
+use std::hash::{Hash, Hasher};
 
 /// Calculates the levenshtein distance between two slices.
 ///
@@ -9,23 +14,103 @@ use std::cmp::min;
 /// # use lib_ccxr::util::levenshtein::*;
 /// assert_eq!(levenshtein(&[1,2,3,4,5], &[1,3,2,4,5,6]), 3);
 /// ```
-pub fn levenshtein<T: Copy + PartialEq>(a: &[T], b: &[T]) -> usize {
-    let mut column: Vec<usize> = (0..).take(a.len() + 1).collect();
-
-    for x in 1..=b.len() {
-        column[0] = x;
-        let mut lastdiag = x - 1;
-        for y in 1..=a.len() {
-            let olddiag = column[y];
-            column[y] = min(
-                min(column[y] + 1, column[y - 1] + 1),
-                lastdiag + (if a[y - 1] == b[x - 1] { 0 } else { 1 }),
-            );
-            lastdiag = olddiag;
+pub fn levenshtein<T: Copy + Eq + Hash>(a: &[T], b: &[T]) -> usize {
+    levenshtein_bounded(a, b, usize::MAX).unwrap()
+}
+
+/// Calculates the levenshtein distance between two slices if it is at most `max`.
+///
+/// Returns [`None`] as soon as the distance is known to be larger than `max`, without
+/// finishing the computation.
+///
+/// # Examples
+/// ```rust
+/// # use lib_ccxr::util::levenshtein::*;
+/// assert_eq!(levenshtein_bounded(b"kitten", b"sitting", 3), Some(3));
+/// assert_eq!(levenshtein_bounded(b"kitten", b"sitting", 2), None);
+/// ```
+pub fn levenshtein_bounded<T: Copy + Eq + Hash>(a: &[T], b: &[T], max: usize) -> Option<usize> {
+    // Common prefixes and suffixes never contribute to the distance
+    let prefix = a.iter().zip(b).take_while(|(x, y)| x == y).count();
+    let (a, b) = (&a[prefix..], &b[prefix..]);
+    let suffix = a
+        .iter()
+        .rev()
+        .zip(b.iter().rev())
+        .take_while(|(x, y)| x == y)
+        .count();
+    let (a, b) = (&a[..a.len() - suffix], &b[..b.len() - suffix]);
+
+    // The shorter slice is the pattern whose rows are packed into words
+    let (pattern, text) = if a.len() <= b.len() { (a, b) } else { (b, a) };
+    if text.len() - pattern.len() > max {
+        return None;
+    }
+    if pattern.is_empty() {
+        return Some(text.len());
+    }
+
+    if pattern.len() <= 64 {
+        return levenshtein_single_word(pattern, text, max);
+    }
+
+    let peq = PatternMasks::new(pattern);
+    let blocks = peq.blocks;
+    let last_row = 1u64 << ((pattern.len() - 1) % 64);
+    let mut pv = vec![!0u64; blocks];
+    let mut mv = vec![0u64; blocks];
+    let mut score = pattern.len();
+
+    for (j, c) in text.iter().enumerate() {
+        let eq = peq.get(c);
+        // The top row of the matrix is 0, 1, 2, ..., so every column starts one higher
+        let mut carry = 1;
+        for k in 0..blocks {
+            let high = if k + 1 == blocks { last_row } else { 1 << 63 };
+            carry = advance_block(&mut pv[k], &mut mv[k], eq.map_or(0, |e| e[k]), carry, high);
+        }
+        score = (score as isize + carry as isize) as usize;
+
+        // Each remaining column can lower the bottom row by at most one
+        if score - max.min(score) > text.len() - j - 1 {
+            return None;
+        }
+    }
+
+    Some(score)
+}
+
+/// [`levenshtein_bounded`] for patterns that fit in one word, the common case of caption lines.
+///
+/// Keeps the whole state on the stack, so nothing is allocated per comparison.
+fn levenshtein_single_word<T: Copy + Eq + Hash>(
+    pattern: &[T],
+    text: &[T],
+    max: usize,
+) -> Option<usize> {
+    let mut keys = [None; 128];
+    let mut masks = [0u64; 128];
+    for (row, symbol) in pattern.iter().enumerate() {
+        let slot = probe(&keys, symbol);
+        keys[slot] = Some(*symbol);
+        masks[slot] |= 1 << row;
+    }
+
+    let last_row = 1u64 << (pattern.len() - 1);
+    let (mut pv, mut mv) = (!0u64, 0u64);
+    let mut score = pattern.len();
+
+    for (j, c) in text.iter().enumerate() {
+        let slot = probe(&keys, c);
+        let eq = if keys[slot].is_some() { masks[slot] } else { 0 };
+        score =
+            (score as isize + advance_block(&mut pv, &mut mv, eq, 1, last_row) as isize) as usize;
+        if score - max.min(score) > text.len() - j - 1 {
+            return None;
         }
     }
 
-    column[a.len()]
+    Some(score)
 }
 
 /// Rust equivalent for `levenshtein_dist` function in C. Uses Rust-native types as input and output.
@@ -34,14 +119,144 @@ pub fn levenshtein_dist(s1: &[u64], s2: &[u64]) -> usize {
 }
 
 /// Rust equivalent for `levenshtein_dist_char` function in C. Uses Rust-native types as input and output.
-pub fn levenshtein_dist_char<T: Copy + PartialEq>(s1: &[T], s2: &[T]) -> usize {
+pub fn levenshtein_dist_char<T: Copy + Eq + Hash>(s1: &[T], s2: &[T]) -> usize {
     levenshtein(s1, s2)
 }
 
+/// Advances one 64-row block of the matrix by one column.
+///
+/// `hin` is the horizontal difference entering the top of the block, the returned value
+/// the one leaving it at the row selected by `high`.
+#[inline]
+fn advance_block(pv: &mut u64, mv: &mut u64, eq: u64, hin: i8, high: u64) -> i8 {
+    let xv = eq | *mv;
+    let eq = eq | (hin < 0) as u64;
+    let xh = ((eq & *pv).wrapping_add(*pv) ^ *pv) | eq;
+    let mut ph = *mv | !(xh | *pv);
+    let mut mh = *pv & xh;
+
+    let hout = if ph & high != 0 {
+        1
+    } else if mh & high != 0 {
+        -1
+    } else {
+        0
+    };
+
+    ph = (ph << 1) | (hin > 0) as u64;
+    mh = (mh << 1) | (hin < 0) as u64;
+    *pv = mh | !(xv | ph);
+    *mv = ph & xv;
+    hout
+}
+
+/// Match masks of the pattern: for each distinct symbol, the rows it appears on.
+///
+/// Symbols are kept in a small open addressing table, so any hashable element type works
+/// without a table indexed by the whole alphabet.
+struct PatternMasks<T> {
+    blocks: usize,
+    keys: Vec<Option<T>>,
+    masks: Vec<u64>,
+}
+
+impl<T: Copy + Eq + Hash> PatternMasks<T> {
+    fn new(pattern: &[T]) -> Self {
+        let blocks = (pattern.len() + 63) / 64;
+        let capacity = (2 * pattern.len()).next_power_of_two().max(16);
+        let mut table = PatternMasks {
+            blocks,
+            keys: vec![None; capacity],
+            masks: vec![0; capacity * blocks],
+        };
+        for (row, symbol) in pattern.iter().enumerate() {
+            let slot = probe(&table.keys, symbol);
+            table.keys[slot] = Some(*symbol);
+            table.masks[slot * blocks + row / 64] |= 1 << (row % 64);
+        }
+        table
+    }
+
+    fn get(&self, symbol: &T) -> Option<&[u64]> {
+        let slot = probe(&self.keys, symbol);
+        self.keys[slot].map(|_| &self.masks[slot * self.blocks..(slot + 1) * self.blocks])
+    }
+}
+
+/// Index of the slot of the open addressing table `keys` holding `symbol`, or of the empty
+/// slot where it would go. The table size must be a power of two and never full.
+#[inline]
+fn probe<T: Eq + Hash>(keys: &[Option<T>], symbol: &T) -> usize {
+    let mask = keys.len() - 1;
+    let mut hasher = FxHasher(0);
+    symbol.hash(&mut hasher);
+    let mut slot = hasher.finish() as usize & mask;
+    while let Some(key) = &keys[slot] {
+        if key == symbol {
+            break;
+        }
+        slot = (slot + 1) & mask;
+    }
+    slot
+}
+
+/// Multiplicative hash for the pattern table; symbols are short and not adversarial.
+struct FxHasher(u64);
+
+impl Hasher for FxHasher {
+    fn write(&mut self, bytes: &[u8]) {
+        for &byte in bytes {
+            self.write_u64(byte as u64);
+        }
+    }
+
+    fn write_u8(&mut self, i: u8) {
+        self.write_u64(i as u64);
+    }
+
+    fn write_u16(&mut self, i: u16) {
+        self.write_u64(i as u64);
+    }
+
+    fn write_u32(&mut self, i: u32) {
+        self.write_u64(i as u64);
+    }
+
+    fn write_u64(&mut self, i: u64) {
+        self.0 = (self.0.rotate_left(5) ^ i).wrapping_mul(0x51_7c_c1_b7_27_22_0a_95);
+    }
+
+    fn write_usize(&mut self, i: usize) {
+        self.write_u64(i as u64);
+    }
+
+    fn finish(&self) -> u64 {
+        // The top bits are the best mixed ones
+        self.0.rotate_left(26)
+    }
+}
+
 #[cfg(test)]
 mod tests {
     use super::*;
 
+    /// Textbook dynamic programming distance, to check the bit-parallel one against.
+    fn reference<T: PartialEq>(a: &[T], b: &[T]) -> usize {
+        let mut column: Vec<usize> = (0..=a.len()).collect();
+        for x in 1..=b.len() {
+            column[0] = x;
+            let mut lastdiag = x - 1;
+            for y in 1..=a.len() {
+                let olddiag = column[y];
+                column[y] = (column[y] + 1)
+                    .min(column[y - 1] + 1)
+                    .min(lastdiag + (a[y - 1] != b[x - 1]) as usize);
+                lastdiag = olddiag;
+            }
+        }
+        column[a.len()]
+    }
+
     #[test]
     fn test_levenshtein() {
         // Empty slices
@@ -70,4 +285,48 @@ mod tests {
         );
         assert_eq!(levenshtein(&["foo", "bar", "baz"], &["foo", "baz"]), 1);
     }
+
+    #[test]
+    fn test_levenshtein_matches_reference() {
+        // Small alphabets give many matches, lengths around 64 and 128 cross block boundaries
+        let mut state: u32 = 0x1234_5678;
+        let mut next = move |n: u32| {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            state % n
+        };
+        for _ in 0..2000 {
+            let alphabet = 2 + next(6);
+            let a: Vec<u16> = (0..next(150)).map(|_| next(alphabet) as u16).collect();
+            let mut b = a.clone();
+            for _ in 0..next(20) {
+                let pos = next(b.len() as u32 + 1) as usize;
+                match next(3) {
+                    0 => b.insert(pos, next(alphabet) as u16),
+                    1 if pos < b.len() => {
+                        b.remove(pos);
+                    }
+                    _ if pos < b.len() => b[pos] = next(alphabet) as u16,
+                    _ => {}
+                }
+            }
+            let expected = reference(&a, &b);
+            assert_eq!(levenshtein(&a, &b), expected, "{:?} {:?}", a, b);
+            assert_eq!(levenshtein_bounded(&a, &b, expected), Some(expected));
+            if expected > 0 {
+                assert_eq!(levenshtein_bounded(&a, &b, expected - 1), None);
+            }
+        }
+    }
+
+    #[test]
+    fn test_levenshtein_bounded() {
+        assert_eq!(levenshtein_bounded(b"", b"", 0), Some(0));
+        assert_eq!(levenshtein_bounded(b"abc", b"", 3), Some(3));
+        assert_eq!(levenshtein_bounded(b"abc", b"", 2), None);
+        assert_eq!(levenshtein_bounded(b"same line", b"same line", 0), Some(0));
+        assert_eq!(levenshtein_bounded(b"same line", b"same lime", 0), None);
+        assert_eq!(levenshtein_bounded(b"same line", b"same lime", 1), Some(1));
+    }
 }
@@ -252,6 +252,17 @@ pub struct Args {
     pub dvr_ms: bool,
     #[arg(long, value_name="format", help_heading=OUTPUT_FORMATS)]
     pub out: Option<OutFormat>,
+    /// Also write the captions in these formats, from the same
+    /// pass over the input. Each file is named like the --out
+    /// one, with the extension of its format. Can be srt, ass,
+    /// ssa, ccd, scc, webvtt, sami, txt, g608, smptett, spupng
+    /// or simplexml, e.g. --also-out=webvtt,scc,smptett,txt
+    #[arg(long = "also-out", value_name="formats", value_delimiter=',', verbatim_doc_comment, help_heading=OUTPUT_FORMATS)]
+    pub also_out: Option<Vec<OutFormat>>,
+    /// Write each of the --also-out formats on a thread of its
+    /// own, so the extraction doesn't wait for them.
+    #[arg(long = "also-out-threads", verbatim_doc_comment, help_heading=OUTPUT_FORMATS)]
+    pub also_out_threads: bool,
     #[arg(long, hide = true)]
     pub srt: bool,
     #[arg(long, hide = true)]
@@ -358,6 +369,19 @@ pub struct Args {
     /// Uses multiple programs from the same input stream.
     #[arg(long, verbatim_doc_comment, help_heading=OPTIONS_AFFECTING_INPUT_FILES)]
     pub multiprogram: bool,
+    /// Process each input file on its own, as an independent
+    /// job, several of them at the same time. Each output file
+    /// is named after its input file, so -o can't be used.
+    #[arg(long, verbatim_doc_comment, help_heading=OPTIONS_AFFECTING_INPUT_FILES)]
+    pub batch: bool,
+    /// With --batch, how many files to process at the same
+    /// time. Defaults to the number of processors.
+    #[arg(long, value_name="n", verbatim_doc_comment, help_heading=OPTIONS_AFFECTING_INPUT_FILES)]
+    pub jobs: Option<u32>,
+    /// With --batch, write a JSON report with the result of
+    /// every job to this file.
+    #[arg(long = "batch-report", value_name="file", verbatim_doc_comment, help_heading=OPTIONS_AFFECTING_INPUT_FILES)]
+    pub batch_report: Option<String>,
     /// List all tracks found in the input file and exit without
     /// processing. Useful for exploring media files before extraction.
     #[arg(long = "list-tracks", short = 'L', verbatim_doc_comment, help_heading=OPTIONS_AFFECTING_INPUT_FILES)]
@@ -563,6 +587,8 @@ pub struct Args {
     /// produce an XMLTV file containing the EPG data from
     /// the source TS file. Mode: 1 = full output
     /// 2 = live output. 3 = both
+    /// Live output is appended to a single _epg_live.xml
+    /// file, rewritten compacted when mostly superseded.
     #[arg(long, verbatim_doc_comment, value_name="mode", help_heading=OUTPUT_AFFECTING_OUTPUT_FILES)]
     pub xmltv: Option<String>,
     /// interval of x seconds between writing live mode xmltv output.
@@ -650,6 +676,14 @@ pub struct Args {
     /// in languages (like "fre-ca" for Canadian French).
     #[arg(long, verbatim_doc_comment, value_name="lang", help_heading=OUTPUT_AFFECTING_OUTPUT_FILES)]
     pub mkvlang: Option<String>,
+    /// For MKV subtitles, write up to this many subtitle
+    /// tracks at the same time, each to its own file.
+    /// VOBSUB tracks converted with OCR are recognized at
+    /// the same time, each with its own Tesseract, and then
+    /// written in order. The default value is 1
+    /// e.g. --mkv-threads 4
+    #[arg(long = "mkv-threads", verbatim_doc_comment, value_name="count", help_heading=OUTPUT_AFFECTING_OUTPUT_FILES)]
+    pub mkv_threads: Option<u32>,
     /// When processing DVB don't use the OCR to write the text as
     /// comments in the XML file.
     #[arg(long, verbatim_doc_comment, help_heading=OUTPUT_AFFECTING_OUTPUT_FILES)]
@@ -668,6 +702,20 @@ pub struct Args {
     /// default location)
     #[arg(long, verbatim_doc_comment, value_name="path", help_heading=OUTPUT_AFFECTING_OUTPUT_FILES)]
     pub italics: Option<String>,
+    /// Compress and write SPUPNG images on this many threads,
+    /// so the extraction doesn't wait for them. The default
+    /// value is 1 (images are written as they are produced)
+    /// e.g. --png-threads 4
+    #[arg(long = "png-threads", verbatim_doc_comment, value_name="count", help_heading=OUTPUT_AFFECTING_OUTPUT_FILES)]
+    pub png_threads: Option<u32>,
+    /// zlib compression level of SPUPNG images, from 0 (none,
+    /// fastest) to 9 (smallest files). Default: libpng's.
+    #[arg(long = "png-compression", verbatim_doc_comment, value_name="level", help_heading=OUTPUT_AFFECTING_OUTPUT_FILES)]
+    pub png_compression: Option<u8>,
+    /// PNG row filter for SPUPNG images: none, sub, up, avg,
+    /// paeth or all (try each one per row). Default: libpng's.
+    #[arg(long = "png-filter", verbatim_doc_comment, value_name="filter", help_heading=OUTPUT_AFFECTING_OUTPUT_FILES)]
+    pub png_filter: Option<String>,
     /// Forces input buffering.
     #[arg(long, verbatim_doc_comment, help_heading=OUTPUT_AFFECTING_BUFFERING)]
     pub bufferinput: bool,
@@ -951,6 +999,14 @@ pub struct Args {
     /// The default value is 95
     #[arg(long = "whiteness-thresh", verbatim_doc_comment, value_name="threshold", help_heading=BURNEDIN_SUBTITLE_EXTRACTION)]
     pub whiteness_thresh: Option<f32>,
+    /// Specify the height of the band at the bottom of the
+    /// frame that is searched for subtitles, as a percentage
+    /// of the frame height between 1 and 100.
+    /// Only this band is converted and OCR'd.
+    /// The default value is 25
+    /// e.g. --sub-band-height 30
+    #[arg(long = "sub-band-height", verbatim_doc_comment, value_name="percent", help_heading=BURNEDIN_SUBTITLE_EXTRACTION)]
+    pub sub_band_height: Option<f32>,
     /// This option will be used if the file should have both
     /// closed captions and burned in subtitles
     #[arg(long, verbatim_doc_comment, help_heading=BURNEDIN_SUBTITLE_EXTRACTION)]
@@ -4,7 +4,7 @@ use crate::avc::sei::*;
 use crate::bindings::{cc_subtitle, encoder_ctx, lib_cc_decode, realloc};
 use crate::ctorust::FromCType;
 use crate::libccxr_exports::time::ccxr_set_fts;
-use crate::{anchor_hdcc, current_fps, process_hdcc, store_hdcc, MPEG_CLOCK_FREQ};
+use crate::{anchor_hdcc, process_hdcc, store_hdcc, MPEG_CLOCK_FREQ};
 use lib_ccxr::common::AvcNalType;
 use lib_ccxr::util::log::DebugMessageFlag;
 use lib_ccxr::{debug, info};
@@ -193,7 +193,7 @@ pub unsafe fn do_nal(
 
                     // Calculate sequence index from PTS difference
                     let pts_diff = (*dec_ctx.timing).current_pts - (*dec_ctx.avc_ctx).currefpts;
-                    let fps_factor = MPEG_CLOCK_FREQ as f64 / current_fps;
+                    let fps_factor = MPEG_CLOCK_FREQ as f64 / (*dec_ctx.timing).current_fps;
                     let calculated_index =
                         round_portable(2.0 * pts_diff as f64 / fps_factor) as i32;
 
@@ -256,7 +256,7 @@ pub unsafe fn do_nal(
                 (*dec_ctx.avc_ctx).num_nal_unit_type_7 += 1;
 
                 let mut ctx_rust = AvcContextRust::from_ctype(*dec_ctx.avc_ctx).unwrap();
-                seq_parameter_set_rbsp(&mut ctx_rust, &working_buffer)?;
+                seq_parameter_set_rbsp(&mut ctx_rust, &mut *dec_ctx.timing, &working_buffer)?;
 
                 (*dec_ctx.avc_ctx).seq_parameter_set_id = ctx_rust.seq_parameter_set_id;
                 (*dec_ctx.avc_ctx).log2_max_frame_num = ctx_rust.log2_max_frame_num;
@@ -1,11 +1,11 @@
 use crate::avc::common_types::*;
 use crate::avc::core::round_portable;
-use crate::bindings::{cc_subtitle, encoder_ctx, lib_cc_decode};
+use crate::bindings::{cc_subtitle, ccx_common_timing_ctx, encoder_ctx, lib_cc_decode};
 use crate::libccxr_exports::time::{
     ccxr_print_debug_timing, ccxr_print_mstime_static, ccxr_set_fts,
 };
 use crate::{anchor_hdcc, process_hdcc, store_hdcc};
-use crate::{ccx_options, current_fps, total_frames_count, MPEG_CLOCK_FREQ};
+use crate::{ccx_options, MPEG_CLOCK_FREQ};
 use lib_ccxr::common::{AvcNalType, BitStreamRust, BitstreamError, FRAMERATES_VALUES, SLICE_TYPES};
 use lib_ccxr::util::log::DebugMessageFlag;
 use lib_ccxr::{debug, info};
@@ -14,6 +14,7 @@ use std::os::raw::c_char;
 /// Process sequence parameter set RBSP
 pub fn seq_parameter_set_rbsp(
     ctx: &mut AvcContextRust,
+    timing: &mut ccx_common_timing_ctx,
     seqbuf: &[u8],
 ) -> Result<(), BitstreamError> {
     // Calculate buffer length from pointer difference
@@ -288,9 +289,8 @@ pub fn seq_parameter_set_rbsp(
                 let clock_tick = num_units_in_tick as f64 / time_scale as f64;
                 debug!(msg_type = DebugMessageFlag::VIDEO_STREAM; "clock_tick= {}", clock_tick);
 
-                unsafe {
-                    current_fps = time_scale as f64 / (2.0 * num_units_in_tick as f64);
-                } // Based on formula D-2, p. 359 of the ISO/IEC 14496-10:2012(E) spec.
+                // Based on formula D-2, p. 359 of the ISO/IEC 14496-10:2012(E) spec.
+                timing.current_fps = time_scale as f64 / (2.0 * num_units_in_tick as f64);
             }
         }
 
@@ -395,7 +395,7 @@ pub unsafe fn slice_header(
 
             // When bottom_field_flag is set the video is interlaced,
             // override current_fps.
-            current_fps = FRAMERATES_VALUES[dec_ctx.current_frame_rate as usize];
+            (*dec_ctx.timing).current_fps = FRAMERATES_VALUES[dec_ctx.current_frame_rate as usize];
         }
     }
 
@@ -544,7 +544,7 @@ pub unsafe fn slice_header(
         // The 2* accounts for a discrepancy between current and actual FPS
         // seen in some files (CCSample2.mpg)
         let pts_diff = (*dec_ctx.timing).current_pts - (*dec_ctx.avc_ctx).currefpts;
-        let fps_factor = MPEG_CLOCK_FREQ as f64 / current_fps;
+        let fps_factor = MPEG_CLOCK_FREQ as f64 / (*dec_ctx.timing).current_fps;
         let calculated_index = round_portable(2.0 * pts_diff as f64 / fps_factor) as i32;
 
         // For some streams (like HDHomeRun recordings), the PTS-based index
@@ -650,7 +650,7 @@ pub unsafe fn slice_header(
         ccxr_print_debug_timing(dec_ctx.timing);
     }
 
-    total_frames_count += 1;
+    (*dec_ctx.timing).total_frames_count += 1;
     dec_ctx.frames_since_last_gop += 1;
 
     store_hdcc(
@@ -23,6 +23,7 @@ use lib_ccxr::common::OutputFormat;
 use lib_ccxr::common::SelectCodec;
 use lib_ccxr::common::StreamMode;
 use lib_ccxr::common::StreamType;
+use lib_ccxr::common::MAX_EXTRA_OUTPUTS;
 use lib_ccxr::common::{BufferdataType, CommonTimingCtx};
 use lib_ccxr::common::{Codec, DataSource};
 use lib_ccxr::hardsubx::ColorHue;
@@ -187,6 +188,10 @@ pub unsafe fn copy_from_rust(ccx_s_options: *mut ccx_s_options, options: Options
         (*ccx_s_options).mkvlang =
             replace_rust_c_string((*ccx_s_options).mkvlang, mkvlang.to_ctype().as_str());
     }
+    (*ccx_s_options).mkv_threads = options.mkv_threads as _;
+    (*ccx_s_options).png_threads = options.png_threads as _;
+    (*ccx_s_options).png_compression_level = options.png_compression_level as _;
+    (*ccx_s_options).png_filters = options.png_filters as _;
     (*ccx_s_options).analyze_video_stream = options.analyze_video_stream as _;
     (*ccx_s_options).hardsubx_ocr_mode = options.hardsubx_ocr_mode.to_ctype();
     (*ccx_s_options).hardsubx_subcolor = options.hardsubx_hue.to_ctype();
@@ -195,6 +200,7 @@ pub unsafe fn copy_from_rust(ccx_s_options: *mut ccx_s_options, options: Options
     (*ccx_s_options).hardsubx_conf_thresh = options.hardsubx_conf_thresh as _;
     (*ccx_s_options).hardsubx_hue = options.hardsubx_hue.get_hue() as _;
     (*ccx_s_options).hardsubx_lum_thresh = options.hardsubx_lum_thresh as _;
+    (*ccx_s_options).hardsubx_band_height = options.hardsubx_band_height as _;
     (*ccx_s_options).transcript_settings = options.transcript_settings.to_ctype();
     (*ccx_s_options).date_format = options.date_format.to_ctype();
     (*ccx_s_options).write_format_rewritten = options.write_format_rewritten as _;
@@ -275,6 +281,12 @@ pub unsafe fn copy_from_rust(ccx_s_options: *mut ccx_s_options, options: Options
     (*ccx_s_options).pes_header_to_stdout = options.pes_header_to_stdout as _;
     (*ccx_s_options).ignore_pts_jumps = options.ignore_pts_jumps as _;
     (*ccx_s_options).multiprogram = options.multiprogram as _;
+    (*ccx_s_options).batch_mode = options.batch_mode as _;
+    (*ccx_s_options).batch_jobs = options.batch_jobs;
+    if let Some(ref batch_report) = options.batch_report {
+        (*ccx_s_options).batch_report =
+            replace_rust_c_string((*ccx_s_options).batch_report, batch_report);
+    }
     (*ccx_s_options).out_interval = options.out_interval;
     (*ccx_s_options).segment_on_key_frames_only = options.segment_on_key_frames_only as _;
     (*ccx_s_options).scc_framerate = options.scc_framerate;
@@ -431,6 +443,10 @@ pub unsafe fn copy_to_rust(ccx_s_options: *const ccx_s_options) -> Options {
                 .expect("Invalid language"),
         )
     }
+    options.mkv_threads = (*ccx_s_options).mkv_threads as u32;
+    options.png_threads = (*ccx_s_options).png_threads as u32;
+    options.png_compression_level = (*ccx_s_options).png_compression_level as i32;
+    options.png_filters = (*ccx_s_options).png_filters as i32;
 
     options.analyze_video_stream = (*ccx_s_options).analyze_video_stream != 0;
     options.hardsubx_ocr_mode =
@@ -442,6 +458,7 @@ pub unsafe fn copy_to_rust(ccx_s_options: *const ccx_s_options) -> Options {
     options.hardsubx_hue = ColorHue::from_ctype((*ccx_s_options).hardsubx_hue as f64 as c_int)
         .unwrap_or(ColorHue::White);
     options.hardsubx_lum_thresh = (*ccx_s_options).hardsubx_lum_thresh as f64;
+    options.hardsubx_band_height = (*ccx_s_options).hardsubx_band_height as f64;
 
     // Handle transcript_settings
     options.transcript_settings =
@@ -536,6 +553,11 @@ pub unsafe fn copy_to_rust(ccx_s_options: *const ccx_s_options) -> Options {
     options.pes_header_to_stdout = (*ccx_s_options).pes_header_to_stdout != 0;
     options.ignore_pts_jumps = (*ccx_s_options).ignore_pts_jumps != 0;
     options.multiprogram = (*ccx_s_options).multiprogram != 0;
+    options.batch_mode = (*ccx_s_options).batch_mode != 0;
+    options.batch_jobs = (*ccx_s_options).batch_jobs;
+    if !(*ccx_s_options).batch_report.is_null() {
+        options.batch_report = Some(c_char_to_string((*ccx_s_options).batch_report));
+    }
     options.out_interval = (*ccx_s_options).out_interval;
     options.segment_on_key_frames_only = (*ccx_s_options).segment_on_key_frames_only != 0;
     options.scc_framerate = (*ccx_s_options).scc_framerate;
@@ -790,6 +812,9 @@ impl CType<ccx_common_timing_ctx> for CommonTimingCtx {
             sync_pts2fts_fts: self.sync_pts2fts_fts,
             sync_pts2fts_pts: self.sync_pts2fts_pts,
             pts_reset: self.pts_reset,
+            // What init_timing_ctx() starts a context with
+            current_fps: 30000.0 / 1001.0,
+            ..Default::default()
         }
     }
 }
@@ -982,6 +1007,19 @@ impl CType<encoder_cfg> for EncoderConfig {
             },
             extract_only_708: self.extract_only_708 as _,
             scc_framerate: 0, // Will be set from ccx_options.scc_framerate in copy_to_c
+            extra_write_formats: {
+                let mut formats = [ccx_output_format::CCX_OF_NULL; MAX_EXTRA_OUTPUTS];
+                for (slot, format) in formats.iter_mut().zip(&self.extra_write_formats) {
+                    *slot = format.to_ctype();
+                }
+                formats
+            },
+            nb_extra_write_formats: self.extra_write_formats.len().min(MAX_EXTRA_OUTPUTS) as _,
+            threaded_outputs: self.threaded_outputs as _,
+            // Only set by library users, never from the command line
+            output_callback: None,
+            subtitle_callback: None,
+            callback_opaque: std::ptr::null_mut(),
         }
     }
 }
@@ -8,6 +8,7 @@ use lib_ccxr::common::{
     AvcNalType, BufferdataType, Codec, CommonTimingCtx, Decoder608ColorCode, Decoder608Report,
     Decoder608Settings, DecoderDtvccReport, DecoderDtvccSettings, DtvccServiceCharset,
     EncoderConfig, FrameType, SelectCodec, StreamMode, StreamType, DTVCC_MAX_SERVICES,
+    MAX_EXTRA_OUTPUTS,
 };
 use lib_ccxr::time::Timestamp;
 use lib_ccxr::util::encoding::Encoding;
@@ -452,6 +453,13 @@ impl FromCType<encoder_cfg> for EncoderConfig {
             services_enabled,
             services_charsets: DtvccServiceCharset::from_ctype(services_charsets_args)?,
             extract_only_708: cfg.extract_only_708 != 0,
+            extra_write_formats: cfg
+                .extra_write_formats
+                .iter()
+                .take((cfg.nb_extra_write_formats.max(0) as usize).min(MAX_EXTRA_OUTPUTS))
+                .filter_map(|&format| lib_ccxr::common::OutputFormat::from_ctype(format))
+                .collect(),
+            threaded_outputs: cfg.threaded_outputs != 0,
         })
     }
 }
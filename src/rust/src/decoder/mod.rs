@@ -26,6 +26,8 @@ const CCX_DTVCC_SCREENGRID_ROWS: u8 = 75;
 const CCX_DTVCC_SCREENGRID_COLUMNS: u8 = 210;
 const CCX_DTVCC_MAX_ROWS: u8 = 15;
 const CCX_DTVCC_MAX_COLUMNS: u8 = 32 * 2;
+const CCX_DTVCC_MAX_SCREEN_PENS: u16 = 256;
+const CCX_DTVCC_DEFAULT_PEN_INDEX: u8 = 0;
 
 /// Context required for processing 708 data
 pub struct Dtvcc<'a> {
@@ -270,6 +272,9 @@ impl DtvccRust {
         let last_sequence = CCX_DTVCC_NO_LAST_SEQUENCE;
         let no_rollup = is_true(opts.no_rollup);
 
+        debug!(msg_type = DebugMessageFlag::DECODER_708; "dtvcc: {} bytes of decoder state per service",
+            std::mem::size_of::<dtvcc_service_decoder>() + std::mem::size_of::<dtvcc_tv_screen>());
+
         // Initialize decoders - only for active services
         // Note: dtvcc_service_decoder is a large struct, so we must allocate it
         // directly on the heap to avoid stack overflow.
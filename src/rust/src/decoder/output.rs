@@ -4,9 +4,14 @@
 use std::os::unix::prelude::{FromRawFd, IntoRawFd};
 #[cfg(windows)]
 use std::os::windows::io::{FromRawHandle, IntoRawHandle};
-use std::{fs::File, io::Write};
+use std::{
+    ffi::{c_void, CStr},
+    fs::File,
+    io::Write,
+};
 
 use crate::{bindings::*, utils::is_true};
+use encoding_rs::Encoding;
 
 use log::{debug, warn};
 
@@ -66,6 +71,36 @@ impl<'a> Writer<'a> {
         }
         Ok(())
     }
+    /// Returns the output encoding and whether symbols are written as UTF-16
+    ///
+    /// The charset label is looked up only once per writer context, the result is
+    /// cached in `dtvcc_writer_ctx` so that rows don't have to resolve it again.
+    pub fn transcoder(&mut self) -> (Option<&'static Encoding>, bool) {
+        if !is_true(self.writer_ctx.transcoder_resolved) {
+            let charset = if self.writer_ctx.charset.is_null() {
+                None
+            } else {
+                unsafe { CStr::from_ptr(self.writer_ctx.charset) }.to_str().ok()
+            };
+            debug!("Charset: {charset:?}");
+            let encoding = charset.and_then(|label| Encoding::for_label(label.as_bytes()));
+            self.writer_ctx.transcoder = match encoding {
+                Some(encoding) => encoding as *const Encoding as *const c_void,
+                None => std::ptr::null(),
+            };
+            // UTF-16/UCS-2 encodings require 2 bytes even for ASCII.
+            // No charset specified - default to variable-width for backward compatibility
+            self.writer_ctx.use_utf16 = charset.map_or(false, is_utf16_charset) as i32;
+            self.writer_ctx.transcoder_resolved = 1;
+        }
+        let encoding = if self.writer_ctx.transcoder.is_null() {
+            None
+        } else {
+            // Encodings are statics owned by encoding_rs, so the pointer never dangles
+            Some(unsafe { &*(self.writer_ctx.transcoder as *const Encoding) })
+        };
+        (encoding, is_true(self.writer_ctx.use_utf16))
+    }
     /// Finish writing up any remaining parts
     pub fn write_done(&mut self) {
         if self.write_format == ccx_output_format::CCX_OF_SAMI {
@@ -188,6 +223,34 @@ mod tests {
         assert_eq!(buf, vec![0x20]);
     }
 
+    #[test]
+    fn test_transcoder_is_resolved_once() {
+        use crate::utils::get_zero_allocated_obj;
+
+        let charset = std::ffi::CString::new("UTF-16BE").unwrap();
+        let mut writer_ctx = get_zero_allocated_obj::<dtvcc_writer_ctx>();
+        writer_ctx.charset = charset.as_ptr() as *mut _;
+        let transcript_settings = get_zero_allocated_obj::<ccx_encoders_transcript_format>();
+        let mut counter = 0u32;
+        let mut writer = Writer::new(
+            &mut counter,
+            0,
+            ccx_output_format::CCX_OF_SRT,
+            &mut writer_ctx,
+            0,
+            &transcript_settings,
+            0,
+        );
+
+        let (encoding, use_utf16) = writer.transcoder();
+        assert_eq!(encoding, Some(encoding_rs::UTF_16BE));
+        assert!(use_utf16);
+
+        // Later lookups use the cached result even if the label goes away
+        writer.writer_ctx.charset = std::ptr::null_mut();
+        assert_eq!(writer.transcoder(), (Some(encoding_rs::UTF_16BE), true));
+    }
+
     #[test]
     fn test_is_utf16_charset() {
         // Should return true for UTF-16 variants
@@ -10,8 +10,8 @@ use std::{
 use super::commands::{self, C0CodeSet, C0Command, C1CodeSet, C1Command};
 use super::window::{PenPreset, WindowPreset};
 use super::{
-    CCX_DTVCC_MAX_COLUMNS, CCX_DTVCC_MAX_ROWS, CCX_DTVCC_SCREENGRID_COLUMNS,
-    CCX_DTVCC_SCREENGRID_ROWS,
+    CCX_DTVCC_DEFAULT_PEN_INDEX, CCX_DTVCC_MAX_COLUMNS, CCX_DTVCC_MAX_ROWS,
+    CCX_DTVCC_SCREENGRID_COLUMNS, CCX_DTVCC_SCREENGRID_ROWS,
 };
 use crate::{
     bindings::*,
@@ -966,13 +966,34 @@ impl dtvcc_service_decoder {
         unsafe {
             let tv = &mut *self.tv;
             for row in 0..copy_rows as usize {
-                for col in 0..CCX_DTVCC_SCREENGRID_COLUMNS as usize {
-                    if col < copy_cols as usize {
-                        tv.chars[top as usize + row][col] = window.rows[row].add(col).read();
-                    }
-                    tv.pen_attribs[top as usize + row][col] = window.pen_attribs[row][col];
-                    tv.pen_colors[top as usize + row][col] = window.pen_colors[row][col];
+                let tv_row = top as usize + row;
+                let window_row: &[dtvcc_symbol] = if copy_cols > 0 {
+                    std::slice::from_raw_parts(window.rows[row], copy_cols as usize)
+                } else {
+                    &[]
+                };
+                // Nothing to do if neither the window row nor the screen row holds text,
+                // pen settings of an empty row never reach the output
+                if !tv.row_may_have_text(tv_row) && !window_row.iter().any(|sym| sym.is_set()) {
+                    continue;
+                }
+                tv.chars[tv_row][..window_row.len()].copy_from_slice(window_row);
+                for col in 0..CCX_DTVCC_MAX_COLUMNS as usize {
+                    let color = &window.pen_colors[row][col];
+                    let attribs = &window.pen_attribs[row][col];
+                    // Runs of cells painted with the same pen reuse the previous lookup
+                    tv.pen_index[tv_row][col] = if col > 0
+                        && *color == window.pen_colors[row][col - 1]
+                        && *attribs == window.pen_attribs[row][col - 1]
+                    {
+                        tv.pen_index[tv_row][col - 1]
+                    } else {
+                        tv.intern_pen(color, attribs)
+                    };
                 }
+                tv.pen_index[tv_row][CCX_DTVCC_MAX_COLUMNS as usize..]
+                    .fill(CCX_DTVCC_DEFAULT_PEN_INDEX);
+                tv.mark_row_dirty(tv_row);
             }
 
             tv.update_time_show(window.time_ms_show);
@@ -1138,6 +1159,13 @@ impl dtvcc_service_decoder {
             return;
         }
 
+        if window.pen_row >= CCX_DTVCC_MAX_ROWS as i32
+            || window.pen_column >= CCX_DTVCC_MAX_COLUMNS as i32
+        {
+            debug!("dtvcc_process_character: pen is outside of the window, skipping");
+            return;
+        }
+
         window.is_empty = 0;
 
         // Add symbol to window
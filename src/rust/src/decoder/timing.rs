@@ -1,21 +1,19 @@
 //! Utilty functions to get timing for captions
 
-use crate::{bindings::*, cb_708, cb_field1, cb_field2};
+use crate::bindings::*;
 
 use log::{debug, error};
 
 impl ccx_common_timing_ctx {
     /// Return the current FTS
     pub fn get_fts(&self, current_field: u8) -> LLONG {
-        unsafe {
-            match current_field {
-                1 => self.fts_now + self.fts_global + cb_field1 as i64 * 1001 / 30,
-                2 => self.fts_now + self.fts_global + cb_field2 as i64 * 1001 / 30,
-                3 => self.fts_now + self.fts_global + cb_708 as i64 * 1001 / 30,
-                _ => {
-                    error!("get_fts: Unknown field");
-                    0
-                }
+        match current_field {
+            1 => self.fts_now + self.fts_global + self.cb_field1 as i64 * 1001 / 30,
+            2 => self.fts_now + self.fts_global + self.cb_field2 as i64 * 1001 / 30,
+            3 => self.fts_now + self.fts_global + self.cb_708 as i64 * 1001 / 30,
+            _ => {
+                error!("get_fts: Unknown field");
+                0
             }
         }
     }
@@ -102,7 +100,6 @@ mod test {
 
     #[test]
     fn test_get_fts() {
-        set_tmp_cb_values();
         let timing_ctx = get_temp_timing_ctx();
 
         // Case 1
@@ -117,7 +114,6 @@ mod test {
 
     #[test]
     fn test_get_visible_end() {
-        set_tmp_cb_values();
         let mut ctx = get_temp_timing_ctx();
         ctx.minimum_fts = 500;
 
@@ -138,7 +134,6 @@ mod test {
 
     #[test]
     fn test_get_visible_start() {
-        set_tmp_cb_values();
         let mut ctx = get_temp_timing_ctx();
         ctx.minimum_fts = 500;
 
@@ -246,18 +241,13 @@ mod test {
         );
     }
 
-    fn set_tmp_cb_values() {
-        unsafe {
-            cb_708 = 10;
-            cb_field1 = 20;
-            cb_field2 = 30;
-        }
-    }
-
     fn get_temp_timing_ctx() -> ccx_common_timing_ctx {
         ccx_common_timing_ctx {
             fts_now: 20,
             fts_global: 40,
+            cb_708: 10,
+            cb_field1: 20,
+            cb_field2: 30,
             ..Default::default()
         }
     }
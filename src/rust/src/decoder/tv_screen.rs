@@ -13,23 +13,37 @@ use std::{ffi::CStr, fs::File};
 #[cfg(windows)]
 use crate::bindings::_get_osfhandle;
 
-use super::output::{color_to_hex, is_utf16_charset, write_char, Writer};
+use super::output::{color_to_hex, write_char, Writer};
 use super::timing::{get_scc_time_str, get_time_str};
-use super::{CCX_DTVCC_SCREENGRID_COLUMNS, CCX_DTVCC_SCREENGRID_ROWS};
+use super::{
+    CCX_DTVCC_DEFAULT_PEN_INDEX, CCX_DTVCC_MAX_SCREEN_PENS, CCX_DTVCC_SCREENGRID_COLUMNS,
+    CCX_DTVCC_SCREENGRID_ROWS,
+};
 use crate::{
     bindings::*,
     utils::{is_false, is_true},
 };
-use encoding_rs::Encoding;
 
 use log::{debug, warn};
 
 impl dtvcc_tv_screen {
     /// Clear all text from TV screen
+    ///
+    /// Only rows touched since the previous clear are reset, after which
+    /// dirty row tracking is trusted by the emptiness checks.
     pub fn clear(&mut self) {
         for row in 0..CCX_DTVCC_SCREENGRID_ROWS as usize {
-            self.chars[row].fill(dtvcc_symbol::default());
+            if self.row_may_have_text(row) {
+                self.chars[row].fill(dtvcc_symbol::default());
+            }
         }
+        self.dirty_rows.fill(0);
+        self.dirty_tracking = 1;
+        self.pens[CCX_DTVCC_DEFAULT_PEN_INDEX as usize] = dtvcc_pen {
+            color: dtvcc_pen_color::default(),
+            attribs: dtvcc_pen_attribs::default(),
+        };
+        self.pen_count = 1;
         self.time_ms_hide = -1;
         self.time_ms_show = -1;
     }
@@ -127,6 +141,9 @@ impl dtvcc_tv_screen {
     pub fn get_write_interval(&self, row_index: usize) -> (usize, usize) {
         let mut first = 0;
         let mut last = 0;
+        if !self.row_may_have_text(row_index) {
+            return (first, last);
+        }
 
         for col in 0..CCX_DTVCC_SCREENGRID_COLUMNS as usize {
             if self.chars[row_index][col].is_set() {
@@ -165,79 +182,55 @@ impl dtvcc_tv_screen {
     /// Write all captions from the row to the output file
     ///
     /// If use_colors is 'true' then <font color="xxx"></font> tags are added to the output
+    ///
+    /// Tags are only emitted at the boundaries of runs of columns that share the same
+    /// pen color and attributes, so a row costs one comparison per column instead of
+    /// four tag checks.
     pub fn write_row(
         &self,
         writer: &mut Writer,
         row_index: usize,
         use_colors: bool,
     ) -> Result<(), String> {
-        let mut buf = Vec::new();
-        let mut pen_color = dtvcc_pen_color::default();
-        let mut pen_attribs = dtvcc_pen_attribs::default();
         let (first, last) = self.get_write_interval(row_index);
         debug!("First: {first}, Last: {last}");
 
         // Determine if we should use UTF-16 mode (2 bytes for all chars) or
         // variable-width mode (1 byte for ASCII, 2 bytes for extended chars).
-        // UTF-16/UCS-2 encodings require 2 bytes even for ASCII.
         // Variable-width encodings (EUC-KR, CP949, Shift-JIS, etc.) use 1 byte for ASCII.
-        let use_utf16 = if !writer.writer_ctx.charset.is_null() {
-            let charset = unsafe {
-                CStr::from_ptr(writer.writer_ctx.charset)
-                    .to_str()
-                    .unwrap_or("")
-            };
-            is_utf16_charset(charset)
-        } else {
-            // No charset specified - default to variable-width for backward compatibility
-            // with raw byte output (no encoding conversion)
-            false
-        };
+        let (encoding, use_utf16) = writer.transcoder();
 
-        for i in 0..last + 1 {
-            if use_colors {
-                self.change_pen_color(
-                    &pen_color,
-                    writer.no_font_color,
-                    row_index,
-                    i,
-                    false,
-                    &mut buf,
-                );
+        let mut buf = Vec::with_capacity((last + 1) * 2);
+        let mut pen_color = dtvcc_pen_color::default();
+        let mut pen_attribs = dtvcc_pen_attribs::default();
+        let pens = &self.pen_index[row_index][..=last];
+
+        let mut run_start = 0;
+        while run_start <= last {
+            let mut run_end = run_start + 1;
+            while run_end <= last && pens[run_end] == pens[run_start] {
+                run_end += 1;
             }
-            self.change_pen_attribs(
-                &pen_attribs,
-                writer.no_font_color,
-                row_index,
-                i,
-                false,
-                &mut buf,
-            );
-            self.change_pen_attribs(
+            self.change_pen(
+                &pen_color,
                 &pen_attribs,
                 writer.no_font_color,
+                use_colors,
                 row_index,
-                i,
-                true,
+                run_start,
                 &mut buf,
             );
-            if use_colors {
-                self.change_pen_color(
-                    &pen_color,
-                    writer.no_font_color,
-                    row_index,
-                    i,
-                    true,
-                    &mut buf,
-                )
-            }
-            pen_color = self.pen_colors[row_index][i];
-            pen_attribs = self.pen_attribs[row_index][i];
-            if i < first {
-                buf.push(b' ');
-            } else {
-                write_char(&self.chars[row_index][i], &mut buf, use_utf16)
+            let pen = &self.pens[pens[run_start] as usize];
+            pen_color = pen.color;
+            pen_attribs = pen.attribs;
+            for i in run_start..run_end {
+                if i < first {
+                    buf.push(b' ');
+                } else {
+                    write_char(&self.chars[row_index][i], &mut buf, use_utf16)
+                }
             }
+            run_start = run_end;
         }
         // there can be unclosed tags or colors after the last symbol in a row
         if use_colors {
@@ -260,27 +253,18 @@ impl dtvcc_tv_screen {
         );
         // Tags can still be crossed e.g <f><i>text</f></i>, but testing HTML code has shown that they still are handled correctly.
         if writer.writer_ctx.cd != (-1_isize) as iconv_t {
-            if writer.writer_ctx.charset.is_null() {
-                debug!("Charset: null");
-            } else {
-                let charset = unsafe {
-                    CStr::from_ptr(writer.writer_ctx.charset)
-                        .to_str()
-                        .map_err(|err| err.to_string())?
-                };
-                debug!("Charset: {charset}");
-
-                // Look up the encoding by label (name)
-                if let Some(encoding) = Encoding::for_label(charset.as_bytes()) {
-                    let (cow, _encoding_used, had_errors) = encoding.decode(&buf);
-                    if had_errors {
-                        println!("Warning: Had errors during encoding from {charset} to UTF-8");
-                    }
-                    if _encoding_used != encoding {
-                        println!("Warning: Encoding specified ({}) does not match encoding detected ({})",charset,_encoding_used.name());
-                    }
-                    writer.write_to_file(cow.as_bytes())?;
+            if let Some(encoding) = encoding {
+                let (cow, encoding_used, had_errors) = encoding.decode(&buf);
+                if had_errors {
+                    println!(
+                        "Warning: Had errors during encoding from {} to UTF-8",
+                        encoding.name()
+                    );
+                }
+                if encoding_used != encoding {
+                    println!("Warning: Encoding specified ({}) does not match encoding detected ({})",encoding.name(),encoding_used.name());
                 }
+                writer.write_to_file(cow.as_bytes())?;
             }
         } else {
             writer.write_to_file(&buf)?;
@@ -582,8 +566,44 @@ impl dtvcc_tv_screen {
         true
     }
 
+    /// Returns `false` if the row is known to be empty without scanning it
+    pub fn row_may_have_text(&self, row_index: usize) -> bool {
+        is_false(self.dirty_tracking) || self.dirty_rows[row_index] != 0
+    }
+
+    /// Mark the row as written since the last clear
+    pub fn mark_row_dirty(&mut self, row_index: usize) {
+        self.dirty_rows[row_index] = 1;
+    }
+
+    /// Returns the index of the pen in the screen's pen table, adding it if needed
+    ///
+    /// Screens only ever use a handful of pens, so a linear search is enough.
+    pub fn intern_pen(&mut self, color: &dtvcc_pen_color, attribs: &dtvcc_pen_attribs) -> u8 {
+        let count = self.pen_count as usize;
+        if let Some(index) = self.pens[..count]
+            .iter()
+            .position(|pen| pen.color == *color && pen.attribs == *attribs)
+        {
+            return index as u8;
+        }
+        if count == CCX_DTVCC_MAX_SCREEN_PENS as usize {
+            debug!("dtvcc_screen_intern_pen: pen table full, using default pen");
+            return CCX_DTVCC_DEFAULT_PEN_INDEX;
+        }
+        self.pens[count] = dtvcc_pen {
+            color: *color,
+            attribs: *attribs,
+        };
+        self.pen_count += 1;
+        count as u8
+    }
+
     /// Returns `true` if row has no text
     pub fn is_row_empty(&self, row_index: usize) -> bool {
+        if !self.row_may_have_text(row_index) {
+            return true;
+        }
         for col_index in 0..CCX_DTVCC_SCREENGRID_COLUMNS as usize {
             if self.chars[row_index][col_index].is_set() {
                 return false;
@@ -592,6 +612,28 @@ impl dtvcc_tv_screen {
         true
     }
 
+    /// Close the tags of the previous pen and open the ones of the pen at `col_index`
+    #[allow(clippy::too_many_arguments)]
+    fn change_pen(
+        &self,
+        pen_color: &dtvcc_pen_color,
+        pen_attribs: &dtvcc_pen_attribs,
+        no_font_color: bool,
+        use_colors: bool,
+        row_index: usize,
+        col_index: usize,
+        buf: &mut Vec<u8>,
+    ) {
+        if use_colors {
+            self.change_pen_color(pen_color, no_font_color, row_index, col_index, false, buf);
+        }
+        self.change_pen_attribs(pen_attribs, no_font_color, row_index, col_index, false, buf);
+        self.change_pen_attribs(pen_attribs, no_font_color, row_index, col_index, true, buf);
+        if use_colors {
+            self.change_pen_color(pen_color, no_font_color, row_index, col_index, true, buf);
+        }
+    }
+
     /// Add underline(<u>) and italic(<i>) tags according to the pen attributes
     ///
     /// Open specifies if tag is an opening or closing tag
@@ -610,7 +652,7 @@ impl dtvcc_tv_screen {
         let new_pen_attribs = if col_index >= CCX_DTVCC_SCREENGRID_COLUMNS as usize {
             dtvcc_pen_attribs::default()
         } else {
-            self.pen_attribs[row_index][col_index]
+            self.pens[self.pen_index[row_index][col_index] as usize].attribs
         };
 
         if pen_attribs.italic != new_pen_attribs.italic {
@@ -647,7 +689,7 @@ impl dtvcc_tv_screen {
         let new_pen_color = if col_index >= CCX_DTVCC_SCREENGRID_COLUMNS as usize {
             dtvcc_pen_color::default()
         } else {
-            self.pen_colors[row_index][col_index]
+            self.pens[self.pen_index[row_index][col_index] as usize].color
         };
         if pen_color.fg_color != new_pen_color.fg_color {
             if pen_color.fg_color != 0x3F && !open {
@@ -692,6 +734,51 @@ mod test {
         }
     }
 
+    #[test]
+    fn test_clear_tracks_dirty_rows() {
+        let mut screen = get_zero_allocated_obj::<dtvcc_tv_screen>();
+        screen.clear();
+
+        screen.chars[3][5] = dtvcc_symbol::new(0x41);
+        screen.mark_row_dirty(3);
+        assert!(!screen.is_row_empty(3));
+        assert!(screen.is_row_empty(4));
+        assert_eq!(screen.get_write_interval(3), (5, 5));
+
+        screen.clear();
+        assert_eq!(screen.chars[3][5], dtvcc_symbol::default());
+        assert!(!screen.row_may_have_text(3));
+    }
+
+    #[test]
+    fn test_intern_pen() {
+        let mut screen = get_zero_allocated_obj::<dtvcc_tv_screen>();
+        screen.clear();
+
+        let default_color = dtvcc_pen_color::default();
+        let default_attribs = dtvcc_pen_attribs::default();
+        assert_eq!(screen.intern_pen(&default_color, &default_attribs), 0);
+
+        let italic = dtvcc_pen_attribs {
+            italic: 1,
+            ..Default::default()
+        };
+        assert_eq!(screen.intern_pen(&default_color, &italic), 1);
+        assert_eq!(screen.intern_pen(&default_color, &italic), 1);
+        assert_eq!(screen.pen_count, 2);
+
+        screen.clear();
+        assert_eq!(screen.pen_count, 1);
+    }
+
+    #[test]
+    fn test_screen_memory_footprint() {
+        // Pens are stored once per screen and referenced by a 1 byte index per cell,
+        // keep the whole screen well below a full grid of pens (~819 KB)
+        let size = std::mem::size_of::<dtvcc_tv_screen>();
+        assert!(size < 100 * 1024, "dtvcc_tv_screen is {size} bytes");
+    }
+
     #[test]
     fn test_update_time_show() {
         let mut screen = get_zero_allocated_obj::<dtvcc_tv_screen>();
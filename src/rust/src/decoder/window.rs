@@ -559,11 +559,9 @@ impl PartialEq for dtvcc_pen_color {
 #[cfg(test)]
 mod test {
     use super::*;
-    use crate::{cb_708, cb_field1, cb_field2};
 
     #[test]
     fn test_update_time_show() {
-        set_test_cb_values();
         let mut timing = get_temp_timing_ctx();
         let mut window = dtvcc_window::default();
         window.update_time_show(&mut timing);
@@ -573,7 +571,6 @@ mod test {
 
     #[test]
     fn test_update_time_end() {
-        set_test_cb_values();
         let mut timing = get_temp_timing_ctx();
         let mut window = dtvcc_window::default();
         window.update_time_hide(&mut timing);
@@ -738,19 +735,14 @@ mod test {
         }
     }
 
-    fn set_test_cb_values() {
-        unsafe {
-            cb_708 = 10;
-            cb_field1 = 20;
-            cb_field2 = 30;
-        }
-    }
-
     fn get_temp_timing_ctx() -> ccx_common_timing_ctx {
         ccx_common_timing_ctx {
             fts_now: 20,
             fts_global: 40,
             minimum_fts: 500,
+            cb_708: 10,
+            cb_field1: 20,
+            cb_field2: 30,
             ..Default::default()
         }
     }
@@ -1,6 +1,7 @@
 use crate::bindings::{lib_ccx_ctx, list_head};
 use lib_ccxr::common::{Codec, Decoder608Report, DecoderDtvccReport, StreamMode, StreamType};
 use lib_ccxr::time::Timestamp;
+use std::os::raw::c_ulong;
 use std::ptr::null_mut;
 
 // Size of the Startbytes Array in CcxDemuxer - const 1MB
@@ -195,6 +196,9 @@ pub struct CcxDemuxer<'a> {
 
     pub strangeheader: i32, // Tracks if the last header was valid
 
+    pub gui_mode_reports: bool,    // Report network reads to the GUI
+    pub net_activity_gui: c_ulong, // Network reads so far, for the GUI reports
+
     pub parent: Option<&'a mut lib_ccx_ctx>,
     pub private_data: *mut std::ffi::c_void, // this could point at large variety of contexts, it's a raw pointer now but after all modules implemented we make it an Option<>
     #[cfg(feature = "enable_ffmpeg")]
@@ -259,6 +263,9 @@ impl Default for CcxDemuxer<'_> {
             warning_program_not_found_shown: false,
             strangeheader: 0,
 
+            gui_mode_reports: false,
+            net_activity_gui: 0,
+
             parent: None,
             private_data: null_mut(),
 
@@ -516,6 +516,8 @@ mod tests {
             bytesinbuffer: 999,
             warning_program_not_found_shown: false,
             strangeheader: 0,
+            gui_mode_reports: false,
+            net_activity_gui: 0,
             parent: None,
             private_data: null_mut(),
             #[cfg(feature = "enable_ffmpeg")]
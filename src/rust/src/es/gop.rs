@@ -4,10 +4,7 @@ use crate::libccxr_exports::time::{
     ccxr_set_current_pts, ccxr_set_fts,
 };
 use crate::process_hdcc;
-use crate::{
-    ccx_options, current_fps, first_gop_time, frames_since_ref_time, fts_at_gop_start, gop_time,
-    total_frames_count, MPEG_CLOCK_FREQ,
-};
+use crate::{ccx_options, MPEG_CLOCK_FREQ};
 use lib_ccxr::common::{BitStreamRust, BitstreamError};
 use lib_ccxr::dbg_es;
 use lib_ccxr::time::c_functions::print_mstime_static;
@@ -96,13 +93,13 @@ unsafe fn gop_header(
     gtc.time_code_seconds = esstream.read_bits(6)? as i32;
     gtc.time_code_pictures = esstream.read_bits(6)? as i32;
 
-    ccxr_calculate_ms_gop_time(&mut gtc as *mut gop_time_code);
+    ccxr_calculate_ms_gop_time(dec_ctx.timing, &mut gtc as *mut gop_time_code);
 
     if esstream.bits_left < 0 {
         return Ok(false);
     }
 
-    if ccxr_gop_accepted(&mut gtc as *mut gop_time_code) != 0 {
+    if ccxr_gop_accepted(dec_ctx.timing, &mut gtc as *mut gop_time_code) != 0 {
         // Do GOP padding during GOP header. The previous GOP and all
         // included captions are written. Use the current GOP time to
         // do the padding.
@@ -133,22 +130,23 @@ unsafe fn gop_header(
         // Report synchronization jumps between GOPs. Warn if there
         // are 20% or more deviation.
         if (ccx_options.debug_mask & 4 != 0)  // CCX_DMT_TIME = 4
-            && ((gtc.ms - gop_time.ms // more than 20% longer
-            > (dec_ctx.frames_since_last_gop as f64 * 1000.0 / current_fps * 1.2) as i64)
-            || (gtc.ms - gop_time.ms // or 20% shorter
-            < (dec_ctx.frames_since_last_gop as f64 * 1000.0 / current_fps * 0.8) as i64))
-            && first_gop_time.inited != 0
+            && ((gtc.ms - (*dec_ctx.timing).gop_time.ms // more than 20% longer
+            > (dec_ctx.frames_since_last_gop as f64 * 1000.0 / (*dec_ctx.timing).current_fps * 1.2) as i64)
+            || (gtc.ms - (*dec_ctx.timing).gop_time.ms // or 20% shorter
+            < (dec_ctx.frames_since_last_gop as f64 * 1000.0 / (*dec_ctx.timing).current_fps * 0.8) as i64))
+            && (*dec_ctx.timing).first_gop_time.inited != 0
         {
             info!("\rWarning: Jump in GOP timing.");
             info!(
                 "  (old) {}",
-                print_mstime_static(Timestamp::from_millis(gop_time.ms), ':')
+                print_mstime_static(Timestamp::from_millis((*dec_ctx.timing).gop_time.ms), ':')
             );
             info!(
                 "  +  {} ({}F)",
                 print_mstime_static(
                     Timestamp::from_millis(
-                        (dec_ctx.frames_since_last_gop as f64 * 1000.0 / current_fps) as i64
+                        (dec_ctx.frames_since_last_gop as f64 * 1000.0
+                            / (*dec_ctx.timing).current_fps) as i64
                     ),
                     ':'
                 ),
@@ -160,31 +158,32 @@ unsafe fn gop_header(
             );
         }
 
-        if first_gop_time.inited == 0 {
-            first_gop_time = gtc;
+        if (*dec_ctx.timing).first_gop_time.inited == 0 {
+            (*dec_ctx.timing).first_gop_time = gtc;
 
             // It needs to be "+1" because the frame count starts at 0 and we
             // need the length of all frames.
-            if total_frames_count == 0 {
+            if (*dec_ctx.timing).total_frames_count == 0 {
                 // If this is the first frame there cannot be an offset
                 (*dec_ctx.timing).fts_fc_offset = 0;
                 // first_gop_time.ms stays unchanged
             } else {
                 (*dec_ctx.timing).fts_fc_offset =
-                    ((total_frames_count + 1) as f64 * 1000.0 / current_fps) as i64;
+                    (((*dec_ctx.timing).total_frames_count + 1) as f64 * 1000.0
+                        / (*dec_ctx.timing).current_fps) as i64;
                 // Compensate for those written before
-                first_gop_time.ms -= (*dec_ctx.timing).fts_fc_offset;
+                (*dec_ctx.timing).first_gop_time.ms -= (*dec_ctx.timing).fts_fc_offset;
             }
 
             debug!(msg_type = DebugMessageFlag::TIME; "\nFirst GOP time: {:02}:{:02}:{:02}:{:03} {:+}ms",
                       gtc.time_code_hours,
                       gtc.time_code_minutes,
                       gtc.time_code_seconds,
-                      (1000.0 * gtc.time_code_pictures as f64 / current_fps) as u32,
+                      (1000.0 * gtc.time_code_pictures as f64 / (*dec_ctx.timing).current_fps) as u32,
                       (*dec_ctx.timing).fts_fc_offset);
         }
 
-        gop_time = gtc;
+        (*dec_ctx.timing).gop_time = gtc;
 
         dec_ctx.frames_since_last_gop = 0;
         // Indicate that we read a gop header (since last frame number 0)
@@ -197,17 +196,18 @@ unsafe fn gop_header(
                 (gtc.ms * (MPEG_CLOCK_FREQ as i64 / 1000)) as _,
             );
             (*dec_ctx.timing).current_tref = 0;
-            frames_since_ref_time = 0;
+            (*dec_ctx.timing).frames_since_ref_time = 0;
             ccxr_set_fts(dec_ctx.timing);
-            fts_at_gop_start = ccxr_get_fts_max(dec_ctx.timing);
+            (*dec_ctx.timing).fts_at_gop_start = ccxr_get_fts_max(dec_ctx.timing);
         } else {
             // FIXME: Wrong when PTS are not increasing but are identical
             // throughout the GOP and then jump to the next time for the
             // next GOP.
             // This effect will also lead to captions being one GOP early
             // for DVD captions.
-            fts_at_gop_start =
-                (ccxr_get_fts_max(dec_ctx.timing) as i32 + (1000.0 / current_fps) as i32) as _;
+            (*dec_ctx.timing).fts_at_gop_start = (ccxr_get_fts_max(dec_ctx.timing) as i32
+                + (1000.0 / (*dec_ctx.timing).current_fps) as i32)
+                as _;
         }
 
         if ccx_options.debug_mask & 4 != 0 {
@@ -1,9 +1,7 @@
 use crate::bindings::{cc_subtitle, encoder_ctx, lib_cc_decode};
+use crate::ccx_options;
 use crate::libccxr_exports::time::{ccxr_get_fts, ccxr_print_debug_timing, ccxr_set_fts};
 use crate::{anchor_hdcc, process_hdcc};
-use crate::{
-    ccx_options, current_fps, frames_since_ref_time, fts_at_gop_start, total_frames_count,
-};
 use lib_ccxr::common::{BitStreamRust, BitstreamError, FrameType};
 use lib_ccxr::debug;
 use lib_ccxr::util::log::DebugMessageFlag;
@@ -218,11 +216,13 @@ pub unsafe fn read_pic_info(
         if dec_ctx.saw_gop_header != 0 {
             // This time (fts_at_gop_start) that was set in the
             // GOP header and it might be off by one GOP. See the comment there.
-            frames_since_ref_time = dec_ctx.frames_since_last_gop; // Should this be 0?
+            (*dec_ctx.timing).frames_since_ref_time = dec_ctx.frames_since_last_gop;
+        // Should this be 0?
         } else {
             // No GOP header, use the current values
-            fts_at_gop_start = ccxr_get_fts(dec_ctx.timing, dec_ctx.current_field);
-            frames_since_ref_time = 0;
+            (*dec_ctx.timing).fts_at_gop_start =
+                ccxr_get_fts(dec_ctx.timing, dec_ctx.current_field);
+            (*dec_ctx.timing).frames_since_ref_time = 0;
         }
 
         if ccx_options.debug_mask & 4 != 0 {
@@ -268,17 +268,18 @@ pub unsafe fn read_pic_info(
     }
 
     dec_ctx.total_pulldownframes += extraframe;
-    total_frames_count += 1 + extraframe;
+    (*dec_ctx.timing).total_frames_count += 1 + extraframe;
     dec_ctx.frames_since_last_gop += (1 + extraframe) as c_int;
-    frames_since_ref_time += (1 + extraframe) as c_int;
+    (*dec_ctx.timing).frames_since_ref_time += (1 + extraframe) as c_int;
 
     // For elementary streams with GOP timing, update fts_now for each frame
     // based on the frame offset from GOP start. This is needed because
     // set_fts() is not called for each picture when use_gop_as_pts == 1.
     if ccx_options.use_gop_as_pts == 1 {
         // Calculate current FTS based on GOP start time + frame offset
-        let frame_offset_ms = (dec_ctx.frames_since_last_gop as f64 * 1000.0 / current_fps) as i64;
-        (*dec_ctx.timing).fts_now = fts_at_gop_start + frame_offset_ms;
+        let frame_offset_ms =
+            (dec_ctx.frames_since_last_gop as f64 * 1000.0 / (*dec_ctx.timing).current_fps) as i64;
+        (*dec_ctx.timing).fts_now = (*dec_ctx.timing).fts_at_gop_start + frame_offset_ms;
 
         // Update fts_max if needed
         if (*dec_ctx.timing).fts_now > (*dec_ctx.timing).fts_max {
@@ -1,5 +1,4 @@
 use crate::bindings::lib_cc_decode;
-use crate::current_fps;
 use lib_ccxr::activity::ActivityExt;
 use lib_ccxr::common::{
     BitStreamRust, BitstreamError, Options, ASPECT_RATIO_TYPES, FRAMERATES_TYPES, FRAMERATES_VALUES,
@@ -83,7 +82,7 @@ fn sequence_header(
             ctx.current_aspect_ratio = aspect_ratio;
             ctx.current_frame_rate = frame_rate;
             unsafe {
-                current_fps = FRAMERATES_VALUES[ctx.current_frame_rate as usize];
+                (*ctx.timing).current_fps = FRAMERATES_VALUES[ctx.current_frame_rate as usize];
             }
             ccx_options.activity_video_info(
                 hor_size,
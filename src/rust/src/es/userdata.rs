@@ -1,7 +1,6 @@
 /* Return a pointer to a string that holds the printable characters
  * of the caption data block. FOR DEBUG PURPOSES ONLY! */
 use crate::bindings::{cc_subtitle, encoder_ctx, lib_cc_decode};
-use crate::current_fps;
 use crate::es::core::dump;
 use crate::{decode_vbi, do_cb, store_hdcc};
 use lib_ccxr::common::{BitStreamRust, BitstreamError};
@@ -96,7 +95,8 @@ pub unsafe fn user_data(
         // last GOP.  Only useful when there are frames before
         // the GOP.
         if (*dec_ctx.timing).fts_max > 0 {
-            (*dec_ctx.timing).fts_now = (*dec_ctx.timing).fts_max + (1000.0 / current_fps) as i64;
+            (*dec_ctx.timing).fts_now =
+                (*dec_ctx.timing).fts_max + (1000.0 / (*dec_ctx.timing).current_fps) as i64;
         }
 
         let mut rcbcount = 0;
@@ -28,10 +28,10 @@ use std::os::raw::{c_char, c_void};
 
 cfg_if! {
     if #[cfg(test)] {
-        use crate::file_functions::file::tests::{terminate_asap, net_activity_gui, net_udp_read, net_tcp_read};
+        use crate::file_functions::file::tests::{net_udp_read, net_tcp_read};
     }
     else {
-        use crate::{terminate_asap, net_activity_gui, net_udp_read, net_tcp_read};
+        use crate::{net_udp_read, net_tcp_read};
     }
 }
 
@@ -255,8 +255,15 @@ pub unsafe fn switch_to_next_file(
 
     0
 }
+/// Whether the extraction the demuxer belongs to was asked to stop
+fn demuxer_terminating(ctx: &CcxDemuxer) -> bool {
+    ctx.parent
+        .as_ref()
+        .is_some_and(|parent| parent.terminate_asap != 0)
+}
+
 /// # Safety
-/// This function is unsafe because we are using raw file descriptors and variables imported from C like terminate_asap.
+/// This function is unsafe because we are using raw file descriptors.
 pub unsafe fn buffered_read_opt(
     ctx: &mut CcxDemuxer,
     buffer: *mut u8,
@@ -287,7 +294,7 @@ pub unsafe fn buffered_read_opt(
                 && ccx_options.live_stream.unwrap().millis() != 0))
             && bytes > 0
         {
-            if terminate_asap != 0 {
+            if demuxer_terminating(ctx) {
                 break;
             }
             if eof {
@@ -434,7 +441,7 @@ pub unsafe fn buffered_read_opt(
                             .map_or(ptr::null(), |s| s.as_ptr() as *const c_char),
                     ) as isize
                 };
-                if terminate_asap != 0 {
+                if demuxer_terminating(ctx) {
                     // Looks like receiving a signal here will trigger a -1, so check that first
                     break;
                 }
@@ -506,7 +513,7 @@ pub unsafe fn buffered_read_opt(
                 {
                     break;
                 }
-                if terminate_asap != 0 {
+                if demuxer_terminating(ctx) {
                     break;
                 }
                 if i == -1 {
@@ -522,7 +529,7 @@ pub unsafe fn buffered_read_opt(
             return copied;
         }
         while bytes != 0 && ctx.infd != -1 {
-            if terminate_asap != 0 {
+            if demuxer_terminating(ctx) {
                 break;
             }
             #[cfg(unix)]
@@ -670,11 +677,10 @@ pub unsafe fn buffered_read(
 
         let result = buffered_read_opt(ctx, ptr, bytes, ccx_options);
 
-        if ccx_options.gui_mode_reports && ccx_options.input_source == DataSource::Network {
-            net_activity_gui += 1;
-            if net_activity_gui.is_multiple_of(1000) {
-                #[allow(static_mut_refs)]
-                ccx_options.activity_report_data_read(&mut net_activity_gui);
+        if ctx.gui_mode_reports && ccx_options.input_source == DataSource::Network {
+            ctx.net_activity_gui += 1;
+            if ctx.net_activity_gui.is_multiple_of(1000) {
+                ccx_options.activity_report_data_read(&mut ctx.net_activity_gui);
             }
         }
 
@@ -780,7 +786,7 @@ mod tests {
     use std::ffi::CString;
     #[cfg(feature = "sanity_check")]
     use std::io::Write;
-    use std::os::raw::{c_char, c_int, c_ulong, c_void};
+    use std::os::raw::{c_char, c_int, c_void};
     #[cfg(unix)]
     use std::os::unix::io::IntoRawFd;
     #[cfg(windows)]
@@ -792,8 +798,6 @@ mod tests {
     use tempfile::tempfile;
 
     static INIT: Once = Once::new();
-    pub static mut terminate_asap: i32 = 0;
-    pub static mut net_activity_gui: c_ulong = 0;
     pub fn net_udp_read(
         _socket: c_int,
         _buffer: *mut c_void,
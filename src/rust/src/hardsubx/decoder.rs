@@ -15,12 +15,19 @@ use std::ptr::null;
 // use crate::bindings::{hardsubx_ocr_mode_HARDSUBX_OCRMODE_WORD};
 use crate::bindings::AVFrame;
 use crate::hardsubx::classifier::*;
-use crate::hardsubx::imgops::{rgb_to_hsv, rgb_to_lab};
+use crate::hardsubx::imgops::{
+    lab_lightness_luma_threshold, luma_levels, rgb_to_hsv, rgb_to_lab, white_text_luma_row,
+    white_text_row,
+};
 use crate::hardsubx::lib_hardsubx_ctx;
 use crate::utils::string_to_c_char;
 
 static EXIT_MALFORMED_PARAMETER: i32 = 7;
 
+// enum hardsubx_band_source
+static HARDSUBX_BAND_RGB: i32 = 0;
+static HARDSUBX_BAND_LUMA_FULL_RANGE: i32 = 2;
+
 // TODO: turn into an enum definition when the hardsubx context is rewritten
 // static HARDSUBX_OCRMODE_FRAME: i32 = 0;
 static HARDSUBX_OCRMODE_WORD: i32 = 1;
@@ -70,6 +77,23 @@ pub unsafe fn dispatch_classifier_functions(ctx: *mut lib_hardsubx_ctx, im: *mut
     }
 }
 
+/// Returns `*pix` if it already has the given geometry, otherwise replaces it with a new image.
+///
+/// # Safety
+/// `pix` must point to a null or valid leptonica image owned by the caller
+unsafe fn reuse_pix(pix: *mut *mut Pix, width: i32, height: i32, depth: i32) -> *mut Pix {
+    if !(*pix).is_null()
+        && pixGetWidth(*pix) == width
+        && pixGetHeight(*pix) == height
+        && pixGetDepth(*pix) == depth
+    {
+        return *pix;
+    }
+    pixDestroy(pix);
+    *pix = pixCreate(width, height, depth);
+    *pix
+}
+
 /// # Safety
 /// The function dereferences a raw pointer
 /// The function also calls other functions whose safety is not guaranteed
@@ -83,54 +107,62 @@ pub unsafe extern "C" fn _process_frame_white_basic(
     height: ::std::os::raw::c_int,
     _index: ::std::os::raw::c_int,
 ) -> *mut ::std::os::raw::c_char {
-    let mut im: *mut Pix = pixCreate(width, height, 32);
-    let mut lum_im: *mut Pix = pixCreate(width, height, 32);
+    // Only the subtitle band at the bottom of the frame is examined. The gray and
+    // luminance planes are produced by one fused pass over the band rows, read either
+    // from the RGB frame or straight from the Y plane of the decoded frame, into band
+    // sized images that are kept in the context and reused for every frame.
+    let top = (*ctx).band_top;
+    let band_source = (*ctx).band_source;
+    let band_height = height - top;
     let frame_deref = *frame;
 
-    for i in (3 * height / 4)..height {
-        for j in 0..width {
-            let p: isize = (j * 3 + i * frame_deref.linesize[0]) as isize;
-            let r: i32 = (*(frame_deref.data[0]).offset(p)).into();
-            let g: i32 = (*(frame_deref.data[0]).offset(p + 1)).into();
-            let b: i32 = (*(frame_deref.data[0]).offset(p + 2)).into();
-            pixSetRGBPixel(im, j, i, r, g, b);
-
-            let mut L: f32 = 0.0;
-            let mut A: f32 = 0.0;
-            let mut B: f32 = 0.0;
-
-            rgb_to_lab(r as f32, g as f32, b as f32, &mut L, &mut A, &mut B);
+    let gray_im = reuse_pix(&mut (*ctx).band_gray, width, band_height, 8);
+    let lum_im = reuse_pix(&mut (*ctx).band_lum, width, band_height, 1);
+    let luma_min = lab_lightness_luma_threshold((*ctx).lum_thresh);
+    let levels = luma_levels(band_source == HARDSUBX_BAND_LUMA_FULL_RANGE);
+
+    let mut gray_row = vec![0u8; width as usize];
+    let mut bright_row = vec![0u8; width as usize];
+    let gray_wpl = pixGetWpl(gray_im) as usize;
+    let lum_wpl = pixGetWpl(lum_im) as usize;
+
+    for i in 0..band_height {
+        let row = frame_deref.data[0].offset(((top + i) * frame_deref.linesize[0]) as isize);
+        if band_source == HARDSUBX_BAND_RGB {
+            let rgb = std::slice::from_raw_parts(row, width as usize * 3);
+            white_text_row(rgb, &mut gray_row, &mut bright_row, luma_min);
+        } else {
+            let luma = std::slice::from_raw_parts(row, width as usize);
+            white_text_luma_row(luma, &mut gray_row, &mut bright_row, &levels, luma_min);
+        }
 
-            if L > (*ctx).lum_thresh {
-                pixSetRGBPixel(lum_im, j, i, 255, 255, 255);
-            } else {
-                pixSetRGBPixel(lum_im, j, i, 0, 0, 0);
-            }
+        // leptonica stores 8 bpp pixels big-endian and 1 bpp pixels MSB first in 32-bit words
+        let gray_line = std::slice::from_raw_parts_mut(
+            pixGetData(gray_im).add(i as usize * gray_wpl),
+            gray_wpl,
+        );
+        for (word, px) in gray_line.iter_mut().zip(gray_row.chunks(4)) {
+            let mut bytes = [0u8; 4];
+            bytes[..px.len()].copy_from_slice(px);
+            *word = u32::from_be_bytes(bytes);
+        }
+        let lum_line =
+            std::slice::from_raw_parts_mut(pixGetData(lum_im).add(i as usize * lum_wpl), lum_wpl);
+        for (word, px) in lum_line.iter_mut().zip(bright_row.chunks(32)) {
+            *word = px
+                .iter()
+                .enumerate()
+                .fold(0, |w, (k, &m)| w | (m as u32) << (31 - k));
         }
     }
 
-    let mut gray_im: *mut Pix = pixConvertRGBToGray(im, 0.0, 0.0, 0.0);
     let mut sobel_edge_im: *mut Pix = pixSobelEdgeFilter(gray_im, L_VERTICAL_EDGES as i32);
     let mut dilate_gray_im: *mut Pix = pixDilateGray(sobel_edge_im, 21, 11);
     let mut edge_im: *mut Pix = pixThresholdToBinary(dilate_gray_im, 50);
 
-    let mut feat_im: *mut Pix = pixCreate(width, height, 32);
-
-    for i in (3 * (height / 4))..height {
-        for j in 0..width {
-            let mut p1: u32 = 0;
-            let mut p2: u32 = 0;
-
-            pixGetPixel(edge_im, j, i, &mut p1);
-            pixGetPixel(lum_im, j, i, &mut p2);
-
-            if p1 == 0 && p2 > 0 {
-                pixSetRGBPixel(feat_im, j, i, 255, 255, 255);
-            } else {
-                pixSetRGBPixel(feat_im, j, i, 0, 0, 0);
-            }
-        }
-    }
+    // Features are bright pixels close to a vertical edge, i.e. not set in edge_im
+    let mut feat_bin_im: *mut Pix = pixSubtract(null::<Pix>() as *mut Pix, lum_im, edge_im);
+    let mut feat_im: *mut Pix = pixConvert1To8(null::<Pix>() as *mut Pix, feat_bin_im, 0, 255);
 
     if (*ctx).detect_italics != 0 {
         (*ctx).ocr_mode = HARDSUBX_OCRMODE_WORD;
@@ -138,12 +170,10 @@ pub unsafe extern "C" fn _process_frame_white_basic(
 
     let subtitle_text = dispatch_classifier_functions(ctx, feat_im);
 
-    pixDestroy(&mut im as *mut *mut Pix);
-    pixDestroy(&mut gray_im as *mut *mut Pix);
     pixDestroy(&mut sobel_edge_im as *mut *mut Pix);
     pixDestroy(&mut dilate_gray_im as *mut *mut Pix);
     pixDestroy(&mut edge_im as *mut *mut Pix);
-    pixDestroy(&mut lum_im as *mut *mut Pix);
+    pixDestroy(&mut feat_bin_im as *mut *mut Pix);
     pixDestroy(&mut feat_im as *mut *mut Pix);
 
     string_to_c_char(&subtitle_text)
@@ -165,8 +195,10 @@ pub unsafe extern "C" fn _process_frame_color_basic(
     let mut im: *mut Pix = pixCreate(width, height, 32);
     let mut hue_im: *mut Pix = pixCreate(width, height, 32);
     let frame_deref = *frame;
+    // Only the subtitle band rows of the frame have been converted
+    let top = (*ctx).band_top;
 
-    for i in 0..height {
+    for i in top..height {
         for j in 0..width {
             let p: isize = (j * 3 + i * frame_deref.linesize[0]) as isize;
             let r: i32 = (*(frame_deref.data[0]).offset(p)).into();
@@ -208,7 +240,7 @@ pub unsafe extern "C" fn _process_frame_color_basic(
 
     let mut feat_im: *mut Pix = pixCreate(width, height, 32);
 
-    for i in (3 * (height / 4))..height {
+    for i in top..height {
         for j in 0..width {
             let mut p1: u32 = 0;
             let mut p2: u32 = 0;
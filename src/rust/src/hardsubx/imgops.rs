@@ -36,6 +36,94 @@ pub extern "C" fn rgb_to_lab(R: f32, G: f32, B: f32, L: &mut f32, a: &mut f32, b
     *b = lab_rep.b;
 }
 
+/// Weights of CIE Y (relative luminance) for linear sRGB primaries, in 1/65536 units.
+///
+/// They sum to 65536, so `luma_fixed` of a pixel ranges over `0..=255 * 65536`.
+const LUMA_WEIGHTS: [u32; 3] = [13938, 46868, 4730];
+
+/// Fixed-point luminance of a pixel, `Y * 255 * 65536` for the `rgb_to_lab` interpretation of RGB.
+#[inline]
+fn luma_fixed(r: u8, g: u8, b: u8) -> u32 {
+    LUMA_WEIGHTS[0] * r as u32 + LUMA_WEIGHTS[1] * g as u32 + LUMA_WEIGHTS[2] * b as u32
+}
+
+/// Smallest fixed-point luminance whose Lab lightness is above `l_thresh`.
+///
+/// Lab L only depends on Y, so `L > l_thresh` from [`rgb_to_lab`] reduces to an integer
+/// comparison against the value returned here, without a per-pixel float conversion.
+pub fn lab_lightness_luma_threshold(l_thresh: f32) -> u32 {
+    // Inverse of L = 116 * f(Y) - 16, with the CIE linear segment below epsilon
+    const KAPPA: f64 = 24389.0 / 27.0;
+    let fy = (l_thresh as f64 + 16.0) / 116.0;
+    let y = if fy > 6.0 / 29.0 {
+        fy * fy * fy
+    } else {
+        l_thresh as f64 / KAPPA
+    };
+    let scaled = y * 255.0 * 65536.0;
+    if scaled < 0.0 {
+        0
+    } else {
+        (scaled.floor() + 1.0).min(u32::MAX as f64) as u32
+    }
+}
+
+/// Fused preprocessing kernel for white subtitle text, run over one RGB24 row.
+///
+/// Writes the leptonica-weighted gray value of each pixel into `gray` (the input of the
+/// edge filter) and 1 or 0 into `bright` depending on whether its luminance reaches
+/// `luma_min` (see [`lab_lightness_luma_threshold`]). The loop has no branches or
+/// float math, so the compiler vectorizes it.
+pub fn white_text_row(rgb: &[u8], gray: &mut [u8], bright: &mut [u8], luma_min: u32) {
+    for ((px, g), m) in rgb
+        .chunks_exact(3)
+        .zip(gray.iter_mut())
+        .zip(bright.iter_mut())
+    {
+        let (r, gr, b) = (px[0], px[1], px[2]);
+        // Same weights and rounding as pixConvertRGBToGray(.., 0.0, 0.0, 0.0)
+        *g = ((3 * r as u32 + 5 * gr as u32 + 2 * b as u32 + 5) / 10) as u8;
+        *m = (luma_fixed(r, gr, b) >= luma_min) as u8;
+    }
+}
+
+/// Maps the Y plane codes of a video frame to full range gray levels.
+///
+/// Limited range video puts black at 16 and white at 235.
+pub fn luma_levels(full_range: bool) -> [u8; 256] {
+    let mut levels = [0u8; 256];
+    for (v, level) in levels.iter_mut().enumerate() {
+        *level = if full_range {
+            v as u8
+        } else {
+            (((v.clamp(16, 235) - 16) * 255 + 109) / 219) as u8
+        };
+    }
+    levels
+}
+
+/// Fused preprocessing kernel for white subtitle text, run over one row of a Y plane.
+///
+/// The counterpart of [`white_text_row`] for frames read without RGB conversion: the
+/// gray value is the Y level itself, and a pixel is bright when its level reaches
+/// `luma_min` (see [`lab_lightness_luma_threshold`]), treating Y as the luminance of a
+/// gray pixel of that level.
+pub fn white_text_luma_row(
+    luma: &[u8],
+    gray: &mut [u8],
+    bright: &mut [u8],
+    levels: &[u8; 256],
+    luma_min: u32,
+) {
+    // A gray pixel of level v has luma_fixed(v, v, v) = 65536 * v
+    let min_level = ((luma_min as u64 + 65535) / 65536) as u32;
+    for ((&y, g), m) in luma.iter().zip(gray.iter_mut()).zip(bright.iter_mut()) {
+        let level = levels[y as usize];
+        *g = level;
+        *m = (level as u32 >= min_level) as u8;
+    }
+}
+
 #[cfg(test)]
 mod test {
     use super::*;
@@ -97,4 +185,74 @@ mod test {
         assert_eq!(a.floor(), 0.0);
         assert_eq!(b.floor(), 0.0);
     }
+
+    #[test]
+    fn test_lab_lightness_luma_threshold_matches_rgb_to_lab() {
+        for &thresh in &[-5.0_f32, 0.0, 5.0, 8.0, 50.0, 80.0, 95.0, 100.0] {
+            let luma_min = lab_lightness_luma_threshold(thresh);
+            for v in (0..=255).step_by(3) {
+                for &(r, g, b) in &[
+                    (v, v, v),
+                    (v, 0, 0),
+                    (0, v, 0),
+                    (0, 0, v),
+                    (v, 255 - v, v / 2),
+                ] {
+                    let (mut l, mut a, mut bb) = (0.0, 0.0, 0.0);
+                    rgb_to_lab(r as f32, g as f32, b as f32, &mut l, &mut a, &mut bb);
+                    // Pixels within float noise of the threshold may go either way
+                    if (l - thresh).abs() < 0.01 {
+                        continue;
+                    }
+                    assert_eq!(
+                        luma_fixed(r, g, b) >= luma_min,
+                        l > thresh,
+                        "rgb ({}, {}, {}) L {} threshold {}",
+                        r,
+                        g,
+                        b,
+                        l,
+                        thresh
+                    );
+                }
+            }
+        }
+    }
+
+    #[test]
+    fn test_white_text_row() {
+        let rgb = [0, 0, 0, 255, 255, 255, 10, 200, 30, 128, 128, 128];
+        let mut gray = [0; 4];
+        let mut bright = [0; 4];
+        white_text_row(
+            &rgb,
+            &mut gray,
+            &mut bright,
+            lab_lightness_luma_threshold(95.0),
+        );
+        assert_eq!(gray, [0, 255, 109, 128]);
+        assert_eq!(bright, [0, 1, 0, 0]);
+    }
+
+    #[test]
+    fn test_white_text_luma_row() {
+        let levels = luma_levels(false);
+        assert_eq!(
+            (levels[0], levels[16], levels[126], levels[235], levels[255]),
+            (0, 0, 128, 255, 255)
+        );
+        assert_eq!(luma_levels(true)[100], 100);
+
+        let luma = [16, 235, 200, 240];
+        let mut gray = [0; 4];
+        let mut bright = [0; 4];
+        let luma_min = lab_lightness_luma_threshold(95.0);
+        white_text_luma_row(&luma, &mut gray, &mut bright, &levels, luma_min);
+        assert_eq!(gray, [0, 255, 214, 255]);
+        assert_eq!(bright, [0, 1, 0, 1]);
+        // Same decision as the RGB kernel for the equivalent gray pixels
+        for (&g, &b) in gray.iter().zip(bright.iter()) {
+            assert_eq!(luma_fixed(g, g, g) >= luma_min, b == 1);
+        }
+    }
 }
@@ -54,4 +54,9 @@ pub struct lib_hardsubx_ctx {
     pub conf_thresh: f32,
     pub hue: f32,
     pub lum_thresh: f32,
+    pub band_gray: *mut Pix,
+    pub band_lum: *mut Pix,
+    pub band_height: f32,
+    pub band_top: ::std::os::raw::c_int,
+    pub band_source: ::std::os::raw::c_int,
 }
@@ -45,36 +45,22 @@ use utils::is_true;
 
 use env_logger::{builder, Target};
 use log::{warn, LevelFilter};
-#[cfg(not(test))]
-use std::os::raw::c_ulong;
 use std::os::raw::{c_uchar, c_void};
 use std::{
     ffi::CStr,
     io::Write,
-    os::raw::{c_char, c_double, c_int, c_uint},
+    os::raw::{c_char, c_int, c_uint},
 };
 
 // Mock data for rust unit tests
 cfg_if! {
     if #[cfg(test)] {
-        static mut cb_708: c_int = 0;
-        static mut cb_field1: c_int = 0;
-        static mut cb_field2: c_int = 0;
-        static mut current_fps: c_double = 30.0;
         static mut usercolor_rgb: [c_int; 8] = [0; 8];
         static mut FILEBUFFERSIZE: c_int = 0;
         static mut MPEG_CLOCK_FREQ: c_int = 90000;
 
-        static mut frames_since_ref_time: c_int = 0;
-        static mut total_frames_count: c_uint = 0;
-        static mut fts_at_gop_start: i64 = 0;
-        static mut gop_rollover: c_int = 0;
-        static mut pts_big_change: c_uint = 0;
-
         static mut tlt_config: ccx_s_teletext_config = unsafe { std::mem::zeroed() };
         static mut ccx_options: ccx_s_options = unsafe { std::mem::zeroed() };
-        static mut gop_time: gop_time_code = unsafe { std::mem::zeroed() };
-        static mut first_gop_time: gop_time_code = unsafe { std::mem::zeroed() };
         static mut ccx_common_timing_settings: ccx_common_timing_settings_t = unsafe { std::mem::zeroed() };
         static mut capitalization_list: word_list = unsafe { std::mem::zeroed() };
         static mut profane: word_list = unsafe { std::mem::zeroed() };
@@ -129,27 +115,14 @@ cfg_if! {
 // External C symbols (only when not testing)
 #[cfg(not(test))]
 extern "C" {
-    static mut cb_708: c_int;
-    static mut cb_field1: c_int;
-    static mut cb_field2: c_int;
-    static mut current_fps: c_double;
     static mut usercolor_rgb: [c_int; 8];
     static mut FILEBUFFERSIZE: c_int;
-    static mut terminate_asap: c_int;
-    static mut net_activity_gui: c_ulong;
     static mut MPEG_CLOCK_FREQ: c_int;
     static mut tlt_config: ccx_s_teletext_config;
     static mut ccx_options: ccx_s_options;
-    static mut frames_since_ref_time: c_int;
-    static mut total_frames_count: c_uint;
-    static mut gop_time: gop_time_code;
-    static mut first_gop_time: gop_time_code;
-    static mut fts_at_gop_start: i64;
-    static mut gop_rollover: c_int;
     static mut ccx_common_timing_settings: ccx_common_timing_settings_t;
     static mut capitalization_list: word_list;
     static mut profane: word_list;
-    static mut pts_big_change: c_uint;
 
     fn version(location: *const c_char);
     fn set_binary_mode();
@@ -373,53 +346,32 @@ pub extern "C" fn ccxr_dtvcc_is_active(dtvcc_ptr: *mut std::ffi::c_void) -> i32
     }
 }
 
-/// Process cc_data
+/// Feeds the DTVCC (CEA-708) triplets of a frame to the 708 decoder in one call
+///
+/// The C side (`process_cc_data`) has already validated and demultiplexed the frame's
+/// cc_data and checked the extraction window, so every triplet is a valid type 2 or 3
+/// block that should be decoded.
 ///
 /// # Safety
-/// dec_ctx should not be a null pointer
+/// dtvcc_rust must point to a valid DtvccRust instance
 /// data should point to cc_data of length cc_count
-/// dec_ctx.dtvcc_rust must point to a valid DtvccRust instance
 #[no_mangle]
-extern "C" fn ccxr_process_cc_data(
-    dec_ctx: *mut lib_cc_decode,
+extern "C" fn ccxr_process_dtvcc_triplets(
+    dtvcc_rust: *mut std::ffi::c_void,
     data: *const ::std::os::raw::c_uchar,
     cc_count: c_int,
-) -> c_int {
-    // Null pointer and bounds checks
-    if dec_ctx.is_null() || data.is_null() || cc_count <= 0 {
-        return -1;
-    }
-
-    let dec_ctx = unsafe { &mut *dec_ctx };
-
-    // Check dtvcc_rust pointer before dereferencing (not dtvcc!)
-    // When Rust is enabled, dtvcc is NULL and dtvcc_rust holds the actual context
-    if dec_ctx.dtvcc_rust.is_null() {
-        return -1;
-    }
-
-    let mut ret = -1;
-    let mut cc_data: Vec<u8> = (0..cc_count * 3)
-        .map(|x| unsafe { *data.add(x as usize) })
-        .collect();
-    // Use the persistent DtvccRust context from dtvcc_rust
-    let dtvcc_rust = dec_ctx.dtvcc_rust as *mut DtvccRust;
-    if dtvcc_rust.is_null() {
-        warn!("ccxr_process_cc_data: dtvcc_rust is null");
-        return ret;
+) {
+    if dtvcc_rust.is_null() || data.is_null() || cc_count <= 0 {
+        return;
     }
-    let dtvcc = unsafe { &mut *dtvcc_rust };
 
-    for cc_block in cc_data.chunks_exact_mut(3) {
-        if !validate_cc_pair(cc_block) {
-            continue;
-        }
-        let success = do_cb_dtvcc_rust(dec_ctx, dtvcc, cc_block);
-        if success {
-            ret = 0;
-        }
+    let dtvcc = unsafe { &mut *(dtvcc_rust as *mut DtvccRust) };
+    let cc_data = unsafe { std::slice::from_raw_parts(data, cc_count as usize * 3) };
+    for cc_block in cc_data.chunks_exact(3) {
+        let cc_valid = (cc_block[0] & 4) >> 2;
+        let cc_type = cc_block[0] & 3;
+        dtvcc.process_cc_data(cc_valid, cc_type, cc_block[1], cc_block[2]);
     }
-    ret
 }
 
 /// Validates a closed caption block pair for both CEA-608 and CEA-708 data.
@@ -524,60 +476,9 @@ pub fn do_cb_dtvcc(ctx: &mut lib_cc_decode, dtvcc: &mut Dtvcc, cc_block: &[u8])
                 if timeok && ctx.write_format != ccx_output_format::CCX_OF_RAW {
                     dtvcc.process_cc_data(cc_valid, cc_type, cc_block[1], cc_block[2]);
                 }
-                unsafe { cb_708 += 1 }
-            }
-            _ => warn!("Invalid cc_type"),
-        }
-    }
-    true
-}
-
-/// Process CC data according to its type (using DtvccRust - persistent context)
-pub fn do_cb_dtvcc_rust(ctx: &mut lib_cc_decode, dtvcc: &mut DtvccRust, cc_block: &[u8]) -> bool {
-    let cc_valid = (cc_block[0] & 4) >> 2;
-    let cc_type = cc_block[0] & 3;
-    let mut timeok = true;
-
-    if ctx.write_format != ccx_output_format::CCX_OF_DVDRAW
-        && ctx.write_format != ccx_output_format::CCX_OF_RAW
-        && (cc_block[0] == 0xFA || cc_block[0] == 0xFC || cc_block[0] == 0xFD)
-        && (cc_block[1] & PARITY_BIT_MASK) == 0
-        && (cc_block[2] & PARITY_BIT_MASK) == 0
-    {
-        return true;
-    }
-
-    if cc_valid == 1 || cc_type == 3 {
-        ctx.cc_stats[cc_type as usize] += 1;
-        match cc_type {
-            // Type 0 and 1 are for CEA-608 data. Handled by C code, do nothing
-            0 | 1 => {}
-            // Type 2 and 3 are for CEA-708 data.
-            2 | 3 => {
-                let current_time = if ctx.timing.is_null() {
-                    0
-                } else {
-                    unsafe { (*ctx.timing).get_fts(ctx.current_field as u8) }
-                };
-                ctx.current_field = 3;
-
-                // Check whether current time is within start and end bounds
-                if is_true(ctx.extraction_start.set)
-                    && current_time < ctx.extraction_start.time_in_ms
-                {
-                    timeok = false;
-                }
-                if is_true(ctx.extraction_end.set) && current_time > ctx.extraction_end.time_in_ms {
-                    timeok = false;
-                    ctx.processed_enough = 1;
+                if !ctx.timing.is_null() {
+                    unsafe { (*ctx.timing).cb_708 += 1 }
                 }
-
-                if timeok && ctx.write_format != ccx_output_format::CCX_OF_RAW {
-                    dtvcc.process_cc_data(cc_valid, cc_type, cc_block[1], cc_block[2]);
-                }
-                // Note: cb_708 is incremented by the C code in do_cb(), not here.
-                // Previously incrementing here caused a double-increment bug that
-                // resulted in incorrect start timestamps.
             }
             _ => warn!("Invalid cc_type"),
         }
@@ -794,14 +695,18 @@ mod test {
     fn test_do_cb() {
         let mut dtvcc_ctx = crate::decoder::test::initialize_dtvcc_ctx();
         let mut dtvcc = Dtvcc::new(&mut dtvcc_ctx);
-        let mut decoder_ctx = lib_cc_decode::default();
+        let mut timing = ccx_common_timing_ctx::default();
+        let mut decoder_ctx = lib_cc_decode {
+            timing: &mut timing,
+            ..Default::default()
+        };
         let cc_block = [0x97, 0x1F, 0x3C];
 
         assert!(do_cb_dtvcc(&mut decoder_ctx, &mut dtvcc, &cc_block));
         assert_eq!(decoder_ctx.current_field, 3);
         assert_eq!(decoder_ctx.cc_stats[3], 1);
         assert_eq!(decoder_ctx.processed_enough, 0);
-        assert_eq!(unsafe { cb_708 }, 11);
+        assert_eq!(timing.cb_708, 1);
     }
 
     #[test]
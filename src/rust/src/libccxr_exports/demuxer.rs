@@ -195,6 +195,8 @@ pub unsafe fn copy_demuxer_from_rust_to_c(c_demuxer: *mut ccx_demuxer, rust_demu
     // Warnings and flags
     c.warning_program_not_found_shown = rust_demuxer.warning_program_not_found_shown as c_int;
     c.strangeheader = rust_demuxer.strangeheader;
+    c.gui_mode_reports = rust_demuxer.gui_mode_reports as c_int;
+    c.net_activity_gui = rust_demuxer.net_activity_gui;
 
     // Parent context
     if rust_demuxer.parent.is_some() {
@@ -303,6 +305,8 @@ pub unsafe fn copy_demuxer_from_c_to_rust(ccx: *const ccx_demuxer) -> CcxDemuxer
 
     let warning_program_not_found_shown = c.warning_program_not_found_shown != 0;
     let strangeheader = c.strangeheader;
+    let gui_mode_reports = c.gui_mode_reports != 0;
+    let net_activity_gui = c.net_activity_gui;
 
     // Context and private data
     let mut parent = None;
@@ -357,6 +361,8 @@ pub unsafe fn copy_demuxer_from_c_to_rust(ccx: *const ccx_demuxer) -> CcxDemuxer
         bytesinbuffer,
         warning_program_not_found_shown,
         strangeheader,
+        gui_mode_reports,
+        net_activity_gui,
         parent,
         private_data,
         #[cfg(feature = "enable_ffmpeg")]
@@ -742,6 +748,8 @@ mod tests {
             bytesinbuffer: 222,
             warning_program_not_found_shown: false,
             strangeheader: 333,
+            gui_mode_reports: true,
+            net_activity_gui: 4444,
             parent: Some(&mut parent),
             private_data: raw_ctx as *mut c_void,
             #[cfg(feature = "enable_ffmpeg")]
@@ -855,6 +863,8 @@ mod tests {
         // Numeric fields
         assert_eq!(c_demuxer.multi_stream_per_prog, 88);
         assert_eq!(c_demuxer.strangeheader, 333);
+        assert_eq!(c_demuxer.gui_mode_reports, 1);
+        assert_eq!(c_demuxer.net_activity_gui, 4444);
 
         // Pointer fields
         assert_eq!(c_demuxer.last_pat_payload, ptr::null_mut());
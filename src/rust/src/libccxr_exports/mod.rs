@@ -62,6 +62,16 @@ pub unsafe extern "C" fn ccxr_verify_crc32(buf: *const u8, len: c_int) -> c_int
     }
 }
 
+/// Reverses the bits of every byte in `buf`, like the `REVERSE_8` loop over a teletext packet in C.
+///
+/// # Safety
+///
+/// `buf` should not be a NULL pointer and must point to at least `len` writable bytes.
+#[no_mangle]
+pub unsafe extern "C" fn ccxr_reverse_bytes(buf: *mut u8, len: usize) {
+    reverse_bytes(std::slice::from_raw_parts_mut(buf, len));
+}
+
 /// Rust equivalent for `levenshtein_dist` function in C. Uses C-native types as input and output.
 ///
 /// # Safety
@@ -102,3 +112,46 @@ pub unsafe extern "C" fn ccxr_levenshtein_dist_char(
 
     ans.min(c_int::MAX as usize) as c_int
 }
+
+/// Levenshtein distance between `s1` and `s2` if it is at most `max`, `max + 1` otherwise.
+///
+/// # Safety
+///
+/// `s1` and `s2` must valid slices of data with lengths of `s1len` and `s2len` respectively.
+#[no_mangle]
+pub unsafe extern "C" fn ccxr_levenshtein_dist_bounded(
+    s1: *const u64,
+    s2: *const u64,
+    s1len: c_uint,
+    s2len: c_uint,
+    max: c_uint,
+) -> c_int {
+    let s1 = std::slice::from_raw_parts(s1, s1len as usize);
+    let s2 = std::slice::from_raw_parts(s2, s2len as usize);
+
+    let ans = levenshtein_bounded(s1, s2, max as usize).unwrap_or(max as usize + 1);
+
+    ans.min(c_int::MAX as usize) as c_int
+}
+
+/// Levenshtein distance between `s1` and `s2` if it is at most `max`, `max + 1` otherwise.
+///
+/// # Safety
+///
+/// `s1` and `s2` must valid slices of data and therefore not be null. They must have lengths
+/// of `s1len` and `s2len` respectively.
+#[no_mangle]
+pub unsafe extern "C" fn ccxr_levenshtein_dist_char_bounded(
+    s1: *const c_char,
+    s2: *const c_char,
+    s1len: c_uint,
+    s2len: c_uint,
+    max: c_uint,
+) -> c_int {
+    let s1 = std::slice::from_raw_parts(s1, s1len as usize);
+    let s2 = std::slice::from_raw_parts(s2, s2len as usize);
+
+    let ans = levenshtein_bounded(s1, s2, max as usize).unwrap_or(max as usize + 1);
+
+    ans.min(c_int::MAX as usize) as c_int
+}
@@ -2,12 +2,9 @@
 
 use std::convert::TryInto;
 use std::ffi::{c_char, c_int, CStr};
+use std::sync::{Mutex, MutexGuard};
 
-use crate::{
-    bindings::*, cb_708, cb_field1, cb_field2, ccx_common_timing_settings as timing_settings,
-    current_fps, first_gop_time, frames_since_ref_time, fts_at_gop_start, gop_rollover, gop_time,
-    pts_big_change, total_frames_count, MPEG_CLOCK_FREQ,
-};
+use crate::{bindings::*, ccx_common_timing_settings as timing_settings, MPEG_CLOCK_FREQ};
 
 use lib_ccxr::common::FrameType;
 use lib_ccxr::time::{c_functions as c, *};
@@ -268,85 +265,81 @@ unsafe fn write_back_to_common_timing_ctx(
     (*ctx).pts_reset = if pts_reset { 1 } else { 0 };
 }
 
-/// Write to [`GLOBAL_TIMING_INFO`] from the equivalent static variables in C.
+/// Serializes the exports below, since each one moves the state of its context through
+/// [`GLOBAL_TIMING_INFO`] and contexts may be used from several threads.
+static TIMING_LOCK: Mutex<()> = Mutex::new(());
+
+fn lock_timing() -> MutexGuard<'static, ()> {
+    TIMING_LOCK
+        .lock()
+        .unwrap_or_else(|poisoned| poisoned.into_inner())
+}
+
+/// Write to [`GLOBAL_TIMING_INFO`] from the equivalent fields of a `ccx_common_timing_ctx`.
 ///
 /// It is used to move data of [`GLOBAL_TIMING_INFO`] from C to Rust.
 ///
 /// # Safety
 ///
-/// All the static variables should be initialized and in valid state.
-unsafe fn apply_timing_info() {
+/// `ctx` should not be null. The caller should hold [`TIMING_LOCK`].
+unsafe fn apply_timing_info(ctx: *const ccx_common_timing_ctx) {
     let Ok(mut timing_info) = GLOBAL_TIMING_INFO.write() else {
         // RwLock is poisoned, skip updating
         return;
     };
 
     // Use unwrap_or(0) for conversions that might fail (e.g., negative values)
-    timing_info.cb_field1 = cb_field1.try_into().unwrap_or(0);
-    timing_info.cb_field2 = cb_field2.try_into().unwrap_or(0);
-    timing_info.cb_708 = cb_708.try_into().unwrap_or(0);
-    timing_info.pts_big_change = pts_big_change != 0;
-    timing_info.current_fps = current_fps;
+    timing_info.cb_field1 = (*ctx).cb_field1.try_into().unwrap_or(0);
+    timing_info.cb_field2 = (*ctx).cb_field2.try_into().unwrap_or(0);
+    timing_info.cb_708 = (*ctx).cb_708.try_into().unwrap_or(0);
+    timing_info.pts_big_change = (*ctx).pts_big_change != 0;
+    timing_info.current_fps = (*ctx).current_fps;
     timing_info.frames_since_ref_time =
-        FrameCount::new(frames_since_ref_time.try_into().unwrap_or(0));
-    timing_info.total_frames_count = FrameCount::new(total_frames_count.into());
-    timing_info.gop_time = generate_gop_time_code(gop_time);
-    timing_info.first_gop_time = generate_gop_time_code(first_gop_time);
-    timing_info.fts_at_gop_start = Timestamp::from_millis(fts_at_gop_start.into());
-    timing_info.gop_rollover = gop_rollover != 0;
+        FrameCount::new((*ctx).frames_since_ref_time.try_into().unwrap_or(0));
+    timing_info.total_frames_count = FrameCount::new((*ctx).total_frames_count.into());
+    timing_info.gop_time = generate_gop_time_code((*ctx).gop_time);
+    timing_info.first_gop_time = generate_gop_time_code((*ctx).first_gop_time);
+    timing_info.fts_at_gop_start = Timestamp::from_millis((*ctx).fts_at_gop_start.into());
+    timing_info.gop_rollover = (*ctx).gop_rollover != 0;
     timing_info.timing_settings.disable_sync_check = timing_settings.disable_sync_check != 0;
     timing_info.timing_settings.no_sync = timing_settings.no_sync != 0;
     timing_info.timing_settings.is_elementary_stream = timing_settings.is_elementary_stream != 0;
     timing_info.mpeg_clock_freq = MPEG_CLOCK_FREQ.into();
 }
 
-/// Write from [`GLOBAL_TIMING_INFO`] to the equivalent static variables in C.
+/// Write from [`GLOBAL_TIMING_INFO`] to the equivalent fields of a `ccx_common_timing_ctx`.
 ///
-/// It is used to move data of [`GLOBAL_TIMING_INFO`] from Rust to C.
+/// It is used to move data of [`GLOBAL_TIMING_INFO`] from Rust to C. The timing settings
+/// are shared by all contexts and only ever read, so they are not written back.
 ///
 /// # Safety
 ///
-/// All the static variables should be initialized and in valid state.
-unsafe fn write_back_from_timing_info() {
+/// `ctx` should not be null. The caller should hold [`TIMING_LOCK`].
+unsafe fn write_back_from_timing_info(ctx: *mut ccx_common_timing_ctx) {
     let Ok(timing_info) = GLOBAL_TIMING_INFO.read() else {
         // RwLock is poisoned, skip writing back
         return;
     };
 
-    cb_field1 = timing_info.cb_field1.try_into().unwrap_or(0);
-    cb_field2 = timing_info.cb_field2.try_into().unwrap_or(0);
-    cb_708 = timing_info.cb_708.try_into().unwrap_or(0);
-    pts_big_change = if timing_info.pts_big_change { 1 } else { 0 };
-    current_fps = timing_info.current_fps;
-    frames_since_ref_time = timing_info
+    (*ctx).cb_field1 = timing_info.cb_field1.try_into().unwrap_or(0);
+    (*ctx).cb_field2 = timing_info.cb_field2.try_into().unwrap_or(0);
+    (*ctx).cb_708 = timing_info.cb_708.try_into().unwrap_or(0);
+    (*ctx).pts_big_change = if timing_info.pts_big_change { 1 } else { 0 };
+    (*ctx).current_fps = timing_info.current_fps;
+    (*ctx).frames_since_ref_time = timing_info
         .frames_since_ref_time
         .as_u64()
         .try_into()
         .unwrap_or(0);
-    total_frames_count = timing_info
+    (*ctx).total_frames_count = timing_info
         .total_frames_count
         .as_u64()
         .try_into()
         .unwrap_or(0);
-    gop_time = write_gop_time_code(timing_info.gop_time);
-    first_gop_time = write_gop_time_code(timing_info.first_gop_time);
-    fts_at_gop_start = timing_info.fts_at_gop_start.millis();
-    gop_rollover = if timing_info.gop_rollover { 1 } else { 0 };
-    timing_settings.disable_sync_check = if timing_info.timing_settings.disable_sync_check {
-        1
-    } else {
-        0
-    };
-    timing_settings.no_sync = if timing_info.timing_settings.no_sync {
-        1
-    } else {
-        0
-    };
-    timing_settings.is_elementary_stream = if timing_info.timing_settings.is_elementary_stream {
-        1
-    } else {
-        0
-    };
+    (*ctx).gop_time = write_gop_time_code(timing_info.gop_time);
+    (*ctx).first_gop_time = write_gop_time_code(timing_info.first_gop_time);
+    (*ctx).fts_at_gop_start = timing_info.fts_at_gop_start.millis();
+    (*ctx).gop_rollover = if timing_info.gop_rollover { 1 } else { 0 };
 }
 
 /// Construct a [`GopTimeCode`] from `gop_time_code`.
@@ -413,13 +406,14 @@ pub unsafe fn write_gop_time_code(g: Option<GopTimeCode>) -> gop_time_code {
 /// `ctx` must not be null.
 #[no_mangle]
 pub unsafe extern "C" fn ccxr_add_current_pts(ctx: *mut ccx_common_timing_ctx, pts: i64) {
-    apply_timing_info();
+    let _lock = lock_timing();
+    apply_timing_info(ctx);
     let mut context = generate_timing_context(ctx);
 
     c::add_current_pts(&mut context, MpegClockTick::new(pts.into()));
 
     write_back_to_common_timing_ctx(ctx, &context);
-    write_back_from_timing_info();
+    write_back_from_timing_info(ctx);
 }
 
 /// Rust equivalent for `set_current_pts` function in C. Uses C-native types as input and output.
@@ -429,13 +423,14 @@ pub unsafe extern "C" fn ccxr_add_current_pts(ctx: *mut ccx_common_timing_ctx, p
 /// `ctx` must not be null.
 #[no_mangle]
 pub unsafe extern "C" fn ccxr_set_current_pts(ctx: *mut ccx_common_timing_ctx, pts: i64) {
-    apply_timing_info();
+    let _lock = lock_timing();
+    apply_timing_info(ctx);
     let mut context = generate_timing_context(ctx);
 
     c::set_current_pts(&mut context, MpegClockTick::new(pts.into()));
 
     write_back_to_common_timing_ctx(ctx, &context);
-    write_back_from_timing_info();
+    write_back_from_timing_info(ctx);
 }
 
 /// Rust equivalent for `set_fts` function in C. Uses C-native types as input and output.
@@ -445,13 +440,14 @@ pub unsafe extern "C" fn ccxr_set_current_pts(ctx: *mut ccx_common_timing_ctx, p
 /// `ctx` must not be null.
 #[no_mangle]
 pub unsafe extern "C" fn ccxr_set_fts(ctx: *mut ccx_common_timing_ctx) -> c_int {
-    apply_timing_info();
+    let _lock = lock_timing();
+    apply_timing_info(ctx);
     let mut context = generate_timing_context(ctx);
 
     let ans = c::set_fts(&mut context);
 
     write_back_to_common_timing_ctx(ctx, &context);
-    write_back_from_timing_info();
+    write_back_from_timing_info(ctx);
 
     if ans {
         1
@@ -470,7 +466,8 @@ pub unsafe extern "C" fn ccxr_get_fts(
     ctx: *mut ccx_common_timing_ctx,
     current_field: c_int,
 ) -> i64 {
-    apply_timing_info();
+    let _lock = lock_timing();
+    apply_timing_info(ctx);
     let mut context = generate_timing_context(ctx);
 
     let caption_field = match current_field {
@@ -483,7 +480,7 @@ pub unsafe extern "C" fn ccxr_get_fts(
     let ans = c::get_fts(&mut context, caption_field);
 
     write_back_to_common_timing_ctx(ctx, &context);
-    write_back_from_timing_info();
+    write_back_from_timing_info(ctx);
 
     ans.millis()
 }
@@ -504,7 +501,8 @@ pub unsafe extern "C" fn ccxr_get_visible_end(
     ctx: *mut ccx_common_timing_ctx,
     _current_field: c_int,
 ) -> i64 {
-    apply_timing_info();
+    let _lock = lock_timing();
+    apply_timing_info(ctx);
     let mut context = generate_timing_context(ctx);
 
     // Use base FTS without cb_field offset for accurate timing
@@ -516,7 +514,7 @@ pub unsafe extern "C" fn ccxr_get_visible_end(
     }
 
     write_back_to_common_timing_ctx(ctx, &context);
-    write_back_from_timing_info();
+    write_back_from_timing_info(ctx);
 
     fts
 }
@@ -538,7 +536,8 @@ pub unsafe extern "C" fn ccxr_get_visible_start(
     ctx: *mut ccx_common_timing_ctx,
     _current_field: c_int,
 ) -> i64 {
-    apply_timing_info();
+    let _lock = lock_timing();
+    apply_timing_info(ctx);
     let context = generate_timing_context(ctx);
 
     // Use base FTS without cb_field offset for accurate timing
@@ -552,7 +551,7 @@ pub unsafe extern "C" fn ccxr_get_visible_start(
     };
 
     write_back_to_common_timing_ctx(ctx, &context);
-    write_back_from_timing_info();
+    write_back_from_timing_info(ctx);
 
     fts
 }
@@ -564,13 +563,14 @@ pub unsafe extern "C" fn ccxr_get_visible_start(
 /// `ctx` must not be null.
 #[no_mangle]
 pub unsafe extern "C" fn ccxr_get_fts_max(ctx: *mut ccx_common_timing_ctx) -> i64 {
-    apply_timing_info();
+    let _lock = lock_timing();
+    apply_timing_info(ctx);
     let mut context = generate_timing_context(ctx);
 
     let ans = c::get_fts_max(&mut context);
 
     write_back_to_common_timing_ctx(ctx, &context);
-    write_back_from_timing_info();
+    write_back_from_timing_info(ctx);
 
     ans.millis()
 }
@@ -595,35 +595,34 @@ pub unsafe extern "C" fn ccxr_print_mstime_static(mstime: i64, buf: *mut c_char)
 /// `ctx` must not be null.
 #[no_mangle]
 pub unsafe extern "C" fn ccxr_print_debug_timing(ctx: *mut ccx_common_timing_ctx) {
-    apply_timing_info();
+    let _lock = lock_timing();
+    apply_timing_info(ctx);
     let mut context = generate_timing_context(ctx);
 
     c::print_debug_timing(&mut context);
 
     write_back_to_common_timing_ctx(ctx, &context);
-    write_back_from_timing_info();
+    write_back_from_timing_info(ctx);
 }
 
 /// Rust equivalent for `calculate_ms_gop_time` function in C. Uses C-native types as input and output.
 ///
 /// # Safety
 ///
-/// `g` must not be null.
+/// `ctx` and `g` must not be null.
 #[no_mangle]
-pub unsafe extern "C" fn ccxr_calculate_ms_gop_time(g: *mut gop_time_code) {
-    apply_timing_info();
-
+pub unsafe extern "C" fn ccxr_calculate_ms_gop_time(
+    ctx: *mut ccx_common_timing_ctx,
+    g: *mut gop_time_code,
+) {
     // Try to convert values, using fallback for out-of-range values
     let hours: u8 = (*g).time_code_hours.try_into().unwrap_or(0);
     let minutes: u8 = (*g).time_code_minutes.try_into().unwrap_or(0);
     let seconds: u8 = (*g).time_code_seconds.try_into().unwrap_or(0);
     let pictures: u8 = (*g).time_code_pictures.try_into().unwrap_or(0);
 
-    // Get timing info, with fallback defaults if lock is poisoned
-    let (fps_value, rollover_flag) = match GLOBAL_TIMING_INFO.read() {
-        Ok(timing_info) => (timing_info.current_fps, timing_info.gop_rollover),
-        Err(_) => (29.97, false), // Fallback defaults
-    };
+    let fps_value = (*ctx).current_fps;
+    let rollover_flag = (*ctx).gop_rollover != 0;
 
     // Ensure fps is valid
     let fps = if fps_value > 0.0 { fps_value } else { 29.97 };
@@ -654,11 +653,17 @@ pub unsafe extern "C" fn ccxr_calculate_ms_gop_time(g: *mut gop_time_code) {
 ///
 /// # Safety
 ///
-/// `g` must not be null.
+/// `ctx` and `g` must not be null.
 #[no_mangle]
-pub unsafe extern "C" fn ccxr_gop_accepted(g: *mut gop_time_code) -> c_int {
+pub unsafe extern "C" fn ccxr_gop_accepted(
+    ctx: *mut ccx_common_timing_ctx,
+    g: *mut gop_time_code,
+) -> c_int {
     if let Some(gop) = generate_gop_time_code(*g) {
+        let _lock = lock_timing();
+        apply_timing_info(ctx);
         let ans = c::gop_accepted(gop);
+        write_back_from_timing_info(ctx);
         if ans {
             1
         } else {
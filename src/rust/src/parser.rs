@@ -640,6 +640,16 @@ impl OptionsExt for Options {
                     }
                     self.hardsubx_lum_thresh = *value as _;
                 }
+
+                if let Some(ref value) = args.sub_band_height {
+                    if *value < 1.0 || *value > 100.0 {
+                        fatal!(
+                            cause = ExitCause::MalformedParameter;
+                           "Invalid subtitle band height, valid values are between 1 & 100"
+                        );
+                    }
+                    self.hardsubx_band_height = *value as _;
+                }
             }
         } // END OF HARDSUBX
 
@@ -803,6 +813,16 @@ impl OptionsExt for Options {
             let str = lang.as_str();
             mkvlang_params_check(str);
         }
+
+        if let Some(value) = args.mkv_threads {
+            if value == 0 {
+                fatal!(
+                    cause = ExitCause::MalformedParameter;
+                    "--mkv-threads needs at least 1 thread"
+                );
+            }
+            self.mkv_threads = value;
+        }
         if args.srt
             || args.mcc
             || args.dvdraw
@@ -817,6 +837,43 @@ impl OptionsExt for Options {
             self.set_output_format(args);
         }
 
+        if let Some(ref formats) = args.also_out {
+            for &format in formats {
+                // Formats that change how the captions are decoded can only be the --out one
+                let write_format = match format {
+                    OutFormat::Srt => OutputFormat::Srt,
+                    OutFormat::Ass | OutFormat::Ssa => OutputFormat::Ssa,
+                    OutFormat::Ccd => OutputFormat::Ccd,
+                    OutFormat::Scc => OutputFormat::Scc,
+                    OutFormat::Webvtt => OutputFormat::WebVtt,
+                    OutFormat::Sami => OutputFormat::Sami,
+                    OutFormat::Txt => OutputFormat::Transcript,
+                    OutFormat::G608 => OutputFormat::G608,
+                    OutFormat::Smptett => OutputFormat::SmpteTt,
+                    OutFormat::Spupng => OutputFormat::SpuPng,
+                    OutFormat::SimpleXml => OutputFormat::SimpleXml,
+                    _ => fatal!(
+                        cause = ExitCause::MalformedParameter;
+                        "--also-out can't write {}, only --out can\n", format
+                    ),
+                };
+                if self.enc_cfg.extra_write_formats.contains(&write_format) {
+                    fatal!(
+                        cause = ExitCause::MalformedParameter;
+                        "--also-out lists {} more than once\n", format
+                    );
+                }
+                self.enc_cfg.extra_write_formats.push(write_format);
+            }
+            if self.enc_cfg.extra_write_formats.len() > MAX_EXTRA_OUTPUTS {
+                fatal!(
+                    cause = ExitCause::MalformedParameter;
+                    "--also-out can add at most {} formats\n", MAX_EXTRA_OUTPUTS
+                );
+            }
+        }
+        self.enc_cfg.threaded_outputs = args.also_out_threads;
+
         if let Some(ref startcreditstext) = args.startcreditstext {
             self.enc_cfg.start_credits_text.clone_from(startcreditstext);
         }
@@ -972,6 +1029,24 @@ impl OptionsExt for Options {
             self.list_tracks_only = true;
         }
 
+        if args.batch {
+            self.batch_mode = true;
+        }
+
+        if let Some(jobs) = args.jobs {
+            if jobs == 0 || jobs > i32::MAX as u32 {
+                fatal!(
+                    cause = ExitCause::MalformedParameter;
+                    "--jobs needs a number of jobs of at least 1\n"
+                );
+            }
+            self.batch_jobs = jobs as i32;
+        }
+
+        if let Some(ref batch_report) = args.batch_report {
+            self.batch_report = Some(batch_report.clone());
+        }
+
         if let Some(ref stream) = args.stream {
             self.live_stream = Some(Timestamp::from_millis(
                 1000 * get_atoi_hex::<i64>(stream.as_str()),
@@ -1456,6 +1531,42 @@ impl OptionsExt for Options {
             self.enc_cfg.render_font_italics = PathBuf::from_str(italics).unwrap_or_default();
         }
 
+        if let Some(value) = args.png_threads {
+            if value == 0 {
+                fatal!(
+                    cause = ExitCause::MalformedParameter;
+                    "--png-threads needs at least 1 thread"
+                );
+            }
+            self.png_threads = value;
+        }
+
+        if let Some(level) = args.png_compression {
+            if level > 9 {
+                fatal!(
+                    cause = ExitCause::MalformedParameter;
+                    "--png-compression must be between 0 and 9"
+                );
+            }
+            self.png_compression_level = level as i32;
+        }
+
+        if let Some(ref filter) = args.png_filter {
+            // libpng's PNG_FILTER_* masks
+            self.png_filters = match filter.as_str() {
+                "none" => 0x08,
+                "sub" => 0x10,
+                "up" => 0x20,
+                "avg" => 0x40,
+                "paeth" => 0x80,
+                "all" => 0xf8,
+                _ => fatal!(
+                    cause = ExitCause::MalformedParameter;
+                    "--png-filter must be none, sub, up, avg, paeth or all"
+                ),
+            };
+        }
+
         #[cfg(feature = "with_libcurl")]
         {
             use url::Url;
@@ -1464,10 +1575,14 @@ impl OptionsExt for Options {
             }
         }
 
-        if self.demux_cfg.auto_stream == StreamMode::Mp4 && self.input_source == DataSource::Stdin {
+        // Other MP4 streams are read as fragmented MP4, without GPAC
+        if self.demux_cfg.auto_stream == StreamMode::Mp4
+            && self.input_source == DataSource::Stdin
+            && self.extract_chapters
+        {
             fatal!(
                 cause = ExitCause::IncompatibleParameters;
-               "MP4 requires an actual file, it's not possible to read from a stream, including stdin."
+               "Extracting MP4 chapters requires an actual file, it's not possible to read them from a stream, including stdin."
             );
         }
 
@@ -1609,6 +1724,45 @@ impl OptionsExt for Options {
             );
         }
 
+        if !self.enc_cfg.extra_write_formats.is_empty() {
+            if self
+                .enc_cfg
+                .extra_write_formats
+                .contains(&self.write_format)
+            {
+                fatal!(
+                    cause = ExitCause::IncompatibleParameters;
+                    "--also-out repeats the --out format.\n"
+                );
+            }
+            if self.cc_to_stdout || self.send_to_srv {
+                fatal!(
+                    cause = ExitCause::IncompatibleParameters;
+                    "--also-out can't be used with -stdout or --sendto.\n"
+                );
+            }
+        }
+
+        if self.batch_mode {
+            if self.output_filename.is_some() || self.cc_to_stdout || self.send_to_srv {
+                fatal!(
+                    cause = ExitCause::IncompatibleParameters;
+                    "--batch names each output after its input, it can't be used with -o, -stdout or --sendto.\n"
+                );
+            }
+            if self.input_source != DataSource::File {
+                fatal!(
+                    cause = ExitCause::IncompatibleParameters;
+                    "--batch can only process input files.\n"
+                );
+            }
+        } else if self.batch_jobs != 0 || self.batch_report.is_some() {
+            fatal!(
+                cause = ExitCause::IncompatibleParameters;
+                "--jobs and --batch-report can only be used with --batch.\n"
+            );
+        }
+
         if self.write_format == OutputFormat::WebVtt && self.enc_cfg.encoding != Encoding::UTF8 {
             self.enc_cfg.encoding = Encoding::UTF8;
             println!("Note: Output format is WebVTT, forcing UTF-8");
@@ -2432,6 +2586,15 @@ pub mod tests {
         assert_eq!(options.debug_mask.mask(), DebugMessageFlag::TELETEXT);
     }
 
+    #[test]
+    fn options_52() {
+        let (options, _) = parse_args(&["--batch", "--jobs", "4", "--batch-report", "report.json"]);
+
+        assert!(options.batch_mode);
+        assert_eq!(options.batch_jobs, 4);
+        assert_eq!(options.batch_report.as_deref(), Some("report.json"));
+    }
+
     #[test]
     fn teletext_1() {
         let (options, _) = parse_args(&[
@@ -0,0 +1,239 @@
+#include <check.h>
+#include "ccx_encoders_scc_suite.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "../src/lib_ccx/lib_ccx.h"
+#include "../src/lib_ccx/ccx_encoders_mcc.h"
+
+// Golden tests for the broadcast caption writers: SCC, its CCD disassembly and
+// MCC lines. The expected output is what these writers produced when they
+// still wrote every code word with its own fdprintf.
+
+// -------------------------------------
+// Helpers
+// -------------------------------------
+
+static struct encoder_ctx *context;
+static struct ccx_s_write out;
+static char out_name[64];
+
+// Puts text on a row of the screen, starting at column, with one style
+static void helper_put_text(struct eia608_screen *data, int row, int column, const char *text,
+			    enum ccx_decoder_608_color_code color, enum font_bits font)
+{
+	for (int i = 0; text[i]; i++)
+	{
+		data->characters[row][column + i] = text[i];
+		data->colors[row][column + i] = color;
+		data->fonts[row][column + i] = font;
+	}
+	data->row_used[row] = 1;
+}
+
+static struct eia608_screen *helper_create_screen(LLONG start_time, LLONG end_time)
+{
+	struct eia608_screen *data = calloc(1, sizeof(struct eia608_screen));
+	for (int row = 0; row < CCX_DECODER_608_SCREEN_ROWS; row++)
+		memset(data->characters[row], ' ', CCX_DECODER_608_SCREEN_WIDTH);
+	data->start_time = start_time;
+	data->end_time = end_time;
+	data->channel = 1;
+	return data;
+}
+
+// A styled row starting at column 0, plain text with an odd number of
+// characters to get padding, and a row with a tab offset, a colour change
+// mid-row and italics
+static struct eia608_screen *helper_create_styled_screen(void)
+{
+	struct eia608_screen *data = helper_create_screen(1000, 3500);
+	helper_put_text(data, 12, 0, "Yellow", COL_YELLOW, FONT_UNDERLINED);
+	helper_put_text(data, 13, 2, "HELLO WORLD", COL_WHITE, FONT_REGULAR);
+	helper_put_text(data, 14, 5, "Green", COL_GREEN, FONT_REGULAR);
+	helper_put_text(data, 14, 11, "and", COL_WHITE, FONT_REGULAR);
+	helper_put_text(data, 14, 15, "it", COL_WHITE, FONT_ITALICS);
+	return data;
+}
+
+static char *helper_read_output(void)
+{
+	static char buffer[8192];
+	ssize_t length = pread(out.fh, buffer, sizeof(buffer) - 1, 0);
+	ck_assert_int_ge(length, 0);
+	buffer[length] = '\0';
+	return buffer;
+}
+
+// -------------------------------------
+// Expected output
+// -------------------------------------
+
+static const char scc_plain_golden[] =
+	"\r\n"
+	"\r\n"
+	"00:00:00:00\t 9420 94f2 5445 d354 942f 94ae\r\n"
+	"\r\n"
+	"00:00:02:00\t 942c";
+
+static const char scc_styled_golden[] =
+	"\r\n"
+	"\r\n"
+	"00:00:01:00\t 9420 136b d9e5 ecec eff7 94d0 97a1 9120 c845 4c4c 4f20 574f 524c c480 94f2 91a2 c7f2 e5e5 6e80 94f4 97a2 9120 616e 6420 9476 97a2 91ae e9f4 942f 94ae\r\n"
+	"\r\n"
+	"00:00:03:15\t 942c";
+
+static const char scc_framerate_golden[] =
+	"\r\n"
+	"\r\n"
+	"01:02:03:11\t 9420 91d0 32b5 942f 94ae\r\n"
+	"\r\n"
+	"01:02:05:25\t 942c";
+
+static const char ccd_golden[] =
+	"CHANNEL 1\r\n"
+	"\r\n"
+	"00:00:01:00\t{RCL}{1300YU}Yellow{1400}{TO1}{Wh}HELLO WORLD_{1504}{Gr}Green_{1508}{TO2}{Wh}and {1512}{TO2}{I}it{EOC}{ENM}\r\n"
+	"00:00:03:15\t{EDM}\r\n"
+	"00:00:04:00\t{RCL}{1300YU}Yellow{1400}{TO1}{Wh}HELLO WORLD_{1504}{Gr}Green_{1508}{TO2}{Wh}and {1512}{TO2}{I}it{EOC}{ENM}\r\n"
+	"00:00:05:00\t{EDM}";
+
+static const char mcc_golden[] =
+	"00:00:00:00\tT1ES1E4F43ZZ72E6FC9420FC94AERHFCC8E574ZZ83\n"
+	"00:00:00:01\tT1ES1E4F43Z0172E6FC9420FC94AERHFCC8E574Z0185\n";
+
+// -------------------------------------
+// TEST preparations
+// -------------------------------------
+static void setup(void)
+{
+	strcpy(out_name, "/tmp/ccx_scc_suite_XXXXXX");
+	memset(&out, 0, sizeof(out));
+	out.fh = mkstemp(out_name);
+	ck_assert_int_ge(out.fh, 0);
+
+	context = calloc(1, sizeof(struct encoder_ctx));
+	context->out = &out;
+	strcpy((char *)context->encoded_crlf, "\r\n");
+	context->encoded_crlf_length = 2;
+}
+
+static void teardown(void)
+{
+	close(out.fh);
+	unlink(out_name);
+	free(context->timing);
+	free(context);
+}
+
+// -------------------------------------
+// TESTS
+// -------------------------------------
+
+START_TEST(test_scc_plain_caption)
+{
+	struct eia608_screen *data = helper_create_screen(0, 2000);
+	helper_put_text(data, 14, 4, "TEST", COL_WHITE, FONT_REGULAR);
+
+	write_cc_buffer_as_scc(data, context);
+	ck_assert_str_eq(helper_read_output(), scc_plain_golden);
+	free(data);
+}
+END_TEST
+
+START_TEST(test_scc_styled_caption)
+{
+	struct eia608_screen *data = helper_create_styled_screen();
+
+	write_cc_buffer_as_scc(data, context);
+	ck_assert_str_eq(helper_read_output(), scc_styled_golden);
+	free(data);
+}
+END_TEST
+
+START_TEST(test_scc_framerate)
+{
+	struct eia608_screen *data = helper_create_screen(3723450, 3725999);
+	helper_put_text(data, 0, 0, "25", COL_WHITE, FONT_REGULAR);
+
+	context->scc_framerate = 2;
+	write_cc_buffer_as_scc(data, context);
+	ck_assert_str_eq(helper_read_output(), scc_framerate_golden);
+	free(data);
+}
+END_TEST
+
+START_TEST(test_ccd_two_captions)
+{
+	struct eia608_screen *data = helper_create_styled_screen();
+
+	// The channel header is only written before the first caption
+	write_cc_buffer_as_ccd(data, context);
+	data->start_time = 4000;
+	data->end_time = 5000;
+	write_cc_buffer_as_ccd(data, context);
+	ck_assert_str_eq(helper_read_output(), ccd_golden);
+	free(data);
+}
+END_TEST
+
+START_TEST(test_mcc_line)
+{
+	struct lib_cc_decode dec_ctx;
+	unsigned char cc_data[] = {0xfc, 0x94, 0x20, 0xfc, 0x94, 0xae, 0xfd, 0x80, 0x80, 0xfa, 0x00, 0x00, 0xfa, 0x00, 0x00, 0xfc, 0xc8, 0xe5};
+
+	memset(&dec_ctx, 0, sizeof(dec_ctx));
+	dec_ctx.current_frame_rate = 4;
+	context->timing = calloc(1, sizeof(struct ccx_common_timing_ctx));
+	context->timing->fts_now = 3723450;
+	// Past the header, which has a random UUID and the current date
+	context->header_printed_flag = CCX_TRUE;
+
+	mcc_encode_cc_data(context, &dec_ctx, cc_data, sizeof(cc_data) / 3);
+	mcc_encode_cc_data(context, &dec_ctx, cc_data, sizeof(cc_data) / 3);
+	ck_assert_str_eq(helper_read_output(), mcc_golden);
+}
+END_TEST
+
+START_TEST(test_mcc_header)
+{
+	struct lib_cc_decode dec_ctx;
+	unsigned char cc_data[] = {0xfc, 0x94, 0x20};
+
+	memset(&dec_ctx, 0, sizeof(dec_ctx));
+	dec_ctx.current_frame_rate = 4;
+	context->timing = calloc(1, sizeof(struct ccx_common_timing_ctx));
+	context->force_dropframe = CCX_TRUE;
+
+	mcc_encode_cc_data(context, &dec_ctx, cc_data, 1);
+	char *output = helper_read_output();
+	ck_assert_int_eq(strncmp(output, "File Format=MacCaption_MCC V1.0\n\n////", 37), 0);
+	ck_assert_ptr_ne(strstr(output, "//     Z  00h\n//\n////"), NULL);
+	ck_assert_ptr_ne(strstr(output, "/\n\nUUID="), NULL);
+	ck_assert_ptr_ne(strstr(output, "\nCreation Program=CCExtractor\nCreation Date="), NULL);
+	ck_assert_ptr_ne(strstr(output, "\nTime Code Rate=30DF\n\n00:00:00:00\t"), NULL);
+}
+END_TEST
+
+Suite *ccx_encoders_scc_suite(void)
+{
+	Suite *s;
+	TCase *tc_scc;
+
+	s = suite_create("Broadcast caption writers");
+
+	tc_scc = tcase_create("SCC: golden output: ");
+	tcase_add_checked_fixture(tc_scc, setup, teardown);
+	tcase_add_test(tc_scc, test_scc_plain_caption);
+	tcase_add_test(tc_scc, test_scc_styled_caption);
+	tcase_add_test(tc_scc, test_scc_framerate);
+	tcase_add_test(tc_scc, test_ccd_two_captions);
+	tcase_add_test(tc_scc, test_mcc_line);
+	tcase_add_test(tc_scc, test_mcc_header);
+	suite_add_tcase(s, tc_scc);
+
+	return s;
+}
@@ -0,0 +1,4 @@
+// -------------------------------------
+// SUITE
+// -------------------------------------
+Suite * ccx_encoders_scc_suite(void);
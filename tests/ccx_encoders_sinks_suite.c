@@ -0,0 +1,127 @@
+#include <check.h>
+#include "ccx_encoders_sinks_suite.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "../src/lib_ccx/lib_ccx.h"
+#include "../src/lib_ccx/ccx_common_common.h"
+#include "../src/lib_ccx/ccx_decoders_common.h"
+
+// Additional outputs (--also-out): subtitles encoded by the main encoder, or by
+// the copy DVB subtitles go through, also reach the other formats' files.
+
+// -------------------------------------
+// Helpers
+// -------------------------------------
+
+static char dir[64];
+static char srt_name[96], vtt_name[96];
+static struct encoder_cfg cfg;
+static struct ccx_common_timing_ctx timing;
+
+static char *helper_read_file(const char *name)
+{
+	static char buffer[4096];
+	FILE *f = fopen(name, "rb");
+	size_t length;
+
+	ck_assert_ptr_ne(f, NULL);
+	length = fread(buffer, 1, sizeof(buffer) - 1, f);
+	fclose(f);
+	buffer[length] = '\0';
+	return buffer;
+}
+
+static void helper_encode_text(struct encoder_ctx *enc_ctx, char *text, LLONG start, LLONG end)
+{
+	struct cc_subtitle sub;
+
+	memset(&sub, 0, sizeof(sub));
+	ck_assert_int_eq(add_cc_sub_text(&sub, text, start, end, "NA", "TEST", CCX_ENC_UTF_8), 0);
+	encode_sub(enc_ctx, &sub);
+	freep(&sub.data);
+}
+
+static void setup(void)
+{
+	init_options(&ccx_options);
+	strcpy(dir, "/tmp/ccx_sinks_suite_XXXXXX");
+	ck_assert_ptr_ne(mkdtemp(dir), NULL);
+	snprintf(srt_name, sizeof(srt_name), "%s/out.srt", dir);
+	snprintf(vtt_name, sizeof(vtt_name), "%s/out.vtt", dir);
+
+	cfg = ccx_options.enc_cfg;
+	cfg.write_format = CCX_OF_SRT;
+	cfg.output_filename = srt_name;
+	cfg.extra_write_formats[0] = CCX_OF_WEBVTT;
+	cfg.nb_extra_write_formats = 1;
+	memset(&timing, 0, sizeof(timing));
+}
+
+static void teardown(void)
+{
+	unlink(srt_name);
+	unlink(vtt_name);
+	rmdir(dir);
+}
+
+// -------------------------------------
+// TESTS
+// -------------------------------------
+
+START_TEST(test_sinks_get_every_subtitle)
+{
+	struct encoder_ctx *enc_ctx = init_encoder(&cfg);
+	ck_assert_ptr_ne(enc_ctx, NULL);
+	enc_ctx->timing = &timing;
+
+	helper_encode_text(enc_ctx, "HELLO", 1000, 2000);
+	helper_encode_text(enc_ctx, "WORLD", 3000, 4000);
+	dinit_encoder(&enc_ctx, 4000);
+
+	ck_assert_ptr_ne(strstr(helper_read_file(srt_name), "00:00:03,000 --> 00:00:03,999\r\nWORLD\r\n"), NULL);
+	char *vtt = helper_read_file(vtt_name);
+	// The times end a millisecond early in both formats
+	ck_assert_int_eq(strncmp(vtt, "WEBVTT", 6), 0);
+	ck_assert_ptr_ne(strstr(vtt, "00:00:01.000 --> 00:00:01.999\r\nHELLO\r\n"), NULL);
+	ck_assert_ptr_ne(strstr(vtt, "00:00:03.000 --> 00:00:03.999\r\nWORLD\r\n"), NULL);
+}
+END_TEST
+
+START_TEST(test_sinks_get_previous_subtitle)
+{
+	// As the DVB decoder does: the subtitle shown last is encoded by a copy of the
+	// encoder once the next one tells when it ends
+	struct encoder_ctx *enc_ctx = init_encoder(&cfg);
+	ck_assert_ptr_ne(enc_ctx, NULL);
+	enc_ctx->timing = &timing;
+
+	enc_ctx->prev = copy_encoder_context(enc_ctx);
+	helper_encode_text(enc_ctx->prev, "PREVIOUS", 1000, 2000);
+	free_encoder_context(enc_ctx->prev);
+	enc_ctx->prev = NULL;
+	dinit_encoder(&enc_ctx, 2000);
+
+	ck_assert_ptr_ne(strstr(helper_read_file(srt_name), "\r\nPREVIOUS\r\n"), NULL);
+	ck_assert_ptr_ne(strstr(helper_read_file(vtt_name), "00:00:01.000 --> 00:00:01.999\r\nPREVIOUS\r\n"), NULL);
+}
+END_TEST
+
+Suite *ccx_encoders_sinks_suite(void)
+{
+	Suite *s;
+	TCase *tc_sinks;
+
+	s = suite_create("Additional outputs");
+
+	tc_sinks = tcase_create("Additional outputs: SRT and WebVTT: ");
+	tcase_add_checked_fixture(tc_sinks, setup, teardown);
+	tcase_add_test(tc_sinks, test_sinks_get_every_subtitle);
+	tcase_add_test(tc_sinks, test_sinks_get_previous_subtitle);
+	suite_add_tcase(s, tc_sinks);
+
+	return s;
+}
@@ -0,0 +1,490 @@
+#include <check.h>
+#include "ccx_mp4_stream_suite.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "../src/lib_ccx/lib_ccx.h"
+#include "../src/lib_ccx/ccx_mp4.h"
+
+// Fragmented MP4 read as a stream by processmp4_stream(): synthetic init
+// segments and fragments with WebVTT and TTML tracks, and track runs with and
+// without their per-sample fields, extracted to SRT. Also the NAL units of the
+// video samples processmp4() reads, in memory and from the file.
+
+// -------------------------------------
+// Helpers
+// -------------------------------------
+
+static unsigned char mp4[4096];
+static size_t mp4_length;
+static size_t box_start[8]; // Of the boxes still open
+static int box_depth;
+
+static char output[4096];
+static size_t output_length;
+
+static void helper_output(void *opaque, const unsigned char *data, size_t length)
+{
+	ck_assert_uint_lt(output_length + length, sizeof(output));
+	memcpy(output + output_length, data, length);
+	output_length += length;
+	output[output_length] = '\0';
+}
+
+static void helper_u32_at(size_t pos, unsigned value)
+{
+	mp4[pos] = value >> 24;
+	mp4[pos + 1] = value >> 16;
+	mp4[pos + 2] = value >> 8;
+	mp4[pos + 3] = value;
+}
+
+static void helper_u32(unsigned value)
+{
+	helper_u32_at(mp4_length, value);
+	mp4_length += 4;
+}
+
+static void helper_bytes(const void *data, size_t length)
+{
+	memcpy(mp4 + mp4_length, data, length);
+	mp4_length += length;
+}
+
+static void helper_box_start(const char *type)
+{
+	box_start[box_depth++] = mp4_length;
+	helper_u32(0); // Size, set by helper_box_end()
+	helper_bytes(type, 4);
+}
+
+static void helper_box_end(void)
+{
+	size_t start = box_start[--box_depth];
+	helper_u32_at(start, mp4_length - start);
+}
+
+// Full box header: version and flags
+static void helper_full_box_start(const char *type, int version, unsigned flags)
+{
+	helper_box_start(type);
+	helper_u32(version << 24 | flags);
+}
+
+// Init segment with one track of the given sample entry, timescale 1000 and
+// trex defaults
+static void helper_init_segment(const char *sample_entry, unsigned default_duration, unsigned default_size)
+{
+	static const unsigned char sample_entry_fields[8] = {0, 0, 0, 0, 0, 0, 0, 1}; // Data reference 1
+
+	helper_box_start("moov");
+	helper_box_start("trak");
+	helper_full_box_start("tkhd", 0, 3);
+	helper_u32(0); // Creation time
+	helper_u32(0); // Modification time
+	helper_u32(1); // Track ID
+	helper_u32(0);
+	helper_u32(0); // Duration
+	helper_box_end();
+	helper_box_start("mdia");
+	helper_full_box_start("mdhd", 0, 0);
+	helper_u32(0);
+	helper_u32(0);
+	helper_u32(1000); // Timescale
+	helper_u32(0);
+	helper_u32(0x55c40000); // und
+	helper_box_end();
+	helper_box_start("minf");
+	helper_box_start("stbl");
+	helper_full_box_start("stsd", 0, 0);
+	helper_u32(1); // Entry count
+	helper_box_start(sample_entry);
+	helper_bytes(sample_entry_fields, sizeof(sample_entry_fields));
+	helper_box_end();
+	helper_box_end(); // stsd
+	helper_box_end(); // stbl
+	helper_box_end(); // minf
+	helper_box_end(); // mdia
+	helper_box_end(); // trak
+	helper_box_start("mvex");
+	helper_full_box_start("trex", 0, 0);
+	helper_u32(1); // Track ID
+	helper_u32(1); // Sample description index
+	helper_u32(default_duration);
+	helper_u32(default_size);
+	helper_u32(0); // Sample flags
+	helper_box_end();
+	helper_box_end(); // mvex
+	helper_box_end(); // moov
+}
+
+// Starts a fragment of track 1 up to the trun sample count, returns where its
+// data offset goes
+static size_t helper_fragment_start(unsigned tfhd_flags, const unsigned *tfhd_fields, int tfhd_field_count,
+				    int has_tfdt, unsigned long long decode_time, unsigned trun_flags, unsigned sample_count)
+{
+	size_t data_offset;
+
+	helper_box_start("moof");
+	helper_full_box_start("mfhd", 0, 0);
+	helper_u32(1); // Sequence number
+	helper_box_end();
+	helper_box_start("traf");
+	helper_full_box_start("tfhd", 0, tfhd_flags);
+	helper_u32(1); // Track ID
+	for (int i = 0; i < tfhd_field_count; i++)
+		helper_u32(tfhd_fields[i]);
+	helper_box_end();
+	if (has_tfdt)
+	{
+		helper_full_box_start("tfdt", 1, 0);
+		helper_u32(decode_time >> 32);
+		helper_u32(decode_time);
+		helper_box_end();
+	}
+	helper_full_box_start("trun", 0, trun_flags | 0x01); // Data offset present
+	helper_u32(sample_count);
+	data_offset = mp4_length;
+	helper_u32(0);
+	return data_offset;
+}
+
+// Ends the trun, traf and moof, and starts the mdat the data offset points to
+static void helper_fragment_end(size_t data_offset)
+{
+	size_t moof = box_start[0];
+
+	helper_box_end(); // trun
+	helper_box_end(); // traf
+	helper_box_end(); // moof
+	helper_u32_at(data_offset, mp4_length - moof + 8);
+	helper_box_start("mdat");
+}
+
+// WebVTT sample with one cue
+static size_t helper_wvtt_sample(const char *text)
+{
+	size_t start = mp4_length;
+
+	helper_box_start("vttc");
+	helper_box_start("payl");
+	helper_bytes(text, strlen(text));
+	helper_box_end();
+	helper_box_end();
+	return mp4_length - start;
+}
+
+// Runs processmp4_stream() on the stream built, as ccextractor reads stdin
+static void helper_extract(void)
+{
+	struct lib_ccx_ctx *ctx;
+
+	ck_assert_int_eq(box_depth, 0);
+	ctx = init_libraries(&ccx_options);
+	ck_assert_ptr_ne(ctx, NULL);
+	ck_assert_int_eq(init_file_buffer(ctx->demux_ctx), 0);
+	memcpy(ctx->demux_ctx->filebuffer, mp4, mp4_length);
+	ctx->demux_ctx->bytesinbuffer = mp4_length;
+
+	ck_assert_int_eq(processmp4_stream(ctx, &ctx->mp4_cfg), 1);
+	dinit_libraries(&ctx);
+}
+
+// Writes the stream built to a file and asks whether it must be read as a stream
+static int helper_is_fragmented(void)
+{
+	char name[64] = "/tmp/ccx_mp4_stream_suite_XXXXXX";
+	int fd = mkstemp(name);
+	int fragmented;
+
+	ck_assert_int_ge(fd, 0);
+	ck_assert_int_eq(write(fd, mp4, mp4_length), mp4_length);
+	close(fd);
+	fragmented = is_fragmented_mp4(name);
+	unlink(name);
+	return fragmented;
+}
+
+// Fragment of two 2 s TTML samples, each with one paragraph
+static void helper_stpp_samples(const char *first, const char *second)
+{
+	const char *docs[] = {first, second};
+	size_t data_offset;
+
+	helper_init_segment("stpp", 0, 0);
+	data_offset = helper_fragment_start(0x020000, NULL, 0, 1, 0, 0x000300, 2);
+	for (int i = 0; i < 2; i++)
+	{
+		helper_u32(2000); // Duration
+		helper_u32(strlen(docs[i]));
+	}
+	helper_fragment_end(data_offset);
+	for (int i = 0; i < 2; i++)
+		helper_bytes(docs[i], strlen(docs[i]));
+	helper_box_end();
+}
+
+// AVC sample with 4 byte NAL unit lengths: an SEI, an IDR slice, filler data and
+// an empty NAL unit at its very end
+static size_t helper_nal_sample(unsigned char *sample)
+{
+	static const unsigned lengths[] = {6, 100, 3, 0};
+	static const unsigned char headers[] = {0x06, 0x65, 0x0c};
+	size_t length = 0;
+
+	for (int i = 0; i < 4; i++)
+	{
+		sample[length++] = lengths[i] >> 24;
+		sample[length++] = lengths[i] >> 16;
+		sample[length++] = lengths[i] >> 8;
+		sample[length++] = lengths[i];
+		for (unsigned j = 0; j < lengths[i]; j++)
+			sample[length++] = j ? (unsigned char)(i * 16 + j) : headers[i];
+	}
+	return length;
+}
+
+// Walks a sample, checking each NAL unit against the one in sample
+static void helper_check_nal_units(struct mp4_nal_reader *r, const unsigned char *sample)
+{
+	static const uint32_t expected_used[] = {6, 64, 0, 0};
+	unsigned char *nal;
+	uint32_t nal_length, used;
+	size_t pos = 0;
+
+	for (int i = 0; i < 4; i++)
+	{
+		ck_assert_int_eq(mp4_nal_reader_next(r, "test", 4, 0, &nal, &nal_length, &used), 1);
+		ck_assert_uint_eq(nal_length, (uint32_t)sample[pos + 3]);
+		ck_assert_uint_eq(used, expected_used[i]);
+		ck_assert_int_eq(memcmp(nal, sample + pos + 4, used), 0);
+		pos += 4 + nal_length;
+	}
+	ck_assert_int_eq(mp4_nal_reader_next(r, "test", 4, 0, &nal, &nal_length, &used), 0);
+}
+
+static void setup(void)
+{
+	init_options(&ccx_options);
+	ccx_options.input_source = CCX_DS_STDIN;
+	ccx_options.write_format = CCX_OF_SRT;
+	ccx_options.enc_cfg.write_format = CCX_OF_SRT;
+	ccx_options.enc_cfg.output_callback = helper_output;
+	ccx_common_timing_settings.disable_sync_check = 1; // As start_ccx() does for MP4
+
+	mp4_length = 0;
+	box_depth = 0;
+	output[0] = '\0';
+	output_length = 0;
+}
+
+// -------------------------------------
+// TESTS
+// -------------------------------------
+
+START_TEST(test_fmp4_trun_sample_fields)
+{
+	// Duration, size, flags and composition offset of every sample
+	size_t data_offset, size_pos[2];
+
+	helper_init_segment("wvtt", 0, 0);
+	data_offset = helper_fragment_start(0x020000, NULL, 0, 1, 5000, 0x000f00, 2);
+	helper_u32(2000); // Duration
+	size_pos[0] = mp4_length;
+	helper_u32(0); // Size, known once the sample is written
+	helper_u32(0); // Flags
+	helper_u32(0); // Composition offset
+	helper_u32(1000);
+	size_pos[1] = mp4_length;
+	helper_u32(0);
+	helper_u32(0);
+	helper_u32(500);
+	helper_fragment_end(data_offset);
+	helper_u32_at(size_pos[0], helper_wvtt_sample("ONE"));
+	helper_u32_at(size_pos[1], helper_wvtt_sample("TWO"));
+	helper_box_end();
+
+	helper_extract();
+
+	// Times count from the first sample shown, SRT ends a millisecond early
+	ck_assert_ptr_ne(strstr(output, "1\r\n00:00:00,000 --> 00:00:01,999\r\nONE\r\n"), NULL);
+	ck_assert_ptr_ne(strstr(output, "2\r\n00:00:02,500 --> 00:00:03,499\r\nTWO\r\n"), NULL);
+}
+END_TEST
+
+START_TEST(test_fmp4_trun_defaults)
+{
+	// No per-sample fields: the size comes from tfhd, the duration from trex,
+	// and without tfdt the decode time starts at 0
+	unsigned tfhd_fields[] = {8 + 8 + 3}; // Default size: a vttc with a three letter payl
+	size_t data_offset;
+
+	helper_init_segment("wvtt", 1500, 0);
+	data_offset = helper_fragment_start(0x020010, tfhd_fields, 1, 0, 0, 0, 2);
+	helper_fragment_end(data_offset);
+	helper_wvtt_sample("AAA");
+	helper_wvtt_sample("BBB");
+	helper_box_end();
+
+	helper_extract();
+
+	ck_assert_ptr_ne(strstr(output, "1\r\n00:00:00,000 --> 00:00:01,499\r\nAAA\r\n"), NULL);
+	ck_assert_ptr_ne(strstr(output, "2\r\n00:00:01,500 --> 00:00:02,999\r\nBBB\r\n"), NULL);
+}
+END_TEST
+
+START_TEST(test_fmp4_stpp)
+{
+	// One TTML document, its paragraphs timed by begin and end
+	static const char ttml[] =
+	    "<?xml version=\"1.0\" encoding=\"UTF-8\"?>"
+	    "<tt xmlns=\"http://www.w3.org/ns/ttml\"><body><div>"
+	    "<p begin=\"00:00:01.000\" end=\"00:00:02.500\">First &amp;\n  line<br/>two</p>"
+	    "<p begin=\"3s\" end=\"4500ms\"><span>Second</span></p>"
+	    "</div></body></tt>";
+	size_t data_offset;
+
+	helper_init_segment("stpp", 0, 0);
+	data_offset = helper_fragment_start(0x020000, NULL, 0, 1, 0, 0x000300, 1);
+	helper_u32(10000); // Duration
+	helper_u32(sizeof(ttml) - 1);
+	helper_fragment_end(data_offset);
+	helper_bytes(ttml, sizeof(ttml) - 1);
+	helper_box_end();
+
+	helper_extract();
+
+	ck_assert_ptr_ne(strstr(output, "00:00:01,000 --> 00:00:02,499\r\nFirst & line\r\ntwo\r\n"), NULL);
+	ck_assert_ptr_ne(strstr(output, "00:00:03,000 --> 00:00:04,499\r\nSecond\r\n"), NULL);
+}
+END_TEST
+
+START_TEST(test_fmp4_stpp_sample_times)
+{
+	// Times that restart in every sample
+	helper_stpp_samples("<tt><body><p begin=\"0.5s\" end=\"1.5s\">One</p></body></tt>",
+			    "<tt><body><p begin=\"0.5s\" end=\"2s\">Two</p></body></tt>");
+
+	helper_extract();
+
+	ck_assert_ptr_ne(strstr(output, "00:00:00,500 --> 00:00:01,499\r\nOne\r\n"), NULL);
+	ck_assert_ptr_ne(strstr(output, "00:00:02,500 --> 00:00:03,999\r\nTwo\r\n"), NULL);
+}
+END_TEST
+
+START_TEST(test_fmp4_stpp_media_times)
+{
+	// Times on the track's timeline, the second cue shown from the first sample on
+	helper_stpp_samples("<tt><body><p begin=\"0.5s\" end=\"1.5s\">One</p></body></tt>",
+			    "<tt><body><p begin=\"1.5s\" end=\"3s\">Two</p></body></tt>");
+
+	helper_extract();
+
+	ck_assert_ptr_ne(strstr(output, "00:00:00,500 --> 00:00:01,499\r\nOne\r\n"), NULL);
+	ck_assert_ptr_ne(strstr(output, "00:00:02,000 --> 00:00:02,999\r\nTwo\r\n"), NULL);
+}
+END_TEST
+
+START_TEST(test_fmp4_is_fragmented)
+{
+	static const char ftyp[] = {0, 0, 0, 16, 'f', 't', 'y', 'p', 'i', 's', 'o', '6', 0, 0, 0, 0};
+	size_t mvex = 0;
+
+	// Init segment
+	helper_bytes(ftyp, sizeof(ftyp));
+	helper_init_segment("wvtt", 0, 0);
+	ck_assert_int_eq(helper_is_fragmented(), 1);
+
+	// The same moov without mvex, as in a file GPAC reads
+	while (memcmp(mp4 + mvex, "mvex", 4))
+		mvex++;
+	memcpy(mp4 + mvex, "free", 4);
+	ck_assert_int_eq(helper_is_fragmented(), 0);
+
+	// Media data before any moov, still being written
+	mp4_length = sizeof(ftyp);
+	helper_box_start("mdat");
+	helper_u32(0);
+	helper_box_end();
+	ck_assert_int_eq(helper_is_fragmented(), 1);
+
+	ck_assert_int_eq(is_fragmented_mp4("/nonexistent/ccx_mp4_stream_suite.mp4"), 0);
+}
+END_TEST
+
+START_TEST(test_mp4_nal_units_in_memory)
+{
+	unsigned char sample[256];
+	size_t length = helper_nal_sample(sample);
+	// Exactly the sample, so that reading past its end is caught by the sanitizers
+	unsigned char *data = malloc(length);
+	struct mp4_nal_reader r = {.fd = -1, .length = (uint32_t)length};
+
+	ck_assert_ptr_ne(data, NULL);
+	memcpy(data, sample, length);
+	r.data = data;
+	helper_check_nal_units(&r, sample);
+
+	// A NAL unit longer than what is left of the sample
+	data[2] = 1;
+	r.pos = 0;
+	unsigned char *nal;
+	uint32_t nal_length, used;
+	ck_assert_int_eq(mp4_nal_reader_next(&r, "test", 4, 0, &nal, &nal_length, &used), -1);
+	free(data);
+}
+END_TEST
+
+START_TEST(test_mp4_nal_units_from_file)
+{
+	char name[64] = "/tmp/ccx_mp4_stream_suite_XXXXXX";
+	unsigned char sample[256];
+	size_t length = helper_nal_sample(sample);
+	int fd = mkstemp(name);
+	struct mp4_nal_reader r = {.offset = 7, .length = (uint32_t)length};
+
+	// The sample after other data, as in an mdat
+	ck_assert_int_ge(fd, 0);
+	ck_assert_int_eq(write(fd, "mdat...", 7), 7);
+	ck_assert_int_eq(write(fd, sample, length), length);
+	r.fd = fd;
+	helper_check_nal_units(&r, sample);
+
+	close(fd);
+	unlink(name);
+	free(r.buf);
+}
+END_TEST
+
+Suite *ccx_mp4_stream_suite(void)
+{
+	Suite *s;
+	TCase *tc_fmp4;
+
+	s = suite_create("Fragmented MP4 streams");
+
+	tc_fmp4 = tcase_create("Fragmented MP4: to SRT: ");
+	tcase_add_checked_fixture(tc_fmp4, setup, NULL);
+	tcase_add_test(tc_fmp4, test_fmp4_trun_sample_fields);
+	tcase_add_test(tc_fmp4, test_fmp4_trun_defaults);
+	tcase_add_test(tc_fmp4, test_fmp4_stpp);
+	tcase_add_test(tc_fmp4, test_fmp4_stpp_sample_times);
+	tcase_add_test(tc_fmp4, test_fmp4_stpp_media_times);
+	suite_add_tcase(s, tc_fmp4);
+
+	tc_fmp4 = tcase_create("Fragmented MP4: file probe: ");
+	tcase_add_checked_fixture(tc_fmp4, setup, NULL);
+	tcase_add_test(tc_fmp4, test_fmp4_is_fragmented);
+	suite_add_tcase(s, tc_fmp4);
+
+	tc_fmp4 = tcase_create("MP4: NAL units of a sample: ");
+	tcase_add_checked_fixture(tc_fmp4, setup, NULL);
+	tcase_add_test(tc_fmp4, test_mp4_nal_units_in_memory);
+	tcase_add_test(tc_fmp4, test_mp4_nal_units_from_file);
+	suite_add_tcase(s, tc_fmp4);
+
+	return s;
+}
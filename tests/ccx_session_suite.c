@@ -0,0 +1,455 @@
+#include <check.h>
+#include "ccx_session_suite.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../src/lib_ccx/lib_ccx.h"
+#include "../src/lib_ccx/ccx_session.h"
+
+// Library use without files: cc_data, transport stream and PES pushed into a
+// session come back as SRT through the callbacks.
+
+// -------------------------------------
+// Helpers
+// -------------------------------------
+
+static char output[4096];
+static size_t output_length;
+static int subtitles;
+
+static void helper_output(void *opaque, const unsigned char *data, size_t length)
+{
+	ck_assert_ptr_eq(opaque, output);
+	ck_assert_uint_lt(output_length + length, sizeof(output));
+	memcpy(output + output_length, data, length);
+	output_length += length;
+	output[output_length] = '\0';
+}
+
+static void helper_subtitle(void *opaque, struct cc_subtitle *sub)
+{
+	subtitles++;
+}
+
+// One field 1 byte pair per frame, 29.97 fps
+static void helper_feed_pair(struct ccx_session *session, unsigned char cc_data_1, unsigned char cc_data_2, int frame)
+{
+	unsigned char cc_data[] = {0xfc, cc_data_1, cc_data_2};
+	ck_assert_int_eq(ccx_session_feed_cc_data(session, cc_data, 1, (LLONG)frame * 3003), CCX_OK);
+}
+
+// Leaves ccx_options alone, the session in use may be working with them
+static struct ccx_session *helper_create_session(enum ccx_session_input input)
+{
+	struct ccx_session_callbacks callbacks = {.output = helper_output, .subtitle = helper_subtitle, .opaque = output};
+
+	return ccx_session_create(&ccx_options, input, &callbacks);
+}
+
+// Hamming 8/4 code words of 0 to 15, ETS 300 706 chapter 8.2
+static const unsigned char hamming_8_4[16] = {
+    0x15, 0x02, 0x49, 0x5e, 0x64, 0x73, 0x38, 0x2f, 0xd0, 0xc7, 0x8c, 0x9b, 0xa1, 0xb6, 0xfd, 0xea};
+
+// MPEG-2 CRC of a PSI section
+static unsigned helper_crc32(const unsigned char *data, size_t length)
+{
+	unsigned crc = 0xffffffff;
+	for (size_t i = 0; i < length; i++)
+	{
+		crc ^= (unsigned)data[i] << 24;
+		for (int bit = 0; bit < 8; bit++)
+			crc = crc & 0x80000000 ? (crc << 1) ^ 0x04c11db7 : crc << 1;
+	}
+	return crc;
+}
+
+static void helper_ts_packet(unsigned char *packet, unsigned pid, int unit_start, unsigned counter, const unsigned char *payload, size_t length)
+{
+	packet[0] = 0x47;
+	packet[1] = (unit_start ? 0x40 : 0x00) | pid >> 8;
+	packet[2] = pid & 0xff;
+	packet[3] = 0x10 | (counter & 0x0f); // Payload only
+	memcpy(packet + 4, payload, length);
+	memset(packet + 4 + length, 0xff, 184 - length);
+}
+
+// section without its CRC, which is appended
+static void helper_psi_packet(unsigned char *packet, unsigned pid, unsigned char *section, size_t length)
+{
+	unsigned char payload[184] = {0x00}; // pointer_field
+	unsigned crc = helper_crc32(section, length);
+
+	memcpy(payload + 1, section, length);
+	payload[1 + length] = crc >> 24;
+	payload[2 + length] = crc >> 16;
+	payload[3 + length] = crc >> 8;
+	payload[4 + length] = crc;
+	helper_ts_packet(packet, pid, 1, 0, payload, length + 5);
+}
+
+// Teletext packet of magazine 8 as sent, bits in transmission order
+static void helper_teletext_packet(unsigned char *data_unit, int row, const unsigned char *data)
+{
+	unsigned char packet[44];
+	unsigned address = row << 3; // Magazine 8 is sent as 0
+
+	packet[0] = 0x55; // Clock run-in
+	packet[1] = 0xe4; // Framing code
+	packet[2] = hamming_8_4[address & 0x0f];
+	packet[3] = hamming_8_4[address >> 4];
+	memcpy(packet + 4, data, 40);
+
+	data_unit[0] = 0x03; // EBU teletext subtitle
+	data_unit[1] = sizeof(packet);
+	for (int i = 0; i < 44; i++)
+	{
+		unsigned char c = packet[i], reversed = 0;
+		for (int bit = 0; bit < 8; bit++)
+			reversed |= ((c >> bit) & 1) << (7 - bit);
+		data_unit[2 + i] = reversed;
+	}
+}
+
+// One PES packet in one TS packet: the header of page 888 and, if text isn't
+// NULL, row 22 with text in a box
+static void helper_teletext_page(unsigned char *packet, unsigned counter, int seconds, const char *text)
+{
+	unsigned char pes[184];
+	unsigned char header[40], row[40];
+	unsigned long long pts = 90000ULL * seconds;
+
+	memset(pes, 0xff, sizeof(pes));
+	pes[0] = 0x00;
+	pes[1] = 0x00;
+	pes[2] = 0x01;
+	pes[3] = 0xbd; // Private stream 1
+	pes[4] = 0x00;
+	pes[5] = sizeof(pes) - 6;
+	pes[6] = 0x84; // Data aligned
+	pes[7] = 0x80; // PTS only
+	pes[8] = 0x24; // Stuffed so that the data units are 46 byte aligned
+	pes[9] = 0x21 | ((pts >> 29) & 0x0e);
+	pes[10] = pts >> 22;
+	pes[11] = ((pts >> 14) & 0xfe) | 0x01;
+	pes[12] = pts >> 7;
+	pes[13] = ((pts << 1) & 0xfe) | 0x01;
+	pes[45] = 0x10; // EBU data
+
+	memset(header, 0x20, sizeof(header));
+	header[0] = hamming_8_4[8]; // Page units
+	header[1] = hamming_8_4[8]; // Page tens
+	header[2] = header[3] = header[4] = header[6] = hamming_8_4[0];
+	header[5] = hamming_8_4[8]; // C6, subtitle page
+	header[7] = hamming_8_4[0]; // Parallel transmission, Latin
+	helper_teletext_packet(pes + 46, 0, header);
+
+	if (text)
+	{
+		memset(row, 0x20, sizeof(row));
+		row[0] = row[1] = 0x0b; // Start box
+		for (size_t i = 0; text[i]; i++)
+		{
+			unsigned char c = text[i];
+			int ones = 0;
+			for (int bit = 0; bit < 7; bit++)
+				ones += (c >> bit) & 1;
+			row[2 + i] = ones % 2 ? c : c | 0x80; // Odd parity
+		}
+		row[2 + strlen(text)] = row[3 + strlen(text)] = 0x8a; // End box
+		helper_teletext_packet(pes + 92, 22, row);
+	}
+
+	helper_ts_packet(packet, 0x101, 1, counter, pes, sizeof(pes));
+}
+
+// A transport stream with a teletext subtitle page 888 showing HELLO at 1 s and
+// WORLD at 3 s, cleared at 5 s, with junk before the second page
+static size_t helper_teletext_ts(unsigned char *ts)
+{
+	unsigned char pat[] = {0x00, 0xb0, 0x0d, 0x00, 0x01, 0xc1, 0x00, 0x00,
+			       0x00, 0x01, 0xe1, 0x00}; // Program 1, PMT PID 0x100
+	unsigned char pmt[] = {0x02, 0xb0, 0x19, 0x00, 0x01, 0xc1, 0x00, 0x00,
+			       0xe1, 0x01, 0xf0, 0x00, // PCR PID 0x101
+			       0x06, 0xe1, 0x01, 0xf0, 0x07,
+			       0x56, 0x05, 'e', 'n', 'g', 0x10, 0x88}; // Teletext subtitles, page 888
+	size_t length = 0;
+
+	helper_psi_packet(ts + length, 0x000, pat, sizeof(pat));
+	length += 188;
+	helper_psi_packet(ts + length, 0x100, pmt, sizeof(pmt));
+	length += 188;
+	helper_teletext_page(ts + length, 0, 1, "HELLO");
+	length += 188;
+	memset(ts + length, 0x00, 5);
+	length += 5;
+	helper_teletext_page(ts + length, 1, 3, "WORLD");
+	length += 188;
+	helper_teletext_page(ts + length, 2, 5, NULL);
+	length += 188;
+	return length;
+}
+
+static void helper_feed_chunks(struct ccx_session *session, const unsigned char *data, size_t length, const size_t *chunks, int chunk_count)
+{
+	for (int i = 0; length; i = (i + 1) % chunk_count)
+	{
+		size_t chunk = chunks[i] < length ? chunks[i] : length;
+		ck_assert_int_eq(ccx_session_feed(session, data, chunk), CCX_OK);
+		data += chunk;
+		length -= chunk;
+	}
+}
+
+// One extraction after another of the teletext stream and of a pop-on caption,
+// the work a thread of the parallel test does
+#define JOB_ROUNDS 3
+struct helper_job
+{
+	const unsigned char *ts;
+	size_t ts_length;
+	char output[4096];
+	size_t output_length;
+	int failed;
+};
+
+static void helper_job_output(void *opaque, const unsigned char *data, size_t length)
+{
+	struct helper_job *job = opaque;
+
+	if (job->output_length + length >= sizeof(job->output))
+	{
+		job->failed = 1;
+		return;
+	}
+	memcpy(job->output + job->output_length, data, length);
+	job->output_length += length;
+	job->output[job->output_length] = '\0';
+}
+
+// No ck_assert() here, it can't leave a thread other than the test's
+static void *helper_job_run(void *arg)
+{
+	static const size_t chunks[] = {1, 187, 2, 190, 93, 376, 7};
+	static const unsigned char pairs[][3] = {{0x94, 0x20, 0}, {0x94, 0x70, 1}, {0xc8, 0x49, 2}, {0x94, 0x2f, 30}, {0x94, 0x2c, 90}};
+	struct helper_job *job = arg;
+	struct ccx_session_callbacks callbacks = {.output = helper_job_output, .opaque = job};
+
+	for (int round = 0; round < JOB_ROUNDS && !job->failed; round++)
+	{
+		struct ccx_session *session = ccx_session_create(&ccx_options, CCX_SESSION_INPUT_TS, &callbacks);
+		if (!session)
+		{
+			job->failed = 1;
+			break;
+		}
+		const unsigned char *data = job->ts;
+		for (size_t i = 0, length = job->ts_length; length; i = (i + 1) % (sizeof(chunks) / sizeof(chunks[0])))
+		{
+			size_t chunk = chunks[i] < length ? chunks[i] : length;
+			if (ccx_session_feed(session, data, chunk) != CCX_OK)
+				job->failed = 1;
+			data += chunk;
+			length -= chunk;
+		}
+		ccx_session_delete(&session);
+
+		session = ccx_session_create(&ccx_options, CCX_SESSION_INPUT_CC_DATA, &callbacks);
+		if (!session)
+		{
+			job->failed = 1;
+			break;
+		}
+		for (size_t i = 0; i < sizeof(pairs) / sizeof(pairs[0]); i++)
+		{
+			unsigned char cc_data[] = {0xfc, pairs[i][0], pairs[i][1]};
+			if (ccx_session_feed_cc_data(session, cc_data, 1, (LLONG)pairs[i][2] * 3003) != CCX_OK)
+				job->failed = 1;
+		}
+		ccx_session_delete(&session);
+	}
+	return NULL;
+}
+
+static void setup(void)
+{
+	init_options(&ccx_options);
+	ccx_options.write_format = CCX_OF_SRT;
+	ccx_options.enc_cfg.trim_subs = 1;
+	output[0] = '\0';
+	output_length = 0;
+	subtitles = 0;
+}
+
+// -------------------------------------
+// TESTS
+// -------------------------------------
+
+START_TEST(test_session_pop_on_caption)
+{
+	struct ccx_session *session = helper_create_session(CCX_SESSION_INPUT_CC_DATA);
+	ck_assert_ptr_ne(session, NULL);
+
+	helper_feed_pair(session, 0x94, 0x20, 0);  // Resume caption loading
+	helper_feed_pair(session, 0x94, 0x70, 1);  // Row 15, column 0
+	helper_feed_pair(session, 0xc8, 0x49, 2);  // HI
+	helper_feed_pair(session, 0x94, 0x2f, 30); // End of caption
+	helper_feed_pair(session, 0x94, 0x2c, 90); // Erase displayed memory
+
+	ccx_session_end(session);
+	ccx_session_delete(&session);
+	ck_assert_ptr_eq(session, NULL);
+
+	ck_assert_int_ge(subtitles, 1);
+	ck_assert_int_eq(strncmp(output, "1\r\n00:00:0", 10), 0);
+	ck_assert_ptr_ne(strstr(output, " --> 00:00:0"), NULL);
+	ck_assert_ptr_ne(strstr(output, "\r\nHI\r\n"), NULL);
+}
+END_TEST
+
+START_TEST(test_session_shared_options)
+{
+	unsigned char ts_packet[188] = {0x47};
+	struct ccx_s_options other = {0}; // init_options() leaves the callbacks alone
+	struct ccx_session_callbacks callbacks = {.output = helper_output, .opaque = output};
+	struct ccx_session *session = helper_create_session(CCX_SESSION_INPUT_CC_DATA);
+	ck_assert_ptr_ne(session, NULL);
+
+	// Sessions alive at the same time read the same options
+	struct ccx_session *second = helper_create_session(CCX_SESSION_INPUT_TS);
+	ck_assert_ptr_ne(second, NULL);
+	init_options(&other);
+	ck_assert_ptr_eq(ccx_session_create(&other, CCX_SESSION_INPUT_TS, &callbacks), NULL);
+	// A cc_data session takes no TS
+	ck_assert_int_eq(ccx_session_feed(session, ts_packet, sizeof(ts_packet)), CCX_EINVAL);
+
+	ccx_session_delete(&second);
+	ccx_session_delete(&session);
+	ck_assert_int_eq(output_length, 0);
+	ck_assert_int_eq(subtitles, 0);
+
+	// With none left any options do
+	other.write_format = CCX_OF_SRT;
+	session = ccx_session_create(&other, CCX_SESSION_INPUT_CC_DATA, &callbacks);
+	ck_assert_ptr_ne(session, NULL);
+	ccx_session_delete(&session);
+}
+END_TEST
+
+START_TEST(test_session_ts_split_packets)
+{
+	static unsigned char ts[6 * 188];
+	static const size_t chunks[] = {1, 187, 2, 190, 93, 376, 7};
+	char whole[sizeof(output)];
+	size_t length = helper_teletext_ts(ts);
+
+	struct ccx_session *session = helper_create_session(CCX_SESSION_INPUT_TS);
+	ck_assert_ptr_ne(session, NULL);
+	ck_assert_int_eq(ccx_session_feed(session, ts, length), CCX_OK);
+	ccx_session_delete(&session);
+
+	ck_assert_int_eq(subtitles, 2);
+	ck_assert_ptr_ne(strstr(output, "00:00:01,000 --> 00:00:02,959\r\nHELLO\r\n"), NULL);
+	ck_assert_ptr_ne(strstr(output, "00:00:03,000 --> 00:00:04,959\r\nWORLD\r\n"), NULL);
+	strcpy(whole, output);
+
+	// Packets, the PSI sections and the PES packets split across calls
+	setup();
+	session = helper_create_session(CCX_SESSION_INPUT_TS);
+	ck_assert_ptr_ne(session, NULL);
+	helper_feed_chunks(session, ts, length, chunks, sizeof(chunks) / sizeof(chunks[0]));
+	ccx_session_delete(&session);
+
+	ck_assert_int_eq(subtitles, 2);
+	ck_assert_str_eq(output, whole);
+}
+END_TEST
+
+START_TEST(test_session_pes_input)
+{
+	// PES header with PTS 0, then a sequence end code
+	unsigned char pes[] = {0x00, 0x00, 0x01, 0xe0, 0x00, 0x00, 0x80, 0x80, 0x05,
+			       0x21, 0x00, 0x01, 0x00, 0x01, 0x00, 0x00, 0x01, 0xb7};
+	unsigned char cc_data[] = {0xfc, 0x80, 0x80};
+	struct ccx_session *session = helper_create_session(CCX_SESSION_INPUT_PES_MPEG2);
+	ck_assert_ptr_ne(session, NULL);
+
+	ck_assert_int_eq(ccx_session_feed(session, pes, sizeof(pes)), CCX_OK);
+	// Header shorter than its length says
+	ck_assert_int_eq(ccx_session_feed(session, pes, 12), CCX_EINVAL);
+	// Not video
+	pes[3] = 0xbd;
+	ck_assert_int_eq(ccx_session_feed(session, pes, sizeof(pes)), CCX_EINVAL);
+	ck_assert_int_eq(ccx_session_feed_cc_data(session, cc_data, 1, 0), CCX_EINVAL);
+
+	ccx_session_end(session);
+	pes[3] = 0xe0;
+	ck_assert_int_eq(ccx_session_feed(session, pes, sizeof(pes)), CCX_EINVAL);
+	ccx_session_delete(&session);
+}
+END_TEST
+
+START_TEST(test_session_parallel_matches_serial)
+{
+	enum
+	{
+		THREADS = 4
+	};
+	static unsigned char ts[6 * 188];
+	static struct helper_job serial, jobs[THREADS];
+	pthread_t threads[THREADS];
+	size_t length = helper_teletext_ts(ts);
+
+	serial.ts = ts;
+	serial.ts_length = length;
+	helper_job_run(&serial);
+	ck_assert_int_eq(serial.failed, 0);
+	ck_assert_ptr_ne(strstr(serial.output, "00:00:03,000 --> 00:00:04,959\r\nWORLD\r\n"), NULL);
+	ck_assert_ptr_ne(strstr(serial.output, "\r\nHI\r\n"), NULL);
+
+	// The same extractions at once, each on its own sessions, give the same output
+	for (int i = 0; i < THREADS; i++)
+	{
+		memset(&jobs[i], 0, sizeof(jobs[i]));
+		jobs[i].ts = ts;
+		jobs[i].ts_length = length;
+		ck_assert_int_eq(pthread_create(&threads[i], NULL, helper_job_run, &jobs[i]), 0);
+	}
+	for (int i = 0; i < THREADS; i++)
+		ck_assert_int_eq(pthread_join(threads[i], NULL), 0);
+	for (int i = 0; i < THREADS; i++)
+	{
+		ck_assert_int_eq(jobs[i].failed, 0);
+		ck_assert_str_eq(jobs[i].output, serial.output);
+	}
+}
+END_TEST
+
+Suite *ccx_session_suite(void)
+{
+	Suite *s;
+	TCase *tc_session;
+
+	s = suite_create("Library sessions");
+
+	tc_session = tcase_create("Session: cc_data to SRT: ");
+	tcase_add_checked_fixture(tc_session, setup, NULL);
+	tcase_add_test(tc_session, test_session_pop_on_caption);
+	tcase_add_test(tc_session, test_session_shared_options);
+	suite_add_tcase(s, tc_session);
+
+	tc_session = tcase_create("Session: TS and PES to SRT: ");
+	tcase_add_checked_fixture(tc_session, setup, NULL);
+	tcase_add_test(tc_session, test_session_ts_split_packets);
+	tcase_add_test(tc_session, test_session_pes_input);
+	suite_add_tcase(s, tc_session);
+
+	tc_session = tcase_create("Session: parallel extractions: ");
+	tcase_add_checked_fixture(tc_session, setup, NULL);
+	tcase_add_test(tc_session, test_session_parallel_matches_serial);
+	suite_add_tcase(s, tc_session);
+
+	return s;
+}
@@ -5,9 +5,12 @@
 
 // TESTS:
 #include "ccx_encoders_splitbysentence_suite.h"
+#include "ccx_encoders_scc_suite.h"
+#include "ccx_encoders_sinks_suite.h"
+#include "ccx_session_suite.h"
+#include "ccx_mp4_stream_suite.h"
 
 struct ccx_s_options ccx_options;
-volatile int terminate_asap = 0;
 
 int main(void)
 {
@@ -17,6 +20,10 @@ int main(void)
 
 	s = ccx_encoders_splitbysentence_suite();
 	sr = srunner_create(s);
+	srunner_add_suite(sr, ccx_encoders_scc_suite());
+	srunner_add_suite(sr, ccx_encoders_sinks_suite());
+	srunner_add_suite(sr, ccx_session_suite());
+	srunner_add_suite(sr, ccx_mp4_stream_suite());
 	srunner_set_fork_status(sr, CK_NOFORK);
 
 	srunner_run_all(sr, CK_VERBOSE);
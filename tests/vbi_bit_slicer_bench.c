@@ -0,0 +1,310 @@
+// Micro-benchmark for the zvbi raw VBI decoder and bit slicer.
+//
+// Synthesizes raw 13.5 MHz Y8 scan lines carrying EIA-608 line 21 captions and
+// WST (Teletext System B) packets, decodes them repeatedly through the same
+// vbi_raw_decoder setup used by ccx_decoders_vbi.c and reports the time per line.
+// Every decoded line is checked against the synthesized payload.
+//
+// The bit slicer takes SSE2 shortcuts where it can. Its results are compared
+// against the plain C path it has for sampling points, on noisy random lines.
+// `make bench` also runs a build without SSE2, for the scalar timings.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../src/lib_ccx/ccx_common_common.h"
+#include "../src/lib_ccx/zvbi/zvbi_decoder.h"
+#include "../src/lib_ccx/zvbi/misc.h"
+#include "../src/lib_ccx/zvbi/bit_slicer.h"
+
+#define SAMPLING_RATE 13.5e6
+#define BYTES_PER_LINE 720
+#define FIRST_SAMPLE_US 9.7 // Sampling starts 9.7 us after the hsync leading edge
+#define LEVEL_LOW 40
+#define LEVEL_HIGH 200
+#define ROUNDS 20000
+#define RANDOM_LINES 20000
+
+// The zvbi sources log through lib_ccx; the bench links them on their own.
+static void quiet_debug(LLONG mask, const char *fmt, ...) {}
+static void quiet_log(const char *fmt, ...) {}
+struct ccx_common_logging_t ccx_common_logging = {.debug_ftn = quiet_debug, .log_ftn = quiet_log};
+
+// Renders NRZ bits sent at `rate` Hz, starting `start_us` after hsync, into one line.
+// Each sample is the box-filtered average of the ideal signal over its period.
+static void synthesize_line(uint8_t *line, const uint8_t *bits, int n_bits, double rate, double start_us)
+{
+	for (int n = 0; n < BYTES_PER_LINE; n++)
+	{
+		double level = 0;
+		for (int sub = 0; sub < 4; sub++)
+		{
+			double t = (n + sub / 4.0) / SAMPLING_RATE + FIRST_SAMPLE_US * 1e-6 - start_us * 1e-6;
+			int k = (t < 0) ? -1 : (int)(t * rate);
+			int bit = (k >= 0 && k < n_bits) ? bits[k] : 0;
+			level += bit ? LEVEL_HIGH : LEVEL_LOW;
+		}
+		line[n] = (uint8_t)(level / 4);
+	}
+}
+
+static int add_byte_lsb_first(uint8_t *bits, int n, uint8_t byte, int repeat)
+{
+	for (int i = 0; i < 8; i++)
+		for (int r = 0; r < repeat; r++)
+			bits[n++] = (byte >> i) & 1;
+	return n;
+}
+
+static uint8_t odd_parity(uint8_t c)
+{
+	uint8_t p = c ^ (c >> 4);
+	p ^= p >> 2;
+	p ^= p >> 1;
+	return (p & 1) ? c : (c | 0x80);
+}
+
+// Line 21: 7 cycles of clock run-in, start bits 001, two bytes with odd parity.
+// Bits are generated at twice the data rate so the run-in can be expressed as well.
+static void synthesize_cc(uint8_t *line, uint8_t b1, uint8_t b2)
+{
+	uint8_t bits[64];
+	int n = 0;
+	for (int i = 0; i < 7; i++)
+	{
+		bits[n++] = 1;
+		bits[n++] = 0;
+	}
+	bits[n++] = 0;
+	bits[n++] = 0;
+	bits[n++] = 0;
+	bits[n++] = 0;
+	bits[n++] = 1;
+	bits[n++] = 1;
+	n = add_byte_lsb_first(bits, n, b1, 2);
+	n = add_byte_lsb_first(bits, n, b2, 2);
+	synthesize_line(line, bits, n, 2 * 503488.0, 10.5);
+}
+
+// WST: clock run-in 0x55 0x55, framing code 0x27, 42 bytes of packet data.
+static void synthesize_wst(uint8_t *line, const uint8_t *packet)
+{
+	uint8_t bits[45 * 8];
+	int n = 0;
+	n = add_byte_lsb_first(bits, n, 0x55, 1);
+	n = add_byte_lsb_first(bits, n, 0x55, 1);
+	n = add_byte_lsb_first(bits, n, 0x27, 1);
+	for (int i = 0; i < 42; i++)
+		n = add_byte_lsb_first(bits, n, packet[i], 1);
+	synthesize_line(line, bits, n, 6937500.0, 10.3);
+}
+
+static double now_ns(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void init_decoder(vbi_raw_decoder *rd, int scanning, int start0, int start1, int count, unsigned int services)
+{
+	vbi_raw_decoder_init(rd);
+	rd->scanning = scanning;
+	rd->sampling_format = VBI_PIXFMT_YUV420;
+	rd->sampling_rate = SAMPLING_RATE;
+	rd->bytes_per_line = BYTES_PER_LINE;
+	rd->offset = FIRST_SAMPLE_US * 1e-6 * SAMPLING_RATE;
+	rd->start[0] = start0;
+	rd->count[0] = count;
+	rd->start[1] = start1;
+	rd->count[1] = count;
+	rd->interlaced = CCX_TRUE;
+	rd->synchronous = CCX_TRUE;
+	vbi_raw_decoder_add_services(rd, services, /* strict */ 0);
+}
+
+// Decodes `image` ROUNDS times, returns the number of mismatching lines in the last round.
+static int run(const char *name, vbi_raw_decoder *rd, uint8_t *image, int lines,
+	       const uint8_t expected[][42], int payload_bytes, int expected_lines)
+{
+	vbi_sliced sliced[64];
+	unsigned int n = 0;
+	double start = now_ns();
+	for (int r = 0; r < ROUNDS; r++)
+		n = vbi_raw_decode(rd, image, sliced);
+	double elapsed = now_ns() - start;
+
+	int errors = (int)n != expected_lines;
+	for (unsigned int i = 0; i < n && !errors; i++)
+		errors += memcmp(sliced[i].data, expected[i], payload_bytes) != 0;
+
+	printf("%-24s %8.1f ns/line  %u/%d lines decoded%s\n", name,
+	       elapsed / ((double)ROUNDS * lines), n, expected_lines, errors ? "  MISMATCH" : "");
+	return errors;
+}
+
+// Bit slicer settings as vbi_raw_decoder derives them from its service table
+struct slicer_service
+{
+	const char *name;
+	unsigned int cri_frc;
+	unsigned int cri_frc_mask;
+	unsigned int cri_bits;
+	unsigned int frc_bits;
+	unsigned int payload_bits;
+	unsigned int cri_rate;
+	unsigned int bit_rate;
+	vbi3_modulation modulation;
+	double start_us;
+	int run_in; // clock run-in elements sent before the CRI bits the slicer checks
+};
+
+static const struct slicer_service slicer_services[] = {
+    {"Caption 525", 0x03, 0x0F, 4, 0, 2 * 8, 1006976, 503488, VBI3_MODULATION_NRZ_LSB, 10.5, 14},
+    {"WST", 0x00AAAAE4, 0xFFFF, 18, 6, 42 * 8, 6937500, 6937500, VBI3_MODULATION_NRZ_LSB, 10.3, 0},
+    {"VPS", 0xAAAA8A99, 0xFFFFFF, 32, 0, 13 * 8, 5000000, 2500000, VBI3_MODULATION_BIPHASE_MSB, 12.5, 0},
+    {"WSS 625", 0x8E3C783E, 0x2499339C, 32, 0, 14, 5000000, 833333, VBI3_MODULATION_BIPHASE_LSB, 11.0, 0},
+};
+
+static void init_slicer(vbi3_bit_slicer *bs, const struct slicer_service *sv)
+{
+	_vbi3_bit_slicer_init(bs);
+	vbi3_bit_slicer_set_params(bs, VBI_PIXFMT_YUV420, SAMPLING_RATE, 0, BYTES_PER_LINE,
+				   sv->cri_frc >> sv->frc_bits, sv->cri_frc_mask >> sv->frc_bits,
+				   sv->cri_bits, sv->cri_rate, ~0U,
+				   sv->cri_frc & ((1U << sv->frc_bits) - 1), sv->frc_bits,
+				   sv->payload_bits, sv->bit_rate, sv->modulation);
+}
+
+// A line of the service with random payload, or of noise or garbage, at a random
+// level with random noise on top. Payload bits become cri_rate / bit_rate elements
+// at the CRI rate, biphase ones the bit and its inverse.
+static void random_line(uint8_t *line, const struct slicer_service *sv)
+{
+	static uint8_t bits[1024];
+	int kind = rand() % 4;
+	int n = 0;
+
+	if (kind == 3)
+	{
+		for (int i = 0; i < BYTES_PER_LINE; i++)
+			line[i] = (uint8_t)rand();
+		return;
+	}
+	if (kind < 2)
+	{
+		int biphase = sv->modulation == VBI3_MODULATION_BIPHASE_LSB || sv->modulation == VBI3_MODULATION_BIPHASE_MSB;
+		unsigned int repeat = sv->cri_rate / sv->bit_rate;
+		for (int i = 0; i < sv->run_in; i++)
+			bits[n++] = !(i & 1);
+		for (int i = sv->cri_bits + sv->frc_bits - 1; i >= 0; i--)
+			bits[n++] = (sv->cri_frc >> i) & 1;
+		for (unsigned int i = 0; i < sv->payload_bits; i++)
+		{
+			int bit = rand() & 1;
+			if (biphase)
+			{
+				bits[n++] = bit;
+				bits[n++] = !bit;
+			}
+			else
+				for (unsigned int r = 0; r < repeat; r++)
+					bits[n++] = bit;
+		}
+	}
+	double jitter = (rand() % 200 - 100) / 100.0;
+	synthesize_line(line, bits, n, sv->cri_rate, sv->start_us + jitter);
+
+	int offset = rand() % 61 - 30;
+	int noise = (kind == 0) ? 4 : 1 + rand() % 60;
+	for (int i = 0; i < BYTES_PER_LINE; i++)
+	{
+		int level = line[i] + offset + rand() % (2 * noise + 1) - noise;
+		line[i] = (uint8_t)(level < 0 ? 0 : level > 255 ? 255 : level);
+	}
+}
+
+// Slices the same random lines with vbi3_bit_slicer_slice(), which may use SSE2, and
+// with vbi3_bit_slicer_slice_with_points(), which never does. Both slicers carry their
+// threshold over from line to line, so that is compared as well.
+static int compare_with_scalar(const struct slicer_service *sv)
+{
+	static uint8_t line[BYTES_PER_LINE + 16];
+	vbi3_bit_slicer fast, scalar;
+	vbi3_bit_slicer_point points[1024];
+	unsigned int n_points;
+	int decoded = 0, mismatches = 0;
+
+	init_slicer(&fast, sv);
+	init_slicer(&scalar, sv);
+	srand(2);
+	for (int l = 0; l < RANDOM_LINES; l++)
+	{
+		uint8_t out_fast[64] = {0}, out_scalar[64] = {0};
+
+		random_line(line, sv);
+		int ok_fast = vbi3_bit_slicer_slice(&fast, out_fast, sizeof(out_fast), line);
+		int ok_scalar = vbi3_bit_slicer_slice_with_points(&scalar, out_scalar, sizeof(out_scalar),
+								  points, &n_points, 1024, line);
+		decoded += ok_scalar;
+		mismatches += ok_fast != ok_scalar || fast.thresh != scalar.thresh ||
+			      memcmp(out_fast, out_scalar, sizeof(out_fast)) != 0;
+	}
+	printf("%-24s %8d lines, %d with data, %d differ from plain C%s\n", sv->name, RANDOM_LINES,
+	       decoded, mismatches, mismatches ? "  MISMATCH" : "");
+	return mismatches;
+}
+
+int main(void)
+{
+	static uint8_t image[32 * BYTES_PER_LINE];
+	static uint8_t expected[32][42];
+	vbi_raw_decoder rd;
+	int failed = 0;
+
+#if defined(HAVE_SSE2_SLICER) && !HAVE_SSE2_SLICER
+	printf("Plain C bit slicer\n");
+#else
+	printf("Bit slicer as built by default\n");
+#endif
+	// Also run in the plain C build so both builds time the lines below in the same state
+	for (size_t i = 0; i < sizeof(slicer_services) / sizeof(slicer_services[0]); i++)
+		failed += compare_with_scalar(&slicer_services[i]);
+
+	// EIA-608: line 21 of both fields
+	init_decoder(&rd, 525, 21, 284, 1, VBI_SLICED_CAPTION_525);
+	const char *text = "HI";
+	for (int field = 0; field < 2; field++)
+	{
+		expected[field][0] = odd_parity(text[field]);
+		expected[field][1] = odd_parity(0x20 + field);
+		synthesize_cc(image + field * BYTES_PER_LINE, expected[field][0], expected[field][1]);
+	}
+	failed += run("line 21 captions", &rd, image, 2, (const uint8_t(*)[42])expected, 2, 2);
+
+	// Same lines without a signal, the common case between captions
+	memset(image, LEVEL_LOW, 2 * BYTES_PER_LINE);
+	failed += run("line 21 blank", &rd, image, 2, (const uint8_t(*)[42])expected, 2, 0);
+	vbi_raw_decoder_destroy(&rd);
+
+	// WST: 16 lines per field, every line carrying a packet. The image is interlaced
+	// while the sliced lines come out field by field.
+	init_decoder(&rd, 625, 7, 320, 16, VBI_SLICED_TELETEXT_B);
+	srand(1);
+	for (int l = 0; l < 32; l++)
+	{
+		int row = (l % 16) * 2 + l / 16;
+		for (int i = 0; i < 42; i++)
+			expected[l][i] = (uint8_t)rand();
+		synthesize_wst(image + row * BYTES_PER_LINE, expected[l]);
+	}
+	failed += run("WST teletext", &rd, image, 32, (const uint8_t(*)[42])expected, 42, 32);
+
+	memset(image, LEVEL_LOW, sizeof(image));
+	failed += run("WST blank", &rd, image, 32, (const uint8_t(*)[42])expected, 42, 0);
+	vbi_raw_decoder_destroy(&rd);
+
+	return failed ? 1 : 0;
+}